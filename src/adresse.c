@@ -1,28 +1,11 @@
 #include "adresse.h"
 #include <stdio.h>
 
-
-void initIPv4(IPv4 *adresse){
-    //à completer
-}
-
-void initMAC(IPv4 *adresse){
-    //à completer
-}
-
-char afficherIPv4(const IPv4 *adresse){
-    //à completer
-}
-
-char afficherMAC(const MAC *adresse){
-    //à completer
-}
-
 char * IPv4_to_string(IPv4 ip, char * str_ipv4){
     if (!str_ipv4){
         return NULL;
     }
-    snprintf(str_ipv4, 16, "%u.%u.%u.%u", ip.IP[0], ip.IP[1], ip.IP[2], ip.IP[3]);
+    snprintf(str_ipv4, 16, "%u.%u.%u.%u", ip.octet[0], ip.octet[1], ip.octet[2], ip.octet[3]);
     return str_ipv4;
 }
 
@@ -31,7 +14,7 @@ char * MAC_to_string(MAC M, char * str_mac){
         return NULL;
     }
     snprintf(str_mac, 18, "%02X:%02X:%02X:%02X:%02X:%02X", 
-             M.MAC[0], M.MAC[1], M.MAC[2], M.MAC[3], M.MAC[4], M.MAC[5]);
+             M.octet[0], M.octet[1], M.octet[2], M.octet[3], M.octet[4], M.octet[5]);
     return str_mac;
 }
 #include "adresse.h"
@@ -134,6 +117,17 @@ bool mac_equals(mac_addr_t mac1, mac_addr_t mac2) {
     return memcmp(mac1.octet, mac2.octet, 6) == 0;
 }
 
+bool mac_est_diffusion(mac_addr_t mac) {
+    for (int i = 0; i < 6; i++) {
+        if (mac.octet[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+bool mac_est_multicast(mac_addr_t mac) {
+    return (mac.octet[0] & 0x01) != 0;
+}
+
 bool ip_equals(ip_addr_t ip1, ip_addr_t ip2) {
     return memcmp(ip1.octet, ip2.octet, 4) == 0;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@ typedef struct {
 } ip_addr_t;
 
 typedef mac_addr_t MAC;
+typedef ip_addr_t IPv4;
 
 void init_mac(mac_addr_t *mac);
 void init_ip(ip_addr_t *ip);
@@ -25,9 +26,14 @@ void afficher_ip(ip_addr_t ip);
 
 char* mac_to_string(mac_addr_t mac, char *str_mac);
 char* ip_to_string(ip_addr_t ip, char *str_ip);
+char* IPv4_to_string(IPv4 ip, char *str_ipv4);
+char* MAC_to_string(MAC M, char *str_mac);
 
 bool parse_mac(const char *str, mac_addr_t *mac);
 bool parse_ip(const char *str, ip_addr_t *ip);
 
 bool mac_equals(mac_addr_t mac1, mac_addr_t mac2);
+bool mac_est_diffusion(mac_addr_t mac);
+// Bit I/G du premier octet : adresse de groupe (multicast ou diffusion)
+bool mac_est_multicast(mac_addr_t mac);
 bool ip_equals(ip_addr_t ip1, ip_addr_t ip2);
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "arp.h"
+#include "memoire.h"
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t cle_ip(ip_addr_t ip) {
+    return ((uint32_t)ip.octet[0] << 24) | ((uint32_t)ip.octet[1] << 16) |
+           ((uint32_t)ip.octet[2] << 8) | ip.octet[3];
+}
+
+// --- Paquets ---
+
+static void ecrire_u16(uint8_t *p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static uint16_t lire_u16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+bool init_trame_arp(trame *t, const paquet_arp_t *p) {
+    if (t == NULL || p == NULL) return false;
+
+    // matériel Ethernet (1), protocole IPv4, adresses de 6 et 4 octets
+    uint8_t octets[TAILLE_PAQUET_ARP];
+    ecrire_u16(octets, 1);
+    ecrire_u16(octets + 2, TYPE_IPV4);
+    octets[4] = 6;
+    octets[5] = 4;
+    ecrire_u16(octets + 6, p->operation);
+    memcpy(octets + 8, p->mac_emetteur.octet, 6);
+    memcpy(octets + 14, p->ip_emetteur.octet, 4);
+    if (p->operation == ARP_REQUETE) {
+        memset(octets + 18, 0, 6);
+    } else {
+        memcpy(octets + 18, p->mac_cible.octet, 6);
+    }
+    memcpy(octets + 24, p->ip_cible.octet, 4);
+
+    mac_addr_t destination = (p->operation == ARP_REQUETE) ? creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF)
+                                                           : p->mac_cible;
+    return init_trame(t, p->mac_emetteur, destination, TYPE_ARP, octets, sizeof(octets));
+}
+
+bool lire_paquet_arp(const trame *t, paquet_arp_t *p) {
+    if (t == NULL || p == NULL || t->type != TYPE_ARP || t->taille_donnees < TAILLE_PAQUET_ARP) return false;
+
+    const uint8_t *d = t->donnees;
+    if (lire_u16(d) != 1 || lire_u16(d + 2) != TYPE_IPV4 || d[4] != 6 || d[5] != 4) return false;
+    p->operation = lire_u16(d + 6);
+    memcpy(p->mac_emetteur.octet, d + 8, 6);
+    memcpy(p->ip_emetteur.octet, d + 14, 4);
+    memcpy(p->mac_cible.octet, d + 18, 6);
+    memcpy(p->ip_cible.octet, d + 24, 4);
+    return p->operation == ARP_REQUETE || p->operation == ARP_REPONSE;
+}
+
+// --- Cache ---
+
+void init_cache_arp(cache_arp_t *cache) {
+    if (cache == NULL) return;
+
+    cache->entrees = NULL;
+    cache->capacite = 0;
+    cache->nb = 0;
+    cache->nb_succes = 0;
+    cache->nb_echecs = 0;
+    cache->nb_expirees = 0;
+}
+
+void deinit_cache_arp(cache_arp_t *cache) {
+    if (cache == NULL) return;
+
+    liberer_memoire(MEMOIRE_TABLES, cache->entrees, cache->capacite * sizeof(entree_arp_t));
+    cache->entrees = NULL;
+    cache->capacite = 0;
+    cache->nb = 0;
+}
+
+static unsigned int hacher_ip(uint32_t ip) {
+    return (unsigned int)((ip * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+// Case contenant l'adresse, ou première case libre rencontrée
+static int case_ip(const cache_arp_t *cache, uint32_t ip) {
+    int masque = cache->capacite - 1;
+    int c = hacher_ip(ip) & masque;
+    while (cache->entrees[c].ip != 0 && cache->entrees[c].ip != ip) {
+        c = (c + 1) & masque;
+    }
+    return c;
+}
+
+// Suppression par décalage arrière, comme l'index des tables de commutation
+static void liberer_case(cache_arp_t *cache, int c) {
+    int masque = cache->capacite - 1;
+    int vide = c;
+    cache->entrees[vide].ip = 0;
+    cache->nb--;
+
+    for (int i = (vide + 1) & masque; cache->entrees[i].ip != 0; i = (i + 1) & masque) {
+        int ideale = hacher_ip(cache->entrees[i].ip) & masque;
+        if (((i - ideale) & masque) >= ((i - vide) & masque)) {
+            cache->entrees[vide] = cache->entrees[i];
+            cache->entrees[i].ip = 0;
+            vide = i;
+        }
+    }
+}
+
+static bool agrandir(cache_arp_t *cache) {
+    int nouvelle_capacite = (cache->capacite == 0) ? 8 : cache->capacite * 2;
+    entree_arp_t *nouvelles = allouer_memoire_zero(MEMOIRE_TABLES, nouvelle_capacite, sizeof(entree_arp_t));
+    if (nouvelles == NULL) return false;
+
+    entree_arp_t *anciennes = cache->entrees;
+    int ancienne_capacite = cache->capacite;
+    cache->entrees = nouvelles;
+    cache->capacite = nouvelle_capacite;
+    for (int c = 0; c < ancienne_capacite; c++) {
+        if (anciennes[c].ip != 0) cache->entrees[case_ip(cache, anciennes[c].ip)] = anciennes[c];
+    }
+    liberer_memoire(MEMOIRE_TABLES, anciennes, ancienne_capacite * sizeof(entree_arp_t));
+    return true;
+}
+
+bool inserer_cache_arp(cache_arp_t *cache, ip_addr_t ip, mac_addr_t mac, uint64_t expiration) {
+    uint32_t cle = cle_ip(ip);
+    if (cache == NULL || cle == 0) return false;
+
+    if (2 * (cache->nb + 1) > cache->capacite && !agrandir(cache)) return false;
+
+    entree_arp_t *e = &cache->entrees[case_ip(cache, cle)];
+    if (e->ip == 0) cache->nb++;
+    e->ip = cle;
+    e->mac = mac;
+    e->expiration = expiration;
+    return true;
+}
+
+bool chercher_cache_arp(cache_arp_t *cache, ip_addr_t ip, uint64_t maintenant, mac_addr_t *mac) {
+    if (cache == NULL) return false;
+
+    uint32_t cle = cle_ip(ip);
+    int c = (cache->capacite > 0 && cle != 0) ? case_ip(cache, cle) : -1;
+    if (c < 0 || cache->entrees[c].ip == 0) {
+        cache->nb_echecs++;
+        return false;
+    }
+    if (cache->entrees[c].expiration <= maintenant) {
+        liberer_case(cache, c);
+        cache->nb_expirees++;
+        cache->nb_echecs++;
+        return false;
+    }
+
+    cache->nb_succes++;
+    if (mac != NULL) *mac = cache->entrees[c].mac;
+    return true;
+}
+
+bool retirer_cache_arp(cache_arp_t *cache, ip_addr_t ip) {
+    uint32_t cle = cle_ip(ip);
+    if (cache == NULL || cache->capacite == 0 || cle == 0) return false;
+
+    int c = case_ip(cache, cle);
+    if (cache->entrees[c].ip == 0) return false;
+    liberer_case(cache, c);
+    return true;
+}
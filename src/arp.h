@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "adresse.h"
+#include "trame.h"
+
+// ARP (RFC 826) sur Ethernet / IPv4 : requête diffusée, réponse en unicast
+#define ARP_REQUETE 1
+#define ARP_REPONSE 2
+#define TAILLE_PAQUET_ARP 28
+
+#define DUREE_CACHE_ARP_DEFAUT 60000000000ULL   // 60 s
+#define RELANCE_ARP 1000000000ULL               // nouvelle requête si sans réponse après 1 s
+
+typedef struct {
+    uint16_t operation;
+    mac_addr_t mac_emetteur;
+    ip_addr_t ip_emetteur;
+    mac_addr_t mac_cible;      // ignorée dans une requête
+    ip_addr_t ip_cible;
+} paquet_arp_t;
+
+// Requête : destination de diffusion ; réponse : destination mac_cible
+bool init_trame_arp(trame *t, const paquet_arp_t *p);
+bool lire_paquet_arp(const trame *t, paquet_arp_t *p);
+
+// Adresse IPv4 rangée dans un entier, premier octet en poids fort
+uint32_t cle_ip(ip_addr_t ip);
+
+typedef struct {
+    uint32_t ip;               // 0 : case libre (0.0.0.0 n'est jamais résolue)
+    mac_addr_t mac;
+    uint64_t expiration;       // date (ns) à partir de laquelle l'entrée est périmée
+} entree_arp_t;
+
+// Cache ARP d'une station : adressage ouvert à sondage linéaire sur la clé IP,
+// taux de remplissage d'au plus 1/2, entrées périmées retirées à la consultation
+typedef struct {
+    entree_arp_t *entrees;
+    int capacite;              // puissance de 2, 0 tant que rien n'est appris
+    int nb;
+    uint64_t nb_succes;
+    uint64_t nb_echecs;        // adresse absente ou périmée
+    uint64_t nb_expirees;
+} cache_arp_t;
+
+void init_cache_arp(cache_arp_t *cache);
+void deinit_cache_arp(cache_arp_t *cache);
+bool inserer_cache_arp(cache_arp_t *cache, ip_addr_t ip, mac_addr_t mac, uint64_t expiration);
+// Vrai si ip est résolue et non périmée à la date maintenant
+bool chercher_cache_arp(cache_arp_t *cache, ip_addr_t ip, uint64_t maintenant, mac_addr_t *mac);
+bool retirer_cache_arp(cache_arp_t *cache, ip_addr_t ip);
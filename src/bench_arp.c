@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "reseau.h"
+#include "stp.h"
+#include "simulation.h"
+#include "trafic.h"
+
+// Banc d'essai de la résolution ARP : arbre à deux niveaux (un switch de cœur,
+// des switchs d'accès de 48 stations), trafic poissonien uniforme de débit fixe
+// pendant la même durée quel que soit le nombre de stations. Mesure le volume de
+// diffusion et le taux de succès des caches quand le nombre de stations croît.
+// Usage : ./bench_arp [nb_stations_max] [trames/s] [durée_ms]
+
+#define STATIONS_PAR_ACCES 48
+
+static void generer_arbre(reseau_t *r, size_t nb_stations) {
+    init_reseau(r);
+    size_t nb_acces = (nb_stations + STATIONS_PAR_ACCES - 1) / STATIONS_PAR_ACCES;
+
+    reseau_ajouter_switch(r, creer_switch(creer_mac(0x02, 0x00, 0x00, 0x00, 0x00, 0x00), (int)nb_acces, 4096));
+    for (size_t a = 0; a < nb_acces; a++) {
+        reseau_ajouter_switch(r, creer_switch(creer_mac(0x02, 0x00, 0x00, 0x01, (uint8_t)(a >> 8), (uint8_t)a),
+                                              STATIONS_PAR_ACCES + 1, 32768));
+    }
+    for (size_t k = 0; k < nb_stations; k++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, 0x01, 0x00, (uint8_t)(k >> 8), (uint8_t)k);
+        reseau_ajouter_station(r, creer_station(mac, creer_ip(10, (uint8_t)(k >> 16), (uint8_t)(k >> 8), (uint8_t)k)));
+    }
+
+    for (size_t a = 0; a < nb_acces; a++) {
+        reseau_relier(r, 0, 1 + a, 4);
+    }
+    for (size_t k = 0; k < nb_stations; k++) {
+        reseau_relier(r, 1 + k / STATIONS_PAR_ACCES, 1 + nb_acces + k, 19);
+    }
+}
+
+static void mesurer(size_t nb_stations, double debit, double duree_ms) {
+    reseau_t r;
+    generer_arbre(&r, nb_stations);
+    calculer_stp(&r, NULL);
+
+    simulation_t sim;
+    generateur_trafic_t g;
+    config_trafic_t c;
+    config_trafic_defaut(&c);
+    c.debit = debit;
+    if (!init_simulation(&sim, &r) || !activer_arp(&sim, DUREE_CACHE_ARP_DEFAUT) ||
+        !init_generateur(&g, &sim, &c)) {
+        fprintf(stderr, "Simulation impossible pour %zu stations\n", nb_stations);
+        deinit_simulation(&sim);
+        deinit_reseau(&r);
+        return;
+    }
+    configurer_files_sortie(&sim, 4096, REJET_QUEUE);
+
+    generer_trafic(&g, (temps_sim_t)(duree_ms * 1e6));
+    executer_simulation(&sim, 0);
+
+    bilan_arp_t b;
+    bilan_arp(&sim, &b);
+    uint64_t inondees = 0;
+    for (size_t i = 0; i < r.nb_switchs; i++) inondees += r.switchs[i].compteurs.nb_inondees;
+    uint64_t emises = sim.compteurs.nb_emises;
+    // chaque requête est remise à toutes les autres stations
+    printf("%8zu %10llu %10llu %9.1f %%  %12llu %10llu %8.1f %%  %8.2f\n", nb_stations,
+           (unsigned long long)g.nb_generees, (unsigned long long)b.nb_requetes,
+           emises > 0 ? 100.0 * (b.nb_requetes + b.nb_reponses) / emises : 0.0,
+           (unsigned long long)(b.nb_requetes * (nb_stations - 1)), (unsigned long long)inondees,
+           b.taux_succes * 100, (double)b.nb_entrees / nb_stations);
+
+    deinit_generateur(&g);
+    deinit_simulation(&sim);
+    deinit_reseau(&r);
+}
+
+int main(int argc, char *argv[]) {
+    size_t max = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1024;
+    double debit = (argc > 2) ? atof(argv[2]) : 100000;
+    double duree_ms = (argc > 3) ? atof(argv[3]) : 200;
+
+    printf("Trafic poissonien : %.0f trames/s pendant %.0f ms, caches de %llu s\n", debit, duree_ms,
+           DUREE_CACHE_ARP_DEFAUT / 1000000000ULL);
+    printf("%8s %10s %10s %11s  %12s %10s %10s  %8s\n", "stations", "trames IP", "requêtes", "part ARP",
+           "copies diff.", "inondées", "succès", "cache/st");
+    for (size_t n = 16; n <= max; n *= 4) {
+        mesurer(n, debit, duree_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "reseau.h"
+#include "stp.h"
+#include "chemins.h"
+
+// Banc d'essai des requêtes de chemin sur l'arbre actif : maillage de switchs
+// en grille portant chacun deux stations, STP calculé, puis paires de stations
+// tirées au hasard. Compare l'index (ancêtre commun par table creuse) à la
+// remontée des parents, puis mesure la mise à jour après un changement de rôles.
+// Usage : ./bench_chemins [nb_switchs] [nb_requetes]
+
+#define STATIONS_PAR_SWITCH 2
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grille cote x cote comme bench_stp ; les stations suivent les switchs
+static void generer_maillage(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        reseau_ajouter_switch(r, creer_switch(mac, 8, 4096 * (1 + rand() % 8)));
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        size_t x = i % cote;
+        if (x + 1 < cote && i + 1 < nb_switchs) reseau_relier(r, i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) reseau_relier(r, i, i + cote, poids[rand() % 3]);
+        if (rand() % 4 == 0 && x + 1 < cote && i + cote + 1 < nb_switchs) {
+            reseau_relier(r, i, i + cote + 1, poids[rand() % 3]);
+        }
+    }
+    for (size_t k = 0; k < nb_switchs * STATIONS_PAR_SWITCH; k++) {
+        mac_addr_t mac = creer_mac(0x02, 0x01, (k >> 24) & 0xFF, (k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF);
+        sommet s = reseau_ajouter_station(r, creer_station(mac, creer_ip(10, k >> 16, k >> 8, k)));
+        reseau_relier(r, k / STATIONS_PAR_SWITCH, s, 19);
+    }
+}
+
+// Référence sans index : remontée du plus profond des deux jusqu'à la rencontre
+static uint64_t cout_par_remontee(const index_chemins_t *idx, sommet a, sommet b) {
+    if (idx->racine[a] != idx->racine[b]) return COUT_CHEMIN_INFINI;
+    uint64_t ca = idx->cout[a], cb = idx->cout[b];
+    while (a != b) {
+        if (idx->profondeur[a] >= idx->profondeur[b]) {
+            a = idx->parent[a];
+        } else {
+            b = idx->parent[b];
+        }
+    }
+    return ca + cb - 2 * idx->cout[a];
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000;
+    size_t nb_requetes = (argc > 2) ? strtoul(argv[2], NULL, 10) : 10000000;
+    if (nb_switchs < 2 || nb_requetes == 0) {
+        fprintf(stderr, "Il faut au moins 2 switchs et une requête\n");
+        return 1;
+    }
+
+    reseau_t r;
+    generer_maillage(&r, nb_switchs);
+    calculer_stp(&r, NULL);
+    size_t n = ordre(&r.g);
+    sommet premiere_station = nb_switchs;
+
+    index_chemins_t idx;
+    double t0 = maintenant();
+    if (!construire_index_chemins(&idx, &r)) {
+        fprintf(stderr, "Construction de l'index impossible\n");
+        deinit_reseau(&r);
+        return 1;
+    }
+    double t1 = maintenant();
+    printf("Maillage : %zu switchs, %zu stations, %zu arbre(s), tour de %zu cases sur %d niveaux\n", nb_switchs,
+           r.nb_stations, idx.nb_arbres, idx.nb_tour, idx.nb_niveaux);
+    printf("Construction de l'index : %.2f ms\n", (t1 - t0) * 1e3);
+
+    // mêmes paires pour les deux méthodes
+    sommet *paires = malloc(2 * nb_requetes * sizeof(sommet));
+    sommet *chemin = malloc((n + 1) * sizeof(sommet));
+    if (paires == NULL || chemin == NULL) {
+        free(paires);
+        free(chemin);
+        deinit_index_chemins(&idx);
+        deinit_reseau(&r);
+        return 1;
+    }
+    srand(7);
+    for (size_t q = 0; q < 2 * nb_requetes; q++) {
+        paires[q] = premiere_station + (sommet)rand() % r.nb_stations;
+    }
+
+    uint64_t total_index = 0, total_remontee = 0, total_sauts = 0;
+    t0 = maintenant();
+    for (size_t q = 0; q < nb_requetes; q++) {
+        total_index += cout_chemin(&idx, paires[2 * q], paires[2 * q + 1]);
+    }
+    t1 = maintenant();
+    double duree_index = t1 - t0;
+    for (size_t q = 0; q < nb_requetes; q++) {
+        total_remontee += cout_par_remontee(&idx, paires[2 * q], paires[2 * q + 1]);
+    }
+    double duree_remontee = maintenant() - t1;
+    t0 = maintenant();
+    for (size_t q = 0; q < nb_requetes; q++) {
+        total_sauts += sauts_chemin(&idx, paires[2 * q], paires[2 * q + 1], chemin);
+    }
+    double duree_sauts = maintenant() - t0;
+
+    printf("%-22s %12s %14s\n", "", "requêtes/s", "ns/requête");
+    printf("%-22s %12.3g %14.1f\n", "coût (index)", nb_requetes / duree_index, duree_index * 1e9 / nb_requetes);
+    printf("%-22s %12.3g %14.1f\n", "coût (remontée)", nb_requetes / duree_remontee,
+           duree_remontee * 1e9 / nb_requetes);
+    printf("%-22s %12.3g %14.1f   (%.1f sommets en moyenne)\n", "liste des sauts", nb_requetes / duree_sauts,
+           duree_sauts * 1e9 / nb_requetes, (double)total_sauts / nb_requetes);
+    printf("Sommes des coûts identiques : %s\n", total_index == total_remontee ? "oui" : "NON");
+
+    // coupure d'un lien bloqué : rôles recalculés, aucun tour modifié
+    size_t bloque = UNKNOWN_INDEX, actif = UNKNOWN_INDEX;
+    for (size_t i = 0; i < r.g.nb_aretes && (bloque == UNKNOWN_INDEX || actif == UNKNOWN_INDEX); i++) {
+        const arete *a = &r.g.aretes[i];
+        if (a->s1 >= nb_switchs || a->s2 >= nb_switchs) continue;
+        bool dans_arbre = idx.parent[a->s1] == a->s2 || idx.parent[a->s2] == a->s1;
+        if (dans_arbre && actif == UNKNOWN_INDEX) actif = i;
+        if (!dans_arbre && bloque == UNKNOWN_INDEX) bloque = i;
+    }
+    arete coupures[2];
+    if (bloque != UNKNOWN_INDEX) coupures[0] = r.g.aretes[bloque];
+    if (actif != UNKNOWN_INDEX) coupures[1] = r.g.aretes[actif];
+    const char *noms[2] = {"lien bloqué coupé", "lien de l'arbre coupé"};
+    for (int k = 0; k < 2; k++) {
+        if ((k == 0 && bloque == UNKNOWN_INDEX) || (k == 1 && actif == UNKNOWN_INDEX)) continue;
+        reseau_delier(&r, coupures[k].s1, coupures[k].s2);
+        calculer_stp(&r, NULL);
+        uint64_t avant = idx.nb_arbres_reconstruits, cases_avant = idx.nb_cases_reecrites;
+        t0 = maintenant();
+        mettre_a_jour_index_chemins(&idx, &r);
+        t1 = maintenant();
+        printf("Mise à jour, %-22s : %.2f ms, %llu arbre(s) refait(s), %llu case(s) de table sur %llu\n", noms[k],
+               (t1 - t0) * 1e3, (unsigned long long)(idx.nb_arbres_reconstruits - avant),
+               (unsigned long long)(idx.nb_cases_reecrites - cases_avant),
+               (unsigned long long)idx.nb_niveaux * idx.nb_tour);
+    }
+
+    free(paires);
+    free(chemin);
+    deinit_index_chemins(&idx);
+    deinit_reseau(&r);
+    return 0;
+}
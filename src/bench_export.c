@@ -0,0 +1,85 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "reseau.h"
+#include "stp.h"
+#include "export.h"
+
+// Banc d'essai de l'export : maillage de switchs en grille portant chacun deux
+// stations (environ un million de liens par défaut), STP calculé, puis écriture
+// DOT et GraphML. L'export ne tient aucune structure auxiliaire : le temps ne
+// dépend que du volume écrit.
+// Usage : ./bench_export [nb_switchs] [repertoire]
+
+#define STATIONS_PAR_SWITCH 2
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grille cote x cote comme bench_chemins ; les stations suivent les switchs
+static void generer_maillage(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        reseau_ajouter_switch(r, creer_switch(mac, 8, 4096 * (1 + rand() % 8)));
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        size_t x = i % cote;
+        if (x + 1 < cote && i + 1 < nb_switchs) reseau_relier(r, i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) reseau_relier(r, i, i + cote, poids[rand() % 3]);
+    }
+    for (size_t k = 0; k < nb_switchs * STATIONS_PAR_SWITCH; k++) {
+        mac_addr_t mac = creer_mac(0x02, 0x01, (k >> 24) & 0xFF, (k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF);
+        sommet s = reseau_ajouter_station(r, creer_station(mac, creer_ip(10, k >> 16, k >> 8, k)));
+        reseau_relier(r, k / STATIONS_PAR_SWITCH, s, 19);
+    }
+}
+
+static void mesurer(const reseau_t *r, const char *nom_fichier) {
+    double t0 = maintenant();
+    bool ok = exporter_reseau(nom_fichier, r);
+    double duree = maintenant() - t0;
+
+    long taille = -1;
+    FILE *f = fopen(nom_fichier, "r");
+    if (f != NULL) {
+        fseek(f, 0, SEEK_END);
+        taille = ftell(f);
+        fclose(f);
+    }
+    printf("%-28s %s en %.2f s, %.1f Mo, %.3g liens/s\n", nom_fichier, ok ? "écrit" : "ÉCHEC", duree, taille / 1e6,
+           nb_aretes(&r->g) / duree);
+    remove(nom_fichier);
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 250000;
+    const char *repertoire = (argc > 2) ? argv[2] : "/tmp";
+    if (nb_switchs < 2) {
+        fprintf(stderr, "Il faut au moins 2 switchs\n");
+        return 1;
+    }
+
+    reseau_t r;
+    generer_maillage(&r, nb_switchs);
+    calculer_stp(&r, NULL);
+    printf("Maillage : %zu switchs, %zu stations, %zu liens\n", nb_switchs, r.nb_stations, nb_aretes(&r.g));
+
+    char nom[512];
+    snprintf(nom, sizeof(nom), "%s/bench_export.dot", repertoire);
+    mesurer(&r, nom);
+    snprintf(nom, sizeof(nom), "%s/bench_export.graphml", repertoire);
+    mesurer(&r, nom);
+
+    deinit_reseau(&r);
+    return 0;
+}
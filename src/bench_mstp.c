@@ -0,0 +1,86 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "reseau.h"
+#include "mstp.h"
+
+// Banc d'essai du MSTP : maillage de switchs en grille, de 1 à 64 MSTI dont
+// les priorités sont tirées au hasard (racines et ports bloqués différents).
+// Pour chaque nombre d'instances : coût total de la convergence (tours, BPDU,
+// enregistrements, octets) et temps de calcul sur un thread puis sur tous.
+// Usage : ./bench_mstp [nb_switchs] [nb_instances_max]
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grille cote x cote comme bench_stp, sans stations
+static void generer_maillage(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        reseau_ajouter_switch(r, creer_switch(mac, 4, 4096 * (1 + rand() % 8)));
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        size_t x = i % cote;
+        if (x + 1 < cote && i + 1 < nb_switchs) reseau_relier(r, i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) reseau_relier(r, i, i + cote, poids[rand() % 3]);
+    }
+}
+
+static double mesurer(plan_mstp_t *plan, reseau_t *r, int nb_threads) {
+    double t0 = maintenant();
+    if (!calculer_mstp(plan, r, nb_threads)) return -1;
+    return (maintenant() - t0) * 1e3;
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000;
+    size_t nb_max = (argc > 2) ? strtoul(argv[2], NULL, 10) : NB_INSTANCES_MAX - 1;
+    if (nb_switchs < 2 || nb_max >= NB_INSTANCES_MAX) {
+        fprintf(stderr, "Il faut au moins 2 switchs et au plus %d MSTI\n", NB_INSTANCES_MAX - 1);
+        return 1;
+    }
+    int nb_threads = 1;
+#ifdef _OPENMP
+    nb_threads = omp_get_max_threads();
+#endif
+
+    reseau_t r;
+    generer_maillage(&r, nb_switchs);
+    printf("Maillage : %zu switchs, %zu liens, %d thread(s)\n", nb_switchs, nb_aretes(&r.g), nb_threads);
+    printf("%5s %6s %12s %16s %12s %10s %10s %8s\n", "MSTI", "tours", "BPDU", "enregistrements", "Mo", "1 thread",
+           "parallèle", "gain");
+
+    for (size_t nb_msti = 0; nb_msti <= nb_max; nb_msti = (nb_msti == 0) ? 1 : 2 * nb_msti) {
+        plan_mstp_t plan;
+        if (!init_plan_mstp(&plan, &r, nb_msti + 1)) {
+            fprintf(stderr, "Plan MSTP impossible\n");
+            break;
+        }
+        srand(7);
+        for (size_t k = 1; k <= nb_msti; k++) {
+            for (size_t i = 0; i < nb_switchs; i++) regler_priorite_instance(&plan, k, i, 4096 * (rand() % 16));
+        }
+        double sequentiel = mesurer(&plan, &r, 1);
+        double parallele = mesurer(&plan, &r, nb_threads);
+        printf("%5zu %6zu %12llu %16llu %12.2f %8.1f ms %7.1f ms %7.2fx\n", nb_msti, plan.nb_tours,
+               (unsigned long long)plan.nb_bpdu, (unsigned long long)plan.nb_enregistrements, plan.octets_bpdu / 1e6,
+               sequentiel, parallele, parallele > 0 ? sequentiel / parallele : 0.0);
+        deinit_plan_mstp(&plan);
+    }
+
+    deinit_reseau(&r);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "reseau.h"
+#include "stp.h"
+#include "simulation.h"
+
+// Banc d'essai de la surveillance multicast : diffusion vidéo sur un arbre à deux
+// niveaux (un switch de cœur, des switchs d'accès de 48 stations). Quelques
+// stations sources émettent chacune un flux vers son groupe, qu'une part des
+// stations a rejoint. Le même trafic est simulé avec inondation puis avec
+// surveillance des adhésions.
+// Usage : ./bench_multicast [nb_stations] [nb_groupes] [part_membres] [trames_par_flux]
+
+#define STATIONS_PAR_ACCES 48
+#define TAILLE_VIDEO 1316          // 7 paquets de transport MPEG de 188 octets
+#define PERIODE_VIDEO 100000ULL    // 10 000 trames/s par flux, environ 100 Mb/s
+
+typedef struct {
+    size_t nb_stations;
+    size_t nb_groupes;
+    double part_membres;
+    size_t trames_par_flux;
+} video_t;
+
+static sommet premiere_station(size_t nb_stations) {
+    return 1 + (nb_stations + STATIONS_PAR_ACCES - 1) / STATIONS_PAR_ACCES;
+}
+
+static void generer_arbre(reseau_t *r, size_t nb_stations) {
+    init_reseau(r);
+    size_t nb_acces = premiere_station(nb_stations) - 1;
+
+    reseau_ajouter_switch(r, creer_switch(creer_mac(0x02, 0x00, 0x00, 0x00, 0x00, 0x00), (int)nb_acces, 4096));
+    for (size_t a = 0; a < nb_acces; a++) {
+        reseau_ajouter_switch(r, creer_switch(creer_mac(0x02, 0x00, 0x00, 0x01, (uint8_t)(a >> 8), (uint8_t)a),
+                                              STATIONS_PAR_ACCES + 1, 32768));
+    }
+    for (size_t k = 0; k < nb_stations; k++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, 0x01, 0x00, (uint8_t)(k >> 8), (uint8_t)k);
+        reseau_ajouter_station(r, creer_station(mac, creer_ip(10, (uint8_t)(k >> 16), (uint8_t)(k >> 8), (uint8_t)k)));
+    }
+
+    // cœur à 10 Gb/s, accès à 1 Gb/s
+    for (size_t a = 0; a < nb_acces; a++) {
+        reseau_relier(r, 0, 1 + a, 2);
+    }
+    for (size_t k = 0; k < nb_stations; k++) {
+        reseau_relier(r, 1 + k / STATIONS_PAR_ACCES, premiere_station(nb_stations) + k, 4);
+    }
+}
+
+// 01:00:5E:00:xx:xx, groupes 239.0.x.x
+static mac_addr_t groupe_video(size_t k) {
+    return creer_mac(0x01, 0x00, 0x5E, 0x00, (uint8_t)(k >> 8), (uint8_t)k);
+}
+
+static void mesurer(reseau_t *r, const video_t *v, bool surveillance) {
+    simulation_t sim;
+    init_simulation(&sim, r);
+    configurer_files_sortie(&sim, 4096, REJET_QUEUE);
+    activer_surveillance_multicast(&sim, surveillance);
+    sommet s0 = premiere_station(v->nb_stations);
+
+    // la source du groupe k est la station k ; les membres sont tirés au hasard
+    srand(1);
+    for (size_t i = v->nb_groupes; i < v->nb_stations; i++) {
+        for (size_t k = 0; k < v->nb_groupes; k++) {
+            if (rand() < v->part_membres * RAND_MAX) rejoindre_groupe_multicast(&sim, s0 + i, groupe_video(k));
+        }
+    }
+    executer_simulation(&sim, 0);
+    for (size_t i = 0; i < r->nb_switchs; i++) reinitialiser_compteurs(&r->switchs[i]);
+    compteurs_simulation_t avant = sim.compteurs;
+    temps_sim_t debut = sim.horloge;
+
+    static uint8_t donnees[TAILLE_VIDEO];
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t n = 0; n < v->trames_par_flux; n++) {
+        executer_jusqua(&sim, debut + n * PERIODE_VIDEO);
+        for (size_t k = 0; k < v->nb_groupes; k++) {
+            trame t;
+            init_trame(&t, r->stations[k].mac, groupe_video(k), TYPE_IPV4, donnees, sizeof(donnees));
+            emettre_trame(&sim, s0 + k, &t);
+            deinit_trame(&t);
+        }
+    }
+    executer_simulation(&sim, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    // volume émis par les ports des switchs, phase d'adhésion comprise
+    uint64_t copies = 0, octets = 0;
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        if (sw == NULL) continue;
+        copies += sw->compteurs.nb_copies + sw->compteurs.nb_copies_multicast;
+        for (int p = 0; p < sw->nb_ports; p++) octets += file_sortie(&sim, s, p)->octets_emis;
+    }
+    printf("%-18s %10llu %10llu %10llu %12llu %9.1f Mo  %8.1f ms\n", surveillance ? "surveillance" : "inondation",
+           (unsigned long long)(sim.compteurs.nb_livrees - avant.nb_livrees),
+           (unsigned long long)(sim.compteurs.nb_filtrees - avant.nb_filtrees),
+           (unsigned long long)(sim.compteurs.nb_rejetees - avant.nb_rejetees), (unsigned long long)copies,
+           octets / 1e6,
+           ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e6);
+    deinit_simulation(&sim);
+    for (size_t i = 0; i < r->nb_switchs; i++) deinit_table_multicast(&r->switchs[i].multicast);
+}
+
+int main(int argc, char *argv[]) {
+    video_t v = {480, 8, 0.1, 200};
+    if (argc > 1) v.nb_stations = strtoul(argv[1], NULL, 10);
+    if (argc > 2) v.nb_groupes = strtoul(argv[2], NULL, 10);
+    if (argc > 3) v.part_membres = atof(argv[3]);
+    if (argc > 4) v.trames_par_flux = strtoul(argv[4], NULL, 10);
+    if (v.nb_groupes >= v.nb_stations) {
+        fprintf(stderr, "Il faut plus de stations que de groupes\n");
+        return 1;
+    }
+
+    reseau_t r;
+    generer_arbre(&r, v.nb_stations);
+    calculer_stp(&r, NULL);
+    printf("Vidéo : %zu stations, %zu flux de %zu trames, %.0f %% des stations par groupe\n", v.nb_stations,
+           v.nb_groupes, v.trames_par_flux, v.part_membres * 100);
+    printf("%-18s %10s %10s %10s %12s %12s  %11s\n", "", "livrées", "filtrées", "rejetées", "copies", "émis",
+           "temps réel");
+    mesurer(&r, &v, false);
+    mesurer(&r, &v, true);
+
+    deinit_reseau(&r);
+    return 0;
+}
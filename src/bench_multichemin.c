@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "reseau.h"
+#include "stp.h"
+#include "multichemin.h"
+#include "simulation.h"
+
+// Banc d'essai de l'acheminement multichemin : fabrique feuilles/épines (leaf-spine)
+// à liens 1 Gb/s, chaque station envoie une rafale vers la station de même rang
+// de la feuille suivante. Le même trafic est simulé sur l'arbre STP (un seul
+// lien montant actif par feuille) puis en multichemin (ECMP sur toutes les épines).
+// Usage : ./bench_multichemin [nb_epines] [nb_feuilles] [stations_par_feuille] [trames_par_station]
+
+typedef struct {
+    size_t nb_epines;
+    size_t nb_feuilles;
+    size_t stations_par_feuille;
+    size_t trames_par_station;
+} fabrique_t;
+
+static sommet premiere_station(const fabrique_t *f) {
+    return f->nb_epines + f->nb_feuilles;
+}
+
+static void generer_fabrique(reseau_t *r, const fabrique_t *f) {
+    init_reseau(r);
+    int ports_epine = (int)f->nb_feuilles;
+    int ports_feuille = (int)(f->nb_epines + f->stations_par_feuille);
+
+    for (size_t e = 0; e < f->nb_epines; e++) {
+        reseau_ajouter_switch(r, creer_switch(creer_mac(0x02, 0x00, 0x00, 0x00, 0x00, (uint8_t)e), ports_epine, 4096));
+    }
+    for (size_t l = 0; l < f->nb_feuilles; l++) {
+        reseau_ajouter_switch(r, creer_switch(creer_mac(0x02, 0x00, 0x00, 0x01, (uint8_t)(l >> 8), (uint8_t)l),
+                                              ports_feuille, 32768));
+    }
+    for (size_t l = 0; l < f->nb_feuilles; l++) {
+        for (size_t k = 0; k < f->stations_par_feuille; k++) {
+            mac_addr_t mac = creer_mac(0x02, 0x00, 0x01, (uint8_t)(l >> 8), (uint8_t)l, (uint8_t)k);
+            reseau_ajouter_station(r, creer_station(mac, creer_ip(10, (uint8_t)(l >> 8), (uint8_t)l, (uint8_t)k)));
+        }
+    }
+
+    for (size_t l = 0; l < f->nb_feuilles; l++) {
+        sommet feuille = f->nb_epines + l;
+        for (size_t e = 0; e < f->nb_epines; e++) {
+            reseau_relier(r, feuille, e, 4);
+        }
+        for (size_t k = 0; k < f->stations_par_feuille; k++) {
+            reseau_relier(r, feuille, premiere_station(f) + l * f->stations_par_feuille + k, 4);
+        }
+    }
+}
+
+// Chaque station s'annonce par une diffusion : les tables sont apprises
+// avant la mesure, le trafic mesuré n'est plus inondé
+static void prechauffer(reseau_t *r, const fabrique_t *f, const plan_spb_t *plan) {
+    simulation_t sim;
+    init_simulation(&sim, r);
+    activer_multichemin(&sim, plan);
+
+    trame t;
+    mac_addr_t diffusion = creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF);
+    for (size_t k = 0; k < r->nb_stations; k++) {
+        init_trame(&t, r->stations[k].mac, diffusion, TYPE_IPV4, NULL, 0);
+        emettre_trame(&sim, premiere_station(f) + k, &t);
+        deinit_trame(&t);
+        executer_simulation(&sim, 0);
+    }
+    deinit_simulation(&sim);
+}
+
+// Renvoie le débit livré (Mb/s)
+static double mesurer(reseau_t *r, const fabrique_t *f, const plan_spb_t *plan) {
+    prechauffer(r, f, plan);
+
+    simulation_t sim;
+    init_simulation(&sim, r);
+    configurer_files_sortie(&sim, 4096, REJET_QUEUE);
+    activer_multichemin(&sim, plan);
+
+    static uint8_t donnees[1500];
+    size_t n = r->nb_stations;
+    for (size_t i = 0; i < n; i++) {
+        // station de même rang sur la feuille suivante
+        size_t j = (i + f->stations_par_feuille) % n;
+        trame t;
+        init_trame(&t, r->stations[i].mac, r->stations[j].mac, TYPE_IPV4, donnees, sizeof(donnees));
+        for (size_t k = 0; k < f->trames_par_station; k++) {
+            emettre_trame(&sim, premiere_station(f) + i, &t);
+        }
+        deinit_trame(&t);
+    }
+    executer_simulation(&sim, 0);
+
+    printf("  %llu/%llu trames livrées en %.3f ms, %llu rejetée(s)\n  ",
+           (unsigned long long)sim.compteurs.nb_livrees, (unsigned long long)sim.compteurs.nb_emises,
+           sim.horloge / 1e6, (unsigned long long)sim.compteurs.nb_rejetees);
+    afficher_bilan_liens(&sim);
+    bilan_liens_t bilan;
+    double debit = bilan_liens(&sim, &bilan) ? bilan.debit_livre : 0.0;
+    deinit_simulation(&sim);
+    return debit;
+}
+
+int main(int argc, char *argv[]) {
+    fabrique_t f = {4, 8, 4, 200};
+    if (argc > 1) f.nb_epines = strtoul(argv[1], NULL, 10);
+    if (argc > 2) f.nb_feuilles = strtoul(argv[2], NULL, 10);
+    if (argc > 3) f.stations_par_feuille = strtoul(argv[3], NULL, 10);
+    if (argc > 4) f.trames_par_station = strtoul(argv[4], NULL, 10);
+
+    reseau_t r;
+    generer_fabrique(&r, &f);
+    printf("Fabrique : %zu épines, %zu feuilles, %zu stations, %zu liens entre switchs\n",
+           f.nb_epines, f.nb_feuilles, r.nb_stations, f.nb_epines * f.nb_feuilles);
+
+    resultat_stp_t res;
+    calculer_stp(&r, &res);
+    printf("\nArbre STP (%zu ports bloqués) :\n", res.nb_ports_bloques);
+    double debit_stp = mesurer(&r, &f, NULL);
+
+    plan_spb_t plan;
+    if (!calculer_plan_spb(&plan, &r)) {
+        fprintf(stderr, "Calcul du plan multichemin impossible\n");
+        deinit_reseau(&r);
+        return 1;
+    }
+    printf("\nMultichemin (%d prochains sauts de coût égal par feuille) :\n",
+           nb_chemins_egaux(&plan, &r, f.nb_epines, f.nb_epines + 1));
+    double debit_spb = mesurer(&r, &f, &plan);
+    if (debit_stp > 0) printf("\nGain de débit du multichemin : x%.2f\n", debit_spb / debit_stp);
+
+    deinit_plan_spb(&plan);
+    deinit_reseau(&r);
+    return 0;
+}
@@ -0,0 +1,145 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "configuration.h"
+#include "stp.h"
+#include "trafic.h"
+#include "profileur.h"
+
+// Banc d'essai du profileur : coût d'une paire entrer_phase / sortir_phase,
+// puis un scénario complet (lecture de la configuration, STP, trafic) dont on
+// affiche le bilan par phase et les piles repliées. Le surcoût estimé est le
+// nombre de phases mesurées multiplié par le coût d'une paire, rapporté au
+// temps total. Le trafic compte TRAMES_SCENARIO trames : une phase ouverte
+// par trame se verrait dans le nombre de phases par trame et dans le surcoût.
+// Les phases n'apparaissent qu'avec make DEFINES=-DPROFILER.
+// Usage : ./bench_profileur [nb_switchs] [fichier_piles]
+
+#define FICHIER_TOPOLOGIE "bench_profileur_topologie.txt"
+#define NB_PAIRES 10000000
+#define TRAMES_SCENARIO 20000
+#define DUREE_TRAFIC 1000000000ULL  // ns simulées
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grille cote x cote de switchs, une station par switch, au format de configuration
+static bool ecrire_topologie(const char *nom_fichier, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+    size_t nb_liens = nb_switchs;
+    for (size_t i = 0; i < nb_switchs; i++) {
+        if (i % cote + 1 < cote && i + 1 < nb_switchs) nb_liens++;
+        if (i + cote < nb_switchs) nb_liens++;
+    }
+
+    FILE *f = fopen(nom_fichier, "w");
+    if (f == NULL) return false;
+
+    srand(42);
+    fprintf(f, "%zu %zu\n", 2 * nb_switchs, nb_liens);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        fprintf(f, "2;02:00:%02zx:%02zx:%02zx:%02zx;%d;%d\n", (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF,
+                i & 0xFF, 8, 4096 * (1 + rand() % 8));
+    }
+    for (size_t k = 0; k < nb_switchs; k++) {
+        fprintf(f, "1;02:01:%02zx:%02zx:%02zx:%02zx;10.%zu.%zu.%zu\n", (k >> 24) & 0xFF, (k >> 16) & 0xFF,
+                (k >> 8) & 0xFF, k & 0xFF, (k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF);
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        if (i % cote + 1 < cote && i + 1 < nb_switchs) fprintf(f, "%zu;%zu;%d\n", i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) fprintf(f, "%zu;%zu;%d\n", i, i + cote, poids[rand() % 3]);
+    }
+    for (size_t k = 0; k < nb_switchs; k++) fprintf(f, "%zu;%zu;19\n", k, nb_switchs + k);
+    return fclose(f) == 0;
+}
+
+// Paires vides appelées directement : indépendant de -DPROFILER
+static double cout_paire_ns(void) {
+    static const char *noms[] = {"a", "b"};
+    double t0 = maintenant();
+    for (long k = 0; k < NB_PAIRES; k++) {
+        entrer_phase(noms[k & 1]);
+        sortir_phase();
+    }
+    double ns = (maintenant() - t0) * 1e9 / NB_PAIRES;
+    reinitialiser_profil();
+    return ns;
+}
+
+static bool jouer(size_t nb_switchs, uint64_t *nb_trames) {
+    if (!ecrire_topologie(FICHIER_TOPOLOGIE, nb_switchs)) return false;
+
+    reseau_t r;
+    init_reseau(&r);
+    bool ok = lire_reseau(FICHIER_TOPOLOGIE, &r);
+    remove(FICHIER_TOPOLOGIE);
+
+    resultat_stp_t res;
+    ok = ok && calculer_stp(&r, &res) && calculer_rstp(&r, &res);
+
+    simulation_t sim;
+    generateur_trafic_t g;
+    config_trafic_t c;
+    config_trafic_defaut(&c);
+    c.debit = TRAMES_SCENARIO * 1e9 / DUREE_TRAFIC;
+    c.graine = 7;
+    if (ok && init_simulation(&sim, &r)) {
+        if (init_generateur(&g, &sim, &c)) {
+            generer_trafic(&g, DUREE_TRAFIC);
+            executer_simulation(&sim, 0);
+            *nb_trames = g.nb_generees;
+            printf("Trafic : %llu trames générées, %llu livrées\n", (unsigned long long)g.nb_generees,
+                   (unsigned long long)sim.compteurs.nb_livrees);
+            deinit_generateur(&g);
+        } else {
+            ok = false;
+        }
+        deinit_simulation(&sim);
+    } else {
+        ok = false;
+    }
+    deinit_reseau(&r);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 2000;
+    const char *fichier_piles = (argc > 2) ? argv[2] : "bench_profileur.folded";
+    if (nb_switchs < 2) {
+        fprintf(stderr, "Il faut au moins 2 switchs\n");
+        return 1;
+    }
+
+    double cout = cout_paire_ns();
+    printf("Paire entrer/sortir : %.1f ns (%d paires)\n", cout, NB_PAIRES);
+    if (!profileur_compile()) printf("Instrumentation absente : recompiler avec make DEFINES=-DPROFILER\n");
+
+    double t0 = maintenant();
+    uint64_t nb_trames = 0;
+    if (!jouer(nb_switchs, &nb_trames)) {
+        fprintf(stderr, "Scénario impossible\n");
+        return 1;
+    }
+    double total_ms = (maintenant() - t0) * 1e3;
+    uint64_t nb_phases = nb_phases_mesurees();
+    printf("Scénario : %zu switchs, %.1f ms, %llu phase(s) mesurée(s) (%.4f par trame), surcoût estimé %.4f %%\n",
+           nb_switchs, total_ms, (unsigned long long)nb_phases, nb_trames > 0 ? (double)nb_phases / nb_trames : 0.0,
+           100.0 * nb_phases * cout / (total_ms * 1e6));
+
+    afficher_bilan_profil(stdout);
+    FILE *f = fopen(fichier_piles, "w");
+    if (f == NULL || !ecrire_piles_profil(f)) {
+        fprintf(stderr, "Écriture des piles dans %s impossible\n", fichier_piles);
+        if (f != NULL) fclose(f);
+        return 1;
+    }
+    fclose(f);
+    printf("Piles repliées dans %s (flamegraph.pl %s > profil.svg)\n", fichier_piles, fichier_piles);
+    return 0;
+}
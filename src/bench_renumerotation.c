@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "reseau.h"
+#include "renumerotation.h"
+#include "stp.h"
+
+// Banc d'essai de la renumérotation : maillage de switchs avec une station par
+// switch, déclarés dans un ordre mélangé comme dans un fichier de configuration
+// écrit à la main. Parcours en largeur et calcul STP sont chronométrés dans
+// l'ordre du fichier puis après renumérotation BFS et RCM depuis le pont racine.
+// Usage : ./bench_renumerotation [nb_switchs]
+
+#define NB_PORTS 8
+#define NB_PARCOURS 5
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void melanger(size_t *t, size_t n) {
+    for (size_t i = n; i > 1; i--) {
+        size_t j = (size_t)rand() % i;
+        size_t x = t[i - 1];
+        t[i - 1] = t[j];
+        t[j] = x;
+    }
+}
+
+// Grille cote x cote (droite, bas, une diagonale sur quatre) : le switch de la
+// case c est déclaré en position rang[c], les stations suivent dans un autre ordre
+static void generer_reseau(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    size_t *cases = malloc(nb_switchs * sizeof(size_t));
+    size_t *rang = malloc(nb_switchs * sizeof(size_t));
+    for (size_t i = 0; i < nb_switchs; i++) cases[i] = i;
+    melanger(cases, nb_switchs);
+    for (size_t k = 0; k < nb_switchs; k++) {
+        size_t c = cases[k];
+        mac_addr_t mac = creer_mac(0x02, 0x00, (c >> 24) & 0xFF, (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+        rang[c] = reseau_ajouter_switch(r, creer_switch(mac, NB_PORTS, 4096 * (1 + rand() % 8)));
+    }
+
+    for (size_t c = 0; c < nb_switchs; c++) {
+        size_t x = c % cote;
+        if (x + 1 < cote && c + 1 < nb_switchs) reseau_relier(r, rang[c], rang[c + 1], poids[rand() % 3]);
+        if (c + cote < nb_switchs) reseau_relier(r, rang[c], rang[c + cote], poids[rand() % 3]);
+        if (rand() % 4 == 0 && x + 1 < cote && c + cote + 1 < nb_switchs) {
+            reseau_relier(r, rang[c], rang[c + cote + 1], poids[rand() % 3]);
+        }
+    }
+
+    melanger(cases, nb_switchs);
+    for (size_t k = 0; k < nb_switchs; k++) {
+        size_t c = cases[k];
+        mac_addr_t mac = creer_mac(0x04, 0x00, (c >> 24) & 0xFF, (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+        ip_addr_t ip = creer_ip(10, (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+        sommet st = reseau_ajouter_station(r, creer_station(mac, ip));
+        reseau_relier(r, st, rang[c], 4);
+    }
+    free(cases);
+    free(rang);
+}
+
+// Parcours en largeur par les ports des équipements, comme le font la
+// diffusion des BPDU ou l'inondation d'une trame
+static size_t parcourir(const reseau_t *r, sommet *file, bool *visite) {
+    size_t n = ordre(&r->g);
+    for (size_t s = 0; s < n; s++) visite[s] = false;
+
+    size_t nb = 0, somme = 0;
+    visite[0] = true;
+    file[nb++] = 0;
+    for (size_t tete = 0; tete < nb; tete++) {
+        sommet s = file[tete];
+        const switch_t *sw = reseau_switch(r, s);
+        if (sw == NULL) {
+            size_t i = r->equipements[s].index;
+            somme += r->stations[i].mac.octet[5];
+            sommet v = r->raccordements[i].voisin;
+            if (v != UNKNOWN_INDEX && !visite[v]) {
+                visite[v] = true;
+                file[nb++] = v;
+            }
+            continue;
+        }
+        somme += sw->mac.octet[5];
+        for (int p = 0; p < sw->nb_ports; p++) {
+            sommet v = sw->ports[p].voisin;
+            if (v == UNKNOWN_INDEX || visite[v]) continue;
+            visite[v] = true;
+            file[nb++] = v;
+        }
+    }
+    return nb + (somme & 1);
+}
+
+// Sommet du futur pont racine : priorité puis adresse MAC les plus petites
+static sommet pont_racine(const reseau_t *r) {
+    sommet racine = 0;
+    const switch_t *meilleur = NULL;
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        if (sw == NULL) continue;
+        if (meilleur == NULL || sw->priorite < meilleur->priorite ||
+            (sw->priorite == meilleur->priorite && memcmp(sw->mac.octet, meilleur->mac.octet, 6) < 0)) {
+            meilleur = sw;
+            racine = s;
+        }
+    }
+    return racine;
+}
+
+// Rôles des ports rangés par indice d'origine, pour comparer les numérotations
+static etat_port_t *copier_roles(const reseau_t *r) {
+    size_t n = ordre(&r->g);
+    etat_port_t *roles = malloc(n * NB_PORTS * sizeof(etat_port_t));
+    for (sommet s = 0; s < n; s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        for (int p = 0; p < NB_PORTS; p++) {
+            roles[sommet_origine(r, s) * NB_PORTS + p] = (sw != NULL) ? get_etat_port(sw, p) : PORT_INCONNU;
+        }
+    }
+    return roles;
+}
+
+static size_t comparer_roles(const etat_port_t *a, const etat_port_t *b, size_t n) {
+    size_t differences = 0;
+    for (size_t i = 0; i < n * NB_PORTS; i++) {
+        if (a[i] != b[i]) differences++;
+    }
+    return differences;
+}
+
+// Renvoie les rôles STP obtenus, rangés par indice d'origine
+static etat_port_t *mesurer(const char *nom, size_t nb_switchs, int methode, const etat_port_t *reference) {
+    reseau_t r;
+    generer_reseau(&r, nb_switchs);
+    size_t n = ordre(&r.g);
+
+    double t_renumerotation = 0;
+    if (methode >= 0) {
+        double debut = maintenant();
+        if (!renumeroter_reseau(&r, pont_racine(&r), (methode_renumerotation_t)methode)) {
+            deinit_reseau(&r);
+            return NULL;
+        }
+        t_renumerotation = maintenant() - debut;
+    }
+
+    sommet *file = malloc(n * sizeof(sommet));
+    bool *visite = malloc(n * sizeof(bool));
+    size_t atteints = parcourir(&r, file, visite);
+    double debut = maintenant();
+    for (int k = 0; k < NB_PARCOURS; k++) atteints = parcourir(&r, file, visite);
+    double t_parcours = (maintenant() - debut) / NB_PARCOURS;
+    free(file);
+    free(visite);
+
+    resultat_stp_t res;
+    debut = maintenant();
+    calculer_stp(&r, &res);
+    double t_stp = maintenant() - debut;
+
+    etat_port_t *roles = copier_roles(&r);
+    printf("%-8s | %10zu | %9.3f ms | %9.3f ms (%zu) | %9.3f ms (%zu tours) | %zu\n", nom, largeur_bande(&r),
+           t_renumerotation * 1e3, t_parcours * 1e3, atteints, t_stp * 1e3, res.nb_tours,
+           reference != NULL ? comparer_roles(roles, reference, n) : 0);
+    deinit_reseau(&r);
+    return roles;
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 50000;
+    if (nb_switchs == 0) nb_switchs = 1;
+
+    printf("Maillage mélangé : %zu switchs, %zu stations\n", nb_switchs, nb_switchs);
+    printf("ordre    | largeur    | renumérotation | parcours (atteints)     | calcul STP               | rôles différents\n");
+    etat_port_t *reference = mesurer("fichier", nb_switchs, -1, NULL);
+    if (reference == NULL) return 1;
+
+    etat_port_t *roles = mesurer("BFS", nb_switchs, RENUMEROTATION_BFS, reference);
+    free(roles);
+    roles = mesurer("RCM", nb_switchs, RENUMEROTATION_RCM, reference);
+    free(roles);
+    free(reference);
+    return 0;
+}
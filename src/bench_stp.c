@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "reseau.h"
+#include "stp.h"
+#include "coeur.h"
+
+// Banc d'essai du calcul STP : maillage de switchs en grille, résolu par
+// le moteur séquentiel puis par le moteur parallèle sur 1 à 32 threads,
+// puis sur un campus de switchs d'accès chargés de stations, puis comparaison
+// RSTP / STP classique sur des maillages de tailles croissantes.
+// Usage : ./bench_stp [nb_switchs]
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grille cote x cote, chaque switch relié à sa droite et à son bas,
+// plus une diagonale une fois sur quatre
+static void generer_maillage(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        reseau_ajouter_switch(r, creer_switch(mac, 8, 4096 * (1 + rand() % 8)));
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        size_t x = i % cote;
+        if (x + 1 < cote && i + 1 < nb_switchs) reseau_relier(r, i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) reseau_relier(r, i, i + cote, poids[rand() % 3]);
+        if (rand() % 4 == 0 && x + 1 < cote && i + cote + 1 < nb_switchs) {
+            reseau_relier(r, i, i + cote + 1, poids[rand() % 3]);
+        }
+    }
+}
+
+// Campus : le même maillage de switchs d'agrégation, chacun portant
+// STATIONS_ACCES stations sur ses ports d'accès
+#define STATIONS_ACCES 20
+
+static void generer_campus(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        reseau_ajouter_switch(r, creer_switch(mac, STATIONS_ACCES + 8, 4096 * (1 + rand() % 8)));
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        size_t x = i % cote;
+        if (x + 1 < cote && i + 1 < nb_switchs) reseau_relier(r, i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) reseau_relier(r, i, i + cote, poids[rand() % 3]);
+        if (rand() % 4 == 0 && x + 1 < cote && i + cote + 1 < nb_switchs) {
+            reseau_relier(r, i, i + cote + 1, poids[rand() % 3]);
+        }
+    }
+    for (size_t k = 0; k < nb_switchs * STATIONS_ACCES; k++) {
+        mac_addr_t mac = creer_mac(0x02, 0x01, (k >> 24) & 0xFF, (k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF);
+        sommet s = reseau_ajouter_station(r, creer_station(mac, creer_ip(10, k >> 16, k >> 8, k)));
+        reseau_relier(r, k / STATIONS_ACCES, s, 19);
+    }
+}
+
+static etat_port_t *copier_roles(const reseau_t *r) {
+    etat_port_t *roles = malloc(r->nb_switchs * 8 * sizeof(etat_port_t));
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        for (int p = 0; p < 8; p++) roles[i * 8 + p] = get_etat_port(&r->switchs[i], p);
+    }
+    return roles;
+}
+
+static size_t comparer_roles(const reseau_t *r, const etat_port_t *reference) {
+    size_t differences = 0;
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        for (int p = 0; p < 8; p++) {
+            if (get_etat_port(&r->switchs[i], p) != reference[i * 8 + p]) differences++;
+        }
+    }
+    return differences;
+}
+
+// Rôles RSTP comparés aux rôles classiques : un port bloqué doit être alternatif ou de secours
+static size_t comparer_roles_rstp(const reseau_t *r, const etat_port_t *reference) {
+    size_t differences = 0;
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        for (int p = 0; p < 8; p++) {
+            etat_port_t role = get_etat_port(&r->switchs[i], p);
+            if (role == PORT_ALTERNATIF || role == PORT_SECOURS) role = PORT_BLOQUE;
+            if (role != reference[i * 8 + p]) differences++;
+        }
+    }
+    return differences;
+}
+
+static void comparer_rstp(size_t nb_switchs) {
+    reseau_t r;
+    generer_maillage(&r, nb_switchs);
+
+    // le moteur bulk-synchrone compte les tours comme des sauts de BPDU réels,
+    // comme la simulation RSTP (le moteur séquentiel en compte moins)
+    resultat_stp_t classique, rapide;
+    calculer_stp_parallele(&r, 1, &classique);
+    etat_port_t *reference = copier_roles(&r);
+
+    double debut = maintenant();
+    calculer_rstp(&r, &rapide);
+    double t = maintenant() - debut;
+
+    printf("%7zu | %5zu tours %10.3f s %12llu BPDU | %5zu sauts %8.3f s %12llu BPDU | %8.3f ms | %zu\n",
+           nb_switchs, classique.nb_tours, classique.temps_convergence_ms / 1e3,
+           (unsigned long long)classique.nb_bpdu, rapide.nb_tours, rapide.temps_convergence_ms / 1e3,
+           (unsigned long long)rapide.nb_bpdu, t * 1e3, comparer_roles_rstp(&r, reference));
+
+    free(reference);
+    deinit_reseau(&r);
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 100000;
+    static const int threads[] = {1, 2, 4, 8, 16, 32};
+
+    reseau_t r;
+    generer_maillage(&r, nb_switchs);
+    printf("Maillage : %zu switchs, %zu liens, %zu boucles\n", r.nb_switchs, nb_aretes(&r.g), nb_cycles(&r.g));
+
+    resultat_stp_t res;
+    double debut = maintenant();
+    calculer_stp(&r, &res);
+    double t_sequentiel = maintenant() - debut;
+    etat_port_t *reference = copier_roles(&r);
+    printf("Séquentiel : %8.3f ms | %zu tours | %llu BPDU | %zu ports bloqués\n",
+           t_sequentiel * 1e3, res.nb_tours, (unsigned long long)res.nb_bpdu, res.nb_ports_bloques);
+
+    for (size_t k = 0; k < sizeof(threads) / sizeof(threads[0]); k++) {
+        debut = maintenant();
+        calculer_stp_parallele(&r, threads[k], &res);
+        double t = maintenant() - debut;
+        printf("%2d thread(s) : %8.3f ms | x%5.2f | %zu tours | %zu ports bloqués | %zu rôle(s) différent(s)\n",
+               threads[k], t * 1e3, t_sequentiel / t, res.nb_tours, res.nb_ports_bloques,
+               comparer_roles(&r, reference));
+    }
+
+    free(reference);
+    deinit_reseau(&r);
+
+    // le STP ne parcourt que le cœur : les stations n'y coûtent rien
+    size_t nb_campus = nb_switchs / 10 > 0 ? nb_switchs / 10 : 1;
+    generer_campus(&r, nb_campus);
+    debut = maintenant();
+    calculer_stp(&r, &res);
+    t_sequentiel = maintenant() - debut;
+    coeur_reseau_t c;
+    construire_coeur(&c, &r);
+    printf("\nCampus : %zu switchs, %zu stations | graphe complet : %zu sommets, %zu liens | "
+           "cœur : %zu sommets, %zu liens\n", r.nb_switchs, r.nb_stations, ordre(&r.g), nb_aretes(&r.g),
+           c.nb_switchs, nb_liens_coeur(&c) / 2);
+    printf("Séquentiel : %8.3f ms | %zu tours | %llu BPDU\n", t_sequentiel * 1e3, res.nb_tours,
+           (unsigned long long)res.nb_bpdu);
+    deinit_coeur(&c);
+    deinit_reseau(&r);
+
+    // convergence simulée : forward delay pour STP, poignée de main pour RSTP
+    printf("\nRSTP contre STP classique (%d ms par saut de BPDU, forward delay %d ms) :\n",
+           DELAI_SAUT_BPDU_MS, FORWARD_DELAY_MS);
+    printf("switchs |            STP classique                 |                RSTP                    | calcul RSTP | rôles différents\n");
+    static const size_t tailles[] = {100, 1000, 10000};
+    for (size_t k = 0; k < sizeof(tailles) / sizeof(tailles[0]) && tailles[k] < nb_switchs; k++) {
+        comparer_rstp(tailles[k]);
+    }
+    comparer_rstp(nb_switchs);
+    return 0;
+}
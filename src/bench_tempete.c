@@ -0,0 +1,93 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "reseau.h"
+#include "stp.h"
+#include "tempete.h"
+
+// Banc d'essai de la tempête de diffusion : maillage de switchs en grille
+// portant chacun deux stations, quelques diffusions injectées sans STP puis
+// avec. Les copies sont comptées par sens de lien et par trame, le coût d'un
+// pas ne dépend que du nombre de liens : des centaines de millions de copies
+// se jouent en quelques secondes.
+// Usage : ./bench_tempete [nb_switchs] [nb_diffusions] [nb_sauts_max]
+
+#define STATIONS_PAR_SWITCH 2
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grille cote x cote comme bench_chemins ; les stations suivent les switchs
+static void generer_maillage(reseau_t *r, size_t nb_switchs) {
+    static const int poids[] = {4, 19, 100};
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    init_reseau(r);
+    srand(42);
+    for (size_t i = 0; i < nb_switchs; i++) {
+        mac_addr_t mac = creer_mac(0x02, 0x00, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+        reseau_ajouter_switch(r, creer_switch(mac, 8, 4096 * (1 + rand() % 8)));
+    }
+    for (size_t i = 0; i < nb_switchs; i++) {
+        size_t x = i % cote;
+        if (x + 1 < cote && i + 1 < nb_switchs) reseau_relier(r, i, i + 1, poids[rand() % 3]);
+        if (i + cote < nb_switchs) reseau_relier(r, i, i + cote, poids[rand() % 3]);
+    }
+    for (size_t k = 0; k < nb_switchs * STATIONS_PAR_SWITCH; k++) {
+        mac_addr_t mac = creer_mac(0x02, 0x01, (k >> 24) & 0xFF, (k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF);
+        sommet s = reseau_ajouter_station(r, creer_station(mac, creer_ip(10, k >> 16, k >> 8, k)));
+        reseau_relier(r, k / STATIONS_PAR_SWITCH, s, 19);
+    }
+}
+
+// Diffusions réparties sur les stations, une tous les dix pas
+static void jouer(const reseau_t *r, const config_tempete_t *config, size_t nb_diffusions, size_t nb_switchs) {
+    tempete_t t;
+    if (!init_tempete(&t, r, config)) {
+        fprintf(stderr, "Initialisation de la tempête impossible\n");
+        return;
+    }
+    for (size_t k = 0; k < nb_diffusions; k++) {
+        size_t station = (k * 7919) % r->nb_stations;
+        injecter_diffusion(&t, nb_switchs + station, 10 * k);
+    }
+
+    double t0 = maintenant();
+    executer_tempete(&t);
+    double duree = maintenant() - t0;
+
+    afficher_bilan_tempete(&t, 5);
+    printf("  %.3f s, %.3g copies/s\n\n", duree, duree > 0 ? t.nb_copies / duree : 0.0);
+    deinit_tempete(&t);
+}
+
+int main(int argc, char *argv[]) {
+    size_t nb_switchs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000;
+    size_t nb_diffusions = (argc > 2) ? strtoul(argv[2], NULL, 10) : 8;
+    size_t nb_sauts_max = (argc > 3) ? strtoul(argv[3], NULL, 10) : 2000;
+    if (nb_switchs < 2 || nb_diffusions == 0) {
+        fprintf(stderr, "Il faut au moins 2 switchs et une diffusion\n");
+        return 1;
+    }
+
+    reseau_t r;
+    generer_maillage(&r, nb_switchs);
+    printf("Maillage : %zu switchs, %zu stations, %zu liens\n\n", nb_switchs, r.nb_stations, nb_aretes(&r.g));
+
+    config_tempete_t config;
+    config_tempete_defaut(&config);
+    config.nb_sauts_max = nb_sauts_max;
+    jouer(&r, &config, nb_diffusions, nb_switchs);
+
+    calculer_stp(&r, NULL);
+    config.respecter_stp = true;
+    jouer(&r, &config, nb_diffusions, nb_switchs);
+
+    deinit_reseau(&r);
+    return 0;
+}
@@ -0,0 +1,503 @@
+#include "checkpoint.h"
+#include "journal.h"
+#include "memoire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// En-tête : les tailles des structures sauvegardées telles quelles
+// permettent de refuser un fichier produit par une autre compilation
+typedef struct {
+    char magique[8];
+    uint32_t version;
+    uint32_t taille_reseau;
+    uint32_t taille_switch;
+    uint32_t taille_entree;
+    uint32_t taille_trame;
+    uint32_t taille_evenement;
+    uint32_t taille_file;
+    uint32_t taille_simulation;
+    uint32_t taille_temporisation;
+} entete_checkpoint_t;
+
+static void remplir_entete(entete_checkpoint_t *e) {
+    memset(e, 0, sizeof(*e));
+    memcpy(e->magique, MAGIQUE_CHECKPOINT, sizeof(e->magique));
+    e->version = VERSION_CHECKPOINT;
+    e->taille_reseau = sizeof(reseau_t);
+    e->taille_switch = sizeof(switch_t);
+    e->taille_entree = sizeof(table_entree_t);
+    e->taille_trame = sizeof(trame);
+    e->taille_evenement = sizeof(evenement_t);
+    e->taille_file = sizeof(file_sortie_t);
+    e->taille_simulation = sizeof(simulation_t);
+    e->taille_temporisation = sizeof(temporisation_t);
+}
+
+static bool ecrire(FILE *f, const void *donnees, size_t taille) {
+    return taille == 0 || fwrite(donnees, 1, taille, f) == taille;
+}
+
+static bool lire(FILE *f, void *donnees, size_t taille) {
+    return taille == 0 || fread(donnees, 1, taille, f) == taille;
+}
+
+// Alloue un tableau de capacite éléments et y lit d'un bloc les nb premiers.
+// Renvoie NULL (et laisse *ok à false) dès qu'une lecture précédente a échoué.
+static void *lire_tableau(FILE *f, size_t capacite, size_t nb, size_t taille_element, bool *ok) {
+    if (!*ok || capacite == 0) return NULL;
+
+    void *tableau = malloc(capacite * taille_element);
+    if (tableau == NULL || nb > capacite || !lire(f, tableau, nb * taille_element)) {
+        free(tableau);
+        *ok = false;
+        return NULL;
+    }
+    return tableau;
+}
+
+// Variante pour les tableaux suivis par la comptabilité mémoire, pour que
+// leur libération ultérieure soit décomptée du même sous-système
+static void *lire_tableau_suivi(FILE *f, sous_systeme_t ss, size_t capacite, size_t nb, size_t taille_element,
+                                bool *ok) {
+    if (!*ok || capacite == 0) return NULL;
+
+    void *tableau = allouer_memoire(ss, capacite * taille_element);
+    if (tableau == NULL || nb > capacite || !lire(f, tableau, nb * taille_element)) {
+        liberer_memoire(ss, tableau, capacite * taille_element);
+        *ok = false;
+        return NULL;
+    }
+    return tableau;
+}
+
+// --- Charges utiles : chaque charge partagée n'est écrite qu'une fois ---
+
+static int comparer_charges(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(charge_utile_t * const *)a;
+    uintptr_t y = (uintptr_t)*(charge_utile_t * const *)b;
+    return (x > y) - (x < y);
+}
+
+static void ajouter_charge(charge_utile_t **charges, size_t *nb, const trame *t) {
+    if (t->charge != NULL) charges[(*nb)++] = t->charge;
+}
+
+// Liste triée et sans doublon des charges référencées par les trames en attente
+static charge_utile_t **recenser_charges(const simulation_t *sim, size_t *nb_charges) {
+    size_t nb_trames = sim->nb_evenements + sim->nb_attentes_arp;
+    for (size_t i = 0; i < sim->nb_files; i++) {
+        nb_trames += sim->files[i].nb;
+    }
+
+    *nb_charges = 0;
+    charge_utile_t **charges = malloc((nb_trames + 1) * sizeof(charge_utile_t *));
+    if (charges == NULL) return NULL;
+
+    for (size_t k = 0; k < sim->nb_evenements; k++) {
+        if (sim->evenements[k].type == EVT_RECEPTION) ajouter_charge(charges, nb_charges, &sim->evenements[k].t);
+    }
+    for (size_t i = 0; i < sim->nb_files; i++) {
+        const file_sortie_t *fs = &sim->files[i];
+        for (int k = 0; k < fs->nb; k++) {
+            ajouter_charge(charges, nb_charges, &fs->trames[(fs->tete + k) % sim->capacite_file]);
+        }
+    }
+    for (size_t k = 0; k < sim->nb_attentes_arp; k++) ajouter_charge(charges, nb_charges, &sim->attentes_arp[k].t);
+
+    qsort(charges, *nb_charges, sizeof(charge_utile_t *), comparer_charges);
+    size_t nb_uniques = 0;
+    for (size_t k = 0; k < *nb_charges; k++) {
+        if (nb_uniques == 0 || charges[nb_uniques - 1] != charges[k]) charges[nb_uniques++] = charges[k];
+    }
+    *nb_charges = nb_uniques;
+    return charges;
+}
+
+// Trame écrite sans ses pointeurs, suivie du numéro de sa charge (0 si aucune)
+static bool ecrire_trame(FILE *f, const trame *t, charge_utile_t **charges, size_t nb_charges) {
+    trame copie = *t;
+    uint64_t numero = 0;
+    if (t->charge != NULL) {
+        charge_utile_t **trouvee = bsearch(&t->charge, charges, nb_charges, sizeof(charge_utile_t *), comparer_charges);
+        numero = (uint64_t)(trouvee - charges) + 1;
+    }
+    copie.charge = NULL;
+    copie.donnees = NULL;
+    return ecrire(f, &copie, sizeof(trame)) && ecrire(f, &numero, sizeof(numero));
+}
+
+static bool lire_trame(FILE *f, trame *t, charge_utile_t **charges, size_t nb_charges) {
+    uint64_t numero;
+    if (!lire(f, t, sizeof(trame)) || !lire(f, &numero, sizeof(numero)) || numero > nb_charges) {
+        t->charge = NULL;
+        return false;
+    }
+    t->charge = (numero == 0) ? NULL : retenir_charge_utile(charges[numero - 1]);
+    t->donnees = (t->charge == NULL) ? NULL : t->charge->octets;
+    return true;
+}
+
+// --- Sauvegarde ---
+
+static bool ecrire_reseau_checkpoint(FILE *f, const reseau_t *r) {
+    const graphe *g = &r->g;
+    bool ok = ecrire(f, r, sizeof(reseau_t))
+              && ecrire(f, g->aretes, g->nb_aretes * sizeof(arete))
+              && ecrire(f, g->index_aretes, g->index_capacite * sizeof(size_t))
+              && ecrire(f, g->uf_parent, g->ordre * sizeof(sommet))
+              && ecrire(f, g->uf_rang, g->ordre * sizeof(unsigned char))
+              && ecrire(f, r->equipements, g->ordre * sizeof(equipement_t))
+              && ecrire(f, r->switchs, r->nb_switchs * sizeof(switch_t));
+
+    for (size_t i = 0; ok && i < r->nb_switchs; i++) {
+        const switch_t *sw = &r->switchs[i];
+        const table_commutation_t *t = &sw->table;
+        ok = ecrire(f, sw->ports, sw->nb_ports * sizeof(port_info_t))
+             && (sw->vlans == NULL || ecrire(f, sw->vlans, (size_t)sw->nb_ports * MOTS_VLAN * sizeof(uint64_t)))
+             && ecrire(f, t->entrees, t->taille * sizeof(table_entree_t))
+             && ecrire(f, t->index, t->index_capacite * sizeof(int))
+             && ecrire(f, t->tetes_ports, t->nb_ports_suivis * sizeof(int))
+             && ecrire(f, sw->multicast.groupes, sw->multicast.nb * sizeof(groupe_multicast_t));
+        for (int k = 0; ok && k < sw->multicast.nb; k++) {
+            const groupe_multicast_t *gr = &sw->multicast.groupes[k];
+            ok = ecrire(f, gr->ports, sw->multicast.mots_ports * sizeof(uint64_t))
+                 && ecrire(f, gr->membres, gr->nb_membres * sizeof(membre_groupe_t));
+        }
+    }
+
+    ok = ok && ecrire(f, r->stations, r->nb_stations * sizeof(station_t))
+            && ecrire(f, r->raccordements, r->nb_stations * sizeof(raccordement_t));
+    // correspondance des indices, présente seulement après une renumérotation
+    if (ok && r->origine != NULL) {
+        ok = ecrire(f, r->origine, g->ordre * sizeof(sommet))
+             && ecrire(f, r->renumerote, g->ordre * sizeof(sommet));
+    }
+    return ok;
+}
+
+static bool ecrire_simulation_checkpoint(FILE *f, const simulation_t *sim,
+                                         charge_utile_t **charges, size_t nb_charges) {
+    bool ok = ecrire(f, sim, sizeof(simulation_t))
+              && ecrire(f, sim->premiere_file, (ordre(&sim->reseau->g) + 1) * sizeof(size_t))
+              && ecrire(f, sim->paires, sim->nb_paires * sizeof(paire_suivie_t))
+              && ecrire(f, sim->adhesions, sim->nb_adhesions * sizeof(adhesion_t))
+              && ecrire(f, sim->roue.temporisations, sim->roue.capacite * sizeof(temporisation_t));
+    if (sim->tempo_ports != NULL) {
+        ok = ok && ecrire(f, sim->tempo_ports, sim->nb_files * sizeof(temporisations_port_t));
+    }
+    if (sim->caches_arp != NULL) {
+        ok = ok && ecrire(f, sim->caches_arp, sim->reseau->nb_stations * sizeof(cache_arp_t));
+        for (size_t i = 0; ok && i < sim->reseau->nb_stations; i++) {
+            const cache_arp_t *c = &sim->caches_arp[i];
+            ok = ecrire(f, c->entrees, c->capacite * sizeof(entree_arp_t));
+        }
+    }
+
+    uint64_t nb = nb_charges;
+    ok = ok && ecrire(f, &nb, sizeof(nb));
+    for (size_t k = 0; ok && k < nb_charges; k++) {
+        uint64_t taille = charges[k]->taille;
+        ok = ecrire(f, &taille, sizeof(taille)) && ecrire(f, charges[k]->octets, charges[k]->taille);
+    }
+
+    ok = ok && ecrire(f, sim->files, sim->nb_files * sizeof(file_sortie_t));
+    for (size_t i = 0; ok && i < sim->nb_files; i++) {
+        const file_sortie_t *fs = &sim->files[i];
+        for (int k = 0; ok && k < fs->nb; k++) {
+            ok = ecrire_trame(f, &fs->trames[(fs->tete + k) % sim->capacite_file], charges, nb_charges);
+        }
+    }
+
+    // l'échéancier est écrit dans l'ordre du tas : il reste valide à la relecture
+    for (size_t k = 0; ok && k < sim->nb_evenements; k++) {
+        evenement_t e = sim->evenements[k];
+        memset(&e.t, 0, sizeof(trame));
+        ok = ecrire(f, &e, sizeof(evenement_t));
+        if (ok && e.type == EVT_RECEPTION) ok = ecrire_trame(f, &sim->evenements[k].t, charges, nb_charges);
+    }
+
+    // paquets en attente de résolution, avec leur temporisation TEMPO_ARP déjà dans la roue
+    for (size_t k = 0; ok && k < sim->nb_attentes_arp; k++) {
+        attente_arp_t a = sim->attentes_arp[k];
+        memset(&a.t, 0, sizeof(trame));
+        ok = ecrire(f, &a, sizeof(attente_arp_t)) && ecrire_trame(f, &sim->attentes_arp[k].t, charges, nb_charges);
+    }
+    return ok;
+}
+
+bool sauvegarder_checkpoint(const char *nom_fichier, const simulation_t *sim) {
+    if (nom_fichier == NULL || sim == NULL || sim->reseau == NULL) return false;
+
+    FILE *f = fopen(nom_fichier, "wb");
+    if (f == NULL) {
+        perror("Erreur de création du point de reprise");
+        return false;
+    }
+
+    size_t nb_charges;
+    charge_utile_t **charges = recenser_charges(sim, &nb_charges);
+    entete_checkpoint_t entete;
+    remplir_entete(&entete);
+
+    bool ok = charges != NULL
+              && ecrire(f, &entete, sizeof(entete))
+              && ecrire_reseau_checkpoint(f, sim->reseau)
+              && ecrire_simulation_checkpoint(f, sim, charges, nb_charges);
+    free(charges);
+    if (fclose(f) != 0) ok = false;
+
+    if (!ok) JOURNALISER_TEXTE(JOURNAL_ERREUR, "Erreur d'écriture du point de reprise %s", nom_fichier, 0, 0, 0);
+    return ok;
+}
+
+// --- Restauration ---
+
+// Les tableaux sont relus d'un bloc et alloués à leur capacité d'origine ;
+// en cas d'échec, les pointeurs non relus valent NULL et deinit_reseau suffit
+static bool lire_reseau_checkpoint(FILE *f, reseau_t *r) {
+    reseau_t lu;
+    init_reseau(r);
+    deinit_graphe(&r->g);
+    if (!lire(f, &lu, sizeof(reseau_t))) return false;
+
+    bool ok = true;
+    graphe *g = &r->g;
+    *g = lu.g;
+    g->aretes = lire_tableau_suivi(f, MEMOIRE_GRAPHE, lu.g.aretes_capacite, lu.g.nb_aretes, sizeof(arete), &ok);
+    g->index_aretes = lire_tableau_suivi(f, MEMOIRE_GRAPHE, lu.g.index_capacite, lu.g.index_capacite, sizeof(size_t), &ok);
+    g->uf_parent = lire_tableau_suivi(f, MEMOIRE_GRAPHE, lu.g.sommets_capacite, lu.g.ordre, sizeof(sommet), &ok);
+    g->uf_rang = lire_tableau_suivi(f, MEMOIRE_GRAPHE, lu.g.sommets_capacite, lu.g.ordre, sizeof(unsigned char), &ok);
+    r->equipements = lire_tableau_suivi(f, MEMOIRE_EQUIPEMENTS, lu.equipements_capacite, lu.g.ordre,
+                                        sizeof(equipement_t), &ok);
+    r->equipements_capacite = lu.equipements_capacite;
+
+    r->switchs = lire_tableau_suivi(f, MEMOIRE_EQUIPEMENTS, lu.switchs_capacite, lu.nb_switchs, sizeof(switch_t), &ok);
+    r->switchs_capacite = lu.switchs_capacite;
+    for (size_t i = 0; ok && i < lu.nb_switchs; i++) {
+        switch_t *sw = &r->switchs[i];
+        table_commutation_t *t = &sw->table;
+        surveiller_purges(t, NULL, NULL);   // rappel de l'exécution sauvegardée
+        sw->ports = lire_tableau_suivi(f, MEMOIRE_PORTS, sw->nb_ports, sw->nb_ports, sizeof(port_info_t), &ok);
+        // appartenance aux VLAN, présente seulement si elle était configurée
+        if (sw->vlans != NULL) {
+            size_t nb_mots = (size_t)sw->nb_ports * MOTS_VLAN;
+            sw->vlans = lire_tableau_suivi(f, MEMOIRE_PORTS, nb_mots, nb_mots, sizeof(uint64_t), &ok);
+        }
+        t->entrees = lire_tableau_suivi(f, MEMOIRE_TABLES, t->capacite, t->taille, sizeof(table_entree_t), &ok);
+        t->index = lire_tableau_suivi(f, MEMOIRE_TABLES, t->index_capacite, t->index_capacite, sizeof(int), &ok);
+        t->tetes_ports = lire_tableau_suivi(f, MEMOIRE_TABLES, t->nb_ports_suivis, t->nb_ports_suivis, sizeof(int), &ok);
+        // groupes relus un à un : seuls ceux complets sont comptés, pour deinit_switch
+        table_multicast_t *m = &sw->multicast;
+        int nb_groupes = m->nb;
+        m->nb = 0;
+        m->groupes = lire_tableau_suivi(f, MEMOIRE_TABLES, m->capacite, nb_groupes, sizeof(groupe_multicast_t), &ok);
+        for (int k = 0; ok && k < nb_groupes; k++) {
+            groupe_multicast_t *gr = &m->groupes[k];
+            gr->ports = lire_tableau_suivi(f, MEMOIRE_TABLES, m->mots_ports + 1, m->mots_ports, sizeof(uint64_t), &ok);
+            gr->membres = lire_tableau_suivi(f, MEMOIRE_TABLES, gr->membres_capacite, gr->nb_membres,
+                                             sizeof(membre_groupe_t), &ok);
+            m->nb++;
+        }
+        r->nb_switchs++;
+    }
+
+    r->stations = lire_tableau_suivi(f, MEMOIRE_EQUIPEMENTS, lu.stations_capacite, lu.nb_stations, sizeof(station_t), &ok);
+    r->raccordements = lire_tableau_suivi(f, MEMOIRE_EQUIPEMENTS, lu.stations_capacite, lu.nb_stations,
+                                          sizeof(raccordement_t), &ok);
+    r->stations_capacite = lu.stations_capacite;
+    r->nb_stations = ok ? lu.nb_stations : 0;
+    if (lu.origine != NULL) {
+        r->origine = lire_tableau_suivi(f, MEMOIRE_EQUIPEMENTS, lu.equipements_capacite, lu.g.ordre, sizeof(sommet), &ok);
+        r->renumerote = lire_tableau_suivi(f, MEMOIRE_EQUIPEMENTS, lu.equipements_capacite, lu.g.ordre, sizeof(sommet), &ok);
+    }
+    return ok;
+}
+
+static charge_utile_t **lire_charges(FILE *f, size_t *nb_charges, bool *ok) {
+    uint64_t nb;
+    *nb_charges = 0;
+    if (!*ok || !lire(f, &nb, sizeof(nb))) {
+        *ok = false;
+        return NULL;
+    }
+
+    charge_utile_t **charges = malloc((nb + 1) * sizeof(charge_utile_t *));
+    if (charges == NULL) {
+        *ok = false;
+        return NULL;
+    }
+    for (uint64_t k = 0; *ok && k < nb; k++) {
+        uint64_t taille;
+        charge_utile_t *c = NULL;
+        if (lire(f, &taille, sizeof(taille))) c = allouer_memoire(MEMOIRE_TRAMES, sizeof(charge_utile_t) + taille + 1);
+        if (c == NULL || !lire(f, c->octets, taille)) {
+            liberer_memoire(MEMOIRE_TRAMES, c, sizeof(charge_utile_t) + taille + 1);
+            *ok = false;
+            break;
+        }
+        // les références sont comptées à mesure que les trames sont relues
+        c->references = 0;
+        c->taille = taille;
+        c->octets[taille] = '\0';
+        charges[(*nb_charges)++] = c;
+    }
+    return charges;
+}
+
+static bool lire_simulation_checkpoint(FILE *f, reseau_t *r, simulation_t *sim) {
+    if (!lire(f, sim, sizeof(simulation_t))) {
+        sim->evenements = NULL;
+        sim->files = NULL;
+        sim->premiere_file = NULL;
+        sim->ports_sortie = NULL;
+        sim->paires = NULL;
+        sim->roue.temporisations = NULL;
+        sim->tempo_ports = NULL;
+        sim->caches_arp = NULL;
+        sim->attentes_arp = NULL;
+        sim->adhesions = NULL;
+        sim->nb_evenements = 0;
+        sim->nb_files = 0;
+        sim->nb_attentes_arp = 0;
+        sim->reseau = r;
+        deinit_simulation(sim);
+        return false;
+    }
+
+    bool ok = true;
+    size_t nb_evenements = sim->nb_evenements;
+    size_t nb_files = sim->nb_files;
+    size_t nb_paires = sim->nb_paires;
+    size_t nb_adhesions = sim->nb_adhesions;
+    size_t nb_attentes = sim->nb_attentes_arp;
+    sim->reseau = r;
+    sim->spb = NULL;             // plan dérivé du réseau, à recalculer et réactiver
+    bool arp = sim->caches_arp != NULL;
+    sim->caches_arp = NULL;
+    sim->attentes_arp = NULL;
+    sim->nb_attentes_arp = 0;
+    sim->nb_evenements = 0;
+    sim->nb_files = 0;
+    sim->nb_paires = 0;
+    sim->files = NULL;
+    sim->evenements = NULL;
+    bool stp_temporise = sim->tempo_ports != NULL;
+    sim->tempo_ports = NULL;
+
+    sim->premiere_file = lire_tableau(f, ordre(&r->g) + 1, ordre(&r->g) + 1, sizeof(size_t), &ok);
+    sim->paires = lire_tableau_suivi(f, MEMOIRE_MESURES, sim->paires_capacite, nb_paires, sizeof(paire_suivie_t),
+                                     &ok);
+    if (ok) sim->nb_paires = nb_paires;
+    sim->nb_adhesions = 0;
+    sim->adhesions = lire_tableau_suivi(f, MEMOIRE_TABLES, sim->adhesions_capacite, nb_adhesions, sizeof(adhesion_t),
+                                        &ok);
+    if (ok) sim->nb_adhesions = nb_adhesions;
+    // la roue est relue telle quelle : chaînages et liste libre sont des indices
+    sim->roue.temporisations = lire_tableau_suivi(f, MEMOIRE_EVENEMENTS, sim->roue.capacite, sim->roue.capacite,
+                                                 sizeof(temporisation_t), &ok);
+    if (!ok) sim->roue.capacite = 0;
+    if (stp_temporise) {
+        sim->tempo_ports = lire_tableau_suivi(f, MEMOIRE_EVENEMENTS, nb_files + 1, nb_files,
+                                              sizeof(temporisations_port_t), &ok);
+    }
+    // caches ARP : un cache non relu reste vide, pour deinit_simulation
+    if (arp) {
+        sim->caches_arp = lire_tableau_suivi(f, MEMOIRE_TABLES, r->nb_stations + 1, r->nb_stations, sizeof(cache_arp_t),
+                                             &ok);
+        for (size_t i = 0; sim->caches_arp != NULL && i < r->nb_stations; i++) {
+            cache_arp_t *c = &sim->caches_arp[i];
+            c->entrees = lire_tableau_suivi(f, MEMOIRE_TABLES, c->capacite, c->capacite, sizeof(entree_arp_t), &ok);
+            if (c->entrees == NULL) {
+                c->capacite = 0;
+                c->nb = 0;
+            }
+        }
+    }
+    sim->ports_sortie = malloc(sim->ports_capacite * sizeof(int));
+    ok = ok && sim->ports_sortie != NULL;
+
+    size_t nb_charges;
+    charge_utile_t **charges = lire_charges(f, &nb_charges, &ok);
+
+    sim->files = lire_tableau_suivi(f, MEMOIRE_FILES, nb_files + 1, nb_files, sizeof(file_sortie_t), &ok);
+    if (ok) {
+        // les anneaux sont recréés à leur capacité, trames en attente en tête
+        for (size_t i = 0; i < nb_files; i++) {
+            file_sortie_t *fs = &sim->files[i];
+            int nb = fs->nb;
+            bool alloue = fs->trames != NULL;
+            fs->nb = 0;
+            fs->tete = 0;
+            fs->trames = alloue ? allouer_memoire(MEMOIRE_FILES, sim->capacite_file * sizeof(trame)) : NULL;
+            if (alloue && fs->trames == NULL) ok = false;
+            for (int k = 0; ok && k < nb; k++) {
+                ok = lire_trame(f, &fs->trames[k], charges, nb_charges);
+                if (ok) fs->nb++;
+            }
+            sim->nb_files++;
+            if (!ok) break;
+        }
+    }
+
+    sim->evenements = lire_tableau_suivi(f, MEMOIRE_EVENEMENTS, sim->evenements_capacite, 0, sizeof(evenement_t), &ok);
+    for (size_t k = 0; ok && k < nb_evenements; k++) {
+        evenement_t *e = &sim->evenements[k];
+        ok = lire(f, e, sizeof(evenement_t))
+             && (e->type != EVT_RECEPTION || lire_trame(f, &e->t, charges, nb_charges));
+        if (ok) sim->nb_evenements++;
+    }
+
+    ok = ok && nb_attentes <= sim->attentes_arp_capacite;
+    sim->attentes_arp = lire_tableau_suivi(f, MEMOIRE_FILES, sim->attentes_arp_capacite, 0, sizeof(attente_arp_t), &ok);
+    for (size_t k = 0; ok && k < nb_attentes; k++) {
+        attente_arp_t *a = &sim->attentes_arp[k];
+        ok = lire(f, a, sizeof(attente_arp_t)) && lire_trame(f, &a->t, charges, nb_charges);
+        if (ok) sim->nb_attentes_arp++;
+    }
+    if (sim->attentes_arp == NULL) sim->attentes_arp_capacite = 0;
+
+    // une charge que plus aucune trame ne référence (fichier tronqué) est libérée ici
+    for (size_t k = 0; k < nb_charges; k++) {
+        if (charges[k]->references == 0) {
+            liberer_memoire(MEMOIRE_TRAMES, charges[k], sizeof(charge_utile_t) + charges[k]->taille + 1);
+        }
+    }
+    free(charges);
+
+    if (ok) surveiller_purges_simulation(sim);
+    if (!ok) deinit_simulation(sim);
+    return ok;
+}
+
+bool restaurer_checkpoint(const char *nom_fichier, reseau_t *r, simulation_t *sim) {
+    if (nom_fichier == NULL || r == NULL || sim == NULL) return false;
+
+    FILE *f = fopen(nom_fichier, "rb");
+    if (f == NULL) {
+        perror("Erreur d'ouverture du point de reprise");
+        return false;
+    }
+    // gros tampon : les tableaux sont relus par blocs entiers
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+
+    entete_checkpoint_t entete, attendu;
+    remplir_entete(&attendu);
+    if (!lire(f, &entete, sizeof(entete)) || memcmp(&entete, &attendu, sizeof(entete)) != 0) {
+        JOURNALISER_TEXTE(JOURNAL_ERREUR, "Point de reprise %s invalide ou produit par une autre version",
+                          nom_fichier, 0, 0, 0);
+        fclose(f);
+        return false;
+    }
+
+    bool ok = lire_reseau_checkpoint(f, r);
+    if (ok) {
+        ok = lire_simulation_checkpoint(f, r, sim);
+    }
+    if (!ok) {
+        JOURNALISER_TEXTE(JOURNAL_ERREUR, "Point de reprise %s tronqué ou illisible", nom_fichier, 0, 0, 0);
+        deinit_reseau(r);
+    }
+    fclose(f);
+    return ok;
+}
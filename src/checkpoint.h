@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdbool.h>
+#include "reseau.h"
+#include "simulation.h"
+
+// Point de reprise : état complet d'une simulation (réseau, états des ports,
+// tables de commutation, files de sortie, événements en attente, temporisations, ARP, horloge)
+// dans un seul fichier binaire. Le format est celui de la mémoire : un point
+// de reprise n'est relu que par un exécutable compilé pour la même architecture.
+#define MAGIQUE_CHECKPOINT "SIMRESCK"
+#define VERSION_CHECKPOINT 9
+
+bool sauvegarder_checkpoint(const char *nom_fichier, const simulation_t *sim);
+
+// Initialise r et sim à partir du fichier (sim->reseau pointe sur r).
+// À libérer par deinit_simulation puis deinit_reseau. Les plans multichemin
+// et MSTP ne sont pas sauvegardés : les recalculer puis les réactiver après
+// restauration. Les caches ARP et les paquets en attente de résolution le
+// sont, la résolution reprend où elle en était.
+bool restaurer_checkpoint(const char *nom_fichier, reseau_t *r, simulation_t *sim);
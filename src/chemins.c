@@ -0,0 +1,346 @@
+#include "chemins.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Liens actifs en adjacence compacte, un élément par sens
+typedef struct {
+    size_t *debut;
+    size_t *curseur;
+    sommet *voisins;
+    uint32_t *couts;
+} adjacence_t;
+
+// Une station émet toujours par son unique carte réseau ; un switch ne relaie
+// que par ses ports racine et désignés
+static bool relaie(const reseau_t *r, sommet s, int port) {
+    if (reseau_station(r, s) != NULL) return true;
+
+    const switch_t *sw = reseau_switch(r, s);
+    etat_port_t etat = get_etat_port(sw, port);
+    return sw != NULL && port_est_actif(sw, port) && (etat == PORT_RACINE || etat == PORT_DESIGNE);
+}
+
+static void noter_lien(adjacence_t *adj, sommet a, sommet b, int cout, bool remplir) {
+    if (!remplir) {
+        adj->debut[a + 1]++;
+        return;
+    }
+    size_t e = adj->curseur[a]++;
+    adj->voisins[e] = b;
+    adj->couts[e] = (uint32_t)cout;
+}
+
+// Premier passage : degrés dans debut ; second : voisins et coûts
+static void parcourir_liens(const reseau_t *r, adjacence_t *adj, bool remplir) {
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        if (sw != NULL) {
+            for (int p = 0; p < sw->nb_ports; p++) {
+                const port_info_t *port = &sw->ports[p];
+                if (port->voisin == UNKNOWN_INDEX || !relaie(r, s, p) ||
+                    !relaie(r, port->voisin, port->port_voisin)) continue;
+
+                // le sens switch -> switch opposé est noté depuis l'autre switch
+                noter_lien(adj, s, port->voisin, port->cout, remplir);
+                if (reseau_switch(r, port->voisin) == NULL) noter_lien(adj, port->voisin, s, port->cout, remplir);
+            }
+        } else if (reseau_station(r, s) != NULL) {
+            const raccordement_t *rc = &r->raccordements[r->equipements[s].index];
+            if (rc->voisin == UNKNOWN_INDEX || reseau_station(r, rc->voisin) == NULL) continue;
+
+            arete a = {s, rc->voisin, 0, false};
+            noter_lien(adj, s, rc->voisin, r->g.aretes[index_arete(&r->g, a)].poids, remplir);
+        }
+    }
+}
+
+static void deinit_adjacence(adjacence_t *adj) {
+    free(adj->debut);
+    free(adj->curseur);
+    free(adj->voisins);
+    free(adj->couts);
+}
+
+static bool init_adjacence(adjacence_t *adj, const reseau_t *r) {
+    size_t n = ordre(&r->g);
+    adj->debut = calloc(n + 1, sizeof(size_t));
+    adj->curseur = malloc((n + 1) * sizeof(size_t));
+    adj->voisins = NULL;
+    adj->couts = NULL;
+    if (adj->debut == NULL || adj->curseur == NULL) {
+        deinit_adjacence(adj);
+        return false;
+    }
+
+    parcourir_liens(r, adj, false);
+    for (size_t s = 0; s < n; s++) {
+        adj->debut[s + 1] += adj->debut[s];
+    }
+    adj->voisins = malloc((adj->debut[n] + 1) * sizeof(sommet));
+    adj->couts = malloc((adj->debut[n] + 1) * sizeof(uint32_t));
+    if (adj->voisins == NULL || adj->couts == NULL) {
+        deinit_adjacence(adj);
+        return false;
+    }
+    memcpy(adj->curseur, adj->debut, (n + 1) * sizeof(size_t));
+    parcourir_liens(r, adj, true);
+    return true;
+}
+
+// Parcours en profondeur de chaque arbre depuis son plus petit sommet : parent,
+// profondeur, coût et tour eulérien. Les liens qui referment une boucle (rôles
+// incohérents, STP non calculé) sont ignorés.
+static bool calculer_tour(index_chemins_t *idx, const reseau_t *r, sommet *tour, size_t *segments,
+                          size_t *nb_tour, size_t *nb_arbres) {
+    size_t n = idx->nb_sommets;
+    adjacence_t adj;
+    sommet *pile = malloc((n + 1) * sizeof(sommet));
+    if (pile == NULL || !init_adjacence(&adj, r)) {
+        free(pile);
+        return false;
+    }
+
+    size_t k = 0, nb = 0;
+    for (sommet s = 0; s < n; s++) {
+        idx->racine[s] = UNKNOWN_INDEX;
+    }
+    // adj.curseur sert de nouveau : prochain voisin à explorer
+    memcpy(adj.curseur, adj.debut, (n + 1) * sizeof(size_t));
+    for (sommet depart = 0; depart < n; depart++) {
+        if (idx->racine[depart] != UNKNOWN_INDEX) continue;
+
+        segments[nb++] = k;
+        idx->parent[depart] = UNKNOWN_INDEX;
+        idx->racine[depart] = depart;
+        idx->profondeur[depart] = 0;
+        idx->cout[depart] = 0;
+        idx->premiere[depart] = k;
+        tour[k++] = depart;
+        size_t hauteur = 0;
+        pile[hauteur++] = depart;
+        while (hauteur > 0) {
+            sommet s = pile[hauteur - 1];
+            if (adj.curseur[s] == adj.debut[s + 1]) {
+                // retour au parent, qui réapparaît dans le tour
+                hauteur--;
+                if (hauteur > 0) tour[k++] = pile[hauteur - 1];
+                continue;
+            }
+
+            size_t e = adj.curseur[s]++;
+            sommet v = adj.voisins[e];
+            if (idx->racine[v] != UNKNOWN_INDEX) continue;
+
+            idx->parent[v] = s;
+            idx->racine[v] = depart;
+            idx->profondeur[v] = idx->profondeur[s] + 1;
+            idx->cout[v] = idx->cout[s] + adj.couts[e];
+            idx->premiere[v] = k;
+            tour[k++] = v;
+            pile[hauteur++] = v;
+        }
+    }
+    segments[nb] = k;
+    *nb_tour = k;
+    *nb_arbres = nb;
+
+    deinit_adjacence(&adj);
+    free(pile);
+    return true;
+}
+
+static int log2_plancher(size_t x) {
+    return 63 - __builtin_clzll(x);
+}
+
+// Table creuse sur le segment tour[a .. b[ d'un arbre, dont seules les cases
+// tour[lo .. hi[ ont changé : au niveau j, seules les fenêtres de 2^j cases qui
+// les recouvrent sont recalculées, soit O((hi - lo) log n + b - a) au pire.
+// Les cases qui débordent du segment ne sont jamais lues, une requête restant
+// dans l'arbre de ses deux sommets.
+static void remplir_table(index_chemins_t *idx, size_t a, size_t b, size_t lo, size_t hi) {
+    size_t n = idx->nb_tour;
+    memcpy(idx->table + lo, idx->tour + lo, (hi - lo) * sizeof(sommet));
+    idx->nb_cases_reecrites += hi - lo;
+    for (int j = 1; j < idx->nb_niveaux; j++) {
+        size_t pas = (size_t)1 << (j - 1), largeur = 2 * pas;
+        if (largeur > b - a) break;
+
+        size_t debut = (lo - a >= largeur - 1) ? lo - (largeur - 1) : a;
+        size_t fin = (hi < b - largeur + 1) ? hi : b - largeur + 1;
+        const sommet *precedent = idx->table + (j - 1) * n;
+        sommet *ligne = idx->table + j * n;
+        for (size_t i = debut; i < fin; i++) {
+            sommet x = precedent[i], y = precedent[i + pas];
+            ligne[i] = (idx->profondeur[y] < idx->profondeur[x]) ? y : x;
+        }
+        idx->nb_cases_reecrites += fin - debut;
+    }
+}
+
+static bool allouer_table(index_chemins_t *idx) {
+    idx->nb_niveaux = (idx->nb_tour > 0) ? log2_plancher(idx->nb_tour) + 1 : 0;
+    free(idx->table);
+    idx->table = malloc((idx->nb_niveaux * idx->nb_tour + 1) * sizeof(sommet));
+    if (idx->table == NULL) return false;
+
+    remplir_table(idx, 0, idx->nb_tour, 0, idx->nb_tour);
+    return true;
+}
+
+bool construire_index_chemins(index_chemins_t *idx, const reseau_t *r) {
+    if (idx == NULL || r == NULL) return false;
+
+    size_t n = ordre(&r->g);
+    idx->nb_sommets = n;
+    idx->parent = malloc((n + 1) * sizeof(sommet));
+    idx->racine = malloc((n + 1) * sizeof(sommet));
+    idx->profondeur = malloc((n + 1) * sizeof(uint32_t));
+    idx->cout = malloc((n + 1) * sizeof(uint64_t));
+    idx->premiere = malloc((n + 1) * sizeof(size_t));
+    idx->tour = malloc((2 * n + 1) * sizeof(sommet));
+    idx->segments = malloc((n + 1) * sizeof(size_t));
+    idx->table = NULL;
+    idx->nb_tour = 0;
+    idx->nb_arbres = 0;
+    idx->nb_niveaux = 0;
+    idx->nb_arbres_reconstruits = 0;
+    idx->nb_cases_reecrites = 0;
+
+    bool ok = idx->parent != NULL && idx->racine != NULL && idx->profondeur != NULL && idx->cout != NULL &&
+              idx->premiere != NULL && idx->tour != NULL && idx->segments != NULL &&
+              calculer_tour(idx, r, idx->tour, idx->segments, &idx->nb_tour, &idx->nb_arbres) &&
+              allouer_table(idx);
+    if (!ok) deinit_index_chemins(idx);
+    return ok;
+}
+
+bool mettre_a_jour_index_chemins(index_chemins_t *idx, const reseau_t *r) {
+    if (idx == NULL || r == NULL) return false;
+
+    if (idx->tour == NULL || ordre(&r->g) != idx->nb_sommets) {
+        uint64_t nb_reconstruits = idx->nb_arbres_reconstruits, nb_cases = idx->nb_cases_reecrites;
+        deinit_index_chemins(idx);
+        if (!construire_index_chemins(idx, r)) return false;
+        idx->nb_arbres_reconstruits = nb_reconstruits + idx->nb_arbres;
+        idx->nb_cases_reecrites += nb_cases;
+        return true;
+    }
+
+    size_t n = idx->nb_sommets;
+    sommet *tour = malloc((2 * n + 1) * sizeof(sommet));
+    size_t *segments = malloc((n + 1) * sizeof(size_t));
+    size_t nb_tour, nb_arbres;
+    if (tour == NULL || segments == NULL || !calculer_tour(idx, r, tour, segments, &nb_tour, &nb_arbres)) {
+        free(tour);
+        free(segments);
+        deinit_index_chemins(idx);
+        return false;
+    }
+
+    // mêmes arbres aux mêmes places : seule la plage modifiée de chaque segment est
+    // refaite. Hors de cette plage, les profondeurs n'ont pas changé : le tour de
+    // la racine jusqu'à une case (ou d'une case jusqu'à la racine) est le même
+    // trajet, dont les allers-retours annulés laissent le chemin vers la racine.
+    if (nb_arbres == idx->nb_arbres && memcmp(segments, idx->segments, (nb_arbres + 1) * sizeof(size_t)) == 0) {
+        for (size_t k = 0; k < nb_arbres; k++) {
+            size_t a = segments[k], b = segments[k + 1];
+            size_t lo = a, hi = b;
+            while (lo < b && tour[lo] == idx->tour[lo]) lo++;
+            if (lo == b) continue;
+            while (tour[hi - 1] == idx->tour[hi - 1]) hi--;
+
+            memcpy(idx->tour + lo, tour + lo, (hi - lo) * sizeof(sommet));
+            remplir_table(idx, a, b, lo, hi);
+            idx->nb_arbres_reconstruits++;
+        }
+        free(tour);
+        free(segments);
+        return true;
+    }
+
+    free(idx->tour);
+    free(idx->segments);
+    idx->tour = tour;
+    idx->segments = segments;
+    idx->nb_tour = nb_tour;
+    idx->nb_arbres = nb_arbres;
+    idx->nb_arbres_reconstruits += nb_arbres;
+    if (!allouer_table(idx)) {
+        deinit_index_chemins(idx);
+        return false;
+    }
+    return true;
+}
+
+void deinit_index_chemins(index_chemins_t *idx) {
+    if (idx == NULL) return;
+
+    free(idx->parent);
+    free(idx->racine);
+    free(idx->profondeur);
+    free(idx->cout);
+    free(idx->premiere);
+    free(idx->tour);
+    free(idx->segments);
+    free(idx->table);
+    idx->parent = NULL;
+    idx->racine = NULL;
+    idx->profondeur = NULL;
+    idx->cout = NULL;
+    idx->premiere = NULL;
+    idx->tour = NULL;
+    idx->segments = NULL;
+    idx->table = NULL;
+    idx->nb_sommets = 0;
+    idx->nb_tour = 0;
+    idx->nb_arbres = 0;
+    idx->nb_niveaux = 0;
+}
+
+sommet ancetre_commun(const index_chemins_t *idx, sommet a, sommet b) {
+    if (idx == NULL || a >= idx->nb_sommets || b >= idx->nb_sommets || idx->racine[a] != idx->racine[b]) {
+        return UNKNOWN_INDEX;
+    }
+
+    size_t i = idx->premiere[a], j = idx->premiere[b];
+    if (i > j) {
+        size_t t = i;
+        i = j;
+        j = t;
+    }
+    int niveau = log2_plancher(j - i + 1);
+    const sommet *ligne = idx->table + niveau * idx->nb_tour;
+    sommet x = ligne[i], y = ligne[j + 1 - ((size_t)1 << niveau)];
+    return (idx->profondeur[y] < idx->profondeur[x]) ? y : x;
+}
+
+size_t longueur_chemin(const index_chemins_t *idx, sommet a, sommet b) {
+    sommet c = ancetre_commun(idx, a, b);
+    if (c == UNKNOWN_INDEX) return UNKNOWN_INDEX;
+    return idx->profondeur[a] + idx->profondeur[b] - 2 * idx->profondeur[c];
+}
+
+uint64_t cout_chemin(const index_chemins_t *idx, sommet a, sommet b) {
+    sommet c = ancetre_commun(idx, a, b);
+    if (c == UNKNOWN_INDEX) return COUT_CHEMIN_INFINI;
+    return idx->cout[a] + idx->cout[b] - 2 * idx->cout[c];
+}
+
+size_t sauts_chemin(const index_chemins_t *idx, sommet a, sommet b, sommet chemin[]) {
+    sommet c = ancetre_commun(idx, a, b);
+    if (c == UNKNOWN_INDEX || chemin == NULL) return 0;
+
+    // montée de a vers l'ancêtre commun, puis de b en remplissant depuis la fin
+    size_t longueur = idx->profondeur[a] + idx->profondeur[b] - 2 * idx->profondeur[c];
+    size_t k = 0;
+    for (sommet v = a; v != c; v = idx->parent[v]) {
+        chemin[k++] = v;
+    }
+    chemin[k] = c;
+    k = longueur;
+    for (sommet v = b; v != c; v = idx->parent[v]) {
+        chemin[k--] = v;
+    }
+    return longueur + 1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "reseau.h"
+
+// Chemins sur l'arbre actif, sans faire circuler de trame. Une fois le STP
+// convergé, les liens dont les deux extrémités relaient (port racine ou désigné
+// côté switch, toujours côté station) forment une forêt. Le tour eulérien de
+// chaque arbre et une table creuse des minimums de profondeur donnent le plus
+// proche ancêtre commun de deux sommets en O(1) : longueur et coût du chemin en
+// O(1), liste des sauts en O(longueur).
+#define COUT_CHEMIN_INFINI UINT64_MAX
+
+typedef struct {
+    size_t nb_sommets;
+    sommet *parent;           // UNKNOWN_INDEX pour la racine d'un arbre
+    sommet *racine;           // plus petit sommet de l'arbre
+    uint32_t *profondeur;     // sauts depuis la racine
+    uint64_t *cout;           // somme des coûts des liens depuis la racine
+    size_t *premiere;         // première apparition du sommet dans le tour
+    sommet *tour;             // arbres à la suite, 2k - 1 cases pour k sommets
+    size_t nb_tour;
+    size_t *segments;         // début du tour de chaque arbre, puis nb_tour
+    size_t nb_arbres;
+    sommet *table;            // niveau j, case i : sommet le moins profond de tour[i .. i + 2^j[
+    int nb_niveaux;
+    uint64_t nb_arbres_reconstruits; // tables d'arbre refaites par mettre_a_jour_index_chemins
+    uint64_t nb_cases_reecrites;     // cases de table recalculées, construction comprise
+} index_chemins_t;
+
+bool construire_index_chemins(index_chemins_t *idx, const reseau_t *r);
+// À appeler quand des rôles de ports ont changé : tant que les arbres gardent les
+// mêmes sommets, seule la plage modifiée du tour de chaque arbre voit sa table
+// refaite, en O(d log n + t) pour d cases changées dans un tour de t cases (les
+// fenêtres des niveaux hauts recouvrent vite tout le tour). Le tour lui-même est
+// toujours recalculé en entier, en O(V + E) : une mise à jour ne descend donc pas
+// sous le temps linéaire, même quand un seul port change de rôle.
+bool mettre_a_jour_index_chemins(index_chemins_t *idx, const reseau_t *r);
+void deinit_index_chemins(index_chemins_t *idx);
+
+// UNKNOWN_INDEX si a et b ne sont pas dans le même arbre
+sommet ancetre_commun(const index_chemins_t *idx, sommet a, sommet b);
+// Nombre de liens traversés, UNKNOWN_INDEX si aucun chemin
+size_t longueur_chemin(const index_chemins_t *idx, sommet a, sommet b);
+// Somme des coûts STP des liens traversés, COUT_CHEMIN_INFINI si aucun chemin
+uint64_t cout_chemin(const index_chemins_t *idx, sommet a, sommet b);
+// Sommets de a à b inclus, écrits dans chemin (longueur_chemin + 1 cases) ;
+// renvoie leur nombre, 0 si aucun chemin
+size_t sauts_chemin(const index_chemins_t *idx, sommet a, sommet b, sommet chemin[]);
@@ -0,0 +1,127 @@
+#include "coeur.h"
+#include "profileur.h"
+#include <stdlib.h>
+
+bool construire_coeur(coeur_reseau_t *c, const reseau_t *r) {
+    if (c == NULL || r == NULL) return false;
+
+    PROFILER_ENTRER("coeur");
+    size_t n = r->nb_switchs;
+    c->nb_switchs = n;
+    c->debut_liens = malloc((n + 1) * sizeof(size_t));
+    c->debut_acces = malloc((n + 1) * sizeof(size_t));
+    c->liens = NULL;
+    c->acces = NULL;
+    c->nb_stations_hors_coeur = 0;
+    if (c->debut_liens == NULL || c->debut_acces == NULL) {
+        deinit_coeur(c);
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    // premier passage : nombre de liens et de stations de chaque switch
+    c->debut_liens[0] = 0;
+    c->debut_acces[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        const switch_t *sw = &r->switchs[i];
+        size_t nb_liens = 0, nb_acces = 0;
+        for (int p = 0; p < sw->nb_ports; p++) {
+            const port_info_t *port = &sw->ports[p];
+            if (port->voisin == UNKNOWN_INDEX) continue;
+
+            type_equipement_t type = r->equipements[port->voisin].type;
+            if (type == EQUIPEMENT_SWITCH && port->actif) nb_liens++;
+            if (type == EQUIPEMENT_STATION) nb_acces++;
+        }
+        c->debut_liens[i + 1] = c->debut_liens[i] + nb_liens;
+        c->debut_acces[i + 1] = c->debut_acces[i] + nb_acces;
+    }
+
+    c->liens = malloc((c->debut_liens[n] + 1) * sizeof(lien_coeur_t));
+    c->acces = malloc((c->debut_acces[n] + 1) * sizeof(acces_station_t));
+    if (c->liens == NULL || c->acces == NULL) {
+        deinit_coeur(c);
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const switch_t *sw = &r->switchs[i];
+        size_t l = c->debut_liens[i], a = c->debut_acces[i];
+        for (int p = 0; p < sw->nb_ports; p++) {
+            const port_info_t *port = &sw->ports[p];
+            if (port->voisin == UNKNOWN_INDEX) continue;
+
+            const equipement_t *e = &r->equipements[port->voisin];
+            if (e->type == EQUIPEMENT_SWITCH && port->actif) {
+                c->liens[l].port = p;
+                c->liens[l].voisin = e->index;
+                c->liens[l].port_voisin = port->port_voisin;
+                c->liens[l].cout = port->cout;
+                l++;
+            } else if (e->type == EQUIPEMENT_STATION) {
+                c->acces[a].port = p;
+                c->acces[a].station = e->index;
+                a++;
+            }
+        }
+    }
+    c->nb_stations_hors_coeur = r->nb_stations - c->debut_acces[n];
+    PROFILER_SORTIR();
+    return true;
+}
+
+void deinit_coeur(coeur_reseau_t *c) {
+    if (c == NULL) return;
+
+    free(c->debut_liens);
+    free(c->liens);
+    free(c->debut_acces);
+    free(c->acces);
+    c->debut_liens = NULL;
+    c->liens = NULL;
+    c->debut_acces = NULL;
+    c->acces = NULL;
+    c->nb_switchs = 0;
+    c->nb_stations_hors_coeur = 0;
+}
+
+size_t nb_liens_coeur(const coeur_reseau_t *c) {
+    return (c == NULL || c->debut_liens == NULL) ? 0 : c->debut_liens[c->nb_switchs];
+}
+
+size_t nb_stations_coeur(const coeur_reseau_t *c) {
+    return (c == NULL || c->debut_acces == NULL) ? 0 : c->debut_acces[c->nb_switchs];
+}
+
+bool graphe_coeur(const coeur_reseau_t *c, graphe *g) {
+    if (c == NULL || g == NULL) return false;
+
+    vider_graphe(g);
+    for (size_t i = 0; i < c->nb_switchs; i++) {
+        if (!ajouter_sommet(g)) return false;
+    }
+    // chaque lien n'est ajouté que depuis son extrémité de plus petit indice
+    for (size_t i = 0; i < c->nb_switchs; i++) {
+        for (size_t k = c->debut_liens[i]; k < c->debut_liens[i + 1]; k++) {
+            const lien_coeur_t *l = &c->liens[k];
+            if (l->voisin <= i) continue;
+
+            arete a = {i, l->voisin, l->cout, false};
+            if (!existe_arete(g, a) && !ajouter_arete(g, a)) return false;
+        }
+    }
+    return true;
+}
+
+size_t stations_port(const coeur_reseau_t *c, size_t sw, int port, size_t stations[]) {
+    if (c == NULL || sw >= c->nb_switchs) return 0;
+
+    size_t nb = 0;
+    for (size_t k = c->debut_acces[sw]; k < c->debut_acces[sw + 1]; k++) {
+        if (c->acces[k].port != port) continue;
+        if (stations != NULL) stations[nb] = c->acces[k].station;
+        nb++;
+    }
+    return nb;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "reseau.h"
+
+// Cœur du réseau : les stations sont toujours des feuilles et sont souvent
+// vingt fois plus nombreuses que les switchs. Le cœur ne garde que les liens
+// entre switchs, en adjacence compacte par switch, et accroche les stations au
+// port d'accès de leur switch dans un tableau à part. Le STP et les analyses qui
+// n'ont que faire des stations parcourent le cœur ; la vue par station se
+// reconstruit à la demande.
+typedef struct {
+    int port;            // port local
+    size_t voisin;       // indice du switch voisin dans reseau_t.switchs
+    int port_voisin;
+    int cout;
+} lien_coeur_t;
+
+typedef struct {
+    int port;            // port d'accès du switch
+    size_t station;      // indice dans reseau_t.stations
+} acces_station_t;
+
+typedef struct {
+    size_t nb_switchs;
+    // liens du switch i : liens[debut_liens[i] .. debut_liens[i + 1][, par port croissant ;
+    // seuls les ports actifs y figurent, comme pour le protocole
+    size_t *debut_liens;
+    lien_coeur_t *liens;
+    // stations du switch i : acces[debut_acces[i] .. debut_acces[i + 1][, par port croissant
+    size_t *debut_acces;
+    acces_station_t *acces;
+    size_t nb_stations_hors_coeur; // reliées à rien, à une station ou à un équipement inconnu
+} coeur_reseau_t;
+
+bool construire_coeur(coeur_reseau_t *c, const reseau_t *r);
+void deinit_coeur(coeur_reseau_t *c);
+
+size_t nb_liens_coeur(const coeur_reseau_t *c);   // chaque lien compte une fois par extrémité
+size_t nb_stations_coeur(const coeur_reseau_t *c);
+
+// Graphe des seuls switchs (sommet i : reseau_t.switchs[i]) pour les analyses
+// de connexité et de boucles ; g doit être initialisé
+bool graphe_coeur(const coeur_reseau_t *c, graphe *g);
+
+// Stations raccordées au port du switch sw, écrites dans stations (indices
+// dans reseau_t.stations) ; renvoie leur nombre
+size_t stations_port(const coeur_reseau_t *c, size_t sw, int port, size_t stations[]);
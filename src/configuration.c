@@ -1,6 +1,8 @@
 #include "configuration.h"
 #include "station.h"
 #include "switch.h"
+#include "journal.h"
+#include "profileur.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,13 +11,31 @@
 //sscanf permet de recup des infos avec une chaine formatée
 //sprintf permet de formater une chaine dans un char *
 
+// Découpe la ligne sur ';' sans état global (contrairement à strtok) :
+// retourne le champ courant et avance le curseur, NULL après le dernier champ
+static char *champ_suivant(char **curseur) {
+    char *debut = *curseur;
+    if (debut == NULL) return NULL;
+    
+    char *separateur = strchr(debut, ';');
+    if (separateur != NULL) {
+        *separateur = '\0';
+        *curseur = separateur + 1;
+    } else {
+        *curseur = NULL;
+    }
+    return debut;
+}
+
 /**
- * Charge la configuration réseau à partir d'un fichier
+ * Lit un réseau complet (graphe, switchs, stations, câblage des ports)
+ * à partir d'un fichier de configuration, sans rien afficher.
+ * Réentrante : plusieurs fichiers peuvent être lus en parallèle.
  * @param nom_fichier Nom du fichier de configuration
- * @param g Pointeur vers le graphe à remplir
- * @return 1 si le chargement a réussi, 0 sinon
+ * @param r Réseau initialisé (son contenu précédent est vidé, ses tampons réutilisés)
+ * @return 1 si la lecture a réussi, 0 sinon
  */
-int charger_configuration(const char *nom_fichier, graphe *g) {
+static int lire_fichier_reseau(const char *nom_fichier, reseau_t *r) {
     FILE *f = fopen(nom_fichier, "r");
     if (!f) {
         perror("Erreur d'ouverture du fichier");
@@ -27,49 +47,31 @@ int charger_configuration(const char *nom_fichier, graphe *g) {
     
     // Lecture de la ligne d'en-tête (nb_equipements nb_liens)
     if (fgets(ligne, MAX_LIGNE, f) == NULL || sscanf(ligne, "%d %d", &nombre_equipements, &nombre_liens) != 2) {
-        fprintf(stderr, "Format de la première ligne incorrect\n");
-        fclose(f);
-        return 0;
-    }
-    
-    // Initialisation du graphe
-    init_graphe(g);
-    
-    // Tableaux pour stocker les équipements
-    switch_t *switchs = malloc(nombre_equipements * sizeof(switch_t));
-    station_t *stations = malloc(nombre_equipements * sizeof(station_t));
-    
-    if (!switchs || !stations) {
-        fprintf(stderr, "Erreur d'allocation mémoire\n");
-        free(switchs);
-        free(stations);
+        JOURNALISER(JOURNAL_ERREUR, "Format de la première ligne incorrect", 0, 0, 0, 0);
         fclose(f);
         return 0;
     }
     
-    int nb_switchs = 0;
-    int nb_stations = 0;
+    // Remise à zéro du réseau
+    vider_reseau(r);
+    graphe *g = &r->g;
     
     // Lecture des équipements
     for (int i = 0; i < nombre_equipements; i++) {
         if (fgets(ligne, MAX_LIGNE, f) == NULL) {
-            fprintf(stderr, "Fin de fichier inattendue\n");
-            free(switchs);
-            free(stations);
+            JOURNALISER(JOURNAL_ERREUR, "Fin de fichier inattendue", 0, 0, 0, 0);
             fclose(f);
             return 0;
         }
         
         int type_equipement;
-        char *token = strtok(ligne, ";");
+        char *curseur = ligne;
+        char *token = champ_suivant(&curseur);
         if (token == NULL || sscanf(token, "%d", &type_equipement) != 1) {
-            fprintf(stderr, "Format incorrect pour le type d'équipement\n");
+            JOURNALISER(JOURNAL_ERREUR, "Format incorrect pour le type d'équipement", 0, 0, 0, 0);
             continue;
         }
         
-        // Ajout d'un sommet dans le graphe pour cet équipement
-        ajouter_sommet(g);
-        
         switch (type_equipement) {
             case 2: { // Switch
                 // Format: 2;MAC;nb_ports;priorite
@@ -78,9 +80,10 @@ int charger_configuration(const char *nom_fichier, graphe *g) {
                 unsigned int priorite;
                 
                 // Lecture de l'adresse MAC
-                token = strtok(NULL, ";");
+                token = champ_suivant(&curseur);
                 if (token == NULL) {
-                    fprintf(stderr, "Format incorrect pour l'adresse MAC du switch\n");
+                    JOURNALISER(JOURNAL_ERREUR, "Format incorrect pour l'adresse MAC du switch", 0, 0, 0, 0);
+                    reseau_ajouter_inconnu(r);
                     continue;
                 }
                 // Conversion de la chaîne en adresse MAC
@@ -89,38 +92,35 @@ int charger_configuration(const char *nom_fichier, graphe *g) {
                        &mac.octet[3], &mac.octet[4], &mac.octet[5]);
                 
                 // Lecture du nombre de ports
-                token = strtok(NULL, ";");
+                token = champ_suivant(&curseur);
                 if (token == NULL || sscanf(token, "%d", &nb_ports) != 1) {
-                    fprintf(stderr, "Format incorrect pour le nombre de ports\n");
+                    JOURNALISER(JOURNAL_ERREUR, "Format incorrect pour le nombre de ports", 0, 0, 0, 0);
+                    reseau_ajouter_inconnu(r);
                     continue;
                 }
                 
                 // Lecture de la priorité
-                token = strtok(NULL, ";");
+                token = champ_suivant(&curseur);
                 if (token == NULL || sscanf(token, "%u", &priorite) != 1) {
-                    fprintf(stderr, "Format incorrect pour la priorité\n");
+                    JOURNALISER(JOURNAL_ERREUR, "Format incorrect pour la priorité", 0, 0, 0, 0);
+                    reseau_ajouter_inconnu(r);
                     continue;
                 }
                 
-                // Initialisation du switch
-                switchs[nb_switchs].mac = mac;
-                switchs[nb_switchs].nb_ports = nb_ports;
-                switchs[nb_switchs].priorite = priorite;
-                switchs[nb_switchs].table.entrees = NULL;
-                switchs[nb_switchs].table.taille = 0;
-                
-                nb_switchs++;
+                // Ajout du switch (et de son sommet) au réseau
+                reseau_ajouter_switch(r, creer_switch(mac, nb_ports, priorite));
                 break;
             }
             case 1: { // Station
                 // Format: 1;MAC;IP
                 MAC mac;
-                IPv4 ip;
+                ip_addr_t ip;
                 
                 // Lecture de l'adresse MAC
-                token = strtok(NULL, ";");
+                token = champ_suivant(&curseur);
                 if (token == NULL) {
-                    fprintf(stderr, "Format incorrect pour l'adresse MAC de la station\n");
+                    JOURNALISER(JOURNAL_ERREUR, "Format incorrect pour l'adresse MAC de la station", 0, 0, 0, 0);
+                    reseau_ajouter_inconnu(r);
                     continue;
                 }
                 // Conversion de la chaîne en adresse MAC
@@ -129,87 +129,206 @@ int charger_configuration(const char *nom_fichier, graphe *g) {
                        &mac.octet[3], &mac.octet[4], &mac.octet[5]);
                 
                 // Lecture de l'adresse IP
-                token = strtok(NULL, ";");
+                token = champ_suivant(&curseur);
                 if (token == NULL) {
-                    fprintf(stderr, "Format incorrect pour l'adresse IP\n");
+                    JOURNALISER(JOURNAL_ERREUR, "Format incorrect pour l'adresse IP", 0, 0, 0, 0);
+                    reseau_ajouter_inconnu(r);
                     continue;
                 }
                 // Conversion de la chaîne en adresse IP
                 sscanf(token, "%hhu.%hhu.%hhu.%hhu", 
                        &ip.octet[0], &ip.octet[1], &ip.octet[2], &ip.octet[3]);
                 
-                // Initialisation de la station
-                stations[nb_stations].mac = mac;
-                stations[nb_stations].ip = ip;
-                
-                nb_stations++;
+                // Ajout de la station (et de son sommet) au réseau
+                reseau_ajouter_station(r, creer_station(mac, ip));
                 break;
             }
             default:
-                fprintf(stderr, "Type d'équipement inconnu: %d\n", type_equipement);
+                JOURNALISER(JOURNAL_ERREUR, "Type d'équipement inconnu: %lld", (int64_t)type_equipement, 0, 0, 0);
+                reseau_ajouter_inconnu(r);
                 break;
         }
     }
     
     // Lecture des liens
+    PROFILER_ENTRER("liens");
     for (int i = 0; i < nombre_liens; i++) {
         if (fgets(ligne, MAX_LIGNE, f) == NULL) {
-            fprintf(stderr, "Fin de fichier inattendue lors de la lecture des liens\n");
+            JOURNALISER(JOURNAL_ERREUR, "Fin de fichier inattendue lors de la lecture des liens", 0, 0, 0, 0);
             break;
         }
         
         int equipement1, equipement2, poids;
         if (sscanf(ligne, "%d;%d;%d", &equipement1, &equipement2, &poids) != 3) {
-            fprintf(stderr, "Format incorrect pour le lien: %s", ligne);
+            JOURNALISER_TEXTE(JOURNAL_ERREUR, "Format incorrect pour le lien: %s", ligne, 0, 0, 0);
             continue;
         }
         
         // Vérifier que les indices sont valides
-        if (equipement1 >= nombre_equipements || equipement2 >= nombre_equipements) {
-            fprintf(stderr, "Indice d'équipement invalide: %d ou %d\n", equipement1, equipement2);
+        if (equipement1 < 0 || equipement2 < 0 ||
+            (size_t)equipement1 >= ordre(g) || (size_t)equipement2 >= ordre(g)) {
+            JOURNALISER(JOURNAL_ERREUR, "Indice d'équipement invalide: %lld ou %lld", (int64_t)equipement1,
+                        (int64_t)equipement2, 0, 0);
             continue;
         }
         
-        // Ajouter l'arête au graphe
-        arete a = {equipement1, equipement2};
-        if (!ajouter_arete(g, a)) {
-            fprintf(stderr, "Impossible d'ajouter l'arête entre %d et %d\n", equipement1, equipement2);
+        // Ajouter le lien au réseau (arête du graphe + câblage des ports)
+        if (!reseau_relier(r, equipement1, equipement2, poids)) {
+            JOURNALISER(JOURNAL_ERREUR, "Impossible d'ajouter l'arête entre %lld et %lld", (int64_t)equipement1,
+                        (int64_t)equipement2, 0, 0);
         }
     }
+    PROFILER_SORTIR();
     
     fclose(f);
+    return 1;
+}
+
+int lire_reseau(const char *nom_fichier, reseau_t *r) {
+    PROFILER_ENTRER("configuration");
+    int ok = lire_fichier_reseau(nom_fichier, r);
+    PROFILER_SORTIR();
+    return ok;
+}
+
+/**
+ * Affiche le résumé d'un réseau chargé : en-tête, switchs et stations
+ */
+void afficher_reseau(const reseau_t *r) {
+    const graphe *g = &r->g;
     
-    // Affichage des informations de la configuration chargée
-    printf("Configuration réseau chargée avec succès:\n");
     printf("\n=================== En-tête ==================\n");
-    printf("- %d équipements (%d switchs, %d stations)\n", nombre_equipements, nb_switchs, nb_stations);
+    printf("- %zu équipements (%zu switchs, %zu stations)\n", ordre(g), r->nb_switchs, r->nb_stations);
     printf("- %zu liens\n", nb_aretes(g));
+    printf("- %zu composante(s) connexe(s), %zu boucle(s) (liens redondants)\n", nb_composantes(g), nb_cycles(g));
     
     // Afficher les switchs
     printf("\n\n==================== Switchs ==================\n");
-    for (int i = 0; i < nb_switchs; i++) {
-        printf("Switch %d - MAC: %02X:%02X:%02X:%02X:%02X:%02X | Ports: %d | Priorité: %d\n", 
-               i,
-               switchs[i].mac.octet[0], switchs[i].mac.octet[1], switchs[i].mac.octet[2],
-               switchs[i].mac.octet[3], switchs[i].mac.octet[4], switchs[i].mac.octet[5],
-               switchs[i].nb_ports, switchs[i].priorite);
+    // dans l'ordre du fichier, même après renumérotation
+    size_t i = 0;
+    for (sommet o = 0; o < ordre(g); o++) {
+        const switch_t *sw = reseau_switch(r, sommet_depuis_origine(r, o));
+        if (sw == NULL) continue;
+        printf("Switch %zu - MAC: %02X:%02X:%02X:%02X:%02X:%02X | Ports: %d | Priorité: %d\n", 
+               i++,
+               sw->mac.octet[0], sw->mac.octet[1], sw->mac.octet[2],
+               sw->mac.octet[3], sw->mac.octet[4], sw->mac.octet[5],
+               sw->nb_ports, sw->priorite);
     }
     
     // Afficher les stations
     printf("\n\n==================== Stations ==================\n");
-    for (int i = 0; i < nb_stations; i++) {
-        printf("Station %d - MAC: %02X:%02X:%02X:%02X:%02X:%02X | IP: %d.%d.%d.%d\n", 
-               i,
-               stations[i].mac.octet[0], stations[i].mac.octet[1], stations[i].mac.octet[2],
-               stations[i].mac.octet[3], stations[i].mac.octet[4], stations[i].mac.octet[5],
-               stations[i].ip.octet[0], stations[i].ip.octet[1], 
-               stations[i].ip.octet[2], stations[i].ip.octet[3]);
+    i = 0;
+    for (sommet o = 0; o < ordre(g); o++) {
+        const station_t *st = reseau_station(r, sommet_depuis_origine(r, o));
+        if (st == NULL) continue;
+        printf("Station %zu - MAC: %02X:%02X:%02X:%02X:%02X:%02X | IP: %d.%d.%d.%d\n", 
+               i++,
+               st->mac.octet[0], st->mac.octet[1], st->mac.octet[2],
+               st->mac.octet[3], st->mac.octet[4], st->mac.octet[5],
+               st->ip.octet[0], st->ip.octet[1], 
+               st->ip.octet[2], st->ip.octet[3]);
+    }
+}
+
+/**
+ * Charge un réseau complet à partir d'un fichier de configuration et l'affiche
+ * @param nom_fichier Nom du fichier de configuration
+ * @param r Pointeur vers le réseau à remplir
+ * @return 1 si le chargement a réussi, 0 sinon
+ */
+int charger_reseau(const char *nom_fichier, reseau_t *r) {
+    init_reseau(r);
+    if (!lire_reseau(nom_fichier, r)) {
+        deinit_reseau(r);
+        return 0;
+    }
+    
+    printf("Configuration réseau chargée avec succès:\n");
+    afficher_reseau(r);
+    return 1;
+}
+
+/**
+ * Charge la configuration réseau à partir d'un fichier
+ * @param nom_fichier Nom du fichier de configuration
+ * @param g Pointeur vers le graphe à remplir
+ * @return 1 si le chargement a réussi, 0 sinon
+ */
+int charger_configuration(const char *nom_fichier, graphe *g) {
+    reseau_t r;
+    if (!charger_reseau(nom_fichier, &r)) {
+        return 0;
     }
     
-    // Libérer la mémoire
-    free(switchs);
-    free(stations);
+    // Seul le graphe est conservé : il est transféré à l'appelant
+    *g = r.g;
+    init_graphe(&r.g);
+    deinit_reseau(&r);
     
     return 1;
 }
 
+/**
+ * Applique un fichier de modifications (delta) à un réseau déjà chargé,
+ * sans relire la topologie de base. Une modification par ligne :
+ *   +;<equipement1>;<equipement2>;<poids>   ajout d'un lien
+ *   -;<equipement1>;<equipement2>           retrait d'un lien
+ *   =;<equipement1>;<equipement2>;<poids>   nouveau poids d'un lien
+ *   P;<switch>;<priorite>                   nouvelle priorité d'un switch
+ * Les lignes vides et celles commençant par '#' sont ignorées. Les indices sont
+ * ceux du fichier de configuration, même si le réseau a été renuméroté.
+ * @param nom_fichier Nom du fichier de modifications
+ * @param r Réseau à modifier
+ * @return Le nombre de modifications appliquées, -1 si le fichier est illisible
+ */
+int appliquer_delta(const char *nom_fichier, reseau_t *r) {
+    FILE *f = fopen(nom_fichier, "r");
+    if (!f) {
+        perror("Erreur d'ouverture du fichier");
+        return -1;
+    }
+    
+    char ligne[MAX_LIGNE];
+    int nb_appliquees = 0;
+    int numero = 0;
+    
+    while (fgets(ligne, MAX_LIGNE, f) != NULL) {
+        numero++;
+        if (ligne[0] == '#' || ligne[0] == '\n' || ligne[0] == '\r' || ligne[0] == '\0') {
+            continue;
+        }
+        
+        int a, b, valeur;
+        bool ok = false;
+        switch (ligne[0]) {
+            case '+':
+                ok = sscanf(ligne + 1, ";%d;%d;%d", &a, &b, &valeur) == 3 && a >= 0 && b >= 0
+                     && reseau_relier(r, sommet_depuis_origine(r, a), sommet_depuis_origine(r, b), valeur);
+                break;
+            case '-':
+                ok = sscanf(ligne + 1, ";%d;%d", &a, &b) == 2 && a >= 0 && b >= 0
+                     && reseau_delier(r, sommet_depuis_origine(r, a), sommet_depuis_origine(r, b));
+                break;
+            case '=':
+                ok = sscanf(ligne + 1, ";%d;%d;%d", &a, &b, &valeur) == 3 && a >= 0 && b >= 0
+                     && reseau_modifier_poids(r, sommet_depuis_origine(r, a), sommet_depuis_origine(r, b), valeur);
+                break;
+            case 'P':
+                ok = sscanf(ligne + 1, ";%d;%d", &a, &valeur) == 2 && a >= 0
+                     && reseau_modifier_priorite(r, sommet_depuis_origine(r, a), valeur);
+                break;
+            default:
+                break;
+        }
+        
+        if (ok) {
+            nb_appliquees++;
+        } else {
+            JOURNALISER_TEXTE(JOURNAL_AVERTISSEMENT, "Modification ignorée: %s (ligne %llu)", ligne, numero, 0, 0);
+        }
+    }
+    
+    fclose(f);
+    return nb_appliquees;
+}
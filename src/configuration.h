@@ -4,9 +4,14 @@
 #include "station.h"
 #include "switch.h"
 #include "graphe.h"
+#include "reseau.h"
 
 #define MAX_LIGNE 256
 
 int charger_configuration(const char *nom_fichier, graphe *g);
+int lire_reseau(const char *nom_fichier, reseau_t *r);
+int charger_reseau(const char *nom_fichier, reseau_t *r);
+void afficher_reseau(const reseau_t *r);
+int appliquer_delta(const char *nom_fichier, reseau_t *r);
 
 #endif
\ No newline at end of file
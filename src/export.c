@@ -0,0 +1,152 @@
+#include "export.h"
+#include "journal.h"
+#include <string.h>
+
+// Port du switch s relié à voisin, -1 pour une station ou un équipement inconnu
+static int port_vers(const reseau_t *r, sommet s, sommet voisin) {
+    const switch_t *sw = reseau_switch(r, s);
+    if (sw == NULL) return -1;
+
+    for (int p = 0; p < sw->nb_ports; p++) {
+        if (sw->ports[p].voisin == voisin) return p;
+    }
+    return -1;
+}
+
+// Extrémité de switch qui ne relaie pas ; une station relaie toujours
+static bool extremite_bloquee(const reseau_t *r, sommet s, int port) {
+    const switch_t *sw = reseau_switch(r, s);
+    if (sw == NULL) return false;
+    if (!port_est_actif(sw, port)) return true;
+
+    etat_port_t etat = get_etat_port(sw, port);
+    return etat == PORT_BLOQUE || etat == PORT_ALTERNATIF || etat == PORT_SECOURS;
+}
+
+static const char *nom_type(const reseau_t *r, sommet s) {
+    switch (r->equipements[s].type) {
+        case EQUIPEMENT_SWITCH: return "switch";
+        case EQUIPEMENT_STATION: return "station";
+        default: return "inconnu";
+    }
+}
+
+// Liens à la suite, extrémités dans leur numérotation d'origine
+typedef void (*ecrire_lien_t)(FILE *f, const reseau_t *r, const arete *a, int port1, int port2, bool bloque);
+
+static void parcourir_liens(FILE *f, const reseau_t *r, ecrire_lien_t ecrire_lien) {
+    for (size_t i = 0; i < r->g.nb_aretes; i++) {
+        const arete *a = &r->g.aretes[i];
+        int port1 = port_vers(r, a->s1, a->s2), port2 = port_vers(r, a->s2, a->s1);
+        bool bloque = extremite_bloquee(r, a->s1, port1) || extremite_bloquee(r, a->s2, port2);
+        ecrire_lien(f, r, a, port1, port2, bloque);
+    }
+}
+
+static void ecrire_extremite_dot(FILE *f, const reseau_t *r, sommet s, int port, const char *cote) {
+    if (reseau_switch(r, s) == NULL) return;
+
+    const char *role = etat_port_to_string(get_etat_port(reseau_switch(r, s), port));
+    fprintf(f, ", %slabel=\"%d %s\", port_%s=%d, role_%s=\"%s\"", cote, port, role, cote, port, cote, role);
+}
+
+static void ecrire_lien_dot(FILE *f, const reseau_t *r, const arete *a, int port1, int port2, bool bloque) {
+    fprintf(f, "  n%zu -- n%zu [label=\"%d\", poids=%d", sommet_origine(r, a->s1), sommet_origine(r, a->s2), a->poids,
+            a->poids);
+    ecrire_extremite_dot(f, r, a->s1, port1, "tail");
+    ecrire_extremite_dot(f, r, a->s2, port2, "head");
+    fprintf(f, bloque ? ", bloque=true, style=dashed, color=red];\n" : "];\n");
+}
+
+bool exporter_dot(FILE *f, const reseau_t *r) {
+    if (f == NULL || r == NULL) return false;
+
+    char mac[18], ip[16];
+    fprintf(f, "graph reseau {\n");
+    fprintf(f, "  node [fontname=\"Helvetica\", fontsize=10];\n  edge [fontname=\"Helvetica\", fontsize=8];\n");
+    for (sommet o = 0; o < ordre(&r->g); o++) {
+        sommet s = sommet_depuis_origine(r, o);
+        const switch_t *sw = reseau_switch(r, s);
+        const station_t *st = reseau_station(r, s);
+        if (sw != NULL) {
+            mac_to_string(sw->mac, mac);
+            fprintf(f, "  n%zu [shape=box, label=\"%zu\\n%s\\nprio %d\", type=\"switch\", mac=\"%s\", priorite=%d];\n",
+                    o, o, mac, sw->priorite, mac, sw->priorite);
+        } else if (st != NULL) {
+            mac_to_string(st->mac, mac);
+            ip_to_string(st->ip, ip);
+            fprintf(f, "  n%zu [shape=ellipse, label=\"%zu\\n%s\", type=\"station\", mac=\"%s\", ip=\"%s\"];\n", o, o,
+                    ip, mac, ip);
+        } else {
+            fprintf(f, "  n%zu [shape=diamond, label=\"%zu\", type=\"%s\"];\n", o, o, nom_type(r, s));
+        }
+    }
+    parcourir_liens(f, r, ecrire_lien_dot);
+    fprintf(f, "}\n");
+    return !ferror(f);
+}
+
+static void ecrire_extremite_graphml(FILE *f, const reseau_t *r, sommet s, int port, const char *cote) {
+    if (reseau_switch(r, s) == NULL) return;
+
+    fprintf(f, "<data key=\"port_%s\">%d</data><data key=\"role_%s\">%s</data>", cote, port, cote,
+            etat_port_to_string(get_etat_port(reseau_switch(r, s), port)));
+}
+
+static void ecrire_lien_graphml(FILE *f, const reseau_t *r, const arete *a, int port1, int port2, bool bloque) {
+    fprintf(f, "    <edge source=\"n%zu\" target=\"n%zu\"><data key=\"poids\">%d</data>", sommet_origine(r, a->s1),
+            sommet_origine(r, a->s2), a->poids);
+    ecrire_extremite_graphml(f, r, a->s1, port1, "source");
+    ecrire_extremite_graphml(f, r, a->s2, port2, "cible");
+    fprintf(f, "<data key=\"bloque\">%s</data></edge>\n", bloque ? "true" : "false");
+}
+
+bool exporter_graphml(FILE *f, const reseau_t *r) {
+    if (f == NULL || r == NULL) return false;
+
+    static const char *cles[][4] = {
+        {"type", "node", "string"},    {"mac", "node", "string"},         {"ip", "node", "string"},
+        {"priorite", "node", "int"},   {"poids", "edge", "int"},          {"port_source", "edge", "int"},
+        {"role_source", "edge", "string"}, {"port_cible", "edge", "int"}, {"role_cible", "edge", "string"},
+        {"bloque", "edge", "boolean"}
+    };
+    char mac[18], ip[16];
+    fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(f, "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n");
+    for (size_t k = 0; k < sizeof(cles) / sizeof(cles[0]); k++) {
+        fprintf(f, "  <key id=\"%s\" for=\"%s\" attr.name=\"%s\" attr.type=\"%s\"/>\n", cles[k][0], cles[k][1],
+                cles[k][0], cles[k][2]);
+    }
+    fprintf(f, "  <graph id=\"reseau\" edgedefault=\"undirected\">\n");
+    for (sommet o = 0; o < ordre(&r->g); o++) {
+        sommet s = sommet_depuis_origine(r, o);
+        const switch_t *sw = reseau_switch(r, s);
+        const station_t *st = reseau_station(r, s);
+        fprintf(f, "    <node id=\"n%zu\"><data key=\"type\">%s</data>", o, nom_type(r, s));
+        if (sw != NULL) {
+            fprintf(f, "<data key=\"mac\">%s</data><data key=\"priorite\">%d</data>", mac_to_string(sw->mac, mac),
+                    sw->priorite);
+        } else if (st != NULL) {
+            fprintf(f, "<data key=\"mac\">%s</data><data key=\"ip\">%s</data>", mac_to_string(st->mac, mac),
+                    ip_to_string(st->ip, ip));
+        }
+        fprintf(f, "</node>\n");
+    }
+    parcourir_liens(f, r, ecrire_lien_graphml);
+    fprintf(f, "  </graph>\n</graphml>\n");
+    return !ferror(f);
+}
+
+bool exporter_reseau(const char *nom_fichier, const reseau_t *r) {
+    if (nom_fichier == NULL || r == NULL) return false;
+
+    FILE *f = fopen(nom_fichier, "w");
+    if (f == NULL) {
+        JOURNALISER_TEXTE(JOURNAL_ERREUR, "Erreur d'ouverture du fichier %s", nom_fichier, 0, 0, 0);
+        return false;
+    }
+    size_t n = strlen(nom_fichier);
+    bool graphml = n >= 8 && strcmp(nom_fichier + n - 8, ".graphml") == 0;
+    bool ok = graphml ? exporter_graphml(f, r) : exporter_dot(f, r);
+    return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "reseau.h"
+
+// Export de la topologie pour les outils externes (Graphviz, Gephi, yEd...) :
+// équipements avec leurs attributs, liens avec leur coût, ports et rôle STP à
+// chaque extrémité. Un lien dont un port de switch est bloqué, alternatif, de
+// secours ou inactif est marqué bloqué (pointillés rouges en DOT). L'écriture
+// se fait en un passage sur les sommets puis les arêtes, sans mémoire
+// supplémentaire ; les sommets gardent leur indice d'origine.
+bool exporter_dot(FILE *f, const reseau_t *r);
+bool exporter_graphml(FILE *f, const reseau_t *r);
+
+// Format choisi par l'extension : .graphml pour GraphML, DOT sinon
+bool exporter_reseau(const char *nom_fichier, const reseau_t *r);
@@ -1,4 +1,8 @@
 #include "graphe.h"
+#include "memoire.h"
+#include "profileur.h"
+#include <stdint.h>
+#include <string.h>
 
 void init_graphe(graphe *g)
 {
@@ -9,9 +13,22 @@ void init_graphe(graphe *g)
     g->ordre  = 0;
     // - allocation d'un tableau d'arêtes de capacité initiale 8
     g->aretes_capacite = 8;
-    g->aretes = malloc(g->aretes_capacite * sizeof(arete));
+    g->aretes = allouer_memoire(MEMOIRE_GRAPHE, g->aretes_capacite * sizeof(arete));
     // - le graphe ne contient initialement ni sommet ni arête
     g->nb_aretes = 0;
+    // - index des arêtes de capacité double de celle du tableau d'arêtes
+    g->index_capacite = 2 * g->aretes_capacite;
+    g->index_aretes = allouer_memoire(MEMOIRE_GRAPHE, g->index_capacite * sizeof(size_t));
+    for(size_t c = 0; g->index_aretes != NULL && c < g->index_capacite; c++){
+        g->index_aretes[c] = UNKNOWN_INDEX;
+    }
+    // - union-find de capacité initiale 8, aucune composante
+    g->sommets_capacite = 8;
+    g->uf_parent = allouer_memoire(MEMOIRE_GRAPHE, g->sommets_capacite * sizeof(sommet));
+    g->uf_rang = allouer_memoire(MEMOIRE_GRAPHE, g->sommets_capacite * sizeof(unsigned char));
+    g->nb_composantes = 0;
+    g->nb_cycles = 0;
+    g->composantes_perimees = false;
 }
 
 void deinit_graphe(graphe *g)
@@ -20,12 +37,39 @@ void deinit_graphe(graphe *g)
         return;
     }
     // libère la mémoire qui avait été allouée dans la fonction init_graphe
-    free(g->aretes);
+    liberer_memoire(MEMOIRE_GRAPHE, g->aretes, g->aretes_capacite * sizeof(arete));
     g->aretes = NULL;
+    liberer_memoire(MEMOIRE_GRAPHE, g->index_aretes, g->index_capacite * sizeof(size_t));
+    g->index_aretes = NULL;
+    liberer_memoire(MEMOIRE_GRAPHE, g->uf_parent, g->sommets_capacite * sizeof(sommet));
+    g->uf_parent = NULL;
+    liberer_memoire(MEMOIRE_GRAPHE, g->uf_rang, g->sommets_capacite * sizeof(unsigned char));
+    g->uf_rang = NULL;
     // réinitialise les champs internes du graphe g
     g->ordre = 0;
     g->aretes_capacite = 0;
     g->nb_aretes = 0;
+    g->index_capacite = 0;
+    g->sommets_capacite = 0;
+    g->nb_composantes = 0;
+    g->nb_cycles = 0;
+    g->composantes_perimees = false;
+}
+
+void vider_graphe(graphe *g)
+{
+    if(g == NULL){
+        return;
+    }
+    // retire sommets et arêtes sans libérer les tableaux
+    for(size_t c = 0; c < g->index_capacite; c++){
+        g->index_aretes[c] = UNKNOWN_INDEX;
+    }
+    g->ordre = 0;
+    g->nb_aretes = 0;
+    g->nb_composantes = 0;
+    g->nb_cycles = 0;
+    g->composantes_perimees = false;
 }
 
 size_t ordre(graphe const *g)
@@ -38,9 +82,75 @@ size_t nb_aretes(graphe const *g)
     return g->nb_aretes;
 }
 
-void ajouter_sommet(graphe *g)
+bool ajouter_sommet(graphe *g)
 {
+    if (g == NULL)
+        return false;
+    // le nouveau sommet forme à lui seul une composante connexe
+    if(g->ordre >= g->sommets_capacite){
+        // les deux tableaux grandissent ensemble ou pas du tout : leur taille
+        // reste celle de sommets_capacite pour reallouer_memoire et liberer_memoire
+        size_t nouvelle_capacite = (g->sommets_capacite == 0) ? 8 : g->sommets_capacite * 2;
+        unsigned char *nouveau_rang = allouer_memoire(MEMOIRE_GRAPHE, nouvelle_capacite * sizeof(unsigned char));
+        if(nouveau_rang == NULL)
+            return false;
+        sommet *nouveau_parent = reallouer_memoire(MEMOIRE_GRAPHE, g->uf_parent,
+                                                   g->sommets_capacite * sizeof(sommet),
+                                                   nouvelle_capacite * sizeof(sommet));
+        if(nouveau_parent == NULL){
+            liberer_memoire(MEMOIRE_GRAPHE, nouveau_rang, nouvelle_capacite * sizeof(unsigned char));
+            return false;
+        }
+        if(g->ordre > 0)
+            memcpy(nouveau_rang, g->uf_rang, g->ordre * sizeof(unsigned char));
+        liberer_memoire(MEMOIRE_GRAPHE, g->uf_rang, g->sommets_capacite * sizeof(unsigned char));
+        g->uf_parent = nouveau_parent;
+        g->uf_rang = nouveau_rang;
+        g->sommets_capacite = nouvelle_capacite;
+    }
+    g->uf_parent[g->ordre] = g->ordre;
+    g->uf_rang[g->ordre] = 0;
+    g->nb_composantes += 1;
     g->ordre += 1;
+    return true;
+
+    // retourne true si le sommet a bien été ajouté, false sinon
+}
+
+// représentant de la composante de s, avec compression de chemin
+// (uf_parent n'est pas const même si g l'est : la compression ne change pas les réponses)
+static sommet trouver(graphe const *g, sommet s)
+{
+    sommet racine = s;
+    while(g->uf_parent[racine] != racine){
+        racine = g->uf_parent[racine];
+    }
+    while(g->uf_parent[s] != racine){
+        sommet suivant = g->uf_parent[s];
+        g->uf_parent[s] = racine;
+        s = suivant;
+    }
+    return racine;
+}
+
+// fusionne les composantes de s1 et s2 (union par rang),
+// retourne false si elles étaient déjà confondues
+static bool unir(graphe *g, sommet s1, sommet s2)
+{
+    sommet r1 = trouver(g, s1);
+    sommet r2 = trouver(g, s2);
+    if(r1 == r2)
+        return false;
+    if(g->uf_rang[r1] < g->uf_rang[r2]){
+        sommet tmp = r1;
+        r1 = r2;
+        r2 = tmp;
+    }
+    g->uf_parent[r2] = r1;
+    if(g->uf_rang[r1] == g->uf_rang[r2])
+        g->uf_rang[r1]++;
+    g->nb_composantes--;
+    return true;
 }
 
 size_t index_sommet(graphe const *g, sommet s)
@@ -55,26 +165,104 @@ size_t index_sommet(graphe const *g, sommet s)
     return UNKNOWN_INDEX;
 }
 
-// une fonction locale "static arete swap_sommets(arete a)" pourra être utile
-static arete swap_sommets(arete a){
-    arete areteInversee = {a.s2, a.s1};
-    return areteInversee;
+static size_t hacher_arete(sommet s1, sommet s2)
+{
+    // (s1,s2) et (s2,s1) doivent tomber dans la même case
+    if(s1 > s2){
+        sommet tmp = s1;
+        s1 = s2;
+        s2 = tmp;
+    }
+    uint64_t h = ((uint64_t)s1 << 32) ^ (uint64_t)s2 ^ ((uint64_t)s2 >> 32);
+    h *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h ^ (h >> 29));
 }
-// cette fonction retourne une nouvelle arête dont les sommets sont les même que l'arête reçue mais inversés
 
-bool existe_arete(graphe const *g, arete a)
+static bool memes_sommets(arete a, arete b)
 {
-    // retourne true si l'arête a est contenue dans le graphe g, false sinon
-    for(int i = 0; i < g->nb_aretes; i++){
-        if ((g->aretes[i].s1 == a.s1 && g->aretes[i].s2 == a.s2) || (g->aretes[i].s1 == a.s2 && g->aretes[i].s2 == a.s1)){
-            return true;
+    return (a.s1 == b.s1 && a.s2 == b.s2) || (a.s1 == b.s2 && a.s2 == b.s1);
+}
+
+// case de l'index contenant l'arête a, ou première case libre rencontrée
+static size_t case_arete(graphe const *g, arete a)
+{
+    size_t masque = g->index_capacite - 1;
+    size_t c = hacher_arete(a.s1, a.s2) & masque;
+    while(g->index_aretes[c] != UNKNOWN_INDEX && !memes_sommets(g->aretes[g->index_aretes[c]], a)){
+        c = (c + 1) & masque;
+    }
+    return c;
+}
+
+// libère une case de l'index en recalant les arêtes suivantes du même agrégat
+static void liberer_case_arete(graphe *g, size_t c)
+{
+    size_t masque = g->index_capacite - 1;
+    size_t vide = c;
+    g->index_aretes[vide] = UNKNOWN_INDEX;
+    for(size_t i = (vide + 1) & masque; g->index_aretes[i] != UNKNOWN_INDEX; i = (i + 1) & masque){
+        arete const *e = &g->aretes[g->index_aretes[i]];
+        size_t ideale = hacher_arete(e->s1, e->s2) & masque;
+        if(((i - ideale) & masque) >= ((i - vide) & masque)){
+            g->index_aretes[vide] = g->index_aretes[i];
+            g->index_aretes[i] = UNKNOWN_INDEX;
+            vide = i;
+        }
+    }
+}
+
+static bool redimensionner_index_aretes(graphe *g, size_t nouvelle_capacite)
+{
+    size_t *nouvel_index = allouer_memoire(MEMOIRE_GRAPHE, nouvelle_capacite * sizeof(size_t));
+    if(nouvel_index == NULL)
+        return false;
+    liberer_memoire(MEMOIRE_GRAPHE, g->index_aretes, g->index_capacite * sizeof(size_t));
+    g->index_aretes = nouvel_index;
+    g->index_capacite = nouvelle_capacite;
+    for(size_t c = 0; c < nouvelle_capacite; c++){
+        g->index_aretes[c] = UNKNOWN_INDEX;
+    }
+    for(size_t i = 0; i < g->nb_aretes; i++){
+        g->index_aretes[case_arete(g, g->aretes[i])] = i;
+    }
+    return true;
+}
+
+// recalcule l'union-find à partir des arêtes restantes
+static void reconstruire_composantes(graphe *g)
+{
+    PROFILER_ENTRER("composantes");
+    for(sommet s = 0; s < g->ordre; s++){
+        g->uf_parent[s] = s;
+        g->uf_rang[s] = 0;
     }
+    g->nb_composantes = g->ordre;
+    g->nb_cycles = 0;
+    for(size_t i = 0; i < g->nb_aretes; i++){
+        g->aretes[i].ferme_boucle = !unir(g, g->aretes[i].s1, g->aretes[i].s2);
+        if(g->aretes[i].ferme_boucle)
+            g->nb_cycles++;
     }
+    g->composantes_perimees = false;
+    PROFILER_SORTIR();
+}
+
+// recalcule l'union-find s'il a été périmé par des suppressions
+// (comme trouver, modifie les champs internes de g sans changer les réponses)
+static void composantes_a_jour(graphe const *g)
+{
+    if(g->composantes_perimees)
+        reconstruire_composantes((graphe *)g);
+}
+
+bool existe_arete(graphe const *g, arete a)
+{
+    // retourne true si l'arête a est contenue dans g, false sinon
     // /!\ l'arête (s1,s2) et l'arête (s2,s1) sont considérées équivalentes
-    return false;
+    return index_arete(g, a) != UNKNOWN_INDEX;
 }
 
-bool ajouter_arete(graphe *g, arete a)
+static bool inserer_arete(graphe *g, arete a)
 {
     if (g == NULL)
         return false;
@@ -89,39 +277,87 @@ bool ajouter_arete(graphe *g, arete a)
     if(existe_arete(g, a)){
         return false;
     }
-    if(existe_arete(g, swap_sommets(a))){
-        return false;
-    }
     // /!\ si la capacité actuelle du tableau d'arêtes n'est pas suffisante,
     // /!\ il faut le réallouer.
     // /!\ on peut par exemple doubler la capacité du tableau actuel.
     if(g->nb_aretes >= g->aretes_capacite){
         size_t nouvelle_capacite = (g->aretes_capacite == 0) ? 8 : g->aretes_capacite * 2;
-        arete *nouveau_tableau = (arete *)realloc(g->aretes, nouvelle_capacite * sizeof(arete));
+        arete *nouveau_tableau = (arete *)reallouer_memoire(MEMOIRE_GRAPHE, g->aretes,
+                                                              g->aretes_capacite * sizeof(arete),
+                                                              nouvelle_capacite * sizeof(arete));
         if(nouveau_tableau == NULL)
             return false;
         g->aretes = nouveau_tableau;
         g->aretes_capacite = nouvelle_capacite;
+        if(!redimensionner_index_aretes(g, 2 * nouvelle_capacite))
+            return false;
     }
+    // une arête entre deux sommets déjà connectés ferme une boucle
+    composantes_a_jour(g);
+    a.ferme_boucle = !unir(g, a.s1, a.s2);
+    if(a.ferme_boucle)
+        g->nb_cycles++;
     g->aretes[g->nb_aretes] = a;
+    g->index_aretes[case_arete(g, a)] = g->nb_aretes;
     g->nb_aretes++;
     return true;
 
     // retourne true si l'arête a bien été ajoutée, false sinon
 }
 
+bool ajouter_arete(graphe *g, arete a)
+{
+    PROFILER_ENTRER("ajout_arete");
+    bool ok = inserer_arete(g, a);
+    PROFILER_SORTIR();
+    return ok;
+}
+
 size_t index_arete(graphe const *g, arete a)
 {
     // retourne l'index de l'arête au sein du tableau d'arêtes de g si l'arête a existe dans g,
     // la valeur UNKNOWN_INDEX sinon
-    if(existe_arete(g, a) == true || existe_arete(g, swap_sommets(a)) == true){
-        for(int i = 0; i < g->nb_aretes;i++){
-            if ((g->aretes[i].s1 == a.s1 && g->aretes[i].s2 == a.s2) || (g->aretes[i].s1 == a.s2 && g->aretes[i].s2 == a.s1)){
-                return i;
-            }
-        }
+    if(g == NULL || g->nb_aretes == 0)
+        return UNKNOWN_INDEX;
+    return g->index_aretes[case_arete(g, a)];
+}
+
+static bool retirer_arete(graphe *g, arete a)
+{
+    // retire l'arête a de g en temps constant : la dernière arête du tableau
+    // prend sa place (l'index des arêtes est mis à jour en conséquence)
+    size_t c;
+    if(g == NULL || g->nb_aretes == 0 || g->index_aretes[c = case_arete(g, a)] == UNKNOWN_INDEX)
+        return false;
+
+    size_t i = g->index_aretes[c];
+    bool redondante = !g->composantes_perimees && g->aretes[i].ferme_boucle;
+    liberer_case_arete(g, c);
+
+    size_t derniere = g->nb_aretes - 1;
+    if(i != derniere){
+        g->index_aretes[case_arete(g, g->aretes[derniere])] = i;
+        g->aretes[i] = g->aretes[derniere];
     }
-    return UNKNOWN_INDEX;
+    g->nb_aretes--;
+
+    // une arête redondante ne porte pas la forêt couvrante de l'union-find :
+    // la connexité est inchangée. Sinon la composante a pu se scinder : le
+    // recalcul est différé à la prochaine requête, une série de suppressions
+    // n'en coûte qu'un.
+    if(redondante)
+        g->nb_cycles--;
+    else
+        g->composantes_perimees = true;
+    return true;
+}
+
+bool supprimer_arete(graphe *g, arete a)
+{
+    PROFILER_ENTRER("suppression_arete");
+    bool ok = retirer_arete(g, a);
+    PROFILER_SORTIR();
+    return ok;
 }
 
 size_t sommets_adjacents(graphe const *g, sommet s, sommet sa[])
@@ -133,13 +369,61 @@ size_t sommets_adjacents(graphe const *g, sommet s, sommet sa[])
     int index = 0;
     for(int i = 0; i < g->nb_aretes; i++){
         if(g->aretes[i].s1 == s){
-            sa[index] = g->aretes[i].s1;
+            sa[index] = g->aretes[i].s2;
             index ++;
         }
         if(g-> aretes[i].s2 == s){
-            sa[index] = g->aretes[i].s2;
+            sa[index] = g->aretes[i].s1;
             index ++;
         }
     }
     return index;
 }
+
+sommet composante(graphe const *g, sommet s)
+{
+    // identifiant de la composante connexe de s (le représentant union-find),
+    // UNKNOWN_INDEX si s n'existe pas dans g
+    if(g == NULL || s >= g->ordre)
+        return UNKNOWN_INDEX;
+    composantes_a_jour(g);
+    return trouver(g, s);
+}
+
+bool meme_composante(graphe const *g, sommet s1, sommet s2)
+{
+    if(g == NULL || s1 >= g->ordre || s2 >= g->ordre)
+        return false;
+    composantes_a_jour(g);
+    return trouver(g, s1) == trouver(g, s2);
+}
+
+size_t nb_composantes(graphe const *g)
+{
+    composantes_a_jour(g);
+    return g->nb_composantes;
+}
+
+size_t nb_cycles(graphe const *g)
+{
+    // nombre cyclomatique : arêtes - sommets + composantes,
+    // soit exactement le nombre d'arêtes redondantes
+    composantes_a_jour(g);
+    return g->nb_cycles;
+}
+
+bool ferme_boucle(graphe const *g, arete a)
+{
+    // retourne true si l'ajout de l'arête a à g fermerait une boucle
+    return meme_composante(g, a.s1, a.s2);
+}
+
+bool arete_redondante(graphe const *g, size_t i)
+{
+    // retourne true si l'arête d'index i reliait, lors de son ajout,
+    // deux sommets déjà connectés (lien redondant pour STP)
+    if(g == NULL || i >= g->nb_aretes)
+        return false;
+    composantes_a_jour(g);
+    return g->aretes[i].ferme_boucle;
+}
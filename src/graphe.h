@@ -10,6 +10,8 @@ typedef struct arete
 {
     sommet s1;
     sommet s2;
+    int poids;         // coût du lien (100 : 10 Mb/s, 19 : 100 Mb/s, 4 : 1 Gb/s)
+    bool ferme_boucle; // renseigné par ajouter_arete : l'arête reliait deux sommets déjà connectés
 } arete;
 
 typedef struct graphe
@@ -18,20 +20,45 @@ typedef struct graphe
     arete *aretes;
     size_t aretes_capacite;
     size_t nb_aretes;
+    // index des arêtes : hachage (adressage ouvert) de la paire de sommets
+    // vers l'index dans aretes, UNKNOWN_INDEX pour une case libre
+    size_t *index_aretes;
+    size_t index_capacite;
+    // union-find (compression de chemin + union par rang) tenu à jour
+    // par ajouter_sommet et ajouter_arete ; la suppression d'une arête non
+    // redondante le marque périmé, il est recalculé à la requête suivante
+    sommet *uf_parent;
+    unsigned char *uf_rang;
+    size_t sommets_capacite;
+    size_t nb_composantes;
+    size_t nb_cycles;
+    bool composantes_perimees;
 } graphe;
 
 static const size_t UNKNOWN_INDEX = -1;
 
 void init_graphe(graphe *g);
 void deinit_graphe(graphe *g);
+void vider_graphe(graphe *g);
 
 size_t ordre(graphe const *g);
 size_t nb_aretes(graphe const *g);
 
-void ajouter_sommet(graphe *g);
+bool ajouter_sommet(graphe *g);
 size_t index_sommet(graphe const *g, sommet s);
 bool existe_arete(graphe const *g, arete a);
 bool ajouter_arete(graphe *g, arete a);
+bool supprimer_arete(graphe *g, arete a);
 size_t index_arete(graphe const *g, arete a);
 
 size_t sommets_adjacents(graphe const *g, sommet s, sommet sa[]);
+
+// Connexité (union-find) : requêtes en temps quasi constant, sauf la première
+// après une ou plusieurs suppressions d'arêtes non redondantes, qui recalcule
+// l'union-find en O(V+E) une seule fois pour toute la série de suppressions
+sommet composante(graphe const *g, sommet s);
+bool meme_composante(graphe const *g, sommet s1, sommet s2);
+size_t nb_composantes(graphe const *g);
+size_t nb_cycles(graphe const *g);
+bool ferme_boucle(graphe const *g, arete a);
+bool arete_redondante(graphe const *g, size_t i);
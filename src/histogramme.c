@@ -0,0 +1,98 @@
+#include "histogramme.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SOUS_CASES (1 << HISTO_BITS_PRECISION)
+
+// Indice de case : les valeurs < 2 * SOUS_CASES ont chacune leur case, au-delà
+// la valeur est ramenée à ses HISTO_BITS_PRECISION + 1 bits de poids fort
+static inline int indice_case(uint64_t valeur) {
+    if (valeur < 2 * SOUS_CASES) return (int)valeur;
+
+    int decalage = (63 - __builtin_clzll(valeur)) - HISTO_BITS_PRECISION;
+    return (decalage << HISTO_BITS_PRECISION) + (int)(valeur >> decalage);
+}
+
+// Plus grande valeur rangée dans la case
+static uint64_t borne_haute(int indice) {
+    if (indice < 2 * SOUS_CASES) return (uint64_t)indice;
+
+    int decalage = (indice >> HISTO_BITS_PRECISION) - 1;
+    uint64_t mantisse = (uint64_t)(indice - (decalage << HISTO_BITS_PRECISION));
+    return (mantisse << decalage) + (((uint64_t)1 << decalage) - 1);
+}
+
+void init_histogramme(histogramme_t *h) {
+    if (h == NULL) return;
+
+    memset(h->cases, 0, sizeof(h->cases));
+    h->nb = 0;
+    h->min = UINT64_MAX;
+    h->max = 0;
+    h->somme = 0.0;
+}
+
+void enregistrer_valeur(histogramme_t *h, uint64_t valeur) {
+    h->cases[indice_case(valeur)]++;
+    h->nb++;
+    h->somme += (double)valeur;
+    if (valeur < h->min) h->min = valeur;
+    if (valeur > h->max) h->max = valeur;
+}
+
+void fusionner_histogrammes(histogramme_t *dest, const histogramme_t *src) {
+    // les cases étant identiques pour tous les histogrammes, la fusion est exacte
+    if (dest == NULL || src == NULL || src->nb == 0) return;
+
+    for (int i = 0; i < NB_CASES_HISTOGRAMME; i++) {
+        dest->cases[i] += src->cases[i];
+    }
+    dest->nb += src->nb;
+    dest->somme += src->somme;
+    if (src->min < dest->min) dest->min = src->min;
+    if (src->max > dest->max) dest->max = src->max;
+}
+
+/**
+ * Valeur en dessous de laquelle se trouvent percentile % des enregistrements
+ * (borne haute de la case, plafonnée au maximum observé)
+ * @return 0 si l'histogramme est vide
+ */
+uint64_t valeur_percentile(const histogramme_t *h, double percentile) {
+    if (h == NULL || h->nb == 0) return 0;
+    if (percentile >= 100.0) return h->max;
+
+    // rang = plafond(percentile * nb / 100), au moins 1
+    double position = percentile / 100.0 * h->nb;
+    uint64_t rang = (uint64_t)position;
+    if ((double)rang < position || rang == 0) rang++;
+
+    uint64_t cumul = 0;
+    for (int i = 0; i < NB_CASES_HISTOGRAMME; i++) {
+        cumul += h->cases[i];
+        if (cumul >= rang) {
+            uint64_t v = borne_haute(i);
+            return (v > h->max) ? h->max : v;
+        }
+    }
+    return h->max;
+}
+
+double moyenne_histogramme(const histogramme_t *h) {
+    return (h == NULL || h->nb == 0) ? 0.0 : h->somme / h->nb;
+}
+
+void afficher_histogramme(const histogramme_t *h, const char *nom, const char *unite, double diviseur) {
+    if (h == NULL) return;
+
+    if (h->nb == 0) {
+        printf("  %s : aucune mesure\n", nom);
+        return;
+    }
+    printf("  %s (%llu mesures, %s) : min %.3f | moy %.3f | p50 %.3f | p90 %.3f | p99 %.3f | p99.9 %.3f | max %.3f\n",
+           nom, (unsigned long long)h->nb, unite,
+           h->min / diviseur, moyenne_histogramme(h) / diviseur,
+           valeur_percentile(h, 50.0) / diviseur, valeur_percentile(h, 90.0) / diviseur,
+           valeur_percentile(h, 99.0) / diviseur, valeur_percentile(h, 99.9) / diviseur,
+           h->max / diviseur);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Histogramme à cases logarithmiques (façon HDR) : chaque puissance de 2 est
+// découpée en 64 sous-cases, soit une erreur relative inférieure à 1/64 sur
+// toute la plage des uint64_t. Enregistrement en temps constant, taille fixe.
+#define HISTO_BITS_PRECISION 6
+#define NB_CASES_HISTOGRAMME ((64 - HISTO_BITS_PRECISION + 1) << HISTO_BITS_PRECISION)
+
+typedef struct {
+    uint64_t cases[NB_CASES_HISTOGRAMME];
+    uint64_t nb;
+    uint64_t min;
+    uint64_t max;
+    double somme;
+} histogramme_t;
+
+void init_histogramme(histogramme_t *h);
+void enregistrer_valeur(histogramme_t *h, uint64_t valeur);
+void fusionner_histogrammes(histogramme_t *dest, const histogramme_t *src);
+
+uint64_t valeur_percentile(const histogramme_t *h, double percentile);
+double moyenne_histogramme(const histogramme_t *h);
+
+// Affiche p50, p90, p99, p99.9 et max, les valeurs étant divisées par diviseur
+void afficher_histogramme(const histogramme_t *h, const char *nom, const char *unite, double diviseur);
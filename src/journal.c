@@ -0,0 +1,216 @@
+#define _POSIX_C_SOURCE 199309L
+#include "journal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Enregistrement de taille fixe : seuls des entiers et une copie de texte
+// bornée traversent l'anneau, la mise en forme reste au thread d'écriture
+typedef struct {
+    uint64_t instant;                  // ns écoulées depuis le démarrage du journal
+    const char *format;
+    uint64_t arguments[4];
+    char texte[JOURNAL_TAILLE_TEXTE];
+    uint8_t niveau;
+    bool avec_texte;
+} enregistrement_journal_t;
+
+// Case de l'anneau (file bornée de Vyukov) : sequence == position quand la case
+// est libre pour le producteur de cette position, position + 1 quand elle est pleine
+typedef struct {
+    uint64_t sequence;
+    enregistrement_journal_t e;
+} case_journal_t;
+
+typedef struct {
+    case_journal_t *cases;
+    uint64_t masque;
+    uint64_t ecriture;                 // prochaine position à réserver (producteurs)
+    uint64_t lecture;                  // prochaine position à lire (thread d'écriture)
+    uint64_t nb_ecrits;
+    uint64_t nb_perdus;
+    uint64_t perdus_signales;
+    bool actif;
+    bool arret;
+    FILE *sortie;
+    struct timespec debut;
+    pthread_t thread;
+} journal_t;
+
+static journal_t journal;
+int niveau_journal = NIVEAU_JOURNAL_DEFAUT;
+
+static const char *nom_niveau(int niveau) {
+    switch (niveau) {
+        case JOURNAL_ERREUR: return "ERREUR";
+        case JOURNAL_AVERTISSEMENT: return "AVERTISSEMENT";
+        case JOURNAL_INFO: return "INFO";
+        default: return "TRACE";
+    }
+}
+
+static void ecrire_message(FILE *sortie, const enregistrement_journal_t *e) {
+    if (e->avec_texte) {
+        fprintf(sortie, e->format, e->texte, (unsigned long long)e->arguments[0],
+                (unsigned long long)e->arguments[1], (unsigned long long)e->arguments[2]);
+    } else {
+        fprintf(sortie, e->format, (unsigned long long)e->arguments[0], (unsigned long long)e->arguments[1],
+                (unsigned long long)e->arguments[2], (unsigned long long)e->arguments[3]);
+    }
+    fputc('\n', sortie);
+}
+
+static bool ecrire_prochain(void) {
+    case_journal_t *c = &journal.cases[journal.lecture & journal.masque];
+    if (__atomic_load_n(&c->sequence, __ATOMIC_ACQUIRE) != journal.lecture + 1) return false;
+
+    const enregistrement_journal_t *e = &c->e;
+    fprintf(journal.sortie, "[%12.6f] %-13s ", e->instant / 1e9, nom_niveau(e->niveau));
+    ecrire_message(journal.sortie, e);
+    // la case est rendue aux producteurs pour le tour suivant de l'anneau
+    __atomic_store_n(&c->sequence, journal.lecture + journal.masque + 1, __ATOMIC_RELEASE);
+    journal.lecture++;
+    __atomic_add_fetch(&journal.nb_ecrits, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+static void signaler_pertes(void) {
+    uint64_t perdus = __atomic_load_n(&journal.nb_perdus, __ATOMIC_RELAXED);
+    if (perdus == journal.perdus_signales) return;
+
+    fprintf(journal.sortie, "[journal] %llu enregistrement(s) perdu(s), anneau plein\n",
+            (unsigned long long)(perdus - journal.perdus_signales));
+    journal.perdus_signales = perdus;
+}
+
+static void *ecrire_journal(void *arg) {
+    (void)arg;
+    const struct timespec pause = {0, 1000000};
+
+    for (;;) {
+        // l'arrêt est lu avant de vider : tout dépôt antérieur à l'arrêt est écrit
+        bool arret = __atomic_load_n(&journal.arret, __ATOMIC_ACQUIRE);
+        size_t nb = 0;
+        while (ecrire_prochain()) nb++;
+        signaler_pertes();
+        if (arret) break;
+        if (nb == 0) {
+            fflush(journal.sortie);
+            nanosleep(&pause, NULL);
+        }
+    }
+    fflush(journal.sortie);
+    return NULL;
+}
+
+static uint64_t instant_journal(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)((t.tv_sec - journal.debut.tv_sec) * 1000000000LL + (t.tv_nsec - journal.debut.tv_nsec));
+}
+
+bool demarrer_journal(FILE *sortie, size_t capacite) {
+    if (sortie == NULL || journal.actif) return false;
+
+    size_t n = 2;
+    while (n < capacite) n *= 2;
+    journal.cases = malloc(n * sizeof(case_journal_t));
+    if (journal.cases == NULL) return false;
+    for (size_t i = 0; i < n; i++) {
+        journal.cases[i].sequence = i;
+    }
+
+    journal.masque = n - 1;
+    journal.ecriture = 0;
+    journal.lecture = 0;
+    journal.nb_ecrits = 0;
+    journal.nb_perdus = 0;
+    journal.perdus_signales = 0;
+    journal.arret = false;
+    journal.sortie = sortie;
+    clock_gettime(CLOCK_MONOTONIC, &journal.debut);
+    if (pthread_create(&journal.thread, NULL, ecrire_journal, NULL) != 0) {
+        free(journal.cases);
+        journal.cases = NULL;
+        return false;
+    }
+    __atomic_store_n(&journal.actif, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+void arreter_journal(void) {
+    if (!journal.actif) return;
+
+    __atomic_store_n(&journal.actif, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&journal.arret, true, __ATOMIC_RELEASE);
+    pthread_join(journal.thread, NULL);
+    free(journal.cases);
+    journal.cases = NULL;
+}
+
+bool journal_demarre(void) {
+    return __atomic_load_n(&journal.actif, __ATOMIC_ACQUIRE);
+}
+
+void regler_niveau_journal(niveau_journal_t niveau) {
+    niveau_journal = niveau;
+}
+
+statistiques_journal_t statistiques_journal(void) {
+    statistiques_journal_t s;
+    s.nb_ecrits = __atomic_load_n(&journal.nb_ecrits, __ATOMIC_RELAXED);
+    s.nb_perdus = __atomic_load_n(&journal.nb_perdus, __ATOMIC_RELAXED);
+    return s;
+}
+
+static void remplir(enregistrement_journal_t *e, niveau_journal_t niveau, const char *format, const char *texte,
+                    uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
+    e->format = format;
+    e->niveau = (uint8_t)niveau;
+    e->arguments[0] = a;
+    e->arguments[1] = b;
+    e->arguments[2] = c;
+    e->arguments[3] = d;
+    e->avec_texte = texte != NULL;
+    if (texte != NULL) {
+        // une ligne lue par fgets garde sa fin de ligne : elle est retirée
+        size_t n = strcspn(texte, "\r\n");
+        if (n >= JOURNAL_TAILLE_TEXTE) n = JOURNAL_TAILLE_TEXTE - 1;
+        memcpy(e->texte, texte, n);
+        e->texte[n] = '\0';
+    }
+}
+
+void deposer_journal(niveau_journal_t niveau, const char *format, const char *texte,
+                     uint64_t a, uint64_t b, uint64_t c, uint64_t d) {
+    if (!__atomic_load_n(&journal.actif, __ATOMIC_ACQUIRE)) {
+        enregistrement_journal_t e;
+        remplir(&e, niveau, format, texte, a, b, c, d);
+        ecrire_message(stderr, &e);
+        return;
+    }
+
+    uint64_t position = __atomic_load_n(&journal.ecriture, __ATOMIC_RELAXED);
+    case_journal_t *c_anneau;
+    for (;;) {
+        c_anneau = &journal.cases[position & journal.masque];
+        uint64_t sequence = __atomic_load_n(&c_anneau->sequence, __ATOMIC_ACQUIRE);
+        int64_t ecart = (int64_t)(sequence - position);
+        if (ecart == 0) {
+            // case libre : la réserver, sinon un autre producteur l'a prise avant
+            if (__atomic_compare_exchange_n(&journal.ecriture, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (ecart < 0) {
+            // le thread d'écriture n'a pas encore libéré cette case : anneau plein
+            __atomic_add_fetch(&journal.nb_perdus, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            position = __atomic_load_n(&journal.ecriture, __ATOMIC_RELAXED);
+        }
+    }
+
+    remplir(&c_anneau->e, niveau, format, texte, a, b, c, d);
+    c_anneau->e.instant = instant_journal();
+    __atomic_store_n(&c_anneau->sequence, position + 1, __ATOMIC_RELEASE);
+}
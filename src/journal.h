@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Journal asynchrone : les producteurs déposent des enregistrements de taille
+// fixe dans un anneau sans verrou, un thread d'écriture les met en forme.
+// Anneau plein : l'enregistrement est perdu et compté, le producteur ne bloque
+// jamais. Tant que le journal n'est pas démarré, les messages sont écrits
+// directement sur stderr, comme avant.
+typedef enum {
+    JOURNAL_ERREUR = 0,
+    JOURNAL_AVERTISSEMENT = 1,
+    JOURNAL_INFO = 2,
+    JOURNAL_TRACE = 3
+} niveau_journal_t;
+
+// Niveau le plus bavard compilé : -DJOURNAL_NIVEAU_MAX=JOURNAL_INFO retire
+// les traces du binaire
+#ifndef JOURNAL_NIVEAU_MAX
+#define JOURNAL_NIVEAU_MAX JOURNAL_TRACE
+#endif
+
+#define NIVEAU_JOURNAL_DEFAUT JOURNAL_AVERTISSEMENT
+#define CAPACITE_JOURNAL_DEFAUT 4096
+#define JOURNAL_TAILLE_TEXTE 64
+
+// Le format est une chaîne littérale mise en forme plus tard par le thread
+// d'écriture : arguments entiers en %llu / %lld / %llx uniquement, précédés
+// du texte (%s) pour JOURNALISER_TEXTE. Le texte est copié, tronqué à 63 octets.
+#define JOURNALISER(niveau, format, a, b, c, d)                                          \
+    do {                                                                                 \
+        if ((niveau) <= JOURNAL_NIVEAU_MAX && (int)(niveau) <= niveau_journal)           \
+            deposer_journal((niveau), (format), NULL, (uint64_t)(a), (uint64_t)(b),      \
+                            (uint64_t)(c), (uint64_t)(d));                               \
+    } while (0)
+
+#define JOURNALISER_TEXTE(niveau, format, texte, a, b, c)                                \
+    do {                                                                                 \
+        if ((niveau) <= JOURNAL_NIVEAU_MAX && (int)(niveau) <= niveau_journal)           \
+            deposer_journal((niveau), (format), (texte), (uint64_t)(a), (uint64_t)(b),   \
+                            (uint64_t)(c), 0);                                           \
+    } while (0)
+
+typedef struct {
+    uint64_t nb_ecrits;   // enregistrements mis en forme par le thread d'écriture
+    uint64_t nb_perdus;   // enregistrements rejetés, anneau plein
+} statistiques_journal_t;
+
+// Filtre à l'exécution, lu sans synchronisation par les producteurs
+extern int niveau_journal;
+
+// capacite : nombre d'enregistrements, arrondi à la puissance de 2 supérieure
+bool demarrer_journal(FILE *sortie, size_t capacite);
+// Vide l'anneau et attend le thread d'écriture ; à appeler une fois les producteurs arrêtés
+void arreter_journal(void);
+bool journal_demarre(void);
+void regler_niveau_journal(niveau_journal_t niveau);
+statistiques_journal_t statistiques_journal(void);
+
+void deposer_journal(niveau_journal_t niveau, const char *format, const char *texte,
+                     uint64_t a, uint64_t b, uint64_t c, uint64_t d);
@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+#include "lot.h"
+#include "configuration.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+static bool ajouter_fichier(char ***fichiers, size_t *nb, size_t *capacite, const char *chemin) {
+    if (*nb >= *capacite) {
+        size_t nouvelle_capacite = (*capacite == 0) ? 16 : *capacite * 2;
+        char **nouveaux = realloc(*fichiers, nouvelle_capacite * sizeof(char *));
+        if (nouveaux == NULL) return false;
+        
+        *fichiers = nouveaux;
+        *capacite = nouvelle_capacite;
+    }
+    
+    (*fichiers)[*nb] = strdup(chemin);
+    if ((*fichiers)[*nb] == NULL) return false;
+    (*nb)++;
+    return true;
+}
+
+static int comparer_noms(const void *a, const void *b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static bool lister_repertoire(const char *repertoire, char ***fichiers, size_t *nb, size_t *capacite) {
+    DIR *d = opendir(repertoire);
+    if (d == NULL) {
+        perror("Erreur d'ouverture du répertoire");
+        return false;
+    }
+    
+    struct dirent *entree;
+    char chemin[4096];
+    bool ok = true;
+    while (ok && (entree = readdir(d)) != NULL) {
+        snprintf(chemin, sizeof(chemin), "%s/%s", repertoire, entree->d_name);
+        struct stat st;
+        if (stat(chemin, &st) == 0 && S_ISREG(st.st_mode)) {
+            ok = ajouter_fichier(fichiers, nb, capacite, chemin);
+        }
+    }
+    closedir(d);
+    
+    qsort(*fichiers, *nb, sizeof(char *), comparer_noms);
+    return ok;
+}
+
+static bool lire_liste(const char *liste, char ***fichiers, size_t *nb, size_t *capacite) {
+    FILE *f = fopen(liste, "r");
+    if (f == NULL) {
+        perror("Erreur d'ouverture de la liste");
+        return false;
+    }
+    
+    char ligne[4096];
+    bool ok = true;
+    while (ok && fgets(ligne, sizeof(ligne), f) != NULL) {
+        ligne[strcspn(ligne, "\r\n")] = '\0';
+        if (ligne[0] != '\0' && ligne[0] != '#') {
+            ok = ajouter_fichier(fichiers, nb, capacite, ligne);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+bool lister_fichiers_lot(const char *source, char ***fichiers, size_t *nb) {
+    if (source == NULL || fichiers == NULL || nb == NULL) return false;
+    
+    *fichiers = NULL;
+    *nb = 0;
+    size_t capacite = 0;
+    
+    struct stat st;
+    if (stat(source, &st) != 0) {
+        perror("Source introuvable");
+        return false;
+    }
+    
+    bool ok = S_ISDIR(st.st_mode) ? lister_repertoire(source, fichiers, nb, &capacite)
+                                  : lire_liste(source, fichiers, nb, &capacite);
+    if (!ok) {
+        liberer_fichiers_lot(*fichiers, *nb);
+        *fichiers = NULL;
+        *nb = 0;
+    }
+    return ok;
+}
+
+void liberer_fichiers_lot(char **fichiers, size_t nb) {
+    for (size_t i = 0; i < nb; i++) {
+        free(fichiers[i]);
+    }
+    free(fichiers);
+}
+
+// État partagé par les threads du pool : seul l'indice du prochain fichier est protégé
+typedef struct {
+    char **fichiers;
+    size_t nb;
+    resultat_lot_t *resultats;
+    size_t prochain;
+    histogramme_t *durees;     // fusion des histogrammes des threads, sous verrou
+    pthread_mutex_t verrou;
+} travail_lot_t;
+
+static void traiter_fichier(reseau_t *r, const char *fichier, resultat_lot_t *res) {
+    res->charge = lire_reseau(fichier, r) == 1;
+    res->nb_equipements = 0;
+    res->nb_composantes = 0;
+    res->racine = 0;
+    res->nb_ports_bloques = 0;
+    if (!res->charge) return;
+    
+    res->nb_equipements = ordre(&r->g);
+    res->nb_composantes = nb_composantes(&r->g);
+    
+    resultat_stp_t stp;
+    if (calculer_stp(r, &stp)) {
+        res->racine = stp.racine;
+        res->nb_ports_bloques = stp.nb_ports_bloques;
+    }
+}
+
+static void *ouvrier_lot(void *arg) {
+    travail_lot_t *travail = arg;
+    
+    // réseau propre au thread, vidé et réutilisé d'un fichier à l'autre
+    reseau_t r;
+    init_reseau(&r);
+    // histogramme propre au thread, fusionné une seule fois à la fin
+    histogramme_t durees;
+    init_histogramme(&durees);
+    
+    for (;;) {
+        pthread_mutex_lock(&travail->verrou);
+        size_t i = travail->prochain++;
+        pthread_mutex_unlock(&travail->verrou);
+        if (i >= travail->nb) break;
+        
+        struct timespec debut, fin;
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        traiter_fichier(&r, travail->fichiers[i], &travail->resultats[i]);
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        enregistrer_valeur(&durees, (uint64_t)((fin.tv_sec - debut.tv_sec) * 1000000000LL +
+                                               (fin.tv_nsec - debut.tv_nsec)));
+    }
+    
+    if (travail->durees != NULL) {
+        pthread_mutex_lock(&travail->verrou);
+        fusionner_histogrammes(travail->durees, &durees);
+        pthread_mutex_unlock(&travail->verrou);
+    }
+    deinit_reseau(&r);
+    return NULL;
+}
+
+bool executer_lot(char **fichiers, size_t nb, int nb_threads, resultat_lot_t *resultats, histogramme_t *durees) {
+    if (fichiers == NULL || resultats == NULL || nb_threads <= 0) return false;
+    
+    travail_lot_t travail = {fichiers, nb, resultats, 0, durees, PTHREAD_MUTEX_INITIALIZER};
+    pthread_t *threads = malloc(nb_threads * sizeof(pthread_t));
+    if (threads == NULL) return false;
+    
+    int lances = 0;
+    while (lances < nb_threads && pthread_create(&threads[lances], NULL, ouvrier_lot, &travail) == 0) {
+        lances++;
+    }
+    // sans aucun thread, le lot est traité par l'appelant
+    if (lances == 0) {
+        ouvrier_lot(&travail);
+    }
+    for (int t = 0; t < lances; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    free(threads);
+    pthread_mutex_destroy(&travail.verrou);
+    return true;
+}
+
+bool ecrire_resultats_lot(const char *nom_sortie, char **fichiers, const resultat_lot_t *resultats, size_t nb) {
+    FILE *f = fopen(nom_sortie, "w");
+    if (f == NULL) {
+        perror("Erreur d'ouverture du fichier de résultats");
+        return false;
+    }
+    
+    size_t nb_charges = 0;
+    fprintf(f, "# fichier;chargement;equipements;composantes;racine;ports_bloques\n");
+    for (size_t i = 0; i < nb; i++) {
+        const resultat_lot_t *res = &resultats[i];
+        if (!res->charge) {
+            fprintf(f, "%s;ECHEC;0;0;-;0\n", fichiers[i]);
+            continue;
+        }
+        nb_charges++;
+        // racine notée priorité/MAC, comme l'identifiant de pont STP
+        fprintf(f, "%s;OK;%zu;%zu;%u/%02x:%02x:%02x:%02x:%02x:%02x;%zu\n",
+                fichiers[i], res->nb_equipements, res->nb_composantes,
+                (unsigned int)(res->racine >> 48),
+                (unsigned int)(res->racine >> 40) & 0xFF, (unsigned int)(res->racine >> 32) & 0xFF,
+                (unsigned int)(res->racine >> 24) & 0xFF, (unsigned int)(res->racine >> 16) & 0xFF,
+                (unsigned int)(res->racine >> 8) & 0xFF, (unsigned int)res->racine & 0xFF,
+                res->nb_ports_bloques);
+    }
+    fprintf(f, "# %zu fichier(s), %zu chargé(s)\n", nb, nb_charges);
+    
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "histogramme.h"
+#include "stp.h"
+
+// Bilan d'un fichier de configuration traité par lot
+typedef struct {
+    bool charge;               // chargement réussi
+    size_t nb_equipements;
+    size_t nb_composantes;
+    bridge_id_t racine;        // racine STP de la composante du premier switch
+    size_t nb_ports_bloques;
+} resultat_lot_t;
+
+// Liste des fichiers d'un répertoire (triés par nom) ou d'un fichier liste (un chemin par ligne)
+bool lister_fichiers_lot(const char *source, char ***fichiers, size_t *nb);
+void liberer_fichiers_lot(char **fichiers, size_t nb);
+
+// Charge chaque fichier et calcule STP sur un pool de nb_threads threads.
+// Chaque thread réutilise son propre réseau d'un fichier à l'autre.
+// Si durees n'est pas NULL, il reçoit le temps de traitement de chaque fichier (ns).
+bool executer_lot(char **fichiers, size_t nb, int nb_threads, resultat_lot_t *resultats, histogramme_t *durees);
+
+bool ecrire_resultats_lot(const char *nom_sortie, char **fichiers, const resultat_lot_t *resultats, size_t nb);
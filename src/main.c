@@ -8,6 +8,22 @@
 #include "switch.h"
 #include "configuration.h"
 #include "stp.h"
+#include "simulation.h"
+#include "histogramme.h"
+#include "checkpoint.h"
+#include "multichemin.h"
+#include "temporisation.h"
+#include "renumerotation.h"
+#include "journal.h"
+#include "trafic.h"
+#include "arp.h"
+#include "memoire.h"
+#include "chemins.h"
+#include "coeur.h"
+#include "tempete.h"
+#include "export.h"
+#include "mstp.h"
+#include "profileur.h"
 
 // Fonctions utilitaires pour les tests
 void test_separator(const char* test_name) {
@@ -84,11 +100,11 @@ void test_graphe() {
     
     // Test ajout d'arêtes
     printf("\nTest ajout d'arêtes:\n");
-    arete a1 = {0, 1};
-    arete a2 = {1, 2};
-    arete a3 = {2, 3};
-    arete a4 = {0, 3};
-    arete a5 = {0, 1}; // Duplicate
+    arete a1 = {.s1 = 0, .s2 = 1};
+    arete a2 = {.s1 = 1, .s2 = 2};
+    arete a3 = {.s1 = 2, .s2 = 3};
+    arete a4 = {.s1 = 0, .s2 = 3};
+    arete a5 = {.s1 = 0, .s2 = 1}; // Duplicate
     
     printf("  Arête (0,1): %s\n", ajouter_arete(&g, a1) ? "Ajoutée" : "Échec");
     printf("  Arête (1,2): %s\n", ajouter_arete(&g, a2) ? "Ajoutée" : "Échec");
@@ -99,9 +115,43 @@ void test_graphe() {
     // Test existence d'arêtes
     printf("\nTest existence d'arêtes:\n");
     printf("  Arête (0,1) existe: %s\n", existe_arete(&g, a1) ? "Oui" : "Non");
-    printf("  Arête (1,0) existe: %s\n", existe_arete(&g, (arete){1, 0}) ? "Oui" : "Non");
-    printf("  Arête (0,4) existe: %s\n", existe_arete(&g, (arete){0, 4}) ? "Oui" : "Non");
-    
+    printf("  Arête (1,0) existe: %s\n", existe_arete(&g, (arete){.s1 = 1, .s2 = 0}) ? "Oui" : "Non");
+    printf("  Arête (0,4) existe: %s\n", existe_arete(&g, (arete){.s1 = 0, .s2 = 4}) ? "Oui" : "Non");
+
+    // Test de la connexité (union-find)
+    printf("\nTest de la connexité:\n");
+    printf("  Composantes connexes: %zu (attendu 2)\n", nb_composantes(&g));
+    printf("  Boucles: %zu (attendu 1)\n", nb_cycles(&g));
+    printf("  Arête (0,3) redondante: %s\n", arete_redondante(&g, index_arete(&g, a4)) ? "Oui" : "Non");
+    printf("  Arête (0,4) fermerait une boucle: %s\n", ferme_boucle(&g, (arete){.s1 = 0, .s2 = 4}) ? "Oui" : "Non");
+
+    // suppressions en série : un seul recalcul, à la requête suivante
+    graphe anneau;
+    init_graphe(&anneau);
+    for (int i = 0; i < 6; i++) ajouter_sommet(&anneau);
+    for (sommet i = 0; i < 6; i++) ajouter_arete(&anneau, (arete){.s1 = i, .s2 = (i + 1) % 6});
+    supprimer_arete(&anneau, (arete){.s1 = 2, .s2 = 3});
+    supprimer_arete(&anneau, (arete){.s1 = 4, .s2 = 5});
+    printf("  Anneau coupé deux fois, recalcul différé: %s (attendu Oui)\n",
+           anneau.composantes_perimees ? "Oui" : "Non");
+    printf("  Composantes, boucles: %zu, %zu (attendu 2, 0)\n", nb_composantes(&anneau), nb_cycles(&anneau));
+    printf("  0 et 5 connectés, 2 et 3 séparés: %s, %s (attendu Oui, Oui)\n",
+           meme_composante(&anneau, 0, 5) ? "Oui" : "Non", meme_composante(&anneau, 2, 3) ? "Non" : "Oui");
+    deinit_graphe(&anneau);
+
+    // union-find agrandi plusieurs fois : les composantes déjà unies sont conservées
+    graphe grand;
+    init_graphe(&grand);
+    size_t ajoutes = 0;
+    for (int i = 0; i < 100; i++) ajoutes += ajouter_sommet(&grand);
+    for (sommet i = 0; i + 1 < 50; i++) ajouter_arete(&grand, (arete){.s1 = i, .s2 = i + 1});
+    for (int i = 0; i < 100; i++) ajoutes += ajouter_sommet(&grand);
+    printf("  Sommets ajoutés, capacité, composantes: %zu, %zu, %zu (attendu 200, 256, 151)\n", ajoutes,
+           grand.sommets_capacite, nb_composantes(&grand));
+    printf("  0 et 49 connectés: %s, ajout dans un graphe NULL: %s (attendu Oui, Non)\n",
+           meme_composante(&grand, 0, 49) ? "Oui" : "Non", ajouter_sommet(NULL) ? "Oui" : "Non");
+    deinit_graphe(&grand);
+
     // Test des sommets adjacents
     printf("\nTest des sommets adjacents:\n");
     for (int i = 0; i < 5; i++) {
@@ -165,6 +215,17 @@ void test_trame() {
         printf("  Copie de trame: Échec\n");
     }
     
+    // Test du partage de la charge utile
+    printf("\nTest du partage de la charge utile:\n");
+    trame copies[4];
+    dupliquer_trame(&t1, copies, 4);
+    printf("  Références après 4 copies: %zu (attendu 5)\n", t1.charge->references);
+    printf("  Données partagées: %s\n", copies[3].donnees == t1.donnees ? "Oui" : "Non");
+    for (int i = 0; i < 4; i++) {
+        deinit_trame(&copies[i]);
+    }
+    printf("  Références après libération des copies: %zu (attendu 1)\n", t1.charge->references);
+    
     // Libération des trames
     deinit_trame(&t1);
     deinit_trame(&t2);
@@ -213,6 +274,41 @@ void test_station() {
     
     deinit_trame(&t);
     printf("\nStation et trame libérées avec succès\n");
+    
+    // Test de la diffusion dans un réseau après STP
+    printf("\nTest de la diffusion sur config2.txt:\n");
+    reseau_t r;
+    if (charger_reseau("config2.txt", &r)) {
+        calculer_stp(&r, NULL);
+        simulation_t sim;
+        init_simulation(&sim, &r);
+        init_trame(&t, r.stations[0].mac, dest_mac, TYPE_IPV4, data, data_size);
+        emettre_trame(&sim, 3, &t);
+        deinit_trame(&t);
+        executer_simulation(&sim, 0);
+        printf("\n  Trames livrées: %llu (attendu 2)\n", (unsigned long long)sim.compteurs.nb_livrees);
+        printf("  Copies créées par inondation: %llu\n", (unsigned long long)sim.compteurs.nb_copies);
+        deinit_simulation(&sim);
+
+        // Rafale de 100 trames sur une file de sortie de 8 places
+        init_simulation(&sim, &r);
+        configurer_files_sortie(&sim, 8, REJET_QUEUE);
+        suivre_paire(&sim, 3, 4);
+        sim.chronometrer = true;
+        init_trame(&t, r.stations[0].mac, dest_mac, TYPE_IPV4, data, data_size);
+        for (int i = 0; i < 100; i++) {
+            emettre_trame(&sim, 3, &t);
+        }
+        deinit_trame(&t);
+        executer_simulation(&sim, 0);
+        printf("  Rafale: %llu trame(s) rejetée(s) par la station (attendu 91)\n",
+               (unsigned long long)file_sortie(&sim, 3, 0)->nb_rejetees);
+        afficher_files_sortie(&sim, 0.5);
+        printf("  Latences mesurées: %llu (attendu 18)\n", (unsigned long long)sim.latence.nb);
+        afficher_latences(&sim);
+        deinit_simulation(&sim);
+        deinit_reseau(&r);
+    }
 }
 
 void test_switch() {
@@ -248,7 +344,28 @@ void test_switch() {
         int port = chercher_port_mac(&sw.table, dest_mac);
         printf("  Port trouvé pour la MAC: %d\n", port);
     }
-    
+
+    // Test de la purge ciblée
+    printf("\nTest de la purge ciblée:\n");
+    for (int i = 0; i < 6; i++) {
+        ajouter_entree_table(&sw.table, creer_mac(0x00, 0x1B, 0x63, 0x84, 0x45, i), i % 2);
+    }
+    printf("  Entrées purgées sur le port 1: %d (attendu 3)\n", vider_port_table(&sw.table, 1));
+    printf("  Retrait par MAC: %s\n", retirer_entree_table(&sw.table, creer_mac(0x00, 0x1B, 0x63, 0x84, 0x45, 0)) ? "OK" : "Échec");
+    set_etat_port(&sw, 0, PORT_BLOQUE);
+    printf("  Entrées restantes après blocage du port 0: %d (attendu 0)\n", sw.table.taille);
+
+    // Test de la commutation et des compteurs d'inondation
+    printf("\nTest de la commutation:\n");
+    int ports_sortie[4];
+    MAC src = {{0x00, 0x1B, 0x63, 0x84, 0x45, 0x01}};
+    int nb = commuter_trame(&sw, 1, src, dest_mac, ports_sortie);
+    printf("  Diffusion reçue sur le port 1: %d copie(s) (attendu 2)\n", nb);
+    nb = commuter_trame(&sw, 2, dest_mac, src, ports_sortie);
+    printf("  Réponse vers la source apprise: port %d (attendu 1)\n", nb == 1 ? ports_sortie[0] : -1);
+    printf("  Compteurs: %llu inondée(s), %llu commutée(s)\n",
+           (unsigned long long)sw.compteurs.nb_inondees, (unsigned long long)sw.compteurs.nb_commutees);
+
     deinit_switch(&sw);
     printf("\nSwitch libéré avec succès\n");
 }
@@ -276,6 +393,36 @@ void test_stp() {
     deinit_stp(&stp);
     deinit_switch(&sw);
     printf("\nSwitch et STP libérés avec succès\n");
+
+    // Test du calcul STP sur un réseau avec boucle
+    printf("\nTest du calcul STP sur config2.txt:\n");
+    reseau_t r;
+    if (charger_reseau("config2.txt", &r)) {
+        resultat_stp_t res;
+        calculer_stp(&r, &res);
+        printf("\n  Convergence en %zu tours, %zu port(s) bloqué(s) (attendu 1)\n", res.nb_tours, res.nb_ports_bloques);
+        afficher_stp(&r);
+
+        etat_port_t roles[3][8];
+        for (int i = 0; i < 3; i++)
+            for (int p = 0; p < 8; p++) roles[i][p] = get_etat_port(&r.switchs[i], p);
+
+        calculer_stp_parallele(&r, 0, &res);
+        bool identiques = true;
+        for (int i = 0; i < 3; i++)
+            for (int p = 0; p < 8; p++) identiques &= roles[i][p] == get_etat_port(&r.switchs[i], p);
+        printf("  Moteur parallèle identique au séquentiel: %s\n", identiques ? "OK" : "Échec");
+
+        // RSTP : même arbre, le port bloqué devient alternatif
+        resultat_stp_t rapide;
+        calculer_rstp(&r, &rapide);
+        printf("\n  RSTP: %zu saut(s), %llu BPDU, %zu port(s) alternatif(s) (attendu 1)\n", rapide.nb_tours,
+               (unsigned long long)rapide.nb_bpdu, rapide.nb_ports_alternatifs);
+        printf("  Convergence: %llu ms en RSTP, %llu ms en STP classique\n",
+               (unsigned long long)rapide.temps_convergence_ms, (unsigned long long)res.temps_convergence_ms);
+        afficher_stp(&r);
+        deinit_reseau(&r);
+    }
 }
 
 void test_configuration() {
@@ -295,7 +442,7 @@ void test_configuration() {
         printf("    Nombre d'arêtes: %zu\n", nb_aretes(&g));
         
         // Vérifier quelques connexions
-        arete test_aretes[] = {{0, 1}, {1, 2}, {1, 3}, {3, 4}};
+        arete test_aretes[] = {{.s1 = 0, .s2 = 1}, {.s1 = 1, .s2 = 2}, {.s1 = 1, .s2 = 3}, {.s1 = 3, .s2 = 4}};
         printf("    Vérification des connexions:\n");
         for (int i = 0; i < 4; i++) {
             bool exists = existe_arete(&g, test_aretes[i]);
@@ -323,6 +470,1150 @@ void test_configuration() {
         result = charger_configuration("test_config_invalid.txt", &g);
         printf("  Résultat du chargement: %s\n", result ? "Succès" : "Échec (attendu)");
     }
+    
+    // Test 4: Application d'un fichier de modifications sur un réseau chargé
+    printf("\nTest 4: Application de delta_config2.txt sur config2.txt\n");
+    reseau_t r;
+    if (charger_reseau("config2.txt", &r)) {
+        int nb = appliquer_delta("delta_config2.txt", &r);
+        printf("  Modifications appliquées: %d (attendu 4)\n", nb);
+        printf("  Nombre d'arêtes: %zu (attendu 6)\n", nb_aretes(&r.g));
+        printf("  Poids du lien (1,2): %d (attendu 19)\n", r.g.aretes[index_arete(&r.g, (arete){.s1 = 1, .s2 = 2})].poids);
+        printf("  Priorité du switch 2: %d (attendu 512)\n", r.switchs[2].priorite);
+        printf("  Retrait du lien (0,1): %s\n", reseau_delier(&r, 0, 1) ? "OK" : "Échec");
+        printf("  Arête (0,1) existe: %s\n", existe_arete(&r.g, (arete){.s1 = 0, .s2 = 1}) ? "Oui" : "Non");
+        deinit_reseau(&r);
+    }
+}
+
+void test_histogramme() {
+    test_separator("Test complet des histogrammes de latence");
+    
+    histogramme_t h1, h2;
+    init_histogramme(&h1);
+    init_histogramme(&h2);
+    for (uint64_t v = 1; v <= 50; v++) enregistrer_valeur(&h1, v);
+    for (uint64_t v = 51; v <= 100; v++) enregistrer_valeur(&h2, v);
+    
+    fusionner_histogrammes(&h1, &h2);
+    printf("Fusion: %llu mesures (attendu 100)\n", (unsigned long long)h1.nb);
+    printf("  p50: %llu (attendu 50)\n", (unsigned long long)valeur_percentile(&h1, 50.0));
+    printf("  p99: %llu (attendu 99)\n", (unsigned long long)valeur_percentile(&h1, 99.0));
+    printf("  max: %llu (attendu 100)\n", (unsigned long long)valeur_percentile(&h1, 100.0));
+    
+    // au-delà de 128, la valeur est arrondie à la borne haute de sa case (erreur < 1/64)
+    init_histogramme(&h2);
+    enregistrer_valeur(&h2, 1000000);
+    enregistrer_valeur(&h2, 5000000);
+    uint64_t p50 = valeur_percentile(&h2, 50.0);
+    printf("  p50 de {1e6, 5e6}: %llu (attendu entre 1000000 et 1015625)\n", (unsigned long long)p50);
+    afficher_histogramme(&h1, "Valeurs 1..100", "unités", 1.0);
+}
+
+void test_checkpoint() {
+    test_separator("Test complet des points de reprise");
+    
+    reseau_t r;
+    if (!charger_reseau("config2.txt", &r)) return;
+    calculer_stp(&r, NULL);
+    
+    // simulation interrompue en pleine rafale : trames en file et événements en attente
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    MAC diffusion = {{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}};
+    uint8_t data[] = "checkpoint";
+    trame t;
+    init_trame(&t, r.stations[0].mac, diffusion, TYPE_IPV4, data, sizeof(data) - 1);
+    for (int i = 0; i < 20; i++) {
+        emettre_trame(&sim, 3, &t);
+    }
+    deinit_trame(&t);
+    executer_simulation(&sim, 30);
+    
+    printf("Sauvegarde: %s\n", sauvegarder_checkpoint("test_checkpoint.bin", &sim) ? "OK" : "Échec");
+    reseau_t r2;
+    simulation_t sim2;
+    if (!restaurer_checkpoint("test_checkpoint.bin", &r2, &sim2)) {
+        printf("Restauration: Échec\n");
+        deinit_simulation(&sim);
+        deinit_reseau(&r);
+        return;
+    }
+    printf("Restauration: OK\n");
+    
+    size_t differences = 0;
+    for (size_t i = 0; i < r.nb_switchs; i++) {
+        for (int p = 0; p < r.switchs[i].nb_ports; p++) {
+            if (get_etat_port(&r.switchs[i], p) != get_etat_port(&r2.switchs[i], p)) differences++;
+        }
+        if (r.switchs[i].table.taille != r2.switchs[i].table.taille) differences++;
+    }
+    printf("  États de ports et tables différents: %zu (attendu 0)\n", differences);
+    printf("  Horloge identique: %s\n", sim.horloge == sim2.horloge ? "Oui" : "Non");
+    printf("  Événements en attente: %zu / %zu\n", sim.nb_evenements, sim2.nb_evenements);
+    
+    // les deux simulations poursuivent à l'identique
+    executer_simulation(&sim, 0);
+    executer_simulation(&sim2, 0);
+    printf("  Trames livrées: %llu / %llu (attendu 40 / 40)\n",
+           (unsigned long long)sim.compteurs.nb_livrees, (unsigned long long)sim2.compteurs.nb_livrees);
+    printf("  Horloge finale identique: %s\n", sim.horloge == sim2.horloge ? "Oui" : "Non");
+
+    deinit_simulation(&sim2);
+    deinit_reseau(&r2);
+    deinit_simulation(&sim);
+
+    // résolution ARP interrompue : paquet retenu, requête en vol, caches restaurés
+    init_simulation(&sim, &r);
+    activer_arp(&sim, 1000000000);
+    init_trame(&t, r.stations[0].mac, diffusion, TYPE_IPV4, data, sizeof(data) - 1);
+    envoyer_ip(&sim, 3, r.stations[1].ip, &t);
+    deinit_trame(&t);
+    executer_simulation(&sim, 3);
+    bool sauvee = sauvegarder_checkpoint("test_checkpoint.bin", &sim);
+    if (sauvee && restaurer_checkpoint("test_checkpoint.bin", &r2, &sim2)) {
+        printf("  ARP restaurée: %s, %zu / %zu en attente (attendu Oui, 1 / 1)\n", sim2.caches_arp != NULL ? "Oui" : "Non",
+               sim.nb_attentes_arp, sim2.nb_attentes_arp);
+        executer_simulation(&sim, 0);
+        executer_simulation(&sim2, 0);
+        printf("  Après résolution: %llu / %llu livrées, %zu en attente (attendu 4 / 4, 0)\n",
+               (unsigned long long)sim.compteurs.nb_livrees, (unsigned long long)sim2.compteurs.nb_livrees,
+               sim2.nb_attentes_arp);
+        deinit_simulation(&sim2);
+        deinit_reseau(&r2);
+    } else {
+        printf("  ARP restaurée: Échec\n");
+    }
+    deinit_simulation(&sim);
+    deinit_reseau(&r);
+    remove("test_checkpoint.bin");
+}
+
+void test_multichemin() {
+    test_separator("Test complet de l'acheminement multichemin");
+    
+    // anneau de 4 switchs, une station sur chacun des switchs 0 et 2 :
+    // deux chemins de coût égal entre eux, dont un bloqué par STP
+    reseau_t r;
+    init_reseau(&r);
+    for (int i = 0; i < 4; i++) {
+        reseau_ajouter_switch(&r, creer_switch(creer_mac(0x02, 0, 0, 0, 0, (uint8_t)i), 4, 32768));
+    }
+    sommet a = reseau_ajouter_station(&r, creer_station(creer_mac(0x02, 0, 0, 1, 0, 0), creer_ip(10, 0, 0, 1)));
+    sommet b = reseau_ajouter_station(&r, creer_station(creer_mac(0x02, 0, 0, 1, 0, 1), creer_ip(10, 0, 0, 2)));
+    for (sommet i = 0; i < 4; i++) {
+        reseau_relier(&r, i, (i + 1) % 4, 4);
+    }
+    reseau_relier(&r, 0, a, 4);
+    reseau_relier(&r, 2, b, 4);
+    calculer_stp(&r, NULL);
+    
+    plan_spb_t plan;
+    if (!calculer_plan_spb(&plan, &r)) {
+        printf("Calcul du plan: Échec\n");
+        deinit_reseau(&r);
+        return;
+    }
+    printf("Distance 0 -> 2: %u (attendu 8)\n", distance_spb(&plan, 0, 2));
+    printf("Chemins de coût égal de 0 vers 2: %d (attendu 2)\n", nb_chemins_egaux(&plan, &r, 0, 2));
+    
+    // b s'annonce d'abord : en mode STP le trafic vers b n'est plus inondé
+    simulation_t annonce;
+    init_simulation(&annonce, &r);
+    trame t;
+    init_trame(&t, r.stations[1].mac, creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF), TYPE_IPV4, NULL, 0);
+    emettre_trame(&annonce, b, &t);
+    deinit_trame(&t);
+    executer_simulation(&annonce, 0);
+    deinit_simulation(&annonce);
+    
+    // 16 flux de MAC sources distinctes : le hachage les répartit sur les deux chemins
+    static uint8_t data[1000];
+    for (int mode = 0; mode < 2; mode++) {
+        simulation_t sim;
+        init_simulation(&sim, &r);
+        if (mode == 1) activer_multichemin(&sim, &plan);
+        for (int f = 0; f < 16; f++) {
+            init_trame(&t, creer_mac(0x02, 0, 0, 2, 0, (uint8_t)f), r.stations[1].mac, TYPE_IPV4, data, sizeof(data));
+            emettre_trame(&sim, a, &t);
+            deinit_trame(&t);
+        }
+        executer_simulation(&sim, 0);
+        bilan_liens_t bilan;
+        bilan_liens(&sim, &bilan);
+        printf("%s: %llu trames livrées, %zu liens utilisés sur %zu (attendu %s)\n",
+               mode == 1 ? "Multichemin" : "STP", (unsigned long long)sim.compteurs.nb_livrees,
+               bilan.nb_liens_utilises, bilan.nb_liens, mode == 1 ? "4" : "2");
+        deinit_simulation(&sim);
+    }
+    
+    deinit_plan_spb(&plan);
+    deinit_reseau(&r);
+}
+
+static void noter_expiration(void *contexte, uint64_t date, int id, const temporisation_t *t) {
+    printf(" %zu@%llums", t->objet, (unsigned long long)(date / 1000000));
+}
+
+// Port du switch s relié au sommet voisin, -1 si aucun
+static int port_vers(const reseau_t *r, sommet s, sommet voisin) {
+    const switch_t *sw = reseau_switch(r, s);
+    for (int p = 0; p < sw->nb_ports; p++) {
+        if (sw->ports[p].voisin == voisin) return p;
+    }
+    return -1;
+}
+
+void test_temporisations() {
+    test_separator("Test complet des temporisations");
+    
+    // roue seule, tics de 1 ms : niveaux 0, 1 et 2, réarmement et annulation
+    roue_temporisations_t roue;
+    init_roue(&roue, 1000000);
+    int a = armer_temporisation(&roue, 5000000, 0, 1, 0);
+    armer_temporisation(&roue, 300000000, 0, 2, 0);
+    armer_temporisation(&roue, 70000000000ULL, 0, 3, 0);
+    int d = armer_temporisation(&roue, 1000000, 0, 4, 0);
+    annuler_temporisation(&roue, d);
+    rearmer_temporisation(&roue, a, 400000000);
+    printf("Expirations:");
+    avancer_roue(&roue, 100000000000ULL, noter_expiration, NULL);
+    printf(" (attendu 2@300ms 1@400ms 3@70000ms)\n");
+    deinit_roue(&roue);
+    
+    // STP temporisé sur le triangle de config2 : racine 0, le switch 2 bloque son port vers 1
+    reseau_t r;
+    if (!charger_reseau("config2.txt", &r)) return;
+    calculer_stp(&r, NULL);
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    activer_temporisations_stp(&sim);
+    configurer_vieillissement(&sim, VIEILLISSEMENT_DEFAUT);
+    
+    int p20 = port_vers(&r, 2, 0), p21 = port_vers(&r, 2, 1), p02 = port_vers(&r, 0, 2);
+    switch_t *sw2 = &r.switchs[2];
+    printf("\nÀ 0 s, port 2->0: %s (attendu REJET)\n", statut_port_to_string(get_statut_port(sw2, p20)));
+    executer_jusqua(&sim, 16000000000ULL);
+    printf("À 16 s, port 2->0: %s (attendu APPRENTISSAGE)\n", statut_port_to_string(get_statut_port(sw2, p20)));
+    executer_jusqua(&sim, 31000000000ULL);
+    printf("À 31 s, port 2->0: %s (attendu ACHEMINEMENT)\n", statut_port_to_string(get_statut_port(sw2, p20)));
+    
+    // chaque station s'annonce, puis les adresses vieillissent sans trafic
+    MAC diffusion = {{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}};
+    for (sommet st = 3; st < 6; st++) {
+        trame t;
+        init_trame(&t, reseau_station(&r, st)->mac, diffusion, TYPE_IPV4, NULL, 0);
+        emettre_trame(&sim, st, &t);
+        deinit_trame(&t);
+    }
+    executer_simulation(&sim, 0);
+    printf("Trames livrées: %llu (attendu 6), entrées apprises sur le switch 2: %d (attendu 3)\n",
+           (unsigned long long)sim.compteurs.nb_livrees, sw2->table.taille);
+    executer_jusqua(&sim, 332000000000ULL);
+    printf("Après 301 s sans trafic: %llu adresse(s) expirée(s) (attendu 9)\n",
+           (unsigned long long)sim.compteurs.nb_expirees);
+    
+    // panne du lien 0-2 : plus de hello sur le port racine du switch 2, max age
+    // puis écoute et apprentissage avant que son port alternatif ne relaie
+    desactiver_port(&r.switchs[0], p02);
+    desactiver_port(sw2, p20);
+    temps_sim_t panne = sim.horloge;
+    executer_jusqua(&sim, panne + 21000000000ULL);
+    printf("\n21 s après la panne: %llu recalcul(s) STP (attendu 1), port 2->1: %s, %s (attendu RACINE, REJET)\n",
+           (unsigned long long)sim.compteurs.nb_recalculs_stp, etat_port_to_string(get_etat_port(sw2, p21)),
+           statut_port_to_string(get_statut_port(sw2, p21)));
+    executer_jusqua(&sim, panne + 51000000000ULL);
+    printf("51 s après la panne, port 2->1: %s (attendu ACHEMINEMENT)\n",
+           statut_port_to_string(get_statut_port(sw2, p21)));
+    
+    // entrées purgées par la coupure d'un port : leurs temporisations d'expiration sont annulées
+    for (sommet st = 3; st < 6; st++) {
+        trame t;
+        init_trame(&t, reseau_station(&r, st)->mac, diffusion, TYPE_IPV4, NULL, 0);
+        emettre_trame(&sim, st, &t);
+        deinit_trame(&t);
+    }
+    executer_simulation(&sim, 0);
+    int entrees = sw2->table.taille, armees = sim.roue.nb_armees;
+    desactiver_port(sw2, p21);
+    printf("Coupure du port 2->1: %d entrée(s) purgée(s), %d temporisation(s) annulée(s) (attendu 2, 2)\n",
+           entrees - sw2->table.taille, armees - sim.roue.nb_armees);
+    
+    deinit_simulation(&sim);
+    deinit_reseau(&r);
+}
+
+void test_renumerotation() {
+    test_separator("Test complet de la renumérotation des sommets");
+    
+    // anneau de 6 switchs déclarés dans le désordre, une station sur deux switchs opposés
+    static const sommet anneau[] = {0, 3, 5, 1, 4, 2};
+    reseau_t r;
+    init_reseau(&r);
+    for (int i = 0; i < 6; i++) {
+        reseau_ajouter_switch(&r, creer_switch(creer_mac(0x02, 0, 0, 0, 0, (uint8_t)i), 4, 32768));
+    }
+    sommet a = reseau_ajouter_station(&r, creer_station(creer_mac(0x02, 0, 0, 1, 0, 0), creer_ip(10, 0, 0, 1)));
+    sommet b = reseau_ajouter_station(&r, creer_station(creer_mac(0x02, 0, 0, 1, 0, 1), creer_ip(10, 0, 0, 2)));
+    for (int i = 0; i < 6; i++) {
+        reseau_relier(&r, anneau[i], anneau[(i + 1) % 6], 4);
+    }
+    reseau_relier(&r, a, anneau[0], 4);
+    reseau_relier(&r, b, anneau[3], 4);
+    
+    size_t avant = largeur_bande(&r);
+    bool ok = renumeroter_reseau(&r, 0, RENUMEROTATION_RCM);
+    printf("Renumérotation RCM: %s (attendu Succès)\n", ok ? "Succès" : "Échec");
+    printf("Largeur de bande: %zu -> %zu (attendu 6 -> 3)\n", avant, largeur_bande(&r));
+    
+    bool reciproque = true;
+    for (sommet o = 0; o < ordre(&r.g); o++) {
+        if (sommet_origine(&r, sommet_depuis_origine(&r, o)) != o) reciproque = false;
+    }
+    printf("Correspondance des indices réciproque: %s (attendu Oui)\n", reciproque ? "Oui" : "Non");
+    char ip[16];
+    station_t *st_a = reseau_station(&r, sommet_depuis_origine(&r, a));
+    station_t *st_b = reseau_station(&r, sommet_depuis_origine(&r, b));
+    printf("Sommet d'origine %zu: station %s (attendu 10.0.0.2)\n", b, ip_to_string(st_b->ip, ip));
+    
+    resultat_stp_t res;
+    calculer_stp(&r, &res);
+    printf("Ports bloqués après renumérotation: %zu (attendu 1)\n", res.nb_ports_bloques);
+    
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    trame t;
+    init_trame(&t, st_a->mac, st_b->mac, TYPE_IPV4, NULL, 0);
+    emettre_trame(&sim, sommet_depuis_origine(&r, a), &t);
+    deinit_trame(&t);
+    executer_simulation(&sim, 0);
+    printf("Trames livrées de %zu vers %zu: %llu (attendu 1)\n", a, b,
+           (unsigned long long)sim.compteurs.nb_livrees);
+    
+    deinit_simulation(&sim);
+    deinit_reseau(&r);
+}
+
+// Nombre de lignes du journal contenant motif
+static int compter_lignes(FILE *f, const char *motif) {
+    char ligne[256];
+    int nb = 0;
+    rewind(f);
+    while (fgets(ligne, sizeof(ligne), f) != NULL) {
+        if (strstr(ligne, motif) != NULL) nb++;
+    }
+    return nb;
+}
+
+void test_journal() {
+    test_separator("Test complet du journal asynchrone");
+    
+    // anneau de 64 enregistrements : une rafale de 1000 dépôts peut en perdre, jamais bloquer
+    FILE *f = tmpfile();
+    if (f == NULL || !demarrer_journal(f, 64)) {
+        printf("Démarrage du journal: Échec\n");
+        if (f != NULL) fclose(f);
+        return;
+    }
+    regler_niveau_journal(JOURNAL_TRACE);
+    for (int i = 0; i < 1000; i++) {
+        JOURNALISER(JOURNAL_TRACE, "rafale %llu", i, 0, 0, 0);
+    }
+    // filtré à l'exécution : ni écrit ni compté comme perdu
+    regler_niveau_journal(JOURNAL_AVERTISSEMENT);
+    for (int i = 0; i < 10; i++) {
+        JOURNALISER(JOURNAL_TRACE, "filtré %llu", i, 0, 0, 0);
+    }
+    arreter_journal();
+    statistiques_journal_t stats = statistiques_journal();
+    printf("Écrits + perdus: %llu (attendu 1000)\n", (unsigned long long)(stats.nb_ecrits + stats.nb_perdus));
+    printf("Lignes écrites: %d, enregistrements écrits: %llu (attendu identiques)\n",
+           compter_lignes(f, "rafale"), (unsigned long long)stats.nb_ecrits);
+    printf("Lignes filtrées: %d (attendu 0)\n", compter_lignes(f, "filtré"));
+    fclose(f);
+    
+    // traces de simulation : une ligne par trame livrée
+    reseau_t r;
+    init_reseau(&r);
+    f = tmpfile();
+    if (f == NULL || !lire_reseau("config2.txt", &r) || !demarrer_journal(f, CAPACITE_JOURNAL_DEFAUT)) {
+        printf("Démarrage du journal: Échec\n");
+        if (f != NULL) fclose(f);
+        deinit_reseau(&r);
+        return;
+    }
+    regler_niveau_journal(JOURNAL_TRACE);
+    calculer_stp(&r, NULL);
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    trame t;
+    init_trame(&t, r.stations[0].mac, creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF), TYPE_IPV4, NULL, 0);
+    emettre_trame(&sim, 3, &t);
+    deinit_trame(&t);
+    executer_simulation(&sim, 0);
+    arreter_journal();
+    regler_niveau_journal(NIVEAU_JOURNAL_DEFAUT);
+    printf("Traces de livraison: %d, trames livrées: %llu (attendu identiques)\n",
+           compter_lignes(f, "trame livrée"), (unsigned long long)sim.compteurs.nb_livrees);
+    
+    deinit_simulation(&sim);
+    deinit_reseau(&r);
+    fclose(f);
+}
+
+void test_trafic() {
+    test_separator("Test complet du générateur de trafic");
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    calculer_stp(&r, NULL);
+    
+    // même graine, même suite de trames : deux exécutions donnent le même bilan
+    config_trafic_t c;
+    config_trafic_defaut(&c);
+    c.debit = 50000;
+    c.loi_taille = TAILLE_IMIX;
+    c.graine = 7;
+    uint64_t livrees[2], octets[2];
+    for (int k = 0; k < 2; k++) {
+        simulation_t sim;
+        generateur_trafic_t g;
+        init_simulation(&sim, &r);
+        init_generateur(&g, &sim, &c);
+        generer_trafic(&g, 10000000);
+        executer_simulation(&sim, 0);
+        livrees[k] = sim.compteurs.nb_livrees;
+        octets[k] = g.octets_generes;
+        deinit_generateur(&g);
+        deinit_simulation(&sim);
+        for (size_t i = 0; i < r.nb_switchs; i++) vider_table_commutation(&r.switchs[i].table);
+    }
+    printf("Poisson 10 ms, graine 7: %llu puis %llu trames livrées, %llu puis %llu octets (attendu identiques)\n",
+           (unsigned long long)livrees[0], (unsigned long long)livrees[1],
+           (unsigned long long)octets[0], (unsigned long long)octets[1]);
+    
+    // tous vers tous : 3 stations, 6 paires, chaque switch apprend les 3 stations
+    config_trafic_defaut(&c);
+    c.motif = MOTIF_TOUS_VERS_TOUS;
+    c.debit = 1000;
+    simulation_t sim;
+    generateur_trafic_t g;
+    init_simulation(&sim, &r);
+    init_generateur(&g, &sim, &c);
+    size_t nb = generer_trafic(&g, 5000000);
+    executer_simulation(&sim, 0);
+    printf("Tous vers tous: %zu trames émises (attendu 6)\n", nb);
+    afficher_bilan_trafic(&g);
+    deinit_generateur(&g);
+    deinit_simulation(&sim);
+    for (size_t i = 0; i < r.nb_switchs; i++) vider_table_commutation(&r.switchs[i].table);
+    
+    // incast vers la station 5 : les 2 autres stations émettent ensemble
+    config_trafic_defaut(&c);
+    c.motif = MOTIF_INCAST;
+    c.debit = 1000;
+    c.point_chaud = 5;
+    init_simulation(&sim, &r);
+    init_generateur(&g, &sim, &c);
+    nb = generer_trafic(&g, 2500000);
+    executer_simulation(&sim, 0);
+    printf("Incast 3 rafales: %zu trames émises, %llu livrées (attendu 6, 6)\n", nb,
+           (unsigned long long)sim.compteurs.nb_livrees);
+    deinit_generateur(&g);
+    
+    // un second générateur sur la même simulation ne compte que ses propres livraisons
+    init_generateur(&g, &sim, &c);
+    nb = generer_trafic(&g, sim.horloge + 500000);
+    executer_simulation(&sim, 0);
+    printf("Second générateur: %zu trames émises, %llu livrées depuis son démarrage (attendu 2, 2)\n", nb,
+           (unsigned long long)(sim.compteurs.nb_livrees - g.livrees_debut));
+    deinit_generateur(&g);
+    
+    // au-delà d'une trame par ns, la période serait nulle : débit refusé
+    c.debit = 2e9;
+    printf("Débit de 2e9 trames/s: %s (attendu Refusé)\n", init_generateur(&g, &sim, &c) ? "Accepté" : "Refusé");
+    deinit_simulation(&sim);
+    
+    // relecture d'une trace : la ligne invalide est comptée puis ignorée
+    FILE *f = fopen("test_trace.csv", "w");
+    if (f != NULL) {
+        fprintf(f, "# date_ns;source;destination;taille\n1000;3;4;100\n2000;4;-1;28\n2500;0;4;100\n3000;5;3;1500\n");
+        fclose(f);
+    }
+    config_trafic_defaut(&c);
+    c.motif = MOTIF_TRACE;
+    c.trace = "test_trace.csv";
+    init_simulation(&sim, &r);
+    init_generateur(&g, &sim, &c);
+    regler_niveau_journal(JOURNAL_ERREUR);
+    nb = generer_trafic(&g, 1000000);
+    regler_niveau_journal(NIVEAU_JOURNAL_DEFAUT);
+    executer_simulation(&sim, 0);
+    printf("Trace: %zu trames émises, %llu refusée(s), %llu livrées (attendu 3, 1, 4)\n", nb,
+           (unsigned long long)g.nb_refusees, (unsigned long long)sim.compteurs.nb_livrees);
+    deinit_generateur(&g);
+    deinit_simulation(&sim);
+    remove("test_trace.csv");
+    
+    deinit_reseau(&r);
+}
+
+void test_arp() {
+    test_separator("Test complet de la résolution ARP");
+    
+    // aller-retour d'un paquet dans une trame
+    paquet_arp_t p = {ARP_REQUETE, creer_mac(0x54, 0xd6, 0xa6, 0x82, 0xc5, 0x01), creer_ip(130, 79, 80, 1),
+                      creer_mac(0, 0, 0, 0, 0, 0), creer_ip(130, 79, 80, 2)};
+    paquet_arp_t lu;
+    trame t;
+    init_trame_arp(&t, &p);
+    bool ok = lire_paquet_arp(&t, &lu);
+    printf("Requête relue: %d, opération %d, diffusion %d, cible %d (attendu 1, 1, 1, 1)\n", ok, lu.operation,
+           mac_est_diffusion(t.destination), ip_equals(lu.ip_cible, p.ip_cible));
+    deinit_trame(&t);
+    
+    // cache : 100 adresses, puis expiration et retrait
+    cache_arp_t cache;
+    init_cache_arp(&cache);
+    for (int k = 1; k <= 100; k++) {
+        inserer_cache_arp(&cache, creer_ip(10, 0, 0, (uint8_t)k), creer_mac(2, 0, 0, 0, 0, (uint8_t)k), 1000);
+    }
+    mac_addr_t mac;
+    ok = chercher_cache_arp(&cache, creer_ip(10, 0, 0, 42), 500, &mac);
+    printf("Cache: %d entrées, 10.0.0.42 trouvée %d (octet %d) (attendu 100, 1, 42)\n", cache.nb, ok, mac.octet[5]);
+    ok = chercher_cache_arp(&cache, creer_ip(10, 0, 0, 42), 1000, &mac);
+    retirer_cache_arp(&cache, creer_ip(10, 0, 0, 7));
+    int trouvees = 0;
+    for (int k = 1; k <= 100; k++) trouvees += chercher_cache_arp(&cache, creer_ip(10, 0, 0, (uint8_t)k), 0, NULL);
+    printf("Après expiration et retrait: %d, %d entrées, %d trouvées (attendu 0, 98, 98)\n", ok, cache.nb, trouvees);
+    deinit_cache_arp(&cache);
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    calculer_stp(&r, NULL);
+    
+    // deux paquets de la station 3 vers 130.79.80.2 : une seule requête, les deux partent à la réponse
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    activer_arp(&sim, 1000000000);
+    uint8_t donnees[100] = {0};
+    init_trame(&t, r.stations[0].mac, creer_mac(0, 0, 0, 0, 0, 0), TYPE_IPV4, donnees, sizeof(donnees));
+    ip_addr_t ip = r.stations[1].ip;
+    envoyer_ip(&sim, 3, ip, &t);
+    envoyer_ip(&sim, 3, ip, &t);
+    executer_simulation(&sim, 0);
+    printf("Résolution: %llu requête(s), %llu réponse(s), %llu livrées (attendu 1, 1, 5)\n",
+           (unsigned long long)sim.compteurs.nb_requetes_arp, (unsigned long long)sim.compteurs.nb_reponses_arp,
+           (unsigned long long)sim.compteurs.nb_livrees);
+    
+    // en cache jusqu'à expiration, puis nouvelle requête
+    envoyer_ip(&sim, 3, ip, &t);
+    executer_jusqua(&sim, 2000000000);
+    envoyer_ip(&sim, 3, ip, &t);
+    executer_simulation(&sim, 0);
+    bilan_arp_t b;
+    bilan_arp(&sim, &b);
+    printf("Après expiration: %llu requête(s), %llu succès, %llu expirée(s), %zu en attente (attendu 2, 1, 1, 0)\n",
+           (unsigned long long)b.nb_requetes, (unsigned long long)b.nb_succes, (unsigned long long)b.nb_expirees,
+           b.nb_en_attente);
+    afficher_bilan_arp(&sim);
+    deinit_simulation(&sim);
+
+    // réponse perdue (port du switch vers la station 3 coupé) : la relance la redemande
+    init_simulation(&sim, &r);
+    activer_arp(&sim, 1000000000);
+    switch_t *sw = reseau_switch(&r, r.raccordements[0].voisin);
+    int port = r.raccordements[0].port_voisin;
+    envoyer_ip(&sim, 3, ip, &t);
+    while (sim.compteurs.nb_reponses_arp == 0 && executer_simulation(&sim, 1) > 0) {
+    }
+    desactiver_port(sw, port);
+    executer_simulation(&sim, 0);
+    activer_port(sw, port);
+    unsigned long long livrees = sim.compteurs.nb_livrees;
+    executer_jusqua(&sim, sim.horloge + RELANCE_ARP);
+    executer_simulation(&sim, 0);
+    printf("Réponse perdue: %llu requête(s), %llu réponse(s), %zu en attente, paquet livré %d (attendu 2, 2, 0, 1)\n",
+           (unsigned long long)sim.compteurs.nb_requetes_arp, (unsigned long long)sim.compteurs.nb_reponses_arp,
+           sim.nb_attentes_arp, sim.compteurs.nb_livrees - livrees == 4);
+
+    // adresse sans titulaire : TENTATIVES_ARP_MAX requêtes, puis les paquets retenus sont abandonnés
+    unsigned long long requetes = sim.compteurs.nb_requetes_arp;
+    envoyer_ip(&sim, 3, creer_ip(130, 79, 80, 9), &t);
+    envoyer_ip(&sim, 3, creer_ip(130, 79, 80, 9), &t);
+    temps_sim_t debut = sim.horloge;
+    for (int k = 1; k <= TENTATIVES_ARP_MAX; k++) {
+        executer_jusqua(&sim, debut + k * (RELANCE_ARP + 1000000));
+        executer_simulation(&sim, 0);
+    }
+    printf("Sans réponse: %llu requête(s), %llu abandon(s), %zu en attente (attendu %d, 2, 0)\n",
+           (unsigned long long)sim.compteurs.nb_requetes_arp - requetes,
+           (unsigned long long)sim.compteurs.nb_abandons_arp, sim.nb_attentes_arp, TENTATIVES_ARP_MAX);
+    deinit_trame(&t);
+    deinit_simulation(&sim);
+
+    deinit_reseau(&r);
+}
+
+void test_multicast() {
+    test_separator("Test complet de la surveillance multicast");
+    
+    // table : le port reste membre tant qu'une de ses stations l'est
+    mac_addr_t groupe = creer_mac(0x01, 0x00, 0x5E, 0x01, 0x02, 0x03);
+    mac_addr_t a = creer_mac(0x02, 0, 0, 0, 0, 1), b = creer_mac(0x02, 0, 0, 0, 0, 2);
+    switch_t sw = creer_switch(creer_mac(0x02, 0, 0, 0, 1, 0), 70, 32768);
+    rejoindre_groupe(&sw.multicast, groupe, a, 65);
+    rejoindre_groupe(&sw.multicast, groupe, b, 65);
+    quitter_groupe(&sw.multicast, groupe, a);
+    bool membre = port_membre_groupe(&sw.multicast, groupe, 65);
+    quitter_groupe(&sw.multicast, groupe, b);
+    printf("Port 65 après un départ: %d, groupes après le second: %d (attendu 1, 0)\n", membre, sw.multicast.nb);
+    
+    // membres oubliés avec leur port coupé, ou faute d'adhésion renouvelée entre deux requêtes
+    rejoindre_groupe(&sw.multicast, groupe, a, 65);
+    rejoindre_groupe(&sw.multicast, groupe, b, 3);
+    desactiver_port(&sw, 65);
+    bool p65 = port_membre_groupe(&sw.multicast, groupe, 65), p3 = port_membre_groupe(&sw.multicast, groupe, 3);
+    int renouveles = vieillir_groupes(&sw.multicast);
+    int oublies = vieillir_groupes(&sw.multicast);
+    printf("Port 65 coupé: %d, port 3: %d ; oubliés: %d puis %d, %d groupe(s) (attendu 0, 1 ; 0 puis 1, 0)\n", p65, p3,
+           renouveles, oublies, sw.multicast.nb);
+    deinit_switch(&sw);
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    calculer_stp(&r, NULL);
+    
+    // la station 4 rejoint le groupe, la station 3 y envoie une trame ; inondée, elle
+    // est aussi filtrée par la station 5 et par le port bloqué du triangle
+    uint8_t donnees[100] = {0};
+    trame t;
+    init_trame(&t, r.stations[0].mac, groupe, TYPE_IPV4, donnees, sizeof(donnees));
+    for (int surveillance = 1; surveillance >= 0; surveillance--) {
+        simulation_t sim;
+        init_simulation(&sim, &r);
+        activer_surveillance_multicast(&sim, surveillance);
+        rejoindre_groupe_multicast(&sim, 4, groupe);
+        executer_simulation(&sim, 0);
+        compteurs_simulation_t avant = sim.compteurs;
+        emettre_trame(&sim, 3, &t);
+        executer_simulation(&sim, 0);
+        printf("%s: %llu livrée(s), %llu filtrée(s) (attendu 1, %d)\n",
+               surveillance ? "Avec surveillance" : "Sans surveillance",
+               (unsigned long long)(sim.compteurs.nb_livrees - avant.nb_livrees),
+               (unsigned long long)(sim.compteurs.nb_filtrees - avant.nb_filtrees), surveillance ? 0 : 2);
+        if (surveillance) {
+            afficher_table_multicast(&r.switchs[0].multicast);
+            
+            // après le départ, le groupe est inconnu et de nouveau inondé
+            quitter_groupe_multicast(&sim, 4, groupe);
+            executer_simulation(&sim, 0);
+            avant = sim.compteurs;
+            emettre_trame(&sim, 3, &t);
+            executer_simulation(&sim, 0);
+            printf("Après départ: %d groupe(s), %llu livrée(s), %llu filtrée(s) (attendu 0, 0, 3)\n",
+                   r.switchs[0].multicast.nb, (unsigned long long)(sim.compteurs.nb_livrees - avant.nb_livrees),
+                   (unsigned long long)(sim.compteurs.nb_filtrees - avant.nb_filtrees));
+        }
+        deinit_simulation(&sim);
+    }
+    
+    // la station 5 (switch 2) rejoint le groupe, puis le lien 0-2 tombe : l'adhésion
+    // apprise sur le port coupé est oubliée et renouvelée par le nouveau chemin 0-1-2
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    activer_temporisations_stp(&sim);
+    executer_jusqua(&sim, 31000000000ULL);
+    activer_surveillance_multicast(&sim, true);
+    rejoindre_groupe_multicast(&sim, 5, groupe);
+    executer_simulation(&sim, 0);
+    int p02 = port_vers(&r, 0, 2), p20 = port_vers(&r, 2, 0), p01 = port_vers(&r, 0, 1);
+    desactiver_port(&r.switchs[0], p02);
+    desactiver_port(&r.switchs[2], p20);
+    bool oublie = !port_membre_groupe(&r.switchs[0].multicast, groupe, p02);
+    executer_jusqua(&sim, sim.horloge + 51000000000ULL);
+    compteurs_simulation_t avant = sim.compteurs;
+    emettre_trame(&sim, 3, &t);
+    executer_simulation(&sim, 0);
+    printf("Après reconvergence: port 0->2 oublié %d, port 0->1 membre %d, %llu livrée(s) (attendu 1, 1, 1)\n", oublie,
+           port_membre_groupe(&r.switchs[0].multicast, groupe, p01),
+           (unsigned long long)(sim.compteurs.nb_livrees - avant.nb_livrees));
+    
+    // adhésion renouvelée à chaque requête générale : toujours connue 3 intervalles plus tard
+    for (int k = 0; k < 3; k++) {
+        executer_jusqua(&sim, sim.horloge + INTERVALLE_REQUETES_MULTICAST);
+        executer_simulation(&sim, 0);
+    }
+    printf("Après 3 requêtes générales: %d groupe(s) sur le switch 0, %llu adhésion(s) oubliée(s) (attendu 1, 0)\n",
+           r.switchs[0].multicast.nb, (unsigned long long)sim.compteurs.nb_adhesions_oubliees);
+    deinit_simulation(&sim);
+    deinit_trame(&t);
+    
+    deinit_reseau(&r);
+}
+
+void test_memoire() {
+    test_separator("Test complet de la comptabilité mémoire");
+    
+    compteur_memoire_t avant[NB_SOUS_SYSTEMES], c;
+    if (!compteur_memoire(MEMOIRE_TABLES, &c)) {
+        printf("Comptabilité non compilée: les enveloppes se réduisent à malloc / free\n");
+        afficher_bilan_memoire(0, 0);
+        return;
+    }
+    for (int ss = 0; ss < NB_SOUS_SYSTEMES; ss++) compteur_memoire(ss, &avant[ss]);
+    
+    // 1000 adresses apprises : la table double jusqu'à 1024 entrées et dépasse le plafond
+    switch_t sw = creer_switch(creer_mac(0x02, 0, 0, 0, 1, 0), 8, 32768);
+    regler_plafond_memoire(MEMOIRE_TABLES, avant[MEMOIRE_TABLES].vivants + 16384);
+    for (int k = 0; k < 1000; k++) {
+        ajouter_entree_table(&sw.table, creer_mac(0x02, 0, 0, 1, k >> 8, k), k % 8);
+    }
+    compteur_memoire(MEMOIRE_TABLES, &c);
+    uint64_t attendu = sw.table.capacite * sizeof(table_entree_t) + sw.table.index_capacite * sizeof(int) +
+                       sw.table.nb_ports_suivis * sizeof(int);
+    printf("Table de %d entrées: %llu octets comptés, %llu attendus (attendu identiques)\n", sw.table.taille,
+           (unsigned long long)(c.vivants - avant[MEMOIRE_TABLES].vivants), (unsigned long long)attendu);
+    deinit_switch(&sw);
+    regler_plafond_memoire(MEMOIRE_TABLES, 0);
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (lire_reseau("config2.txt", &r)) {
+        calculer_stp(&r, NULL);
+        simulation_t sim;
+        init_simulation(&sim, &r);
+        // temporisations, ARP, adhésions et paires suivies sont comptés eux aussi
+        activer_temporisations_stp(&sim);
+        activer_arp(&sim, DUREE_CACHE_ARP_DEFAUT);
+        activer_surveillance_multicast(&sim, true);
+        rejoindre_groupe_multicast(&sim, 4, creer_mac(0x01, 0x00, 0x5E, 0x01, 0x02, 0x03));
+        suivre_paire(&sim, 3, 4);
+        uint8_t donnees[100] = {0};
+        trame t;
+        init_trame(&t, r.stations[0].mac, r.stations[1].mac, TYPE_IPV4, donnees, sizeof(donnees));
+        envoyer_ip(&sim, 3, r.stations[1].ip, &t);
+        deinit_trame(&t);
+        afficher_bilan_memoire(ordre(&r.g), nb_aretes(&r.g));
+        executer_simulation(&sim, 0);
+        deinit_simulation(&sim);
+    }
+    deinit_reseau(&r);
+    
+    // tout ce qui a été alloué depuis le début du test a été rendu
+    int ecarts = 0;
+    for (int ss = 0; ss < NB_SOUS_SYSTEMES; ss++) {
+        compteur_memoire(ss, &c);
+        if (c.vivants != avant[ss].vivants) ecarts++;
+    }
+    printf("Sous-systèmes non revenus à leur niveau initial: %d (attendu 0)\n", ecarts);
+}
+
+void test_chemins() {
+    test_separator("Test complet des chemins sur l'arbre actif");
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    calculer_stp(&r, NULL);
+    
+    // le lien 1-2 du triangle est bloqué : de la station 4 à la station 5, on passe par le switch 0
+    index_chemins_t idx;
+    if (!construire_index_chemins(&idx, &r)) {
+        printf("Construction de l'index: Échec\n");
+        deinit_reseau(&r);
+        return;
+    }
+    sommet chemin[8];
+    size_t n = sauts_chemin(&idx, 4, 5, chemin);
+    printf("Chemin 4 -> 5:");
+    for (size_t k = 0; k < n; k++) printf(" %zu", chemin[k]);
+    printf(" (attendu 4 1 0 2 5)\n");
+    printf("Longueur, coût et ancêtre commun: %zu, %llu, %zu (attendu 4, 16, 0)\n", longueur_chemin(&idx, 4, 5),
+           (unsigned long long)cout_chemin(&idx, 4, 5), ancetre_commun(&idx, 4, 5));
+    printf("Longueur 3 -> 4: %zu, 3 -> 3: %zu (attendu 3, 0)\n", longueur_chemin(&idx, 3, 4),
+           longueur_chemin(&idx, 3, 3));
+    
+    // sans le lien 0-1, le port bloqué relaie : un seul arbre est refait
+    reseau_delier(&r, 0, 1);
+    calculer_stp(&r, NULL);
+    uint64_t cases_avant = idx.nb_cases_reecrites;
+    mettre_a_jour_index_chemins(&idx, &r);
+    printf("Après coupure 0-1: longueur %zu, coût %llu, arbres refaits %llu (attendu 3, 12, 1)\n",
+           longueur_chemin(&idx, 4, 5), (unsigned long long)cout_chemin(&idx, 4, 5),
+           (unsigned long long)idx.nb_arbres_reconstruits);
+    
+    // seule la plage modifiée du tour est reprise, avec le même résultat qu'une construction complète
+    index_chemins_t neuf;
+    if (construire_index_chemins(&neuf, &r)) {
+        size_t differences = 0;
+        for (sommet a = 0; a < ordre(&r.g); a++) {
+            for (sommet b = 0; b < ordre(&r.g); b++) {
+                if (ancetre_commun(&idx, a, b) != ancetre_commun(&neuf, a, b)) differences++;
+            }
+        }
+        printf("Mise à jour partielle: %llu case(s) réécrite(s) sur %llu, %zu différence(s) (attendu moins, 0)\n",
+               (unsigned long long)(idx.nb_cases_reecrites - cases_avant),
+               (unsigned long long)neuf.nb_cases_reecrites, differences);
+        deinit_index_chemins(&neuf);
+    }
+    
+    // sans le lien 0-2 non plus, la station 3 est isolée avec le switch 0
+    reseau_delier(&r, 0, 2);
+    calculer_stp(&r, NULL);
+    mettre_a_jour_index_chemins(&idx, &r);
+    printf("Après coupure 0-2: %zu arbre(s), chemin 3 -> 4 %s (attendu 2, absent)\n", idx.nb_arbres,
+           longueur_chemin(&idx, 3, 4) == UNKNOWN_INDEX ? "absent" : "présent");
+    
+    deinit_index_chemins(&idx);
+    deinit_reseau(&r);
+}
+
+void test_coeur() {
+    test_separator("Test complet du cœur du réseau");
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    
+    // le triangle de switchs forme le cœur, chaque station pend à un port d'accès
+    coeur_reseau_t c;
+    construire_coeur(&c, &r);
+    printf("Cœur: %zu switchs, %zu extrémités de liens, %zu stations accrochées (attendu 3, 6, 3)\n",
+           c.nb_switchs, nb_liens_coeur(&c), nb_stations_coeur(&c));
+    const raccordement_t *rc = &r.raccordements[1];
+    size_t stations[4];
+    size_t nb = stations_port(&c, r.equipements[rc->voisin].index, rc->port_voisin, stations);
+    printf("Stations du port d'accès de la station 1: %zu, première %zu (attendu 1, 1)\n", nb, stations[0]);
+    
+    graphe g;
+    init_graphe(&g);
+    graphe_coeur(&c, &g);
+    printf("Graphe du cœur: %zu sommets, %zu arêtes, %zu boucle(s) (attendu 3, 3, 1)\n", ordre(&g), nb_aretes(&g),
+           nb_cycles(&g));
+    deinit_graphe(&g);
+    
+    // le port 0 du switch 0 (vers le switch 1), désactivé, sort du cœur
+    desactiver_port(&r.switchs[0], 0);
+    deinit_coeur(&c);
+    construire_coeur(&c, &r);
+    printf("Après désactivation d'un port: %zu extrémités de liens (attendu 5)\n", nb_liens_coeur(&c));
+    
+    deinit_coeur(&c);
+    deinit_reseau(&r);
+}
+
+void test_tempete() {
+    test_separator("Test complet de la tempête de diffusion");
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    
+    // sans STP, le triangle fait tourner la diffusion jusqu'à la limite de sauts
+    config_tempete_t config;
+    config_tempete_defaut(&config);
+    config.nb_sauts_max = 64;
+    tempete_t t;
+    init_tempete(&t, &r, &config);
+    injecter_diffusion(&t, 3, 0);
+    size_t nb_pas = executer_tempete(&t);
+    printf("Sans STP: %zu pas, facteur %.2f, saturation %s (attendu 64, > 1, oui)\n", nb_pas,
+           facteur_amplification(&t), temps_saturation(&t) > 0 ? "oui" : "non");
+    // au pas 4, le switch 0 reçoit la trame des deux côtés et ne peut en passer qu'une à la station 3
+    printf("Pas 4: %llu copies émises, %llu rejetée(s) (attendu 3, 1)\n",
+           (unsigned long long)t.courbe[4].copies, (unsigned long long)t.courbe[4].rejetees);
+    deinit_tempete(&t);
+    
+    // plafond global : la tempête s'arrête dès 100 copies
+    config.copies_max = 100;
+    init_tempete(&t, &r, &config);
+    injecter_diffusion(&t, 3, 0);
+    injecter_diffusion(&t, 4, 2);
+    executer_tempete(&t);
+    printf("Plafond de 100 copies: %s, copies en vol abandonnées %s (attendu atteint, oui)\n",
+           t.nb_copies >= 100 && t.nb_copies < 110 ? "atteint" : "dépassé", t.nb_abandonnees > 0 ? "oui" : "non");
+    deinit_tempete(&t);
+    
+    // avec le STP, le lien 1-2 bloqué coupe la boucle : une copie par station
+    calculer_stp(&r, NULL);
+    config_tempete_defaut(&config);
+    config.respecter_stp = true;
+    init_tempete(&t, &r, &config);
+    injecter_diffusion(&t, 3, 0);
+    nb_pas = executer_tempete(&t);
+    printf("Avec STP: %zu pas, %llu copies, %llu livrées, facteur %.2f (attendu 3, 6, 2, 1.00)\n", nb_pas,
+           (unsigned long long)t.nb_copies, (unsigned long long)t.nb_livrees, facteur_amplification(&t));
+    deinit_tempete(&t);
+    
+    deinit_reseau(&r);
+}
+
+// Lignes du fichier exporté contenant motif, et aussi autre s'il n'est pas NULL
+static int compter_lignes_export(const char *nom_fichier, const char *motif, const char *autre) {
+    FILE *f = fopen(nom_fichier, "r");
+    if (f == NULL) return -1;
+    
+    char ligne[512];
+    int nb = 0;
+    while (fgets(ligne, sizeof(ligne), f) != NULL) {
+        if (strstr(ligne, motif) != NULL && (autre == NULL || strstr(ligne, autre) != NULL)) nb++;
+    }
+    fclose(f);
+    return nb;
+}
+
+void test_export() {
+    test_separator("Test complet de l'export DOT et GraphML");
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    calculer_stp(&r, NULL);
+    
+    // un nœud par équipement, une arête par lien, le lien 1-2 du triangle marqué bloqué
+    bool ok = exporter_reseau("test_export.dot", &r);
+    printf("Export DOT: %s, %d nœuds, %d liens, %d bloqué(s) (attendu Succès, 6, 6, 1)\n", ok ? "Succès" : "Échec",
+           compter_lignes_export("test_export.dot", "type=", NULL),
+           compter_lignes_export("test_export.dot", " -- ", NULL),
+           compter_lignes_export("test_export.dot", "bloque=true", NULL));
+    printf("Lien bloqué entre 1 et 2: %d (attendu 1)\n",
+           compter_lignes_export("test_export.dot", "n1 -- n2 [", "bloque=true"));
+    
+    ok = exporter_reseau("test_export.graphml", &r);
+    printf("Export GraphML: %s, %d nœuds, %d liens, %d bloqué(s) (attendu Succès, 6, 6, 1)\n",
+           ok ? "Succès" : "Échec", compter_lignes_export("test_export.graphml", "<node ", NULL),
+           compter_lignes_export("test_export.graphml", "<edge ", NULL),
+           compter_lignes_export("test_export.graphml", "<data key=\"bloque\">true", NULL));
+    remove("test_export.dot");
+    remove("test_export.graphml");
+    
+    deinit_reseau(&r);
+}
+
+void test_vlan_mstp() {
+    test_separator("Test complet des VLAN 802.1Q et du MSTP");
+    
+    // l'étiquette allonge la trame de 4 octets
+    trame t;
+    init_trame(&t, creer_mac(0x02, 0, 0, 0, 0, 1), creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF), TYPE_IPV4, NULL, 0);
+    size_t sans = taille_trame_octets(&t);
+    t.vlan = 10;
+    printf("Taille sans puis avec étiquette: %zu, %zu (attendu 72, 76)\n", sans, taille_trame_octets(&t));
+    deinit_trame(&t);
+    
+    // une même MAC apprise indépendamment dans deux VLAN
+    table_commutation_t table;
+    init_table_commutation(&table);
+    mac_addr_t mac = creer_mac(0x02, 0, 0, 0, 0, 7);
+    ajouter_entree_fid(&table, 10, mac, 1);
+    ajouter_entree_fid(&table, 20, mac, 2);
+    printf("Port dans les VLAN 10, 20 et sans VLAN: %d, %d, %d (attendu 1, 2, -1)\n", chercher_port_fid(&table, 10, mac),
+           chercher_port_fid(&table, 20, mac), chercher_port_mac(&table, mac));
+    retirer_entree_fid(&table, 10, mac);
+    printf("Après retrait dans le VLAN 10: %d entrée(s), port dans le VLAN 20: %d (attendu 1, 2)\n", table.taille,
+           chercher_port_fid(&table, 20, mac));
+    deinit_table_commutation(&table);
+    
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau("config2.txt", &r)) {
+        deinit_reseau(&r);
+        return;
+    }
+    
+    // CIST : racine 0, lien 1-2 bloqué ; MSTI 1 (VLAN 20) : racine 2, lien 0-1 bloqué
+    plan_mstp_t plan, sequentiel;
+    init_plan_mstp(&plan, &r, 2);
+    regler_priorite_instance(&plan, 1, 2, 0);
+    associer_vlan_instance(&plan, 20, 1);
+    init_plan_mstp(&sequentiel, &r, 2);
+    regler_priorite_instance(&sequentiel, 1, 2, 0);
+    calculer_mstp(&sequentiel, &r, 1);
+    bool ok = calculer_mstp(&plan, &r, 4);
+    printf("Calcul MSTP: %s, rôles identiques en séquentiel: %s (attendu Succès, oui)\n", ok ? "Succès" : "Échec",
+           memcmp(plan.roles, sequentiel.roles, 2 * plan.nb_ports * sizeof(etat_port_t)) == 0 ? "oui" : "non");
+    printf("Racines CIST, MSTI 1: switch %d, switch %d (attendu 1, 3)\n",
+           (int)(plan.resultats[0].racine & 0xFF), (int)(plan.resultats[1].racine & 0xFF));
+    int p12 = port_vers(&r, 2, 1), p10 = port_vers(&r, 1, 0);
+    printf("Port 2->1 dans CIST, MSTI 1: %s, %s (attendu ALTERNATIF, DESIGNE)\n",
+           etat_port_to_string(roles_instance(&plan, 0, 2)[p12]), etat_port_to_string(roles_instance(&plan, 1, 2)[p12]));
+    printf("Port 1->0 dans CIST, MSTI 1: %s, %s (attendu RACINE, ALTERNATIF)\n",
+           etat_port_to_string(roles_instance(&plan, 0, 1)[p10]), etat_port_to_string(roles_instance(&plan, 1, 1)[p10]));
+    printf("Port 2->1 du switch (CIST appliquée): %s (attendu ALTERNATIF)\n",
+           etat_port_to_string(get_etat_port(&r.switchs[2], p12)));
+    printf("BPDU: %llu, enregistrements: %llu (attendu %llu, %llu)\n", (unsigned long long)plan.nb_bpdu,
+           (unsigned long long)plan.nb_enregistrements, (unsigned long long)(6 * plan.nb_tours),
+           (unsigned long long)(plan.resultats[0].nb_bpdu + plan.resultats[1].nb_bpdu));
+    deinit_plan_mstp(&sequentiel);
+    
+    // station 3 dans le VLAN 10, stations 4 et 5 dans le VLAN 20, liens entre switchs en trunk
+    for (size_t i = 0; i < r.nb_switchs; i++) {
+        for (sommet v = 0; v < r.nb_switchs; v++) {
+            int p = port_vers(&r, i, v);
+            if (p < 0) continue;
+            configurer_vlan_port(&r.switchs[i], p, 10, true);
+            configurer_vlan_port(&r.switchs[i], p, 20, true);
+        }
+        set_vlan_natif(&r.switchs[i], port_vers(&r, i, 3 + i), i == 0 ? 10 : 20);
+    }
+    printf("Port d'accès de la station 3 membre des VLAN 10, 20: %s, %s (attendu oui, non)\n",
+           port_membre_vlan(&r.switchs[0], port_vers(&r, 0, 3), 10) ? "oui" : "non",
+           port_membre_vlan(&r.switchs[0], port_vers(&r, 0, 3), 20) ? "oui" : "non");
+    
+    // diffusion de la station 4 : reste dans le VLAN 20 et suit l'arbre de la MSTI 1 (liens 1-2 et 2-0)
+    simulation_t sim;
+    init_simulation(&sim, &r);
+    activer_mstp(&sim, &plan);
+    init_trame(&t, r.stations[1].mac, creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF), TYPE_IPV4, NULL, 0);
+    emettre_trame(&sim, 4, &t);
+    deinit_trame(&t);
+    executer_simulation(&sim, 0);
+    printf("Diffusion dans le VLAN 20: %llu livrée(s) (attendu 1)\n", (unsigned long long)sim.compteurs.nb_livrees);
+    printf("Station 4 apprise par le switch 2 dans le VLAN 20: port %d, sans VLAN: %d (attendu %d, -1)\n",
+           chercher_port_fid(&r.switchs[2].table, 20, r.stations[1].mac), chercher_port_mac(&r.switchs[2].table,
+           r.stations[1].mac), p12);
+    // le switch 0 la reçoit du switch 2, le lien 0-1 étant bloqué dans la MSTI 1
+    printf("Station 4 apprise par le switch 0 vers le switch: %d (attendu 2)\n",
+           (int)r.switchs[0].ports[chercher_port_fid(&r.switchs[0].table, 20, r.stations[1].mac)].voisin);
+
+    // lien 1-2 coupé : après max age, la MSTI 1 est recalculée et passe par le lien 0-1
+    activer_temporisations_stp(&sim);
+    desactiver_port(&r.switchs[1], port_vers(&r, 1, 2));
+    executer_jusqua(&sim, sim.horloge + (MAX_AGE_MS + 2 * HELLO_TIME_MS) * 1000000ULL);
+    executer_simulation(&sim, 0);
+    printf("Après coupure du lien 1-2: %llu recalcul(s), port 1->0 dans la MSTI 1: %s (attendu 1, RACINE)\n",
+           (unsigned long long)sim.compteurs.nb_recalculs_stp, etat_port_to_string(roles_instance(&plan, 1, 1)[p10]));
+    uint64_t livrees = sim.compteurs.nb_livrees;
+    init_trame(&t, r.stations[1].mac, creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF), TYPE_IPV4, NULL, 0);
+    emettre_trame(&sim, 4, &t);
+    deinit_trame(&t);
+    executer_simulation(&sim, 0);
+    printf("Diffusion dans le VLAN 20 par le lien 0-1: %llu livrée(s) (attendu 1)\n",
+           (unsigned long long)(sim.compteurs.nb_livrees - livrees));
+    deinit_simulation(&sim);
+    
+    deinit_plan_mstp(&plan);
+    deinit_reseau(&r);
+}
+
+// Quelques centaines de microsecondes de calcul, pour que chaque phase ait une durée
+static void occuper_profil(void) {
+    volatile unsigned long somme = 0;
+    for (unsigned long k = 0; k < 500000; k++) somme += k;
+}
+
+void test_profileur() {
+    test_separator("Test complet du profileur par phases");
+    
+    printf("Instrumentation compilée: %s (attendu %s)\n", profileur_compile() ? "oui" : "non",
+#ifdef PROFILER
+           "oui"
+#else
+           "non"
+#endif
+    );
+    
+    // "a" appelée deux fois, "b" imbriquée dans chacune, "c" seule
+    reinitialiser_profil();
+    for (int k = 0; k < 2; k++) {
+        entrer_phase("a");
+        occuper_profil();
+        entrer_phase("b");
+        occuper_profil();
+        sortir_phase();
+        sortir_phase();
+    }
+    entrer_phase("c");
+    occuper_profil();
+    sortir_phase();
+    printf("Phases mesurées: %llu (attendu 5)\n", (unsigned long long)nb_phases_mesurees());
+    
+    FILE *f = tmpfile();
+    bool ecrit = f != NULL && ecrire_piles_profil(f);
+    int lignes = 0, a = 0, ab = 0, c = 0;
+    if (ecrit) {
+        char ligne[256], pile[200];
+        unsigned long long us;
+        rewind(f);
+        while (fgets(ligne, sizeof(ligne), f) != NULL) {
+            if (sscanf(ligne, "%199s %llu", pile, &us) != 2 || us == 0) continue;
+            lignes++;
+            if (strcmp(pile, "a") == 0) a++;
+            if (strcmp(pile, "a;b") == 0) ab++;
+            if (strcmp(pile, "c") == 0) c++;
+        }
+    }
+    if (f != NULL) fclose(f);
+    printf("Piles repliées: %d ligne(s), a=%d a;b=%d c=%d (attendu 3 ligne(s), a=1 a;b=1 c=1)\n", lignes, a, ab, c);
+
+    // les phases du graphe (avec -DPROFILER) restent imbriquées dans celle de l'appelant,
+    // y compris le recalcul différé des composantes après une suppression
+    reinitialiser_profil();
+    entrer_phase("externe");
+    graphe g;
+    init_graphe(&g);
+    for (int k = 0; k < 3; k++) ajouter_sommet(&g);
+    ajouter_arete(&g, (arete){.s1 = 0, .s2 = 1});
+    ajouter_arete(&g, (arete){.s1 = 1, .s2 = 2});
+    supprimer_arete(&g, (arete){.s1 = 0, .s2 = 1});
+    size_t composantes = nb_composantes(&g);
+    entrer_phase("apres");
+    occuper_profil();
+    sortir_phase();
+    sortir_phase();
+    deinit_graphe(&g);
+    f = tmpfile();
+    int externe_apres = 0, hors_externe = 0;
+    if (f != NULL && ecrire_piles_profil(f)) {
+        char ligne[256], pile[200];
+        rewind(f);
+        while (fgets(ligne, sizeof(ligne), f) != NULL) {
+            if (sscanf(ligne, "%199s", pile) != 1) continue;
+            if (strcmp(pile, "externe;apres") == 0) externe_apres++;
+            if (strncmp(pile, "externe", 7) != 0 || (pile[7] != '\0' && pile[7] != ';')) hors_externe++;
+        }
+    }
+    if (f != NULL) fclose(f);
+    printf("Graphe dans une phase: %zu composante(s), externe;apres=%d, piles hors d'externe=%d (attendu 2, 1, 0)\n",
+           composantes, externe_apres, hors_externe);
+
+    // au-delà de la profondeur maximale, les phases sont comptées comme perdues
+    reinitialiser_profil();
+    for (int k = 0; k < PROFONDEUR_PROFIL_MAX + 3; k++) entrer_phase("profonde");
+    for (int k = 0; k < PROFONDEUR_PROFIL_MAX + 3; k++) sortir_phase();
+    printf("Phases mesurées, perdues: %llu, %llu (attendu %d, 3)\n", (unsigned long long)nb_phases_mesurees(),
+           (unsigned long long)nb_phases_perdues(), PROFONDEUR_PROFIL_MAX);
+    
+    // sortie sans phase ouverte : sans effet
+    sortir_phase();
+    printf("Sortie en trop ignorée: %llu (attendu %d)\n", (unsigned long long)nb_phases_mesurees(),
+           PROFONDEUR_PROFIL_MAX);
+    reinitialiser_profil();
 }
 
 int main() {
@@ -335,6 +1626,22 @@ int main() {
     test_switch();
     test_stp();
     test_configuration();
+    test_histogramme();
+    test_checkpoint();
+    test_multichemin();
+    test_temporisations();
+    test_renumerotation();
+    test_journal();
+    test_trafic();
+    test_arp();
+    test_multicast();
+    test_memoire();
+    test_chemins();
+    test_coeur();
+    test_tempete();
+    test_export();
+    test_vlan_mstp();
+    test_profileur();
     
     printf("\n=== Fin des tests ===\n");
     return 0;
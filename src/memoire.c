@@ -0,0 +1,118 @@
+#include "memoire.h"
+#include "journal.h"
+#include <stdio.h>
+
+static const char *noms[NB_SOUS_SYSTEMES] = {
+    "graphe", "équipements", "ports", "tables", "trames", "événements", "files", "mesures"
+};
+
+const char *nom_sous_systeme(sous_systeme_t ss) {
+    return (ss < NB_SOUS_SYSTEMES) ? noms[ss] : "?";
+}
+
+#ifdef COMPTER_MEMOIRE
+
+// Compteurs modifiés sans verrou (le calcul STP parallèle peut allouer)
+static compteur_memoire_t compteurs[NB_SOUS_SYSTEMES];
+static uint64_t plafonds[NB_SOUS_SYSTEMES];
+static bool plafond_signale[NB_SOUS_SYSTEMES];
+
+static void compter(sous_systeme_t ss, uint64_t ajout, uint64_t retrait) {
+    compteur_memoire_t *c = &compteurs[ss];
+    __atomic_fetch_add(&c->nb_allocations, ajout > 0, __ATOMIC_RELAXED);
+    uint64_t vivants = __atomic_add_fetch(&c->vivants, ajout - retrait, __ATOMIC_RELAXED);
+    uint64_t pic = __atomic_load_n(&c->pic, __ATOMIC_RELAXED);
+    while (vivants > pic &&
+           !__atomic_compare_exchange_n(&c->pic, &pic, vivants, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    if (plafonds[ss] > 0 && vivants > plafonds[ss] && !plafond_signale[ss]) {
+        plafond_signale[ss] = true;
+        JOURNALISER_TEXTE(JOURNAL_AVERTISSEMENT, "Mémoire : %s dépasse son plafond (%llu octets vivants, "
+                          "plafond %llu)", noms[ss], vivants, plafonds[ss], 0);
+    }
+}
+
+void *allouer_memoire(sous_systeme_t ss, size_t taille) {
+    void *p = malloc(taille);
+    if (p != NULL) compter(ss, taille, 0);
+    return p;
+}
+
+void *allouer_memoire_zero(sous_systeme_t ss, size_t nb, size_t taille) {
+    void *p = calloc(nb, taille);
+    if (p != NULL) compter(ss, nb * taille, 0);
+    return p;
+}
+
+void *reallouer_memoire(sous_systeme_t ss, void *p, size_t ancienne, size_t nouvelle) {
+    void *q = realloc(p, nouvelle);
+    if (q != NULL) compter(ss, nouvelle, (p != NULL) ? ancienne : 0);
+    return q;
+}
+
+void liberer_memoire(sous_systeme_t ss, void *p, size_t taille) {
+    if (p == NULL) return;
+    free(p);
+    compter(ss, 0, taille);
+}
+
+bool compteur_memoire(sous_systeme_t ss, compteur_memoire_t *c) {
+    if (ss >= NB_SOUS_SYSTEMES || c == NULL) return false;
+    c->vivants = __atomic_load_n(&compteurs[ss].vivants, __ATOMIC_RELAXED);
+    c->pic = __atomic_load_n(&compteurs[ss].pic, __ATOMIC_RELAXED);
+    c->nb_allocations = __atomic_load_n(&compteurs[ss].nb_allocations, __ATOMIC_RELAXED);
+    return true;
+}
+
+void regler_plafond_memoire(sous_systeme_t ss, uint64_t octets) {
+    if (ss >= NB_SOUS_SYSTEMES) return;
+    plafonds[ss] = octets;
+    plafond_signale[ss] = false;
+}
+
+void reinitialiser_pics_memoire(void) {
+    for (int ss = 0; ss < NB_SOUS_SYSTEMES; ss++) {
+        __atomic_store_n(&compteurs[ss].pic, __atomic_load_n(&compteurs[ss].vivants, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+    }
+}
+
+#else
+
+bool compteur_memoire(sous_systeme_t ss, compteur_memoire_t *c) {
+    return false;
+}
+
+void regler_plafond_memoire(sous_systeme_t ss, uint64_t octets) {
+}
+
+void reinitialiser_pics_memoire(void) {
+}
+
+#endif
+
+void afficher_bilan_memoire(size_t nb_equipements, size_t nb_aretes) {
+    compteur_memoire_t c;
+    if (!compteur_memoire(MEMOIRE_GRAPHE, &c)) {
+        printf("Mémoire : comptabilité non compilée (make DEFINES=-DCOMPTER_MEMOIRE)\n");
+        return;
+    }
+
+    uint64_t total = 0, total_pic = 0;
+    printf("Mémoire par sous-système (octets vivants / pic) :\n");
+    for (int ss = 0; ss < NB_SOUS_SYSTEMES; ss++) {
+        compteur_memoire(ss, &c);
+        printf("  %-12s %12llu / %12llu  (%llu allocation(s))\n", noms[ss], (unsigned long long)c.vivants,
+               (unsigned long long)c.pic, (unsigned long long)c.nb_allocations);
+        total += c.vivants;
+        total_pic += c.pic;
+    }
+    printf("  %-12s %12llu / %12llu\n", "total", (unsigned long long)total, (unsigned long long)total_pic);
+
+    // le graphe se rapporte aux arêtes, le reste aux équipements
+    compteur_memoire(MEMOIRE_GRAPHE, &c);
+    if (nb_aretes > 0) printf("  par arête : %.1f octets de graphe\n", (double)c.vivants / nb_aretes);
+    if (nb_equipements > 0) {
+        printf("  par équipement : %.1f octets hors graphe\n", (double)(total - c.vivants) / nb_equipements);
+    }
+}
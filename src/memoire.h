@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Comptabilité mémoire par sous-système. Les allocations des structures
+// volumineuses passent par ces fonctions, qui reçoivent la taille du bloc
+// aussi à la libération. Compilée avec -DCOMPTER_MEMOIRE, chaque sous-système
+// tient ses octets vivants et son pic ; sans, les appels se réduisent à
+// malloc / calloc / realloc / free.
+typedef enum {
+    MEMOIRE_GRAPHE = 0,      // arêtes, index des arêtes, union-find
+    MEMOIRE_EQUIPEMENTS,     // équipements, switchs, stations, raccordements, correspondances
+    MEMOIRE_PORTS,           // ports des switchs
+    MEMOIRE_TABLES,          // tables de commutation, groupes et adhésions multicast, caches ARP, plans SPB
+    MEMOIRE_TRAMES,          // charges utiles
+    MEMOIRE_EVENEMENTS,      // tas d'événements, roue et temporisations STP de la simulation
+    MEMOIRE_FILES,           // files de sortie et leurs anneaux, paquets en attente de résolution ARP
+    MEMOIRE_MESURES,         // histogrammes de latence par paire suivie
+    NB_SOUS_SYSTEMES
+} sous_systeme_t;
+
+typedef struct {
+    uint64_t vivants;        // octets alloués et non libérés
+    uint64_t pic;
+    uint64_t nb_allocations; // allocations et réallocations réussies
+} compteur_memoire_t;
+
+#ifdef COMPTER_MEMOIRE
+
+void *allouer_memoire(sous_systeme_t ss, size_t taille);
+void *allouer_memoire_zero(sous_systeme_t ss, size_t nb, size_t taille);
+// ancienne : taille du bloc p (ignorée si p est NULL)
+void *reallouer_memoire(sous_systeme_t ss, void *p, size_t ancienne, size_t nouvelle);
+void liberer_memoire(sous_systeme_t ss, void *p, size_t taille);
+
+#else
+
+static inline void *allouer_memoire(sous_systeme_t ss, size_t taille) {
+    (void)ss;
+    return malloc(taille);
+}
+
+static inline void *allouer_memoire_zero(sous_systeme_t ss, size_t nb, size_t taille) {
+    (void)ss;
+    return calloc(nb, taille);
+}
+
+static inline void *reallouer_memoire(sous_systeme_t ss, void *p, size_t ancienne, size_t nouvelle) {
+    (void)ss;
+    (void)ancienne;
+    return realloc(p, nouvelle);
+}
+
+static inline void liberer_memoire(sous_systeme_t ss, void *p, size_t taille) {
+    (void)ss;
+    (void)taille;
+    free(p);
+}
+
+#endif
+
+// false si la comptabilité n'est pas compilée
+bool compteur_memoire(sous_systeme_t ss, compteur_memoire_t *c);
+const char *nom_sous_systeme(sous_systeme_t ss);
+// Avertissement (une fois) quand les octets vivants dépassent le plafond, 0 : aucun
+void regler_plafond_memoire(sous_systeme_t ss, uint64_t octets);
+void reinitialiser_pics_memoire(void);
+
+// Octets vivants et pic par sous-système, puis rapportés aux équipements et aux arêtes
+void afficher_bilan_memoire(size_t nb_equipements, size_t nb_aretes);
@@ -0,0 +1,150 @@
+#include "mstp.h"
+#include "profileur.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+bool init_plan_mstp(plan_mstp_t *plan, const reseau_t *r, size_t nb_instances) {
+    if (plan == NULL || r == NULL || nb_instances == 0 || nb_instances > NB_INSTANCES_MAX) return false;
+
+    memset(plan, 0, sizeof(*plan));
+    size_t n = r->nb_switchs;
+    plan->nb_instances = nb_instances;
+    plan->nb_switchs = n;
+    plan->debut = malloc((n + 1) * sizeof(size_t));
+    if (plan->debut == NULL) return false;
+
+    plan->debut[0] = 0;
+    for (size_t i = 0; i < n; i++) plan->debut[i + 1] = plan->debut[i] + r->switchs[i].nb_ports;
+    plan->nb_ports = plan->debut[n];
+
+    plan->priorites = malloc((nb_instances * n > 0 ? nb_instances * n : 1) * sizeof(int));
+    plan->roles = calloc(nb_instances * plan->nb_ports > 0 ? nb_instances * plan->nb_ports : 1, sizeof(etat_port_t));
+    plan->resultats = calloc(nb_instances, sizeof(resultat_stp_t));
+    if (plan->priorites == NULL || plan->roles == NULL || plan->resultats == NULL) {
+        deinit_plan_mstp(plan);
+        return false;
+    }
+    for (size_t k = 0; k < nb_instances; k++) {
+        for (size_t i = 0; i < n; i++) plan->priorites[k * n + i] = r->switchs[i].priorite;
+    }
+    return true;
+}
+
+void deinit_plan_mstp(plan_mstp_t *plan) {
+    if (plan == NULL) return;
+
+    free(plan->debut);
+    free(plan->priorites);
+    free(plan->roles);
+    free(plan->resultats);
+    memset(plan, 0, sizeof(*plan));
+}
+
+bool associer_vlan_instance(plan_mstp_t *plan, uint16_t vlan, size_t instance) {
+    if (plan == NULL || vlan == 0 || vlan > VLAN_MAX || instance >= plan->nb_instances) return false;
+
+    plan->instance_vlan[vlan] = (uint8_t)instance;
+    return true;
+}
+
+bool regler_priorite_instance(plan_mstp_t *plan, size_t instance, size_t sw, int priorite) {
+    if (plan == NULL || instance >= plan->nb_instances || sw >= plan->nb_switchs) return false;
+
+    plan->priorites[instance * plan->nb_switchs + sw] = priorite;
+    return true;
+}
+
+// Instance k sur le cœur partagé ; chaque appel n'écrit que ses propres tableaux
+static bool calculer_instance(plan_mstp_t *plan, const reseau_t *r, const coeur_reseau_t *c, size_t k) {
+    size_t n = plan->nb_switchs;
+    bridge_id_t *ids = malloc((n > 0 ? n : 1) * sizeof(bridge_id_t));
+    if (ids == NULL) return false;
+
+    for (size_t i = 0; i < n; i++) {
+        bridge_id_t mac = calculer_bridge_id(&r->switchs[i]) & 0xFFFFFFFFFFFFULL;
+        ids[i] = (bridge_id_t)(plan->priorites[k * n + i] & 0xFFFF) << 48 | mac;
+    }
+    bool ok = calculer_instance_stp(r, c, ids, plan->debut, plan->roles + k * plan->nb_ports, &plan->resultats[k]);
+    free(ids);
+    return ok;
+}
+
+bool calculer_mstp(plan_mstp_t *plan, reseau_t *r, int nb_threads) {
+    if (plan == NULL || r == NULL || r->nb_switchs != plan->nb_switchs) return false;
+
+#ifdef _OPENMP
+    if (nb_threads <= 0) nb_threads = omp_get_max_threads();
+#else
+    nb_threads = 1;
+#endif
+
+    PROFILER_ENTRER("mstp");
+    coeur_reseau_t c;
+    if (!construire_coeur(&c, r)) {
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    // instances de durées inégales : distribution dynamique
+    bool ok = true;
+    long nb_instances = (long)plan->nb_instances;
+    #pragma omp parallel for num_threads(nb_threads) schedule(dynamic) reduction(&&:ok)
+    for (long k = 0; k < nb_instances; k++) {
+        ok = calculer_instance(plan, r, &c, (size_t)k) && ok;
+    }
+
+    if (ok) {
+        for (size_t i = 0; i < plan->nb_switchs; i++) {
+            for (int p = 0; p < r->switchs[i].nb_ports; p++) {
+                set_etat_port(&r->switchs[i], p, plan->roles[plan->debut[i] + p]);
+            }
+        }
+
+        plan->nb_tours = 0;
+        plan->nb_enregistrements = 0;
+        for (size_t k = 0; k < plan->nb_instances; k++) {
+            if (plan->resultats[k].nb_tours > plan->nb_tours) plan->nb_tours = plan->resultats[k].nb_tours;
+            plan->nb_enregistrements += plan->resultats[k].nb_bpdu;
+        }
+        plan->nb_bpdu = (uint64_t)nb_liens_coeur(&c) * plan->nb_tours;
+        plan->octets_bpdu = plan->nb_bpdu * TAILLE_BPDU_MST
+                            + (plan->nb_enregistrements - plan->resultats[0].nb_bpdu) * TAILLE_ENREGISTREMENT_MSTI;
+    }
+    deinit_coeur(&c);
+    PROFILER_SORTIR();
+    return ok;
+}
+
+const etat_port_t *roles_instance(const plan_mstp_t *plan, size_t instance, size_t sw) {
+    if (plan == NULL || instance >= plan->nb_instances || sw >= plan->nb_switchs) return NULL;
+    return plan->roles + instance * plan->nb_ports + plan->debut[sw];
+}
+
+const etat_port_t *roles_vlan(const plan_mstp_t *plan, size_t sw, uint16_t vlan) {
+    if (plan == NULL || vlan > VLAN_MAX) return NULL;
+    return roles_instance(plan, plan->instance_vlan[vlan], sw);
+}
+
+void afficher_mstp(const plan_mstp_t *plan) {
+    if (plan == NULL) {
+        printf("MSTP: NULL\n");
+        return;
+    }
+
+    printf("MSTP : %zu instance(s), %zu tours, %llu BPDU, %llu enregistrements, %llu octets\n", plan->nb_instances,
+           plan->nb_tours, (unsigned long long)plan->nb_bpdu, (unsigned long long)plan->nb_enregistrements,
+           (unsigned long long)plan->octets_bpdu);
+    for (size_t k = 0; k < plan->nb_instances; k++) {
+        const resultat_stp_t *res = &plan->resultats[k];
+        size_t nb_vlan = 0;
+        for (int v = 1; v <= VLAN_MAX; v++) {
+            if (plan->instance_vlan[v] == k) nb_vlan++;
+        }
+        printf("  %s %zu : racine %016llx, %zu VLAN, %zu tours, %zu port(s) bloqué(s)\n", k == 0 ? "CIST" : "MSTI", k,
+               (unsigned long long)res->racine, nb_vlan, res->nb_tours, res->nb_ports_bloques);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "reseau.h"
+#include "stp.h"
+
+// MSTP (802.1s) : les VLAN sont répartis entre plusieurs instances d'arbre
+// couvrant sur la même topologie. L'instance 0 (CIST) porte les VLAN non
+// associés et les trames sans VLAN ; chaque instance a ses propres priorités de
+// pont, donc sa racine et ses ports bloqués, ce qui répartit la charge entre
+// les liens. Les instances sont indépendantes : calculer_mstp les répartit sur
+// les threads OpenMP. Un BPDU MST transporte toutes les instances (un
+// enregistrement par MSTI) : le nombre de BPDU est celui de l'instance la plus
+// longue, leur taille croît avec le nombre d'instances.
+#define NB_INSTANCES_MAX 65           // CIST + 64 MSTI
+#define TAILLE_BPDU_MST 102           // octets, CIST et en-tête MST compris
+#define TAILLE_ENREGISTREMENT_MSTI 16
+
+typedef struct {
+    size_t nb_instances;
+    size_t nb_switchs;
+    size_t nb_ports;                   // ports de tous les switchs
+    size_t *debut;                     // premier port global de chaque switch
+    uint8_t instance_vlan[VLAN_MAX + 1];
+    int *priorites;                    // nb_instances x nb_switchs
+    etat_port_t *roles;                // nb_instances x nb_ports, rôle de debut[i] + p dans l'instance
+    resultat_stp_t *resultats;         // par instance
+    size_t nb_tours;                   // tours jusqu'à convergence de toutes les instances
+    uint64_t nb_bpdu;                  // BPDU MST émis
+    uint64_t nb_enregistrements;       // enregistrements d'instance transportés (CIST comprise)
+    uint64_t octets_bpdu;
+} plan_mstp_t;
+
+// Toutes les instances reprennent la priorité configurée de chaque switch
+// et tous les VLAN sont associés à la CIST
+bool init_plan_mstp(plan_mstp_t *plan, const reseau_t *r, size_t nb_instances);
+void deinit_plan_mstp(plan_mstp_t *plan);
+
+bool associer_vlan_instance(plan_mstp_t *plan, uint16_t vlan, size_t instance);
+bool regler_priorite_instance(plan_mstp_t *plan, size_t instance, size_t sw, int priorite);
+
+// Calcule toutes les instances ; la CIST est appliquée aux ports des switchs,
+// les autres restent dans le plan. nb_threads <= 0 : valeur par défaut d'OpenMP.
+bool calculer_mstp(plan_mstp_t *plan, reseau_t *r, int nb_threads);
+
+// Rôles des ports du switch d'indice sw dans une instance, ou dans celle du VLAN
+const etat_port_t *roles_instance(const plan_mstp_t *plan, size_t instance, size_t sw);
+const etat_port_t *roles_vlan(const plan_mstp_t *plan, size_t sw, uint16_t vlan);
+
+void afficher_mstp(const plan_mstp_t *plan);
@@ -0,0 +1,266 @@
+#include "multichemin.h"
+#include "memoire.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Index dans r->switchs du switch relié au port, ou UNKNOWN_INDEX
+static size_t switch_voisin(const reseau_t *r, const port_info_t *port) {
+    if (!port->actif || port->voisin == UNKNOWN_INDEX || r->equipements[port->voisin].type != EQUIPEMENT_SWITCH) {
+        return UNKNOWN_INDEX;
+    }
+    return r->equipements[port->voisin].index;
+}
+
+// Switch et port auxquels la station est raccordée, false si elle ne l'est pas
+static bool raccordement_station(const reseau_t *r, size_t station, size_t *sw, int *port) {
+    const raccordement_t *rc = &r->raccordements[station];
+    if (rc->voisin == UNKNOWN_INDEX || r->equipements[rc->voisin].type != EQUIPEMENT_SWITCH) return false;
+
+    *sw = r->equipements[rc->voisin].index;
+    *port = rc->port_voisin;
+    return true;
+}
+
+// File de priorité de Dijkstra : tas binaire à suppression paresseuse
+typedef struct {
+    uint32_t distance;
+    size_t sw;
+} noeud_t;
+
+typedef struct {
+    noeud_t *noeuds;
+    size_t nb;
+    size_t capacite;
+} tas_t;
+
+static bool empiler(tas_t *tas, uint32_t distance, size_t sw) {
+    if (tas->nb >= tas->capacite) {
+        size_t nouvelle_capacite = (tas->capacite == 0) ? 8 : tas->capacite * 2;
+        noeud_t *nouveaux = realloc(tas->noeuds, nouvelle_capacite * sizeof(noeud_t));
+        if (nouveaux == NULL) return false;
+
+        tas->noeuds = nouveaux;
+        tas->capacite = nouvelle_capacite;
+    }
+
+    size_t i = tas->nb++;
+    while (i > 0 && tas->noeuds[(i - 1) / 2].distance > distance) {
+        tas->noeuds[i] = tas->noeuds[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    tas->noeuds[i].distance = distance;
+    tas->noeuds[i].sw = sw;
+    return true;
+}
+
+static noeud_t depiler(tas_t *tas) {
+    noeud_t premier = tas->noeuds[0];
+    noeud_t dernier = tas->noeuds[--tas->nb];
+
+    size_t i = 0;
+    while (2 * i + 1 < tas->nb) {
+        size_t enfant = 2 * i + 1;
+        if (enfant + 1 < tas->nb && tas->noeuds[enfant + 1].distance < tas->noeuds[enfant].distance) enfant++;
+        if (tas->noeuds[enfant].distance >= dernier.distance) break;
+        tas->noeuds[i] = tas->noeuds[enfant];
+        i = enfant;
+    }
+    if (tas->nb > 0) tas->noeuds[i] = dernier;
+    return premier;
+}
+
+// Distances de tous les switchs vers la racine (liens symétriques)
+static bool dijkstra(const reseau_t *r, size_t racine, uint32_t *distances, tas_t *tas) {
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        distances[i] = DISTANCE_INFINIE;
+    }
+    distances[racine] = 0;
+    tas->nb = 0;
+    if (!empiler(tas, 0, racine)) return false;
+
+    while (tas->nb > 0) {
+        noeud_t n = depiler(tas);
+        if (n.distance != distances[n.sw]) continue;
+
+        const switch_t *sw = &r->switchs[n.sw];
+        for (int p = 0; p < sw->nb_ports; p++) {
+            size_t j = switch_voisin(r, &sw->ports[p]);
+            if (j == UNKNOWN_INDEX) continue;
+
+            uint32_t d = n.distance + (uint32_t)sw->ports[p].cout;
+            if (d < distances[j]) {
+                distances[j] = d;
+                if (!empiler(tas, d, j)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool calculer_plan_spb(plan_spb_t *plan, const reseau_t *r) {
+    if (plan == NULL || r == NULL) return false;
+
+    plan->nb_switchs = r->nb_switchs;
+    plan->nb_racines = 0;
+    plan->distances = NULL;
+    init_table_commutation(&plan->stations);
+    plan->ligne = allouer_memoire(MEMOIRE_TABLES, (r->nb_switchs > 0 ? r->nb_switchs : 1) * sizeof(size_t));
+    if (plan->ligne == NULL) return false;
+
+    // les switchs de bordure sont les seules racines nécessaires
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        plan->ligne[i] = UNKNOWN_INDEX;
+    }
+    for (size_t k = 0; k < r->nb_stations; k++) {
+        size_t sw;
+        int port;
+        if (!raccordement_station(r, k, &sw, &port)) continue;
+        if (plan->ligne[sw] == UNKNOWN_INDEX) plan->ligne[sw] = plan->nb_racines++;
+        if (!ajouter_entree_table(&plan->stations, r->stations[k].mac, (int)k)) {
+            deinit_plan_spb(plan);
+            return false;
+        }
+    }
+
+    plan->distances = allouer_memoire(MEMOIRE_TABLES, (plan->nb_racines * r->nb_switchs + 1) * sizeof(uint32_t));
+    tas_t tas = {NULL, 0, 0};
+    bool ok = plan->distances != NULL;
+    for (size_t i = 0; ok && i < r->nb_switchs; i++) {
+        if (plan->ligne[i] != UNKNOWN_INDEX) {
+            ok = dijkstra(r, i, &plan->distances[plan->ligne[i] * r->nb_switchs], &tas);
+        }
+    }
+    free(tas.noeuds);
+
+    if (!ok) deinit_plan_spb(plan);
+    return ok;
+}
+
+void deinit_plan_spb(plan_spb_t *plan) {
+    if (plan == NULL) return;
+
+    liberer_memoire(MEMOIRE_TABLES, plan->ligne, (plan->nb_switchs > 0 ? plan->nb_switchs : 1) * sizeof(size_t));
+    liberer_memoire(MEMOIRE_TABLES, plan->distances, (plan->nb_racines * plan->nb_switchs + 1) * sizeof(uint32_t));
+    deinit_table_commutation(&plan->stations);
+    plan->ligne = NULL;
+    plan->distances = NULL;
+    plan->nb_switchs = 0;
+    plan->nb_racines = 0;
+}
+
+uint32_t distance_spb(const plan_spb_t *plan, size_t sw, size_t racine) {
+    if (plan == NULL || sw >= plan->nb_switchs || racine >= plan->nb_switchs ||
+        plan->ligne[racine] == UNKNOWN_INDEX) {
+        return DISTANCE_INFINIE;
+    }
+    return plan->distances[plan->ligne[racine] * plan->nb_switchs + sw];
+}
+
+// Le port p de sw mène-t-il vers la racine par un plus court chemin ?
+static bool sur_plus_court_chemin(const plan_spb_t *plan, const reseau_t *r, size_t sw, int p, size_t racine) {
+    const port_info_t *port = &r->switchs[sw].ports[p];
+    size_t j = switch_voisin(r, port);
+    if (j == UNKNOWN_INDEX) return false;
+
+    uint32_t d = distance_spb(plan, sw, racine);
+    uint32_t dj = distance_spb(plan, j, racine);
+    return d != DISTANCE_INFINIE && dj != DISTANCE_INFINIE && dj + (uint32_t)port->cout == d;
+}
+
+int nb_chemins_egaux(const plan_spb_t *plan, const reseau_t *r, size_t sw, size_t racine) {
+    if (plan == NULL || r == NULL || sw >= r->nb_switchs) return 0;
+
+    int nb = 0;
+    for (int p = 0; p < r->switchs[sw].nb_ports; p++) {
+        if (sur_plus_court_chemin(plan, r, sw, p, racine)) nb++;
+    }
+    return nb;
+}
+
+// Hachage d'un flux, salé par le switch pour éviter que tous les switchs
+// fassent le même choix (polarisation)
+static uint64_t hacher_flux(mac_addr_t source, mac_addr_t destination, size_t sw) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 6; i++) {
+        h = (h ^ source.octet[i]) * 0x100000001b3ULL;
+    }
+    for (int i = 0; i < 6; i++) {
+        h = (h ^ destination.octet[i]) * 0x100000001b3ULL;
+    }
+    h ^= (uint64_t)sw * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+// Parent de j dans l'arbre des plus courts chemins enraciné en racine :
+// le voisin de plus petit indice situé sur un plus court chemin
+static size_t parent_arbre(const plan_spb_t *plan, const reseau_t *r, size_t j, size_t racine) {
+    size_t parent = UNKNOWN_INDEX;
+    const switch_t *sw = &r->switchs[j];
+    for (int p = 0; p < sw->nb_ports; p++) {
+        if (!sur_plus_court_chemin(plan, r, j, p, racine)) continue;
+        size_t k = switch_voisin(r, &sw->ports[p]);
+        if (k < parent) parent = k;
+    }
+    return parent;
+}
+
+static int diffuser_spb(const plan_spb_t *plan, const reseau_t *r, size_t sw, int port_entree,
+                        size_t racine, int ports_sortie[]) {
+    int nb = 0;
+    const switch_t *s = &r->switchs[sw];
+    for (int p = 0; p < s->nb_ports; p++) {
+        const port_info_t *port = &s->ports[p];
+        if (p == port_entree || !port->actif || port->voisin == UNKNOWN_INDEX) continue;
+
+        size_t j = switch_voisin(r, port);
+        if (j == UNKNOWN_INDEX) {
+            if (r->equipements[port->voisin].type == EQUIPEMENT_STATION) ports_sortie[nb++] = p;
+        } else if (parent_arbre(plan, r, j, racine) == sw) {
+            ports_sortie[nb++] = p;
+        }
+    }
+    return nb;
+}
+
+int acheminer_spb(const plan_spb_t *plan, const reseau_t *r, size_t sw, int port_entree,
+                  mac_addr_t source, mac_addr_t destination, int ports_sortie[]) {
+    if (plan == NULL || r == NULL || sw >= r->nb_switchs || ports_sortie == NULL) return 0;
+    if (!port_est_actif(&r->switchs[sw], port_entree)) return 0;
+
+    if (mac_est_diffusion(destination)) {
+        // arbre propre à la source : chaque trame n'est reçue qu'une fois par switch
+        int k = chercher_port_mac(&plan->stations, source);
+        size_t racine;
+        int port;
+        if (k < 0 || !raccordement_station(r, (size_t)k, &racine, &port)) return 0;
+        return diffuser_spb(plan, r, sw, port_entree, racine, ports_sortie);
+    }
+
+    int k = chercher_port_mac(&plan->stations, destination);
+    size_t cible;
+    int port_station;
+    if (k < 0 || !raccordement_station(r, (size_t)k, &cible, &port_station)) return 0;
+
+    if (cible == sw) {
+        if (port_station == port_entree) return 0;
+        ports_sortie[0] = port_station;
+        return 1;
+    }
+
+    // ECMP : choix stable par flux parmi les prochains sauts de coût égal
+    int candidats = nb_chemins_egaux(plan, r, sw, cible);
+    if (candidats == 0) return 0;
+
+    int choix = (int)(hacher_flux(source, destination, sw) % (uint64_t)candidats);
+    const switch_t *s = &r->switchs[sw];
+    for (int p = 0; p < s->nb_ports; p++) {
+        if (sur_plus_court_chemin(plan, r, sw, p, cible) && choix-- == 0) {
+            ports_sortie[0] = p;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "reseau.h"
+
+// Acheminement par plus courts chemins (façon SPB/TRILL) : chaque switch connaît
+// la distance de tout switch vers chaque switch de bordure (portant des stations),
+// calculée par Dijkstra sur les coûts des liens. Aucun lien n'est bloqué :
+// - unicast : répartition par flux (hachage MAC source/destination) entre les
+//   prochains sauts de coût égal (ECMP)
+// - diffusion : arbre des plus courts chemins enraciné au switch de la source
+#define DISTANCE_INFINIE UINT32_MAX
+
+typedef struct {
+    size_t nb_switchs;
+    size_t nb_racines;            // switchs de bordure
+    size_t *ligne;                // ligne de distances de chaque switch, UNKNOWN_INDEX s'il n'est pas de bordure
+    uint32_t *distances;          // nb_racines x nb_switchs : coût du switch vers la racine
+    table_commutation_t stations; // MAC -> indice de station (le "port" de la table)
+} plan_spb_t;
+
+bool calculer_plan_spb(plan_spb_t *plan, const reseau_t *r);
+void deinit_plan_spb(plan_spb_t *plan);
+
+uint32_t distance_spb(const plan_spb_t *plan, size_t sw, size_t racine);
+
+// Ports de sortie du switch d'indice sw pour une trame reçue sur port_entree,
+// même convention que commuter_trame. Renvoie le nombre de ports.
+int acheminer_spb(const plan_spb_t *plan, const reseau_t *r, size_t sw, int port_entree,
+                  mac_addr_t source, mac_addr_t destination, int ports_sortie[]);
+
+// Nombre de prochains sauts de coût égal du switch sw vers le switch racine
+int nb_chemins_egaux(const plan_spb_t *plan, const reseau_t *r, size_t sw, size_t racine);
@@ -0,0 +1,295 @@
+#define _POSIX_C_SOURCE 199309L
+#include "profileur.h"
+#include "journal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Nœud de l'arbre des appels d'un thread : une phase dans un contexte d'appel donné
+typedef struct {
+    const char *nom;
+    int parent;
+    int premier_fils;        // -1 si aucun
+    int frere;               // fils suivant du même parent, -1 si aucun
+    uint64_t nb_appels;
+    uint64_t ticks;          // temps total, sous-phases comprises
+} noeud_profil_t;
+
+typedef struct tampon_profil {
+    noeud_profil_t noeuds[NB_NOEUDS_PROFIL_MAX];   // 0 : racine du thread
+    int nb_noeuds;
+    int pile[PROFONDEUR_PROFIL_MAX];               // nœud de chaque phase ouverte, -1 si perdue
+    uint64_t debuts[PROFONDEUR_PROFIL_MAX];
+    int profondeur;                                // peut dépasser la limite : phases perdues
+    int courant;
+    uint64_t nb_perdues;
+    struct tampon_profil *suivant;
+} tampon_profil_t;
+
+static __thread tampon_profil_t *tampon;
+static tampon_profil_t *tampons;                   // tous les threads, pour le bilan
+static pthread_mutex_t verrou = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t origine_ticks, origine_ns;         // étalonnage du compteur
+static char *fichier_sortie;
+
+bool profileur_compile(void) {
+#ifdef PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+static uint64_t nanosecondes(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Compteur de cycles quand il existe (quelques ns par lecture), horloge monotone sinon
+static inline uint64_t lire_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return nanosecondes();
+#endif
+}
+
+static void vider_tampon(tampon_profil_t *t) {
+    t->nb_noeuds = 1;
+    t->noeuds[0] = (noeud_profil_t){NULL, -1, -1, -1, 0, 0};
+    t->profondeur = 0;
+    t->courant = 0;
+    t->nb_perdues = 0;
+}
+
+// Tampon du thread appelant, créé et inscrit au premier appel
+static tampon_profil_t *tampon_courant(void) {
+    if (tampon != NULL) return tampon;
+
+    tampon_profil_t *t = malloc(sizeof(tampon_profil_t));
+    if (t == NULL) return NULL;
+    vider_tampon(t);
+    pthread_mutex_lock(&verrou);
+    if (tampons == NULL && origine_ns == 0) {
+        origine_ns = nanosecondes();
+        origine_ticks = lire_ticks();
+    }
+    t->suivant = tampons;
+    tampons = t;
+    pthread_mutex_unlock(&verrou);
+    tampon = t;
+    return t;
+}
+
+// Fils de parent portant ce nom, créé s'il n'existe pas ; -1 si le tampon est plein
+static int fils_nomme(tampon_profil_t *t, int parent, const char *nom) {
+    int dernier = -1;
+    for (int n = t->noeuds[parent].premier_fils; n != -1; n = t->noeuds[n].frere) {
+        if (t->noeuds[n].nom == nom || strcmp(t->noeuds[n].nom, nom) == 0) return n;
+        dernier = n;
+    }
+    if (t->nb_noeuds >= NB_NOEUDS_PROFIL_MAX) return -1;
+
+    int n = t->nb_noeuds++;
+    t->noeuds[n] = (noeud_profil_t){nom, parent, -1, -1, 0, 0};
+    if (dernier == -1) {
+        t->noeuds[parent].premier_fils = n;
+    } else {
+        t->noeuds[dernier].frere = n;
+    }
+    return n;
+}
+
+void entrer_phase(const char *nom) {
+    tampon_profil_t *t = tampon_courant();
+    if (t == NULL || nom == NULL) return;
+    if (t->profondeur >= PROFONDEUR_PROFIL_MAX) {
+        t->profondeur++;
+        t->nb_perdues++;
+        return;
+    }
+
+    int n = fils_nomme(t, t->courant, nom);
+    if (n == -1) {
+        t->nb_perdues++;
+    } else {
+        t->courant = n;
+    }
+    t->pile[t->profondeur] = n;
+    // lu en dernier : la recherche du nœud n'est pas comptée dans la phase
+    t->debuts[t->profondeur++] = lire_ticks();
+}
+
+void sortir_phase(void) {
+    uint64_t fin = lire_ticks();
+    tampon_profil_t *t = tampon;
+    if (t == NULL || t->profondeur == 0) return;
+
+    if (--t->profondeur >= PROFONDEUR_PROFIL_MAX) return;
+    int n = t->pile[t->profondeur];
+    if (n == -1) return;
+    t->noeuds[n].ticks += fin - t->debuts[t->profondeur];
+    t->noeuds[n].nb_appels++;
+    t->courant = t->noeuds[n].parent;
+}
+
+void reinitialiser_profil(void) {
+    pthread_mutex_lock(&verrou);
+    for (tampon_profil_t *t = tampons; t != NULL; t = t->suivant) vider_tampon(t);
+    pthread_mutex_unlock(&verrou);
+}
+
+uint64_t nb_phases_mesurees(void) {
+    uint64_t nb = 0;
+    pthread_mutex_lock(&verrou);
+    for (tampon_profil_t *t = tampons; t != NULL; t = t->suivant) {
+        for (int n = 1; n < t->nb_noeuds; n++) nb += t->noeuds[n].nb_appels;
+    }
+    pthread_mutex_unlock(&verrou);
+    return nb;
+}
+
+uint64_t nb_phases_perdues(void) {
+    uint64_t nb = 0;
+    pthread_mutex_lock(&verrou);
+    for (tampon_profil_t *t = tampons; t != NULL; t = t->suivant) nb += t->nb_perdues;
+    pthread_mutex_unlock(&verrou);
+    return nb;
+}
+
+// Nanosecondes par tick, mesurées depuis le premier tampon (au moins 10 ms)
+static double etalonner(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t ns = nanosecondes();
+    while (ns - origine_ns < 10000000ULL) ns = nanosecondes();
+    uint64_t ticks = lire_ticks();
+    return (ticks > origine_ticks) ? (double)(ns - origine_ns) / (double)(ticks - origine_ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+// Temps propre d'un nœud : son total moins celui de ses sous-phases
+static uint64_t ticks_propres(const tampon_profil_t *t, int n) {
+    uint64_t enfants = 0;
+    for (int k = t->noeuds[n].premier_fils; k != -1; k = t->noeuds[k].frere) enfants += t->noeuds[k].ticks;
+    return (t->noeuds[n].ticks > enfants) ? t->noeuds[n].ticks - enfants : 0;
+}
+
+typedef struct {
+    const char *nom;
+    uint64_t nb_appels;
+    uint64_t ticks;
+    uint64_t propres;
+} bilan_phase_t;
+
+static int comparer_phases(const void *a, const void *b) {
+    const bilan_phase_t *p1 = a, *p2 = b;
+    if (p1->propres != p2->propres) return (p1->propres > p2->propres) ? -1 : 1;
+    return strcmp(p1->nom, p2->nom);
+}
+
+void afficher_bilan_profil(FILE *f) {
+    if (f == NULL) return;
+
+    pthread_mutex_lock(&verrou);
+    size_t capacite = 0;
+    for (tampon_profil_t *t = tampons; t != NULL; t = t->suivant) capacite += t->nb_noeuds;
+    bilan_phase_t *phases = malloc((capacite > 0 ? capacite : 1) * sizeof(bilan_phase_t));
+    if (phases == NULL) {
+        pthread_mutex_unlock(&verrou);
+        return;
+    }
+
+    // fusion par nom : une phase appelée depuis plusieurs contextes ou threads n'a qu'une ligne
+    size_t nb = 0;
+    uint64_t total_propres = 0, perdues = 0;
+    for (tampon_profil_t *t = tampons; t != NULL; t = t->suivant) {
+        perdues += t->nb_perdues;
+        for (int n = 1; n < t->nb_noeuds; n++) {
+            size_t k = 0;
+            while (k < nb && strcmp(phases[k].nom, t->noeuds[n].nom) != 0) k++;
+            if (k == nb) phases[nb++] = (bilan_phase_t){t->noeuds[n].nom, 0, 0, 0};
+            uint64_t propres = ticks_propres(t, n);
+            phases[k].nb_appels += t->noeuds[n].nb_appels;
+            phases[k].ticks += t->noeuds[n].ticks;
+            phases[k].propres += propres;
+            total_propres += propres;
+        }
+    }
+    double ns_par_tick = etalonner();
+    pthread_mutex_unlock(&verrou);
+
+    qsort(phases, nb, sizeof(bilan_phase_t), comparer_phases);
+    fprintf(f, "Profil par phase (%s) :\n", profileur_compile() ? "instrumentation compilée" : "sans -DPROFILER");
+    fprintf(f, "  %-20s %10s %12s %12s %7s\n", "phase", "appels", "total ms", "propre ms", "part");
+    for (size_t k = 0; k < nb; k++) {
+        fprintf(f, "  %-20s %10llu %12.3f %12.3f %6.1f %%\n", phases[k].nom, (unsigned long long)phases[k].nb_appels,
+                phases[k].ticks * ns_par_tick / 1e6, phases[k].propres * ns_par_tick / 1e6,
+                total_propres > 0 ? 100.0 * phases[k].propres / total_propres : 0.0);
+    }
+    if (perdues > 0) fprintf(f, "  %llu phase(s) perdue(s) : tampon plein ou imbrication trop profonde\n",
+                             (unsigned long long)perdues);
+    free(phases);
+}
+
+// Parcours en profondeur : chemin contient les phases des ancêtres séparées par ';'
+static void ecrire_noeud(FILE *f, const tampon_profil_t *t, int n, char *chemin, size_t longueur, double ns_par_tick) {
+    int ecrits = snprintf(chemin + longueur, PROFONDEUR_PROFIL_MAX * 64 - longueur, "%s%s", longueur > 0 ? ";" : "",
+                          t->noeuds[n].nom);
+    if (ecrits < 0 || longueur + ecrits >= PROFONDEUR_PROFIL_MAX * 64) return;
+    longueur += ecrits;
+
+    uint64_t us = (uint64_t)(ticks_propres(t, n) * ns_par_tick / 1e3 + 0.5);
+    if (us > 0) fprintf(f, "%s %llu\n", chemin, (unsigned long long)us);
+    for (int k = t->noeuds[n].premier_fils; k != -1; k = t->noeuds[k].frere) {
+        ecrire_noeud(f, t, k, chemin, longueur, ns_par_tick);
+    }
+}
+
+bool ecrire_piles_profil(FILE *f) {
+    if (f == NULL) return false;
+
+    char chemin[PROFONDEUR_PROFIL_MAX * 64];
+    pthread_mutex_lock(&verrou);
+    double ns_par_tick = etalonner();
+    // les piles identiques de plusieurs threads sont additionnées par les outils
+    for (tampon_profil_t *t = tampons; t != NULL; t = t->suivant) {
+        for (int k = t->noeuds[0].premier_fils; k != -1; k = t->noeuds[k].frere) {
+            ecrire_noeud(f, t, k, chemin, 0, ns_par_tick);
+        }
+    }
+    pthread_mutex_unlock(&verrou);
+    return !ferror(f);
+}
+
+static void terminer_profil(void) {
+    afficher_bilan_profil(stderr);
+    if (fichier_sortie == NULL) return;
+
+    FILE *f = fopen(fichier_sortie, "w");
+    if (f == NULL || !ecrire_piles_profil(f)) {
+        JOURNALISER_TEXTE(JOURNAL_ERREUR, "Écriture des piles dans %s impossible", fichier_sortie, 0, 0, 0);
+    }
+    if (f != NULL) fclose(f);
+    free(fichier_sortie);
+    fichier_sortie = NULL;
+}
+
+bool profiler_a_la_sortie(const char *fichier_piles) {
+    static bool inscrit = false;
+    free(fichier_sortie);
+    fichier_sortie = NULL;
+    if (fichier_piles != NULL) {
+        fichier_sortie = malloc(strlen(fichier_piles) + 1);
+        if (fichier_sortie == NULL) return false;
+        strcpy(fichier_sortie, fichier_piles);
+    }
+    if (!inscrit) inscrit = atexit(terminer_profil) == 0;
+    return inscrit;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Profilage par phases : chaque phase instrumentée est encadrée par
+// PROFILER_ENTRER("nom") / PROFILER_SORTIR(), qui doivent être appariés sur
+// tous les chemins. Chaque thread accumule ses phases dans son propre tampon
+// (arbre des appels imbriqués, sans verrou) ; le bilan fusionne les tampons.
+// Compilé avec -DPROFILER, le code instrumenté (configuration, cœur, STP,
+// acheminement) appelle le profileur ; sans, les macros disparaissent du
+// binaire. Les phases sont grossières (une par calcul ou par boucle
+// d'événements, jamais par trame) pour rester sous 1 % du temps d'exécution.
+#ifdef PROFILER
+#define PROFILER_ENTRER(nom) entrer_phase(nom)
+#define PROFILER_SORTIR() sortir_phase()
+#else
+#define PROFILER_ENTRER(nom) ((void)0)
+#define PROFILER_SORTIR() ((void)0)
+#endif
+
+#define PROFONDEUR_PROFIL_MAX 32   // phases imbriquées par thread
+#define NB_NOEUDS_PROFIL_MAX 512   // chemins d'appel distincts par thread
+
+// nom : chaîne littérale (gardée par pointeur). Au-delà des limites, la phase
+// est ignorée et comptée comme perdue.
+void entrer_phase(const char *nom);
+void sortir_phase(void);
+
+// Vrai si l'instrumentation est compilée (-DPROFILER)
+bool profileur_compile(void);
+
+// Tableau par phase, toutes imbrications et tous threads confondus : appels,
+// temps total, temps propre (hors sous-phases) et part du temps propre cumulé
+void afficher_bilan_profil(FILE *f);
+// Piles repliées pour flamegraph.pl, inferno ou speedscope :
+// "phase;sous_phase microsecondes_propres", une ligne par chemin d'appel
+bool ecrire_piles_profil(FILE *f);
+// Bilan sur stderr et piles dans le fichier à la fin du programme (atexit)
+bool profiler_a_la_sortie(const char *fichier_piles);
+// Oublie les mesures ; à appeler quand aucune phase n'est ouverte
+void reinitialiser_profil(void);
+// Phases refermées et phases ignorées, tous threads confondus
+uint64_t nb_phases_mesurees(void);
+uint64_t nb_phases_perdues(void);
@@ -0,0 +1,263 @@
+#include "renumerotation.h"
+#include "journal.h"
+#include "memoire.h"
+#include "profileur.h"
+#include <stdlib.h>
+
+// Adjacence compacte construite depuis la liste des arêtes :
+// les voisins de s sont voisins[debut[s] .. debut[s + 1])
+typedef struct {
+    size_t *debut;
+    sommet *voisins;
+} adjacence_t;
+
+static bool construire_adjacence(const graphe *g, adjacence_t *adj) {
+    size_t n = ordre(g);
+    adj->debut = calloc(n + 1, sizeof(size_t));
+    adj->voisins = malloc((2 * g->nb_aretes + 1) * sizeof(sommet));
+    size_t *curseur = malloc((n + 1) * sizeof(size_t));
+    if (adj->debut == NULL || adj->voisins == NULL || curseur == NULL) {
+        free(adj->debut);
+        free(adj->voisins);
+        free(curseur);
+        return false;
+    }
+
+    for (size_t i = 0; i < g->nb_aretes; i++) {
+        adj->debut[g->aretes[i].s1 + 1]++;
+        adj->debut[g->aretes[i].s2 + 1]++;
+    }
+    for (size_t s = 0; s < n; s++) {
+        adj->debut[s + 1] += adj->debut[s];
+        curseur[s] = adj->debut[s];
+    }
+    for (size_t i = 0; i < g->nb_aretes; i++) {
+        adj->voisins[curseur[g->aretes[i].s1]++] = g->aretes[i].s2;
+        adj->voisins[curseur[g->aretes[i].s2]++] = g->aretes[i].s1;
+    }
+    free(curseur);
+    return true;
+}
+
+static size_t degre(const adjacence_t *adj, sommet s) {
+    return adj->debut[s + 1] - adj->debut[s];
+}
+
+// Sommets par degré croissant (tri par dénombrement), départs des composantes suivantes
+static sommet *trier_par_degre(const adjacence_t *adj, size_t n) {
+    size_t degre_max = 0;
+    for (sommet s = 0; s < n; s++) {
+        if (degre(adj, s) > degre_max) degre_max = degre(adj, s);
+    }
+
+    size_t *compte = calloc(degre_max + 2, sizeof(size_t));
+    sommet *tries = malloc((n + 1) * sizeof(sommet));
+    if (compte == NULL || tries == NULL) {
+        free(compte);
+        free(tries);
+        return NULL;
+    }
+    for (sommet s = 0; s < n; s++) {
+        compte[degre(adj, s) + 1]++;
+    }
+    for (size_t d = 0; d <= degre_max; d++) {
+        compte[d + 1] += compte[d];
+    }
+    for (sommet s = 0; s < n; s++) {
+        tries[compte[degre(adj, s)]++] = s;
+    }
+    free(compte);
+    return tries;
+}
+
+/**
+ * Ordre de parcours en largeur, composante par composante. En mode RCM, les
+ * voisins d'un sommet sont enfilés par degré croissant et l'ordre est renversé.
+ * @return nouveau[s] : nouvel indice du sommet s, NULL en cas d'échec
+ */
+static sommet *calculer_permutation(const graphe *g, sommet racine, methode_renumerotation_t methode) {
+    size_t n = ordre(g);
+    adjacence_t adj;
+    if (!construire_adjacence(g, &adj)) return NULL;
+
+    sommet *parcours = malloc((n + 1) * sizeof(sommet));
+    sommet *nouveau = malloc((n + 1) * sizeof(sommet));
+    bool *visite = calloc(n + 1, sizeof(bool));
+    sommet *departs = trier_par_degre(&adj, n);
+    if (parcours == NULL || nouveau == NULL || visite == NULL || departs == NULL) {
+        free(parcours);
+        free(nouveau);
+        nouveau = NULL;
+        goto fin;
+    }
+
+    size_t nb = 0;
+    size_t prochain_depart = 0;
+    while (nb < n) {
+        sommet depart = racine;
+        if (nb > 0 || depart >= n) {
+            while (visite[departs[prochain_depart]]) prochain_depart++;
+            depart = departs[prochain_depart];
+        }
+        visite[depart] = true;
+        parcours[nb++] = depart;
+
+        // le tableau de parcours sert de file
+        for (size_t tete = nb - 1; tete < nb; tete++) {
+            sommet s = parcours[tete];
+            size_t premier = nb;
+            for (size_t k = adj.debut[s]; k < adj.debut[s + 1]; k++) {
+                sommet v = adj.voisins[k];
+                if (visite[v]) continue;
+                visite[v] = true;
+                parcours[nb++] = v;
+            }
+            if (methode != RENUMEROTATION_RCM) continue;
+
+            // tri par insertion : un sommet a au plus quelques dizaines de voisins
+            for (size_t i = premier + 1; i < nb; i++) {
+                sommet v = parcours[i];
+                size_t j = i;
+                while (j > premier && degre(&adj, parcours[j - 1]) > degre(&adj, v)) {
+                    parcours[j] = parcours[j - 1];
+                    j--;
+                }
+                parcours[j] = v;
+            }
+        }
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        nouveau[parcours[k]] = (methode == RENUMEROTATION_RCM) ? n - 1 - k : k;
+    }
+    free(parcours);
+
+fin:
+    free(visite);
+    free(departs);
+    free(adj.debut);
+    free(adj.voisins);
+    return nouveau;
+}
+
+// Graphe reconstruit avec les arêtes dans le même ordre : union-find,
+// boucles et index d'arêtes sont recalculés à l'identique aux indices près
+static bool renumeroter_graphe(const graphe *g, const sommet *nouveau, graphe *resultat) {
+    init_graphe(resultat);
+    for (size_t s = 0; s < ordre(g); s++) {
+        if (!ajouter_sommet(resultat)) return false;
+    }
+
+    for (size_t i = 0; i < g->nb_aretes; i++) {
+        arete a = g->aretes[i];
+        a.s1 = nouveau[a.s1];
+        a.s2 = nouveau[a.s2];
+        if (!ajouter_arete(resultat, a)) return false;
+    }
+    return true;
+}
+
+bool renumeroter_reseau(reseau_t *r, sommet racine, methode_renumerotation_t methode) {
+    if (r == NULL) return false;
+
+    PROFILER_ENTRER("renumerotation");
+    // nouveaux tableaux aux capacités d'origine : les ajouts ultérieurs restent possibles
+    size_t n = ordre(&r->g);
+    size_t capacite = r->equipements_capacite > 0 ? r->equipements_capacite : 1;
+    size_t capacite_switchs = r->switchs_capacite > 0 ? r->switchs_capacite : 1;
+    size_t capacite_stations = r->stations_capacite > 0 ? r->stations_capacite : 1;
+    sommet *nouveau = calculer_permutation(&r->g, racine, methode);
+    sommet *ancien = malloc((n + 1) * sizeof(sommet));
+    equipement_t *equipements = allouer_memoire(MEMOIRE_EQUIPEMENTS, capacite * sizeof(equipement_t));
+    switch_t *switchs = allouer_memoire(MEMOIRE_EQUIPEMENTS, capacite_switchs * sizeof(switch_t));
+    station_t *stations = allouer_memoire(MEMOIRE_EQUIPEMENTS, capacite_stations * sizeof(station_t));
+    raccordement_t *raccordements = allouer_memoire(MEMOIRE_EQUIPEMENTS, capacite_stations * sizeof(raccordement_t));
+    sommet *origine = allouer_memoire(MEMOIRE_EQUIPEMENTS, capacite * sizeof(sommet));
+    sommet *renumerote = allouer_memoire(MEMOIRE_EQUIPEMENTS, capacite * sizeof(sommet));
+    bool alloue = nouveau != NULL && ancien != NULL && equipements != NULL && switchs != NULL &&
+                  stations != NULL && raccordements != NULL && origine != NULL && renumerote != NULL;
+    graphe g;
+    if (!alloue || !renumeroter_graphe(&r->g, nouveau, &g)) {
+        JOURNALISER(JOURNAL_ERREUR, "Mémoire insuffisante pour renuméroter le réseau", 0, 0, 0, 0);
+        if (alloue) deinit_graphe(&g);
+        free(nouveau);
+        free(ancien);
+        liberer_memoire(MEMOIRE_EQUIPEMENTS, equipements, capacite * sizeof(equipement_t));
+        liberer_memoire(MEMOIRE_EQUIPEMENTS, switchs, capacite_switchs * sizeof(switch_t));
+        liberer_memoire(MEMOIRE_EQUIPEMENTS, stations, capacite_stations * sizeof(station_t));
+        liberer_memoire(MEMOIRE_EQUIPEMENTS, raccordements, capacite_stations * sizeof(raccordement_t));
+        liberer_memoire(MEMOIRE_EQUIPEMENTS, origine, capacite * sizeof(sommet));
+        liberer_memoire(MEMOIRE_EQUIPEMENTS, renumerote, capacite * sizeof(sommet));
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    for (sommet s = 0; s < n; s++) {
+        ancien[nouveau[s]] = s;
+    }
+
+    // les équipements sont rangés dans l'ordre des nouveaux sommets
+    size_t nb_switchs = 0, nb_stations = 0;
+    for (sommet k = 0; k < n; k++) {
+        equipement_t e = r->equipements[ancien[k]];
+        switch (e.type) {
+            case EQUIPEMENT_SWITCH: {
+                switch_t *sw = &switchs[nb_switchs];
+                *sw = r->switchs[e.index];
+                for (int p = 0; p < sw->nb_ports; p++) {
+                    if (sw->ports[p].voisin != UNKNOWN_INDEX) sw->ports[p].voisin = nouveau[sw->ports[p].voisin];
+                }
+                e.index = nb_switchs++;
+                break;
+            }
+            case EQUIPEMENT_STATION:
+                stations[nb_stations] = r->stations[e.index];
+                raccordements[nb_stations] = r->raccordements[e.index];
+                if (raccordements[nb_stations].voisin != UNKNOWN_INDEX) {
+                    raccordements[nb_stations].voisin = nouveau[raccordements[nb_stations].voisin];
+                }
+                e.index = nb_stations++;
+                break;
+            default:
+                break;
+        }
+        equipements[k] = e;
+        origine[k] = sommet_origine(r, ancien[k]);
+        renumerote[origine[k]] = k;
+    }
+
+    deinit_graphe(&r->g);
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->equipements, r->equipements_capacite * sizeof(equipement_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->switchs, r->switchs_capacite * sizeof(switch_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->stations, r->stations_capacite * sizeof(station_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->raccordements, r->stations_capacite * sizeof(raccordement_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->origine, r->equipements_capacite * sizeof(sommet));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->renumerote, r->equipements_capacite * sizeof(sommet));
+    r->g = g;
+    r->equipements = equipements;
+    r->equipements_capacite = capacite;
+    r->switchs = switchs;
+    r->switchs_capacite = capacite_switchs;
+    r->stations = stations;
+    r->raccordements = raccordements;
+    r->stations_capacite = capacite_stations;
+    r->origine = origine;
+    r->renumerote = renumerote;
+
+    free(nouveau);
+    free(ancien);
+    PROFILER_SORTIR();
+    return true;
+}
+
+size_t largeur_bande(const reseau_t *r) {
+    if (r == NULL) return 0;
+
+    size_t largeur = 0;
+    for (size_t i = 0; i < r->g.nb_aretes; i++) {
+        const arete *a = &r->g.aretes[i];
+        size_t ecart = (a->s1 > a->s2) ? a->s1 - a->s2 : a->s2 - a->s1;
+        if (ecart > largeur) largeur = ecart;
+    }
+    return largeur;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include "reseau.h"
+
+// Renumérotation des sommets pour la localité mémoire : les équipements voisins
+// dans la topologie deviennent voisins dans tous les tableaux par équipement
+// (equipements, switchs, stations, raccordements). Les indices d'origine restent
+// accessibles par sommet_origine / sommet_depuis_origine.
+// À appliquer avant toute simulation ou plan multichemin, qui indexent les sommets.
+typedef enum {
+    RENUMEROTATION_BFS,   // ordre de parcours en largeur
+    RENUMEROTATION_RCM    // Cuthill-McKee inverse : voisins par degré croissant, ordre renversé
+} methode_renumerotation_t;
+
+// racine : sommet courant de départ ; les autres composantes partent de leur
+// sommet de plus petit degré. Partir du pont racine en BFS accélère aussi
+// calculer_stp, qui relaxe les switchs par indice croissant ; RCM le place en dernier.
+bool renumeroter_reseau(reseau_t *r, sommet racine, methode_renumerotation_t methode);
+
+// Largeur de bande : plus grand écart d'indices entre les extrémités d'un lien
+size_t largeur_bande(const reseau_t *r);
@@ -0,0 +1,304 @@
+#include "reseau.h"
+#include "journal.h"
+#include "memoire.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void init_reseau(reseau_t *r) {
+    if (r == NULL) return;
+
+    init_graphe(&r->g);
+    r->equipements = NULL;
+    r->equipements_capacite = 0;
+    r->switchs = NULL;
+    r->nb_switchs = 0;
+    r->switchs_capacite = 0;
+    r->stations = NULL;
+    r->raccordements = NULL;
+    r->nb_stations = 0;
+    r->stations_capacite = 0;
+    r->origine = NULL;
+    r->renumerote = NULL;
+}
+
+void deinit_reseau(reseau_t *r) {
+    if (r == NULL) return;
+
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        deinit_switch(&r->switchs[i]);
+    }
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->switchs, r->switchs_capacite * sizeof(switch_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->stations, r->stations_capacite * sizeof(station_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->raccordements, r->stations_capacite * sizeof(raccordement_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->equipements, r->equipements_capacite * sizeof(equipement_t));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->origine, r->equipements_capacite * sizeof(sommet));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->renumerote, r->equipements_capacite * sizeof(sommet));
+    deinit_graphe(&r->g);
+
+    r->equipements = NULL;
+    r->equipements_capacite = 0;
+    r->switchs = NULL;
+    r->nb_switchs = 0;
+    r->switchs_capacite = 0;
+    r->stations = NULL;
+    r->raccordements = NULL;
+    r->nb_stations = 0;
+    r->stations_capacite = 0;
+    r->origine = NULL;
+    r->renumerote = NULL;
+}
+
+void vider_reseau(reseau_t *r) {
+    // retire tous les équipements et liens en conservant les tableaux alloués,
+    // pour enchaîner les chargements sans réallouer
+    if (r == NULL) return;
+
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        deinit_switch(&r->switchs[i]);
+    }
+    r->nb_switchs = 0;
+    r->nb_stations = 0;
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->origine, r->equipements_capacite * sizeof(sommet));
+    liberer_memoire(MEMOIRE_EQUIPEMENTS, r->renumerote, r->equipements_capacite * sizeof(sommet));
+    r->origine = NULL;
+    r->renumerote = NULL;
+    vider_graphe(&r->g);
+}
+
+// Ajoute un sommet au graphe et lui associe un équipement
+static sommet ajouter_equipement(reseau_t *r, type_equipement_t type, size_t index) {
+    if (ordre(&r->g) >= r->equipements_capacite) {
+        size_t nouvelle_capacite = (r->equipements_capacite == 0) ? 8 : r->equipements_capacite * 2;
+        equipement_t *nouveaux = reallouer_memoire(MEMOIRE_EQUIPEMENTS, r->equipements,
+                                                   r->equipements_capacite * sizeof(equipement_t),
+                                                   nouvelle_capacite * sizeof(equipement_t));
+        if (nouveaux == NULL) return UNKNOWN_INDEX;
+
+        r->equipements = nouveaux;
+        if (r->origine != NULL) {
+            sommet *origine = reallouer_memoire(MEMOIRE_EQUIPEMENTS, r->origine,
+                                                r->equipements_capacite * sizeof(sommet),
+                                                nouvelle_capacite * sizeof(sommet));
+            if (origine != NULL) r->origine = origine;
+            sommet *renumerote = reallouer_memoire(MEMOIRE_EQUIPEMENTS, r->renumerote,
+                                                   r->equipements_capacite * sizeof(sommet),
+                                                   nouvelle_capacite * sizeof(sommet));
+            if (renumerote != NULL) r->renumerote = renumerote;
+            if (origine == NULL || renumerote == NULL) return UNKNOWN_INDEX;
+        }
+        r->equipements_capacite = nouvelle_capacite;
+    }
+
+    sommet s = ordre(&r->g);
+    if (!ajouter_sommet(&r->g)) return UNKNOWN_INDEX;
+
+    r->equipements[s].type = type;
+    r->equipements[s].index = index;
+    // un sommet ajouté après renumérotation garde son indice, inutilisé à l'origine
+    if (r->origine != NULL) {
+        r->origine[s] = s;
+        r->renumerote[s] = s;
+    }
+    return s;
+}
+
+sommet reseau_ajouter_switch(reseau_t *r, switch_t sw) {
+    if (r == NULL) return UNKNOWN_INDEX;
+
+    if (r->nb_switchs >= r->switchs_capacite) {
+        size_t nouvelle_capacite = (r->switchs_capacite == 0) ? 8 : r->switchs_capacite * 2;
+        switch_t *nouveaux = reallouer_memoire(MEMOIRE_EQUIPEMENTS, r->switchs, r->switchs_capacite * sizeof(switch_t),
+                                               nouvelle_capacite * sizeof(switch_t));
+        if (nouveaux == NULL) return UNKNOWN_INDEX;
+
+        r->switchs = nouveaux;
+        r->switchs_capacite = nouvelle_capacite;
+    }
+
+    sommet s = ajouter_equipement(r, EQUIPEMENT_SWITCH, r->nb_switchs);
+    if (s == UNKNOWN_INDEX) return UNKNOWN_INDEX;
+
+    r->switchs[r->nb_switchs] = sw;
+    r->nb_switchs++;
+    return s;
+}
+
+sommet reseau_ajouter_station(reseau_t *r, station_t st) {
+    if (r == NULL) return UNKNOWN_INDEX;
+
+    if (r->nb_stations >= r->stations_capacite) {
+        size_t nouvelle_capacite = (r->stations_capacite == 0) ? 8 : r->stations_capacite * 2;
+        station_t *nouvelles = reallouer_memoire(MEMOIRE_EQUIPEMENTS, r->stations,
+                                                 r->stations_capacite * sizeof(station_t),
+                                                 nouvelle_capacite * sizeof(station_t));
+        if (nouvelles == NULL) return UNKNOWN_INDEX;
+        r->stations = nouvelles;
+
+        raccordement_t *nouveaux = reallouer_memoire(MEMOIRE_EQUIPEMENTS, r->raccordements,
+                                                     r->stations_capacite * sizeof(raccordement_t),
+                                                     nouvelle_capacite * sizeof(raccordement_t));
+        if (nouveaux == NULL) return UNKNOWN_INDEX;
+        r->raccordements = nouveaux;
+
+        r->stations_capacite = nouvelle_capacite;
+    }
+
+    sommet s = ajouter_equipement(r, EQUIPEMENT_STATION, r->nb_stations);
+    if (s == UNKNOWN_INDEX) return UNKNOWN_INDEX;
+
+    r->stations[r->nb_stations] = st;
+    r->raccordements[r->nb_stations].voisin = UNKNOWN_INDEX;
+    r->raccordements[r->nb_stations].port_voisin = -1;
+    r->nb_stations++;
+    return s;
+}
+
+sommet reseau_ajouter_inconnu(reseau_t *r) {
+    // sommet réservé pour une ligne d'équipement illisible :
+    // les indices des équipements suivants restent ceux du fichier
+    if (r == NULL) return UNKNOWN_INDEX;
+    return ajouter_equipement(r, EQUIPEMENT_INCONNU, 0);
+}
+
+sommet sommet_origine(const reseau_t *r, sommet s) {
+    if (r == NULL || r->origine == NULL || s >= ordre(&r->g)) return s;
+    return r->origine[s];
+}
+
+sommet sommet_depuis_origine(const reseau_t *r, sommet origine) {
+    if (r == NULL || r->renumerote == NULL || origine >= ordre(&r->g)) return origine;
+    return r->renumerote[origine];
+}
+
+switch_t *reseau_switch(const reseau_t *r, sommet s) {
+    if (r == NULL || s >= ordre(&r->g) || r->equipements[s].type != EQUIPEMENT_SWITCH) {
+        return NULL;
+    }
+    return &r->switchs[r->equipements[s].index];
+}
+
+station_t *reseau_station(const reseau_t *r, sommet s) {
+    if (r == NULL || s >= ordre(&r->g) || r->equipements[s].type != EQUIPEMENT_STATION) {
+        return NULL;
+    }
+    return &r->stations[r->equipements[s].index];
+}
+
+// Port libre de l'équipement s : premier port libre d'un switch,
+// -1 pour une station non encore reliée, -2 si aucun port n'est disponible
+static int port_disponible(const reseau_t *r, sommet s) {
+    switch (r->equipements[s].type) {
+        case EQUIPEMENT_SWITCH: {
+            int port = premier_port_libre(&r->switchs[r->equipements[s].index]);
+            return (port < 0) ? -2 : port;
+        }
+        case EQUIPEMENT_STATION:
+            return (r->raccordements[r->equipements[s].index].voisin == UNKNOWN_INDEX) ? -1 : -2;
+        default:
+            return -2;
+    }
+}
+
+static void brancher(reseau_t *r, sommet s, int port, sommet voisin, int port_voisin, int poids) {
+    if (r->equipements[s].type == EQUIPEMENT_SWITCH) {
+        port_info_t *p = &r->switchs[r->equipements[s].index].ports[port];
+        p->voisin = voisin;
+        p->port_voisin = port_voisin;
+        p->cout = poids;
+        p->actif = true;
+    } else {
+        raccordement_t *rc = &r->raccordements[r->equipements[s].index];
+        rc->voisin = voisin;
+        rc->port_voisin = port_voisin;
+    }
+}
+
+bool reseau_relier(reseau_t *r, sommet s1, sommet s2, int poids) {
+    if (r == NULL || s1 >= ordre(&r->g) || s2 >= ordre(&r->g) || poids <= 0) {
+        return false;
+    }
+
+    int p1 = port_disponible(r, s1);
+    int p2 = port_disponible(r, s2);
+    if (p1 == -2 || p2 == -2) {
+        JOURNALISER(JOURNAL_ERREUR, "Aucun port disponible pour relier %llu et %llu", sommet_origine(r, s1),
+                    sommet_origine(r, s2), 0, 0);
+        return false;
+    }
+
+    arete a = {s1, s2, poids, false};
+    if (!ajouter_arete(&r->g, a)) return false;
+
+    brancher(r, s1, p1, s2, p2, poids);
+    brancher(r, s2, p2, s1, p1, poids);
+    return true;
+}
+
+// Port de l'équipement s relié à voisin : port du switch, -1 pour une station, -2 si aucun
+static int port_vers(const reseau_t *r, sommet s, sommet voisin) {
+    if (r->equipements[s].type == EQUIPEMENT_STATION) {
+        return (r->raccordements[r->equipements[s].index].voisin == voisin) ? -1 : -2;
+    }
+    const switch_t *sw = &r->switchs[r->equipements[s].index];
+    for (int p = 0; p < sw->nb_ports; p++) {
+        if (sw->ports[p].voisin == voisin) return p;
+    }
+    return -2;
+}
+
+static void debrancher(reseau_t *r, sommet s, int port) {
+    if (r->equipements[s].type == EQUIPEMENT_SWITCH) {
+        switch_t *sw = &r->switchs[r->equipements[s].index];
+        // désactiver le port purge les adresses apprises dessus
+        desactiver_port(sw, port);
+        set_etat_port(sw, port, PORT_INCONNU);
+        sw->ports[port].voisin = UNKNOWN_INDEX;
+        sw->ports[port].port_voisin = -1;
+        sw->ports[port].cout = 0;
+    } else {
+        raccordement_t *rc = &r->raccordements[r->equipements[s].index];
+        rc->voisin = UNKNOWN_INDEX;
+        rc->port_voisin = -1;
+    }
+}
+
+bool reseau_delier(reseau_t *r, sommet s1, sommet s2) {
+    if (r == NULL) return false;
+
+    arete a = {s1, s2, 0, false};
+    if (index_arete(&r->g, a) == UNKNOWN_INDEX) return false;
+
+    int p1 = port_vers(r, s1, s2);
+    int p2 = port_vers(r, s2, s1);
+    if (p1 == -2 || p2 == -2) return false;
+
+    debrancher(r, s1, p1);
+    debrancher(r, s2, p2);
+    return supprimer_arete(&r->g, a);
+}
+
+bool reseau_modifier_poids(reseau_t *r, sommet s1, sommet s2, int poids) {
+    if (r == NULL || poids <= 0) return false;
+
+    arete a = {s1, s2, 0, false};
+    size_t i = index_arete(&r->g, a);
+    if (i == UNKNOWN_INDEX) return false;
+
+    r->g.aretes[i].poids = poids;
+    // le coût STP des deux ports suit le poids du lien
+    sommet extremites[2] = {s1, s2};
+    for (int k = 0; k < 2; k++) {
+        switch_t *sw = reseau_switch(r, extremites[k]);
+        int p = port_vers(r, extremites[k], extremites[1 - k]);
+        if (sw != NULL && p >= 0) sw->ports[p].cout = poids;
+    }
+    return true;
+}
+
+bool reseau_modifier_priorite(reseau_t *r, sommet s, int priorite) {
+    switch_t *sw = reseau_switch(r, s);
+    if (sw == NULL || priorite < 0 || priorite > 0xFFFF) return false;
+
+    sw->priorite = priorite;
+    return true;
+}
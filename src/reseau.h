@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "graphe.h"
+#include "station.h"
+#include "switch.h"
+
+// Type d'équipement, tel qu'il apparaît dans les fichiers de configuration
+typedef enum {
+    EQUIPEMENT_INCONNU = 0,
+    EQUIPEMENT_STATION = 1,
+    EQUIPEMENT_SWITCH = 2
+} type_equipement_t;
+
+// Équipement associé à un sommet du graphe
+typedef struct {
+    type_equipement_t type;
+    size_t index;      // index dans reseau_t.switchs ou reseau_t.stations
+} equipement_t;
+
+// Raccordement de l'unique carte réseau d'une station
+typedef struct {
+    sommet voisin;     // UNKNOWN_INDEX si la station n'est pas reliée
+    int port_voisin;
+} raccordement_t;
+
+// Réseau local : graphe des liens + équipements portés par les sommets
+typedef struct {
+    graphe g;
+    equipement_t *equipements;     // un par sommet
+    size_t equipements_capacite;
+    switch_t *switchs;
+    size_t nb_switchs;
+    size_t switchs_capacite;
+    station_t *stations;
+    raccordement_t *raccordements; // un par station
+    size_t nb_stations;
+    size_t stations_capacite;
+    // après renumérotation : indice d'origine (ordre du fichier) de chaque sommet
+    // et réciproque, NULL tant que le réseau n'a pas été renuméroté
+    sommet *origine;
+    sommet *renumerote;
+} reseau_t;
+
+void init_reseau(reseau_t *r);
+void deinit_reseau(reseau_t *r);
+void vider_reseau(reseau_t *r);
+
+sommet reseau_ajouter_switch(reseau_t *r, switch_t sw);
+sommet reseau_ajouter_station(reseau_t *r, station_t st);
+sommet reseau_ajouter_inconnu(reseau_t *r);
+bool reseau_relier(reseau_t *r, sommet s1, sommet s2, int poids);
+bool reseau_delier(reseau_t *r, sommet s1, sommet s2);
+bool reseau_modifier_poids(reseau_t *r, sommet s1, sommet s2, int poids);
+bool reseau_modifier_priorite(reseau_t *r, sommet s, int priorite);
+
+// Traduction entre indices courants et indices d'origine, utilisés
+// pour les affichages et les fichiers de modifications
+sommet sommet_origine(const reseau_t *r, sommet s);
+sommet sommet_depuis_origine(const reseau_t *r, sommet origine);
+
+switch_t *reseau_switch(const reseau_t *r, sommet s);
+station_t *reseau_station(const reseau_t *r, sommet s);
@@ -0,0 +1,1272 @@
+#define _POSIX_C_SOURCE 199309L
+#include "simulation.h"
+#include "stp.h"
+#include "journal.h"
+#include "memoire.h"
+#include "profileur.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Une entrée purgée hors expiration (changement de rôle, port coupé) emporte sa temporisation
+static void annuler_vieillissement(void *contexte, int vieillissement) {
+    simulation_t *sim = contexte;
+    annuler_temporisation(&sim->roue, vieillissement);
+}
+
+void surveiller_purges_simulation(simulation_t *sim) {
+    reseau_t *r = sim->reseau;
+    for (size_t i = 0; i < r->nb_switchs; i++) surveiller_purges(&r->switchs[i].table, annuler_vieillissement, sim);
+}
+
+bool init_simulation(simulation_t *sim, reseau_t *r) {
+    if (sim == NULL || r == NULL) return false;
+
+    sim->reseau = r;
+    sim->horloge = 0;
+    sim->nb_evenements = 0;
+    sim->evenements_capacite = 64;
+    sim->sequence = 0;
+    sim->evenements = allouer_memoire(MEMOIRE_EVENEMENTS, sim->evenements_capacite * sizeof(evenement_t));
+    sim->capacite_file = CAPACITE_FILE_DEFAUT;
+    sim->politique = REJET_QUEUE;
+
+    // une file par port de switch et une par carte réseau de station
+    size_t n = ordre(&r->g);
+    sim->premiere_file = malloc((n + 1) * sizeof(size_t));
+    sim->nb_files = 0;
+    if (sim->premiere_file != NULL) {
+        for (size_t s = 0; s < n; s++) {
+            sim->premiere_file[s] = sim->nb_files;
+            switch (r->equipements[s].type) {
+                case EQUIPEMENT_SWITCH:
+                    sim->nb_files += r->switchs[r->equipements[s].index].nb_ports;
+                    break;
+                case EQUIPEMENT_STATION:
+                    sim->nb_files++;
+                    break;
+                default:
+                    break;
+            }
+        }
+        sim->premiere_file[n] = sim->nb_files;
+    }
+    sim->files = allouer_memoire_zero(MEMOIRE_FILES, sim->nb_files + 1, sizeof(file_sortie_t));
+
+    // le tampon de sortie doit contenir tous les ports du plus grand switch
+    sim->ports_capacite = 1;
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        if (r->switchs[i].nb_ports > sim->ports_capacite) {
+            sim->ports_capacite = r->switchs[i].nb_ports;
+        }
+    }
+    sim->ports_sortie = malloc(sim->ports_capacite * sizeof(int));
+
+    sim->compteurs.nb_emises = 0;
+    sim->compteurs.nb_livrees = 0;
+    sim->compteurs.nb_copies = 0;
+    sim->compteurs.nb_filtrees = 0;
+    sim->compteurs.nb_rejetees = 0;
+    sim->compteurs.octets_livres = 0;
+    sim->compteurs.nb_expirees = 0;
+    sim->compteurs.nb_recalculs_stp = 0;
+    sim->compteurs.nb_requetes_arp = 0;
+    sim->compteurs.nb_reponses_arp = 0;
+    sim->compteurs.nb_abandons_arp = 0;
+    sim->compteurs.nb_adhesions_oubliees = 0;
+    sim->spb = NULL;
+    sim->mstp = NULL;
+
+    init_histogramme(&sim->latence);
+    sim->paires = NULL;
+    sim->nb_paires = 0;
+    sim->paires_capacite = 0;
+    sim->chronometrer = false;
+    init_histogramme(&sim->temps_commutation);
+    init_roue(&sim->roue, RESOLUTION_TEMPORISATIONS);
+    sim->vieillissement = 0;
+    sim->tempo_ports = NULL;
+    sim->caches_arp = NULL;
+    sim->duree_cache_arp = DUREE_CACHE_ARP_DEFAUT;
+    sim->attentes_arp = NULL;
+    sim->nb_attentes_arp = 0;
+    sim->attentes_arp_capacite = 0;
+    sim->adhesions = NULL;
+    sim->nb_adhesions = 0;
+    sim->adhesions_capacite = 0;
+    sim->requete_multicast = TEMPORISATION_AUCUNE;
+    sim->rapport_multicast = TEMPORISATION_AUCUNE;
+
+    // les identifiants de temporisation d'une simulation précédente n'ont plus cours
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        table_commutation_t *table = &r->switchs[i].table;
+        for (int k = 0; k < table->taille; k++) {
+            table->entrees[k].vieillissement = TEMPORISATION_AUCUNE;
+        }
+    }
+    surveiller_purges_simulation(sim);
+
+    if (sim->evenements == NULL || sim->premiere_file == NULL || sim->files == NULL ||
+        sim->ports_sortie == NULL) {
+        deinit_simulation(sim);
+        return false;
+    }
+    return true;
+}
+
+void deinit_simulation(simulation_t *sim) {
+    if (sim == NULL) return;
+
+    for (size_t i = 0; i < sim->reseau->nb_switchs; i++) surveiller_purges(&sim->reseau->switchs[i].table, NULL, NULL);
+
+    // les trames encore en transit ou en attente rendent leur référence sur la charge utile
+    for (size_t k = 0; k < sim->nb_evenements; k++) {
+        if (sim->evenements[k].type == EVT_RECEPTION) deinit_trame(&sim->evenements[k].t);
+    }
+    if (sim->files != NULL) {
+        for (size_t i = 0; i < sim->nb_files; i++) {
+            file_sortie_t *f = &sim->files[i];
+            for (int k = 0; k < f->nb; k++) {
+                deinit_trame(&f->trames[(f->tete + k) % sim->capacite_file]);
+            }
+            liberer_memoire(MEMOIRE_FILES, f->trames, sim->capacite_file * sizeof(trame));
+        }
+    }
+    if (sim->caches_arp != NULL) {
+        for (size_t i = 0; i < sim->reseau->nb_stations; i++) deinit_cache_arp(&sim->caches_arp[i]);
+    }
+    for (size_t k = 0; k < sim->nb_attentes_arp; k++) deinit_trame(&sim->attentes_arp[k].t);
+    liberer_memoire(MEMOIRE_TABLES, sim->caches_arp, (sim->reseau->nb_stations + 1) * sizeof(cache_arp_t));
+    liberer_memoire(MEMOIRE_FILES, sim->attentes_arp, sim->attentes_arp_capacite * sizeof(attente_arp_t));
+    sim->caches_arp = NULL;
+    sim->attentes_arp = NULL;
+    sim->nb_attentes_arp = 0;
+    sim->attentes_arp_capacite = 0;
+    liberer_memoire(MEMOIRE_TABLES, sim->adhesions, sim->adhesions_capacite * sizeof(adhesion_t));
+    sim->adhesions = NULL;
+    sim->nb_adhesions = 0;
+    sim->adhesions_capacite = 0;
+    liberer_memoire(MEMOIRE_EVENEMENTS, sim->evenements, sim->evenements_capacite * sizeof(evenement_t));
+    liberer_memoire(MEMOIRE_FILES, sim->files, (sim->nb_files + 1) * sizeof(file_sortie_t));
+    free(sim->premiere_file);
+    free(sim->ports_sortie);
+    liberer_memoire(MEMOIRE_MESURES, sim->paires, sim->paires_capacite * sizeof(paire_suivie_t));
+    liberer_memoire(MEMOIRE_EVENEMENTS, sim->tempo_ports, (sim->nb_files + 1) * sizeof(temporisations_port_t));
+    deinit_roue(&sim->roue);
+    sim->tempo_ports = NULL;
+    sim->evenements = NULL;
+    sim->files = NULL;
+    sim->premiere_file = NULL;
+    sim->ports_sortie = NULL;
+    sim->paires = NULL;
+    sim->nb_paires = 0;
+    sim->paires_capacite = 0;
+    sim->nb_evenements = 0;
+    sim->evenements_capacite = 0;
+    sim->nb_files = 0;
+    sim->ports_capacite = 0;
+}
+
+void configurer_files_sortie(simulation_t *sim, int capacite, politique_rejet_t politique) {
+    // à appeler avant la première émission : les anneaux déjà alloués gardent leur taille
+    if (sim == NULL || capacite <= 0) return;
+
+    for (size_t i = 0; i < sim->nb_files; i++) {
+        if (sim->files[i].trames != NULL) {
+            JOURNALISER(JOURNAL_AVERTISSEMENT, "Files de sortie déjà utilisées, configuration ignorée", 0, 0, 0, 0);
+            return;
+        }
+    }
+    sim->capacite_file = capacite;
+    sim->politique = politique;
+}
+
+// Le plan doit avoir été calculé sur le réseau de la simulation et lui survivre
+void activer_multichemin(simulation_t *sim, const plan_spb_t *plan) {
+    if (sim == NULL) return;
+    sim->spb = plan;
+}
+
+// Même contrainte : le plan doit avoir été calculé sur le réseau de la simulation ;
+// avec le STP temporisé, chaque reconvergence recalcule toutes ses instances
+void activer_mstp(simulation_t *sim, plan_mstp_t *plan) {
+    if (sim == NULL) return;
+    sim->mstp = plan;
+}
+
+/**
+ * Débit d'un lien d'après son poids, selon les coûts STP de 802.1D
+ * (100 = 10 Mb/s, 19 = 100 Mb/s, 4 = 1 Gb/s, 2 = 10 Gb/s)
+ * @return Le débit en bits par seconde
+ */
+uint64_t debit_lien(int poids) {
+    switch (poids) {
+        case 250: return 4000000ULL;
+        case 100: return 10000000ULL;
+        case 62:  return 16000000ULL;
+        case 19:  return 100000000ULL;
+        case 4:   return 1000000000ULL;
+        case 2:   return 10000000000ULL;
+        default:
+            // poids hors norme : débit inversement proportionnel, calé sur 4 = 1 Gb/s
+            return (poids > 0) ? 4000000000ULL / (uint64_t)poids : 1000000000ULL;
+    }
+}
+
+// Durée d'occupation du port pour une trame, intervalle inter-trames compris
+temps_sim_t duree_serialisation(const trame *t, int poids) {
+    uint64_t bits = (taille_trame_octets(t) + INTERVALLE_INTER_TRAMES) * 8ULL;
+    return (bits * 1000000000ULL) / debit_lien(poids);
+}
+
+file_sortie_t *file_sortie(const simulation_t *sim, sommet s, int port) {
+    if (sim == NULL || s >= ordre(&sim->reseau->g) || port < 0) return NULL;
+
+    size_t i = sim->premiere_file[s] + port;
+    if (i >= sim->premiere_file[s + 1]) return NULL;
+    return &sim->files[i];
+}
+
+// Échéancier : tas binaire minimal sur (date, sequence)
+static bool precede(const evenement_t *a, const evenement_t *b) {
+    return a->date < b->date || (a->date == b->date && a->sequence < b->sequence);
+}
+
+static bool planifier(simulation_t *sim, temps_sim_t date, type_evenement_t type,
+                      sommet equipement, int port, const trame *t) {
+    if (sim->nb_evenements >= sim->evenements_capacite) {
+        size_t nouvelle_capacite = sim->evenements_capacite * 2;
+        evenement_t *nouveaux = reallouer_memoire(MEMOIRE_EVENEMENTS, sim->evenements,
+                                                   sim->evenements_capacite * sizeof(evenement_t),
+                                                   nouvelle_capacite * sizeof(evenement_t));
+        if (nouveaux == NULL) return false;
+
+        sim->evenements = nouveaux;
+        sim->evenements_capacite = nouvelle_capacite;
+    }
+
+    evenement_t e;
+    e.date = date;
+    e.sequence = sim->sequence++;
+    e.type = type;
+    e.equipement = equipement;
+    e.port = port;
+    if (t != NULL) e.t = *t;
+
+    size_t i = sim->nb_evenements++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!precede(&e, &sim->evenements[parent])) break;
+        sim->evenements[i] = sim->evenements[parent];
+        i = parent;
+    }
+    sim->evenements[i] = e;
+    return true;
+}
+
+static evenement_t extraire_prochain(simulation_t *sim) {
+    evenement_t premier = sim->evenements[0];
+    evenement_t dernier = sim->evenements[--sim->nb_evenements];
+
+    size_t i = 0;
+    size_t n = sim->nb_evenements;
+    while (2 * i + 1 < n) {
+        size_t enfant = 2 * i + 1;
+        if (enfant + 1 < n && precede(&sim->evenements[enfant + 1], &sim->evenements[enfant])) enfant++;
+        if (!precede(&sim->evenements[enfant], &dernier)) break;
+        sim->evenements[i] = sim->evenements[enfant];
+        i = enfant;
+    }
+    if (n > 0) sim->evenements[i] = dernier;
+    return premier;
+}
+
+// Extrémité distante du lien branché sur le port : sommet voisin, port d'arrivée et poids
+static bool extremite(const simulation_t *sim, sommet s, int port, sommet *voisin, int *port_voisin, int *poids) {
+    const reseau_t *r = sim->reseau;
+    if (r->equipements[s].type == EQUIPEMENT_SWITCH) {
+        const port_info_t *p = &r->switchs[r->equipements[s].index].ports[port];
+        *voisin = p->voisin;
+        *port_voisin = p->port_voisin;
+        *poids = p->cout;
+    } else {
+        const raccordement_t *rc = &r->raccordements[r->equipements[s].index];
+        *voisin = rc->voisin;
+        *port_voisin = rc->port_voisin;
+        if (*voisin != UNKNOWN_INDEX) {
+            arete a = {s, rc->voisin, 0, false};
+            size_t i = index_arete(&r->g, a);
+            *poids = (i == UNKNOWN_INDEX) ? 0 : r->g.aretes[i].poids;
+        }
+    }
+    if (*voisin == UNKNOWN_INDEX) return false;
+    // la carte d'une station n'a qu'un port
+    if (*port_voisin < 0) *port_voisin = 0;
+    return true;
+}
+
+// Sérialise la trame sur le lien : le port est occupé jusqu'à la fin d'émission
+// et le voisin la reçoit à ce moment (propagation négligée)
+static void demarrer_emission(simulation_t *sim, file_sortie_t *f, sommet s, int port, trame *t) {
+    sommet voisin;
+    int port_voisin, poids;
+    if (!extremite(sim, s, port, &voisin, &port_voisin, &poids)) {
+        sim->compteurs.nb_filtrees++;
+        deinit_trame(t);
+        return;
+    }
+
+    temps_sim_t duree = duree_serialisation(t, poids);
+    temps_sim_t fin = sim->horloge + duree;
+    f->nb_emises++;
+    f->octets_emis += taille_trame_octets(t);
+    f->temps_occupe += duree;
+
+    if (!planifier(sim, fin, EVT_RECEPTION, voisin, port_voisin, t)) {
+        deinit_trame(t);
+    }
+    f->occupe = planifier(sim, fin, EVT_FIN_EMISSION, s, port, NULL);
+}
+
+// Confie une trame au port de sortie (la file prend possession de la référence) :
+// émission immédiate si le port est libre, sinon mise en attente ou rejet
+static void transmettre(simulation_t *sim, sommet s, int port, trame *t) {
+    file_sortie_t *f = file_sortie(sim, s, port);
+    if (f == NULL) {
+        deinit_trame(t);
+        return;
+    }
+
+    if (!f->occupe) {
+        demarrer_emission(sim, f, s, port, t);
+        return;
+    }
+
+    if (f->trames == NULL) {
+        f->trames = allouer_memoire(MEMOIRE_FILES, sim->capacite_file * sizeof(trame));
+        if (f->trames == NULL) {
+            deinit_trame(t);
+            return;
+        }
+    }
+
+    if (f->nb >= sim->capacite_file) {
+        f->nb_rejetees++;
+        sim->compteurs.nb_rejetees++;
+        JOURNALISER(JOURNAL_TRACE, "t=%llu ns : file pleine sur %llu port %llu, trame rejetée", sim->horloge,
+                    sommet_origine(sim->reseau, s), port, 0);
+        if (sim->politique == REJET_QUEUE) {
+            deinit_trame(t);
+            return;
+        }
+        // REJET_TETE : la plus ancienne trame en attente laisse sa place
+        deinit_trame(&f->trames[f->tete]);
+        f->tete = (f->tete + 1) % sim->capacite_file;
+        f->nb--;
+    }
+
+    f->trames[(f->tete + f->nb) % sim->capacite_file] = *t;
+    f->nb++;
+    if (f->nb > f->occupation_max) f->occupation_max = f->nb;
+}
+
+static void terminer_emission(simulation_t *sim, const evenement_t *e) {
+    file_sortie_t *f = file_sortie(sim, e->equipement, e->port);
+    f->occupe = false;
+    if (f->nb == 0) return;
+
+    trame t = f->trames[f->tete];
+    f->tete = (f->tete + 1) % sim->capacite_file;
+    f->nb--;
+    demarrer_emission(sim, f, e->equipement, e->port, &t);
+}
+
+// --- Temporisations : vieillissement des adresses et STP 802.1D ---
+
+// Clé d'une adresse apprise : FID sur les 16 bits de poids fort, MAC sur les 48 autres
+static uint64_t cle_mac(uint16_t fid, mac_addr_t mac) {
+    uint64_t cle = fid;
+    for (int i = 0; i < 6; i++) {
+        cle = (cle << 8) | mac.octet[i];
+    }
+    return cle;
+}
+
+static mac_addr_t mac_cle(uint64_t cle) {
+    mac_addr_t mac;
+    for (int i = 5; i >= 0; i--) {
+        mac.octet[i] = (uint8_t)(cle & 0xFF);
+        cle >>= 8;
+    }
+    return mac;
+}
+
+// Arme ou repousse l'expiration de l'adresse apprise par le switch
+static void rafraichir_adresse(simulation_t *sim, sommet s, switch_t *sw, uint16_t fid, mac_addr_t mac) {
+    table_entree_t *e = chercher_entree_fid(&sw->table, fid, mac);
+    if (e == NULL) return;
+
+    temps_sim_t echeance = sim->horloge + sim->vieillissement;
+    if (!rearmer_temporisation(&sim->roue, e->vieillissement, echeance)) {
+        e->vieillissement = armer_temporisation(&sim->roue, echeance, TEMPO_VIEILLISSEMENT, s, cle_mac(fid, mac));
+    }
+}
+
+bool configurer_vieillissement(simulation_t *sim, temps_sim_t duree) {
+    if (sim == NULL) return false;
+
+    sim->vieillissement = duree;
+    reseau_t *r = sim->reseau;
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        switch_t *sw = reseau_switch(r, s);
+        if (sw == NULL) continue;
+
+        for (int k = 0; k < sw->table.taille; k++) {
+            table_entree_t *e = &sw->table.entrees[k];
+            if (duree == 0) {
+                annuler_temporisation(&sim->roue, e->vieillissement);
+                e->vieillissement = TEMPORISATION_AUCUNE;
+            } else {
+                rafraichir_adresse(sim, s, sw, e->fid, e->mac);
+                if (e->vieillissement == TEMPORISATION_AUCUNE) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Port relié à un port actif d'un autre switch : il reçoit des BPDU
+static bool port_recoit_bpdu(const reseau_t *r, const switch_t *sw, int p) {
+    const port_info_t *port = &sw->ports[p];
+    if (!port->actif || port->voisin == UNKNOWN_INDEX) return false;
+
+    const switch_t *voisin = reseau_switch(r, port->voisin);
+    return voisin != NULL && port_est_actif(voisin, port->port_voisin);
+}
+
+static bool role_relaie(etat_port_t etat) {
+    return etat == PORT_RACINE || etat == PORT_DESIGNE;
+}
+
+// Un port non désigné qui reçoit des BPDU surveille leur fraîcheur (max age),
+// un port relayant qui n'achemine pas encore poursuit ses transitions
+static bool armer_temporisations_port(simulation_t *sim, sommet s, switch_t *sw, int p) {
+    temporisations_port_t *tp = &sim->tempo_ports[sim->premiere_file[s] + p];
+    temps_sim_t maintenant = sim->horloge;
+
+    if (port_recoit_bpdu(sim->reseau, sw, p) && get_etat_port(sw, p) != PORT_DESIGNE) {
+        temps_sim_t echeance = maintenant + MAX_AGE_MS * 1000000ULL;
+        if (!rearmer_temporisation(&sim->roue, tp->age_max, echeance)) {
+            tp->age_max = armer_temporisation(&sim->roue, echeance, TEMPO_AGE_MAX, s, (uint64_t)p);
+            if (tp->age_max == TEMPORISATION_AUCUNE) return false;
+        }
+    } else {
+        annuler_temporisation(&sim->roue, tp->age_max);
+        tp->age_max = TEMPORISATION_AUCUNE;
+    }
+
+    if (!role_relaie(get_etat_port(sw, p))) {
+        annuler_temporisation(&sim->roue, tp->transition);
+        tp->transition = TEMPORISATION_AUCUNE;
+    }
+    return true;
+}
+
+static bool armer_transition(simulation_t *sim, sommet s, int p) {
+    temporisations_port_t *tp = &sim->tempo_ports[sim->premiere_file[s] + p];
+    if (temporisation_armee(&sim->roue, tp->transition)) return true;
+
+    tp->transition = armer_temporisation(&sim->roue, sim->horloge + FORWARD_DELAY_MS * 1000000ULL,
+                                         TEMPO_FORWARD_DELAY, s, (uint64_t)p);
+    return tp->transition != TEMPORISATION_AUCUNE;
+}
+
+// Un port qui se met à relayer commence par l'écoute
+static bool demarrer_transition(simulation_t *sim, sommet s, switch_t *sw, int p) {
+    set_statut_port(sw, p, STATUT_REJET);
+    return armer_transition(sim, s, p);
+}
+
+bool activer_temporisations_stp(simulation_t *sim) {
+    if (sim == NULL) return false;
+
+    if (sim->tempo_ports == NULL) {
+        sim->tempo_ports = allouer_memoire(MEMOIRE_EVENEMENTS, (sim->nb_files + 1) * sizeof(temporisations_port_t));
+        if (sim->tempo_ports == NULL) return false;
+        for (size_t i = 0; i <= sim->nb_files; i++) {
+            sim->tempo_ports[i].age_max = TEMPORISATION_AUCUNE;
+            sim->tempo_ports[i].transition = TEMPORISATION_AUCUNE;
+        }
+    }
+
+    reseau_t *r = sim->reseau;
+    bool ok = true;
+    for (sommet s = 0; ok && s < ordre(&r->g); s++) {
+        switch_t *sw = reseau_switch(r, s);
+        if (sw == NULL) continue;
+
+        ok = armer_temporisation(&sim->roue, sim->horloge, TEMPO_HELLO, s, 0) != TEMPORISATION_AUCUNE;
+        for (int p = 0; ok && p < sw->nb_ports; p++) {
+            if (!port_est_actif(sw, p) || sw->ports[p].voisin == UNKNOWN_INDEX) continue;
+            if (role_relaie(get_etat_port(sw, p))) ok = demarrer_transition(sim, s, sw, p);
+            ok = ok && armer_temporisations_port(sim, s, sw, p);
+        }
+    }
+    return ok;
+}
+
+// Recalcul de toutes les instances MSTP : la CIST est appliquée aux ports,
+// et un port dont le rôle change dans une MSTI oublie ses adresses apprises
+// (les MSTI n'ont pas de transitions : leurs rôles s'appliquent aussitôt)
+static void recalculer_mstp(simulation_t *sim) {
+    plan_mstp_t *plan = sim->mstp;
+    size_t nb_roles = (plan->nb_instances - 1) * plan->nb_ports;
+    etat_port_t *anciens = malloc((nb_roles + 1) * sizeof(etat_port_t));
+    if (anciens == NULL) return;
+    memcpy(anciens, plan->roles + plan->nb_ports, nb_roles * sizeof(etat_port_t));
+
+    if (calculer_mstp(plan, sim->reseau, 0)) {
+        const etat_port_t *roles = plan->roles + plan->nb_ports;
+        for (size_t i = 0; i < plan->nb_switchs; i++) {
+            switch_t *sw = &sim->reseau->switchs[i];
+            for (int p = 0; p < sw->nb_ports; p++) {
+                bool change = false;
+                for (size_t k = 0; k + 1 < plan->nb_instances && !change; k++) {
+                    size_t j = k * plan->nb_ports + plan->debut[i] + p;
+                    change = anciens[j] != roles[j];
+                }
+                if (change) {
+                    vider_port_table(&sw->table, p);
+                    quitter_port_groupes(&sw->multicast, p);
+                }
+            }
+        }
+    }
+    free(anciens);
+}
+
+// Max age écoulé : l'arbre est recalculé sans les liens muets, les ports
+// qui se mettent à relayer repassent par l'écoute et l'apprentissage
+static void reconfigurer_stp(simulation_t *sim) {
+    reseau_t *r = sim->reseau;
+    statut_port_t *anciens = malloc((sim->nb_files + 1) * sizeof(statut_port_t));
+    if (anciens == NULL) return;
+
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        for (int p = 0; sw != NULL && p < sw->nb_ports; p++) {
+            anciens[sim->premiere_file[s] + p] = get_statut_port(sw, p);
+        }
+    }
+
+    sim->compteurs.nb_recalculs_stp++;
+    JOURNALISER(JOURNAL_INFO, "t=%llu ns : max age expiré, recalcul STP n°%llu", sim->horloge,
+                sim->compteurs.nb_recalculs_stp, 0, 0);
+    if (sim->mstp != NULL) {
+        recalculer_mstp(sim);
+    } else {
+        calculer_stp(r, NULL);
+    }
+
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        switch_t *sw = reseau_switch(r, s);
+        for (int p = 0; sw != NULL && p < sw->nb_ports; p++) {
+            if (!port_est_actif(sw, p) || sw->ports[p].voisin == UNKNOWN_INDEX) continue;
+
+            statut_port_t ancien = anciens[sim->premiere_file[s] + p];
+            if (role_relaie(get_etat_port(sw, p)) && ancien != STATUT_ACHEMINEMENT) {
+                set_statut_port(sw, p, ancien);
+                if (ancien == STATUT_REJET) demarrer_transition(sim, s, sw, p);
+            }
+            armer_temporisations_port(sim, s, sw, p);
+        }
+    }
+    free(anciens);
+}
+
+// Hello d'un switch : chaque port désigné rafraîchit l'information du port d'en face
+static void emettre_hello(simulation_t *sim, sommet s) {
+    reseau_t *r = sim->reseau;
+    const switch_t *sw = reseau_switch(r, s);
+    for (int p = 0; p < sw->nb_ports; p++) {
+        if (get_etat_port(sw, p) != PORT_DESIGNE || !port_recoit_bpdu(r, sw, p)) continue;
+
+        const port_info_t *port = &sw->ports[p];
+        temporisations_port_t *tp = &sim->tempo_ports[sim->premiere_file[port->voisin] + port->port_voisin];
+        rearmer_temporisation(&sim->roue, tp->age_max, sim->horloge + MAX_AGE_MS * 1000000ULL);
+    }
+    armer_temporisation(&sim->roue, sim->horloge + HELLO_TIME_MS * 1000000ULL, TEMPO_HELLO, s, 0);
+}
+
+bool emettre_trame(simulation_t *sim, sommet station, const trame *t) {
+    if (sim == NULL || t == NULL) return false;
+
+    station_t *st = reseau_station(sim->reseau, station);
+    if (st == NULL) return false;
+    const raccordement_t *rc = &sim->reseau->raccordements[sim->reseau->equipements[station].index];
+    if (rc->voisin == UNKNOWN_INDEX) return false;
+
+    trame copie;
+    copier_trame(&copie, t);
+    copie.date_emission = sim->horloge;
+    sim->compteurs.nb_emises++;
+    transmettre(sim, station, 0, &copie);
+    return true;
+}
+
+// Réception par un switch : la trame est confiée à chaque port de sortie,
+// le descripteur reçu sert pour le dernier et des copies légères pour les autres
+static void recevoir_switch(simulation_t *sim, evenement_t *e) {
+    reseau_t *r = sim->reseau;
+    size_t index = r->equipements[e->equipement].index;
+    switch_t *sw = &r->switchs[index];
+
+    // VLAN de la trame : son étiquette ou le VLAN natif du port de réception
+    uint16_t vlan = vlan_entree(sw, e->port, e->t.vlan);
+    const etat_port_t *roles = (sim->mstp != NULL) ? roles_vlan(sim->mstp, index, vlan) : NULL;
+    int nb = (sim->spb != NULL)
+             ? acheminer_spb(sim->spb, r, index, e->port, e->t.source, e->t.destination, sim->ports_sortie)
+             : commuter_trame_vlan(sw, e->port, vlan, roles, e->t.source, e->t.destination, sim->ports_sortie);
+    if (sw->multicast.actif) surveiller_adhesion(sw, e->port, &e->t);
+    if (sim->vieillissement > 0 && sim->spb == NULL) rafraichir_adresse(sim, e->equipement, sw, vlan, e->t.source);
+    JOURNALISER(JOURNAL_TRACE, "t=%llu ns : switch %llu reçoit sur le port %llu, %llu port(s) de sortie", sim->horloge,
+                sommet_origine(r, e->equipement), e->port, nb);
+    if (nb == 0) {
+        sim->compteurs.nb_filtrees++;
+        deinit_trame(&e->t);
+        return;
+    }
+
+    for (int k = 0; k < nb; k++) {
+        trame sortie;
+        if (k == nb - 1) {
+            sortie = e->t;
+        } else {
+            copier_trame(&sortie, &e->t);
+            sim->compteurs.nb_copies++;
+        }
+        sortie.vlan = vlan_sortie(sw, sim->ports_sortie[k], vlan);
+        transmettre(sim, e->equipement, sim->ports_sortie[k], &sortie);
+    }
+}
+
+bool activer_arp(simulation_t *sim, temps_sim_t duree_cache) {
+    if (sim == NULL || duree_cache == 0) return false;
+
+    if (sim->caches_arp == NULL) {
+        sim->caches_arp = allouer_memoire(MEMOIRE_TABLES, (sim->reseau->nb_stations + 1) * sizeof(cache_arp_t));
+        if (sim->caches_arp == NULL) return false;
+        for (size_t i = 0; i < sim->reseau->nb_stations; i++) init_cache_arp(&sim->caches_arp[i]);
+    }
+    sim->duree_cache_arp = duree_cache;
+    return true;
+}
+
+static cache_arp_t *cache_station(const simulation_t *sim, sommet station) {
+    return &sim->caches_arp[sim->reseau->equipements[station].index];
+}
+
+static bool diffuser_requete_arp(simulation_t *sim, sommet station, const station_t *st, ip_addr_t ip) {
+    paquet_arp_t requete = {ARP_REQUETE, st->mac, st->ip, creer_mac(0, 0, 0, 0, 0, 0), ip};
+    trame t;
+    if (!init_trame_arp(&t, &requete)) return false;
+
+    bool ok = emettre_trame(sim, station, &t);
+    if (ok) sim->compteurs.nb_requetes_arp++;
+    deinit_trame(&t);
+    return ok;
+}
+
+// Nouvelle requête pour les paquets de la station retenus pour ip, relance suivante armée
+static bool relancer_arp(simulation_t *sim, sommet station, uint32_t ip) {
+    ip_addr_t adresse = creer_ip(ip >> 24, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+    if (!diffuser_requete_arp(sim, station, reseau_station(sim->reseau, station), adresse)) return false;
+
+    int relance = TEMPORISATION_AUCUNE;
+    for (size_t k = 0; k < sim->nb_attentes_arp; k++) {
+        attente_arp_t *a = &sim->attentes_arp[k];
+        if (a->station != station || a->ip != ip) continue;
+        if (relance == TEMPORISATION_AUCUNE) {
+            // première entrée du destinataire : réarme sa relance, ou en arme une nouvelle
+            temps_sim_t echeance = sim->horloge + RELANCE_ARP;
+            relance = rearmer_temporisation(&sim->roue, a->relance, echeance)
+                      ? a->relance : armer_temporisation(&sim->roue, echeance, TEMPO_ARP, station, ip);
+        }
+        a->relance = relance;
+        a->date_requete = sim->horloge;
+        a->nb_requetes++;
+    }
+    return true;
+}
+
+// Retire les paquets de la station retenus pour ip ; abandonner : ils sont perdus,
+// sinon ils sont émis vers mac dans l'ordre d'envoi
+static void liberer_attentes_arp(simulation_t *sim, sommet station, uint32_t ip, mac_addr_t mac, bool abandonner) {
+    size_t garde = 0, nb_abandons = 0;
+    bool annulee = false;
+    for (size_t k = 0; k < sim->nb_attentes_arp; k++) {
+        attente_arp_t *a = &sim->attentes_arp[k];
+        if (a->station != station || a->ip != ip) {
+            sim->attentes_arp[garde++] = *a;
+            continue;
+        }
+        if (!annulee) {
+            annuler_temporisation(&sim->roue, a->relance);
+            annulee = true;
+        }
+        if (abandonner) {
+            deinit_trame(&a->t);
+            nb_abandons++;
+        } else {
+            a->t.destination = mac;
+            sim->compteurs.nb_emises++;
+            transmettre(sim, station, 0, &a->t);
+        }
+    }
+    sim->nb_attentes_arp = garde;
+    sim->compteurs.nb_abandons_arp += nb_abandons;
+    if (nb_abandons > 0) {
+        JOURNALISER(JOURNAL_INFO, "t=%llu ns : station %llu abandonne %llu paquet(s) vers %llx, sans réponse ARP",
+                    sim->horloge, sommet_origine(sim->reseau, station), nb_abandons, ip);
+    }
+}
+
+// Échéance TEMPO_ARP : nouvelle requête, ou abandon après TENTATIVES_ARP_MAX
+static void expirer_attente_arp(simulation_t *sim, sommet station, uint32_t ip, int id) {
+    attente_arp_t *groupe = NULL;
+    for (size_t k = 0; k < sim->nb_attentes_arp && groupe == NULL; k++) {
+        attente_arp_t *a = &sim->attentes_arp[k];
+        if (a->station == station && a->ip == ip && a->relance == id) groupe = a;
+    }
+    if (groupe == NULL) return;
+
+    // l'identifiant est déjà libéré par la roue
+    for (size_t k = 0; k < sim->nb_attentes_arp; k++) {
+        attente_arp_t *a = &sim->attentes_arp[k];
+        if (a->station == station && a->ip == ip) a->relance = TEMPORISATION_AUCUNE;
+    }
+    if (groupe->nb_requetes >= TENTATIVES_ARP_MAX || !relancer_arp(sim, station, ip)) {
+        liberer_attentes_arp(sim, station, ip, creer_mac(0, 0, 0, 0, 0, 0), true);
+    }
+}
+
+bool envoyer_ip(simulation_t *sim, sommet station, ip_addr_t destination, const trame *t) {
+    if (sim == NULL || t == NULL) return false;
+    if (sim->caches_arp == NULL) return emettre_trame(sim, station, t);
+
+    const station_t *st = reseau_station(sim->reseau, station);
+    if (st == NULL || sim->reseau->raccordements[sim->reseau->equipements[station].index].voisin == UNKNOWN_INDEX) {
+        return false;
+    }
+
+    trame envoi = *t;
+    if (chercher_cache_arp(cache_station(sim, station), destination, sim->horloge, &envoi.destination)) {
+        return emettre_trame(sim, station, &envoi);
+    }
+
+    // paquets déjà retenus pour ce destinataire
+    uint32_t ip = cle_ip(destination);
+    int nb = 0;
+    const attente_arp_t *groupe = NULL;
+    for (size_t k = 0; k < sim->nb_attentes_arp; k++) {
+        const attente_arp_t *a = &sim->attentes_arp[k];
+        if (a->station == station && a->ip == ip) {
+            nb++;
+            groupe = a;
+        }
+    }
+    // relance avant le plafond : une réponse perdue ne doit pas rendre le destinataire injoignable
+    if (groupe != NULL && sim->horloge - groupe->date_requete >= RELANCE_ARP) relancer_arp(sim, station, ip);
+    if (nb >= ATTENTES_ARP_MAX) {
+        sim->compteurs.nb_abandons_arp++;
+        return false;
+    }
+
+    attente_arp_t nouvelle;
+    nouvelle.station = station;
+    nouvelle.ip = ip;
+    if (groupe != NULL) {
+        nouvelle.date_requete = groupe->date_requete;
+        nouvelle.nb_requetes = groupe->nb_requetes;
+        nouvelle.relance = groupe->relance;
+    }
+    if (sim->nb_attentes_arp >= sim->attentes_arp_capacite) {
+        size_t nouvelle_capacite = (sim->attentes_arp_capacite == 0) ? 8 : sim->attentes_arp_capacite * 2;
+        attente_arp_t *nouvelles = reallouer_memoire(MEMOIRE_FILES, sim->attentes_arp,
+                                                     sim->attentes_arp_capacite * sizeof(attente_arp_t),
+                                                     nouvelle_capacite * sizeof(attente_arp_t));
+        if (nouvelles == NULL) return false;
+
+        sim->attentes_arp = nouvelles;
+        sim->attentes_arp_capacite = nouvelle_capacite;
+    }
+    if (groupe == NULL) {
+        if (!diffuser_requete_arp(sim, station, st, destination)) return false;
+        nouvelle.date_requete = sim->horloge;
+        nouvelle.nb_requetes = 1;
+        nouvelle.relance = armer_temporisation(&sim->roue, sim->horloge + RELANCE_ARP, TEMPO_ARP, station, ip);
+    }
+
+    // la latence mesurée à la livraison inclut le temps de résolution
+    copier_trame(&nouvelle.t, t);
+    nouvelle.t.date_emission = sim->horloge;
+    sim->attentes_arp[sim->nb_attentes_arp++] = nouvelle;
+    return true;
+}
+
+// Requête ou réponse visant la station : l'émetteur est appris (RFC 826),
+// une requête reçoit une réponse unicast
+static void traiter_arp(simulation_t *sim, sommet s, const station_t *st, const trame *t) {
+    paquet_arp_t p;
+    if (!lire_paquet_arp(t, &p) || !ip_equals(p.ip_cible, st->ip)) return;
+
+    inserer_cache_arp(cache_station(sim, s), p.ip_emetteur, p.mac_emetteur, sim->horloge + sim->duree_cache_arp);
+    if (p.operation == ARP_REQUETE) {
+        paquet_arp_t reponse = {ARP_REPONSE, st->mac, st->ip, p.mac_emetteur, p.ip_emetteur};
+        trame r;
+        if (init_trame_arp(&r, &reponse)) {
+            if (emettre_trame(sim, s, &r)) sim->compteurs.nb_reponses_arp++;
+            deinit_trame(&r);
+        }
+    }
+    liberer_attentes_arp(sim, s, cle_ip(p.ip_emetteur), p.mac_emetteur, false);
+}
+
+void activer_surveillance_multicast(simulation_t *sim, bool actif) {
+    if (sim == NULL) return;
+
+    for (size_t i = 0; i < sim->reseau->nb_switchs; i++) {
+        table_multicast_t *table = &sim->reseau->switchs[i].multicast;
+        table->actif = actif;
+        if (!actif) deinit_table_multicast(table);
+    }
+    if (actif && sim->requete_multicast == TEMPORISATION_AUCUNE) {
+        sim->requete_multicast = armer_temporisation(&sim->roue, sim->horloge + INTERVALLE_REQUETES_MULTICAST,
+                                                     TEMPO_REQUETE_MULTICAST, 0, 0);
+    } else if (!actif) {
+        annuler_temporisation(&sim->roue, sim->requete_multicast);
+        annuler_temporisation(&sim->roue, sim->rapport_multicast);
+        sim->requete_multicast = TEMPORISATION_AUCUNE;
+        sim->rapport_multicast = TEMPORISATION_AUCUNE;
+    }
+}
+
+// Adhésions triées par (station, groupe) : recherche dichotomique à chaque réception
+static int comparer_adhesion(sommet station, mac_addr_t groupe, const adhesion_t *a) {
+    if (station != a->station) return (station < a->station) ? -1 : 1;
+    return memcmp(groupe.octet, a->groupe.octet, 6);
+}
+
+// Position de l'adhésion, ou position d'insertion si absente (*trouvee à false)
+static size_t chercher_adhesion(const simulation_t *sim, sommet station, mac_addr_t groupe, bool *trouvee) {
+    size_t debut = 0, fin = sim->nb_adhesions;
+    while (debut < fin) {
+        size_t milieu = debut + (fin - debut) / 2;
+        int c = comparer_adhesion(station, groupe, &sim->adhesions[milieu]);
+        if (c == 0) {
+            *trouvee = true;
+            return milieu;
+        }
+        if (c < 0) {
+            fin = milieu;
+        } else {
+            debut = milieu + 1;
+        }
+    }
+    *trouvee = false;
+    return debut;
+}
+
+static bool emettre_adhesion(simulation_t *sim, sommet station, mac_addr_t groupe, int operation) {
+    trame t;
+    if (!init_trame_adhesion(&t, reseau_station(sim->reseau, station)->mac, groupe, operation)) return false;
+
+    bool ok = emettre_trame(sim, station, &t);
+    deinit_trame(&t);
+    return ok;
+}
+
+bool rejoindre_groupe_multicast(simulation_t *sim, sommet station, mac_addr_t groupe) {
+    if (sim == NULL || reseau_station(sim->reseau, station) == NULL) return false;
+    if (!mac_est_multicast(groupe) || mac_est_diffusion(groupe)) return false;
+
+    bool trouvee;
+    size_t k = chercher_adhesion(sim, station, groupe, &trouvee);
+    if (!trouvee) {
+        if (sim->nb_adhesions >= sim->adhesions_capacite) {
+            size_t nouvelle_capacite = (sim->adhesions_capacite == 0) ? 8 : sim->adhesions_capacite * 2;
+            adhesion_t *nouvelles = reallouer_memoire(MEMOIRE_TABLES, sim->adhesions,
+                                                      sim->adhesions_capacite * sizeof(adhesion_t),
+                                                      nouvelle_capacite * sizeof(adhesion_t));
+            if (nouvelles == NULL) return false;
+
+            sim->adhesions = nouvelles;
+            sim->adhesions_capacite = nouvelle_capacite;
+        }
+        memmove(&sim->adhesions[k + 1], &sim->adhesions[k], (sim->nb_adhesions - k) * sizeof(adhesion_t));
+        sim->adhesions[k].station = station;
+        sim->adhesions[k].groupe = groupe;
+        sim->nb_adhesions++;
+    }
+    // réémise même pour un membre connu, comme un rapport IGMP périodique
+    return emettre_adhesion(sim, station, groupe, ADHESION_REJOINDRE);
+}
+
+bool quitter_groupe_multicast(simulation_t *sim, sommet station, mac_addr_t groupe) {
+    if (sim == NULL || reseau_station(sim->reseau, station) == NULL) return false;
+
+    bool trouvee;
+    size_t k = chercher_adhesion(sim, station, groupe, &trouvee);
+    if (!trouvee) return false;
+    sim->nb_adhesions--;
+    memmove(&sim->adhesions[k], &sim->adhesions[k + 1], (sim->nb_adhesions - k) * sizeof(adhesion_t));
+    return emettre_adhesion(sim, station, groupe, ADHESION_QUITTER);
+}
+
+// Chaque station réémet ses adhésions, que les switchs traversés renouvellent
+static void renouveler_adhesions(simulation_t *sim) {
+    for (size_t k = 0; k < sim->nb_adhesions; k++) {
+        emettre_adhesion(sim, sim->adhesions[k].station, sim->adhesions[k].groupe, ADHESION_REJOINDRE);
+    }
+}
+
+// Requête générale : les membres qui n'ont pas répondu à la précédente sont oubliés
+static void interroger_adhesions(simulation_t *sim) {
+    for (size_t i = 0; i < sim->reseau->nb_switchs; i++) {
+        table_multicast_t *table = &sim->reseau->switchs[i].multicast;
+        if (table->actif) sim->compteurs.nb_adhesions_oubliees += vieillir_groupes(table);
+    }
+    renouveler_adhesions(sim);
+    sim->requete_multicast = armer_temporisation(&sim->roue, sim->horloge + INTERVALLE_REQUETES_MULTICAST,
+                                                 TEMPO_REQUETE_MULTICAST, 0, 0);
+}
+
+static bool station_destinataire(const simulation_t *sim, sommet s, const station_t *st, mac_addr_t destination) {
+    if (mac_equals(destination, st->mac) || mac_est_diffusion(destination)) return true;
+    bool trouvee = false;
+    if (mac_est_multicast(destination)) chercher_adhesion(sim, s, destination, &trouvee);
+    return trouvee;
+}
+
+static void recevoir_station(simulation_t *sim, evenement_t *e) {
+    const station_t *st = reseau_station(sim->reseau, e->equipement);
+    if (station_destinataire(sim, e->equipement, st, e->t.destination)) {
+        if (sim->caches_arp != NULL && e->t.type == TYPE_ARP) traiter_arp(sim, e->equipement, st, &e->t);
+        sim->compteurs.nb_livrees++;
+        sim->compteurs.octets_livres += taille_trame_octets(&e->t);
+        JOURNALISER(JOURNAL_TRACE, "t=%llu ns : trame livrée à %llu", sim->horloge,
+                    sommet_origine(sim->reseau, e->equipement), 0, 0);
+
+        temps_sim_t latence = sim->horloge - e->t.date_emission;
+        enregistrer_valeur(&sim->latence, latence);
+        for (size_t i = 0; i < sim->nb_paires; i++) {
+            paire_suivie_t *p = &sim->paires[i];
+            if (mac_equals(p->source, e->t.source) && mac_equals(p->destination, st->mac)) {
+                enregistrer_valeur(&p->latence, latence);
+            }
+        }
+    } else {
+        sim->compteurs.nb_filtrees++;
+    }
+    deinit_trame(&e->t);
+}
+
+static void expirer(void *contexte, uint64_t date, int id, const temporisation_t *t) {
+    simulation_t *sim = contexte;
+    sim->horloge = date;
+    switch_t *sw = reseau_switch(sim->reseau, t->objet);
+
+    switch ((type_temporisation_t)t->type) {
+        case TEMPO_VIEILLISSEMENT: {
+            // l'entrée a pu être purgée puis réapprise avec une autre temporisation
+            mac_addr_t mac = mac_cle(t->argument);
+            uint16_t fid = (uint16_t)(t->argument >> 48);
+            table_entree_t *e = chercher_entree_fid(&sw->table, fid, mac);
+            if (e != NULL && e->vieillissement == id) {
+                e->vieillissement = TEMPORISATION_AUCUNE;   // déjà libérée par la roue
+                retirer_entree_fid(&sw->table, fid, mac);
+                sim->compteurs.nb_expirees++;
+                JOURNALISER(JOURNAL_TRACE, "t=%llu ns : switch %llu oublie %012llx", date,
+                            sommet_origine(sim->reseau, t->objet), t->argument, 0);
+            }
+            break;
+        }
+        case TEMPO_HELLO:
+            emettre_hello(sim, t->objet);
+            break;
+        case TEMPO_AGE_MAX:
+            sim->tempo_ports[sim->premiere_file[t->objet] + t->argument].age_max = TEMPORISATION_AUCUNE;
+            reconfigurer_stp(sim);
+            break;
+        case TEMPO_ARP:
+            expirer_attente_arp(sim, t->objet, (uint32_t)t->argument, id);
+            break;
+        case TEMPO_REQUETE_MULTICAST:
+            interroger_adhesions(sim);
+            break;
+        case TEMPO_RAPPORT_MULTICAST:
+            sim->rapport_multicast = TEMPORISATION_AUCUNE;
+            renouveler_adhesions(sim);
+            break;
+        case TEMPO_FORWARD_DELAY: {
+            int p = (int)t->argument;
+            temporisations_port_t *tp = &sim->tempo_ports[sim->premiere_file[t->objet] + p];
+            tp->transition = TEMPORISATION_AUCUNE;
+            if (get_statut_port(sw, p) == STATUT_REJET) {
+                set_statut_port(sw, p, STATUT_APPRENTISSAGE);
+                armer_transition(sim, t->objet, p);
+            } else {
+                set_statut_port(sw, p, STATUT_ACHEMINEMENT);
+                // au tic suivant : un seul renouvellement pour tous les ports qui relaient dans celui-ci
+                if (sw->multicast.actif && sim->rapport_multicast == TEMPORISATION_AUCUNE) {
+                    sim->rapport_multicast = armer_temporisation(&sim->roue, date + RESOLUTION_TEMPORISATIONS,
+                                                                 TEMPO_RAPPORT_MULTICAST, 0, 0);
+                }
+            }
+            JOURNALISER_TEXTE(JOURNAL_TRACE, "%s : t=%llu ns, switch %llu port %llu",
+                              statut_port_to_string(get_statut_port(sw, p)), date,
+                              sommet_origine(sim->reseau, t->objet), p);
+            break;
+        }
+    }
+}
+
+// Traite les événements par date croissante jusqu'à épuisement (ou max_etapes si non nul)
+static size_t traiter_evenements(simulation_t *sim, size_t max_etapes) {
+    size_t etapes = 0;
+    while (sim->nb_evenements > 0 && (max_etapes == 0 || etapes < max_etapes)) {
+        // les temporisations échues avant l'événement passent en premier
+        avancer_roue(&sim->roue, sim->evenements[0].date, expirer, sim);
+        evenement_t e = extraire_prochain(sim);
+        sim->horloge = e.date;
+
+        if (e.type == EVT_FIN_EMISSION) {
+            terminer_emission(sim, &e);
+        } else {
+            switch (sim->reseau->equipements[e.equipement].type) {
+                case EQUIPEMENT_SWITCH:
+                    if (sim->chronometrer) {
+                        struct timespec debut, fin;
+                        clock_gettime(CLOCK_MONOTONIC, &debut);
+                        recevoir_switch(sim, &e);
+                        clock_gettime(CLOCK_MONOTONIC, &fin);
+                        enregistrer_valeur(&sim->temps_commutation,
+                                           (uint64_t)((fin.tv_sec - debut.tv_sec) * 1000000000LL +
+                                                      (fin.tv_nsec - debut.tv_nsec)));
+                    } else {
+                        recevoir_switch(sim, &e);
+                    }
+                    break;
+                case EQUIPEMENT_STATION:
+                    recevoir_station(sim, &e);
+                    break;
+                default:
+                    deinit_trame(&e.t);
+                    break;
+            }
+        }
+        etapes++;
+    }
+    return etapes;
+}
+
+// Une phase de profilage par appel, jamais par événement
+size_t executer_simulation(simulation_t *sim, size_t max_etapes) {
+    if (sim == NULL) return 0;
+
+    PROFILER_ENTRER("acheminement");
+    size_t etapes = traiter_evenements(sim, max_etapes);
+    PROFILER_SORTIR();
+    return etapes;
+}
+
+size_t avancer_simulation(simulation_t *sim, temps_sim_t date) {
+    if (sim == NULL) return 0;
+
+    size_t etapes = 0;
+    while (sim->nb_evenements > 0 && sim->evenements[0].date <= date) {
+        etapes += traiter_evenements(sim, 1);
+    }
+    avancer_roue(&sim->roue, date, expirer, sim);
+    if (sim->horloge < date) sim->horloge = date;
+    return etapes;
+}
+
+size_t executer_jusqua(simulation_t *sim, temps_sim_t date) {
+    if (sim == NULL) return 0;
+
+    PROFILER_ENTRER("acheminement");
+    size_t etapes = avancer_simulation(sim, date);
+    PROFILER_SORTIR();
+    return etapes;
+}
+
+/**
+ * Suit séparément la latence des trames de la station source livrées à la
+ * station destination (en plus de l'histogramme global)
+ */
+bool suivre_paire(simulation_t *sim, sommet source, sommet destination) {
+    if (sim == NULL) return false;
+
+    const station_t *src = reseau_station(sim->reseau, source);
+    const station_t *dst = reseau_station(sim->reseau, destination);
+    if (src == NULL || dst == NULL) return false;
+
+    if (sim->nb_paires >= sim->paires_capacite) {
+        size_t nouvelle_capacite = (sim->paires_capacite == 0) ? 8 : sim->paires_capacite * 2;
+        paire_suivie_t *nouvelles = reallouer_memoire(MEMOIRE_MESURES, sim->paires,
+                                                      sim->paires_capacite * sizeof(paire_suivie_t),
+                                                      nouvelle_capacite * sizeof(paire_suivie_t));
+        if (nouvelles == NULL) return false;
+
+        sim->paires = nouvelles;
+        sim->paires_capacite = nouvelle_capacite;
+    }
+
+    paire_suivie_t *p = &sim->paires[sim->nb_paires++];
+    p->source = src->mac;
+    p->destination = dst->mac;
+    init_histogramme(&p->latence);
+    return true;
+}
+
+void bilan_arp(const simulation_t *sim, bilan_arp_t *bilan) {
+    if (sim == NULL || bilan == NULL) return;
+
+    bilan->nb_requetes = sim->compteurs.nb_requetes_arp;
+    bilan->nb_reponses = sim->compteurs.nb_reponses_arp;
+    bilan->nb_abandons = sim->compteurs.nb_abandons_arp;
+    bilan->nb_en_attente = sim->nb_attentes_arp;
+    bilan->nb_succes = 0;
+    bilan->nb_echecs = 0;
+    bilan->nb_expirees = 0;
+    bilan->nb_entrees = 0;
+    for (size_t i = 0; sim->caches_arp != NULL && i < sim->reseau->nb_stations; i++) {
+        const cache_arp_t *c = &sim->caches_arp[i];
+        bilan->nb_succes += c->nb_succes;
+        bilan->nb_echecs += c->nb_echecs;
+        bilan->nb_expirees += c->nb_expirees;
+        bilan->nb_entrees += c->nb;
+    }
+    uint64_t consultations = bilan->nb_succes + bilan->nb_echecs;
+    bilan->taux_succes = (consultations > 0) ? (double)bilan->nb_succes / consultations : 0;
+}
+
+void afficher_bilan_arp(const simulation_t *sim) {
+    if (sim == NULL) return;
+
+    bilan_arp_t b;
+    bilan_arp(sim, &b);
+    printf("ARP : %llu requête(s) diffusée(s), %llu réponse(s) | caches : %.1f %% de succès "
+           "(%llu / %llu), %zu entrée(s), %llu expirée(s) | %zu paquet(s) en attente, %llu abandonné(s)\n",
+           (unsigned long long)b.nb_requetes, (unsigned long long)b.nb_reponses, b.taux_succes * 100,
+           (unsigned long long)b.nb_succes, (unsigned long long)(b.nb_succes + b.nb_echecs), b.nb_entrees,
+           (unsigned long long)b.nb_expirees, b.nb_en_attente, (unsigned long long)b.nb_abandons);
+}
+
+void afficher_latences(const simulation_t *sim) {
+    if (sim == NULL) return;
+
+    printf("Latences de bout en bout (temps simulé) :\n");
+    afficher_histogramme(&sim->latence, "Toutes paires", "µs", 1e3);
+    for (size_t i = 0; i < sim->nb_paires; i++) {
+        char source[18], destination[18], nom[48];
+        snprintf(nom, sizeof(nom), "%s -> %s", MAC_to_string(sim->paires[i].source, source),
+                 MAC_to_string(sim->paires[i].destination, destination));
+        afficher_histogramme(&sim->paires[i].latence, nom, "µs", 1e3);
+    }
+    if (sim->chronometrer) {
+        printf("Coût de simulation par commutation (temps réel) :\n");
+        afficher_histogramme(&sim->temps_commutation, "Commutation", "ns", 1.0);
+    }
+}
+
+static void afficher_file(const simulation_t *sim, const file_sortie_t *f, sommet s, int port) {
+    const reseau_t *r = sim->reseau;
+    sommet voisin;
+    int port_voisin, poids = 0;
+    extremite(sim, s, port, &voisin, &port_voisin, &poids);
+    double utilisation = (sim->horloge > 0) ? 100.0 * f->temps_occupe / sim->horloge : 0.0;
+
+    printf("  %s %zu port %d -> %zu (%llu Mb/s) : %5.1f%% | %llu trames, %llu octets | max %d en attente | %llu rejetée(s)\n",
+           r->equipements[s].type == EQUIPEMENT_SWITCH ? "Switch" : "Station", sommet_origine(r, s), port,
+           sommet_origine(r, voisin),
+           (unsigned long long)(debit_lien(poids) / 1000000), utilisation,
+           (unsigned long long)f->nb_emises, (unsigned long long)f->octets_emis,
+           f->occupation_max, (unsigned long long)f->nb_rejetees);
+}
+
+/**
+ * Affiche les ports congestionnés : taux d'occupation du lien au moins égal
+ * à seuil_utilisation (entre 0 et 1) depuis le début, ou trames rejetées
+ */
+void afficher_files_sortie(const simulation_t *sim, double seuil_utilisation) {
+    if (sim == NULL) return;
+
+    printf("Files de sortie à t = %.3f ms (capacité %d, %s) :\n", sim->horloge / 1e6, sim->capacite_file,
+           sim->politique == REJET_QUEUE ? "rejet en queue" : "rejet en tête");
+
+    size_t nb_affichees = 0;
+    for (sommet s = 0; s < ordre(&sim->reseau->g); s++) {
+        for (size_t i = sim->premiere_file[s]; i < sim->premiere_file[s + 1]; i++) {
+            const file_sortie_t *f = &sim->files[i];
+            if (f->nb_emises == 0 && f->nb_rejetees == 0) continue;
+
+            double utilisation = (sim->horloge > 0) ? (double)f->temps_occupe / sim->horloge : 0.0;
+            if (utilisation >= seuil_utilisation || f->nb_rejetees > 0) {
+                afficher_file(sim, f, s, (int)(i - sim->premiere_file[s]));
+                nb_affichees++;
+            }
+        }
+    }
+    if (nb_affichees == 0) printf("  Aucun lien congestionné\n");
+}
+
+bool bilan_liens(const simulation_t *sim, bilan_liens_t *bilan) {
+    if (sim == NULL || bilan == NULL) return false;
+
+    const reseau_t *r = sim->reseau;
+    bilan->nb_liens = 0;
+    bilan->nb_liens_utilises = 0;
+    bilan->utilisation_moyenne = 0.0;
+    bilan->utilisation_max = 0.0;
+    bilan->debit_livre = (sim->horloge > 0) ? sim->compteurs.octets_livres * 8.0 * 1e9 / sim->horloge : 0.0;
+    if (sim->horloge == 0) return true;
+
+    // chaque lien est compté une fois, depuis son extrémité de plus petit sommet
+    double somme = 0.0;
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        if (sw == NULL) continue;
+
+        for (int p = 0; p < sw->nb_ports; p++) {
+            const port_info_t *port = &sw->ports[p];
+            if (port->voisin == UNKNOWN_INDEX || port->voisin < s ||
+                r->equipements[port->voisin].type != EQUIPEMENT_SWITCH) {
+                continue;
+            }
+
+            const file_sortie_t *aller = file_sortie(sim, s, p);
+            const file_sortie_t *retour = file_sortie(sim, port->voisin, port->port_voisin);
+            temps_sim_t occupe = aller->temps_occupe > retour->temps_occupe ? aller->temps_occupe : retour->temps_occupe;
+            double utilisation = (double)occupe / sim->horloge;
+
+            bilan->nb_liens++;
+            if (aller->nb_emises > 0 || retour->nb_emises > 0) bilan->nb_liens_utilises++;
+            if (utilisation > bilan->utilisation_max) bilan->utilisation_max = utilisation;
+            somme += utilisation;
+        }
+    }
+    if (bilan->nb_liens > 0) bilan->utilisation_moyenne = somme / bilan->nb_liens;
+    return true;
+}
+
+void afficher_bilan_liens(const simulation_t *sim) {
+    bilan_liens_t bilan;
+    if (!bilan_liens(sim, &bilan)) return;
+
+    printf("Liens entre switchs (%s) : %zu utilisé(s) sur %zu | utilisation moyenne %.1f%%, max %.1f%% | débit livré %.1f Mb/s\n",
+           sim->spb != NULL ? "multichemin" : "STP", bilan.nb_liens_utilises, bilan.nb_liens,
+           100.0 * bilan.utilisation_moyenne, 100.0 * bilan.utilisation_max, bilan.debit_livre / 1e6);
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arp.h"
+#include "histogramme.h"
+#include "mstp.h"
+#include "multichemin.h"
+#include "reseau.h"
+#include "temporisation.h"
+#include "trame.h"
+
+// Temps simulé, en nanosecondes
+typedef uint64_t temps_sim_t;
+
+#define CAPACITE_FILE_DEFAUT 64      // trames en attente par port de sortie
+#define INTERVALLE_INTER_TRAMES 12   // octets de silence entre deux trames
+#define RESOLUTION_TEMPORISATIONS 1000000ULL        // 1 ms
+#define VIEILLISSEMENT_DEFAUT 300000000000ULL       // 300 s (802.1D)
+#define ATTENTES_ARP_MAX 3           // paquets IP retenus par adresse en cours de résolution
+#define TENTATIVES_ARP_MAX 3         // requêtes sans réponse avant d'abandonner les paquets retenus
+#define INTERVALLE_REQUETES_MULTICAST 125000000000ULL  // 125 s (requêtes générales IGMP)
+
+typedef enum {
+    EVT_RECEPTION,        // la trame arrive sur le port de l'équipement
+    EVT_FIN_EMISSION      // le port a fini de sérialiser sa trame
+} type_evenement_t;
+
+typedef struct {
+    temps_sim_t date;
+    uint64_t sequence;   // départage des événements simultanés dans l'ordre de création
+    type_evenement_t type;
+    sommet equipement;
+    int port;            // port de réception ou d'émission (0 pour une station)
+    trame t;             // EVT_RECEPTION uniquement
+} evenement_t;
+
+// Temporisations de la roue ; objet est le sommet du switch, ou de la station pour TEMPO_ARP
+// (inutilisé pour les temporisations multicast, communes à la simulation)
+typedef enum {
+    TEMPO_VIEILLISSEMENT,   // adresse apprise (argument : MAC)
+    TEMPO_HELLO,            // émission périodique des BPDU par les ports désignés
+    TEMPO_AGE_MAX,          // informations reçues sur le port périmées (argument : port)
+    TEMPO_FORWARD_DELAY,    // passage au statut suivant (argument : port)
+    TEMPO_ARP,              // résolution sans réponse : relance ou abandon (argument : cle_ip)
+    TEMPO_REQUETE_MULTICAST,  // requête générale périodique : adhésions non renouvelées oubliées
+    TEMPO_RAPPORT_MULTICAST   // nouveau chemin relayant : les stations renouvellent leurs adhésions
+} type_temporisation_t;
+
+// Temporisations STP d'un port de switch (TEMPORISATION_AUCUNE si non armée)
+typedef struct {
+    int age_max;
+    int transition;
+} temporisations_port_t;
+
+// Politique appliquée quand une trame arrive sur une file de sortie pleine
+typedef enum {
+    REJET_QUEUE = 0,     // la trame arrivante est rejetée (tail drop)
+    REJET_TETE           // la plus ancienne trame en attente est rejetée
+} politique_rejet_t;
+
+// File de sortie d'un port : anneau de capacité fixe, alloué au premier usage
+typedef struct {
+    trame *trames;
+    int tete;
+    int nb;
+    bool occupe;                 // une trame est en cours de sérialisation
+    uint64_t nb_emises;
+    uint64_t octets_emis;
+    uint64_t nb_rejetees;
+    int occupation_max;
+    temps_sim_t temps_occupe;    // cumul des durées de sérialisation
+} file_sortie_t;
+
+typedef struct {
+    uint64_t nb_emises;      // trames émises par les stations
+    uint64_t nb_livrees;     // trames remises à une station destinataire
+    uint64_t nb_copies;      // descripteurs supplémentaires créés par les inondations
+    uint64_t nb_filtrees;    // trames ignorées (station non destinataire, port bloqué)
+    uint64_t nb_rejetees;    // trames perdues sur une file de sortie pleine
+    uint64_t octets_livres;  // taille sur le support des trames livrées
+    uint64_t nb_expirees;    // adresses retirées des tables par vieillissement
+    uint64_t nb_recalculs_stp; // reconvergences déclenchées par max age
+    uint64_t nb_requetes_arp;  // requêtes diffusées par les stations
+    uint64_t nb_reponses_arp;
+    uint64_t nb_abandons_arp;  // paquets IP perdus : trop nombreux en attente, ou restés sans réponse
+    uint64_t nb_adhesions_oubliees; // membres multicast non renouvelés entre deux requêtes générales
+} compteurs_simulation_t;
+
+// Occupation des liens entre switchs (la plus chargée des deux directions)
+typedef struct {
+    size_t nb_liens;
+    size_t nb_liens_utilises;
+    double utilisation_moyenne;   // entre 0 et 1, sur tous les liens
+    double utilisation_max;
+    double debit_livre;           // bit/s livrés aux stations depuis le début
+} bilan_liens_t;
+
+// Couple de stations dont la latence de bout en bout est suivie séparément
+typedef struct {
+    mac_addr_t source;
+    mac_addr_t destination;
+    histogramme_t latence;
+} paire_suivie_t;
+
+// Paquet IP retenu par une station jusqu'à la résolution de son destinataire
+typedef struct {
+    sommet station;
+    uint32_t ip;                 // cle_ip du destinataire
+    temps_sim_t date_requete;    // dernière requête diffusée pour ce destinataire
+    int nb_requetes;             // requêtes diffusées pour ce destinataire
+    int relance;                 // temporisation TEMPO_ARP, commune aux paquets du destinataire
+    trame t;                     // destination renseignée à la réception de la réponse
+} attente_arp_t;
+
+// Groupe multicast rejoint par une station
+typedef struct {
+    sommet station;
+    mac_addr_t groupe;
+} adhesion_t;
+
+// Résolution ARP, toutes stations confondues
+typedef struct {
+    uint64_t nb_requetes;
+    uint64_t nb_reponses;
+    uint64_t nb_succes;          // consultations des caches
+    uint64_t nb_echecs;
+    uint64_t nb_expirees;
+    size_t nb_entrees;           // entrées présentes dans les caches
+    size_t nb_en_attente;
+    uint64_t nb_abandons;
+    double taux_succes;          // entre 0 et 1
+} bilan_arp_t;
+
+// Simulation à événements discrets de la commutation des trames
+typedef struct {
+    reseau_t *reseau;
+    temps_sim_t horloge;
+    evenement_t *evenements;     // tas binaire ordonné par (date, sequence)
+    size_t nb_evenements;
+    size_t evenements_capacite;
+    uint64_t sequence;
+    file_sortie_t *files;        // une file par port de switch et par station
+    size_t *premiere_file;       // indice de la file du port 0 de chaque sommet
+    size_t nb_files;
+    int capacite_file;
+    politique_rejet_t politique;
+    const plan_spb_t *spb;       // acheminement multichemin, NULL : apprentissage + STP
+    plan_mstp_t *mstp;           // une instance d'arbre par groupe de VLAN, NULL : arbre commun
+    int *ports_sortie;           // tampon de travail pour commuter_trame
+    int ports_capacite;
+    compteurs_simulation_t compteurs;
+    histogramme_t latence;           // émission -> livraison, en ns simulées, toutes paires
+    paire_suivie_t *paires;
+    size_t nb_paires;
+    size_t paires_capacite;
+    bool chronometrer;               // mesure le temps réel de chaque commutation
+    histogramme_t temps_commutation; // en ns de temps réel, si chronometrer
+    roue_temporisations_t roue;
+    temps_sim_t vieillissement;      // durée de vie des adresses apprises, 0 : sans expiration
+    temporisations_port_t *tempo_ports; // une par file, NULL tant que le STP n'est pas temporisé
+    cache_arp_t *caches_arp;         // un par station, NULL tant que l'ARP n'est pas activé
+    temps_sim_t duree_cache_arp;
+    attente_arp_t *attentes_arp;     // dans l'ordre d'envoi
+    size_t nb_attentes_arp;
+    size_t attentes_arp_capacite;
+    adhesion_t *adhesions;           // les stations acceptent les trames de leurs groupes
+    size_t nb_adhesions;
+    size_t adhesions_capacite;
+    int requete_multicast;           // temporisations multicast, TEMPORISATION_AUCUNE si non armées
+    int rapport_multicast;
+} simulation_t;
+
+bool init_simulation(simulation_t *sim, reseau_t *r);
+void deinit_simulation(simulation_t *sim);
+// Fait annuler par la roue de sim les temporisations des entrées purgées des
+// tables (appelé par init_simulation, à rappeler après une restauration)
+void surveiller_purges_simulation(simulation_t *sim);
+void configurer_files_sortie(simulation_t *sim, int capacite, politique_rejet_t politique);
+void activer_multichemin(simulation_t *sim, const plan_spb_t *plan);
+void activer_mstp(simulation_t *sim, plan_mstp_t *plan);
+
+uint64_t debit_lien(int poids);
+temps_sim_t duree_serialisation(const trame *t, int poids);
+
+bool emettre_trame(simulation_t *sim, sommet station, const trame *t);
+size_t executer_simulation(simulation_t *sim, size_t max_etapes);
+// Traite événements et temporisations jusqu'à date incluse, puis y place l'horloge
+size_t executer_jusqua(simulation_t *sim, temps_sim_t date);
+// Même chose sans phase de profilage, pour les boucles qui avancent trame par
+// trame et ouvrent elles-mêmes une seule phase (generer_trafic)
+size_t avancer_simulation(simulation_t *sim, temps_sim_t date);
+
+// Vieillissement des tables de commutation (0 : désactivé), y compris
+// pour les adresses déjà apprises
+bool configurer_vieillissement(simulation_t *sim, temps_sim_t duree);
+
+// STP 802.1D temporisé à partir des rôles déjà calculés : les ports relayant passent
+// par l'écoute et l'apprentissage (forward delay), les ports désignés émettent un
+// hello périodique et un port qui n'en reçoit plus pendant max age provoque un
+// nouveau calcul de l'arbre
+bool activer_temporisations_stp(simulation_t *sim);
+
+// Les stations répondent aux requêtes ARP qui les visent et tiennent un cache
+// dont les entrées vivent duree_cache
+bool activer_arp(simulation_t *sim, temps_sim_t duree_cache);
+
+// Envoi d'un paquet IP dans la trame t (destination MAC ignorée) : émis aussitôt si
+// l'adresse est en cache, sinon retenu et une requête est diffusée, relancée toutes
+// les RELANCE_ARP tant que la réponse n'est pas arrivée ; après TENTATIVES_ARP_MAX
+// requêtes sans réponse, les paquets retenus sont abandonnés. Sans ARP, émet t telle
+// quelle. false si la station n'est pas raccordée ou si trop de paquets attendent déjà.
+bool envoyer_ip(simulation_t *sim, sommet station, ip_addr_t destination, const trame *t);
+void bilan_arp(const simulation_t *sim, bilan_arp_t *bilan);
+void afficher_bilan_arp(const simulation_t *sim);
+
+// Surveillance des adhésions multicast sur tous les switchs : les trames d'un
+// groupe connu ne partent que vers ses ports membres au lieu d'être inondées.
+// Comme l'IGMP, une requête générale toutes les INTERVALLE_REQUETES_MULTICAST
+// oublie les membres qui n'ont pas renouvelé leur adhésion depuis la précédente
+// et fait renouveler les siennes à chaque station ; un port qui se met à relayer
+// après une reconvergence les fait aussi renouveler, sans attendre la requête.
+void activer_surveillance_multicast(simulation_t *sim, bool actif);
+// La station émet une trame d'adhésion (ou de départ), inondée sur l'arbre,
+// dont chaque switch traversé retient le port d'arrivée
+bool rejoindre_groupe_multicast(simulation_t *sim, sommet station, mac_addr_t groupe);
+bool quitter_groupe_multicast(simulation_t *sim, sommet station, mac_addr_t groupe);
+
+bool suivre_paire(simulation_t *sim, sommet source, sommet destination);
+void afficher_latences(const simulation_t *sim);
+
+file_sortie_t *file_sortie(const simulation_t *sim, sommet s, int port);
+void afficher_files_sortie(const simulation_t *sim, double seuil_utilisation);
+bool bilan_liens(const simulation_t *sim, bilan_liens_t *bilan);
+void afficher_bilan_liens(const simulation_t *sim);
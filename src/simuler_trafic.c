@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "configuration.h"
+#include "stp.h"
+#include "trafic.h"
+#include "memoire.h"
+#include "export.h"
+#include "profileur.h"
+
+// Charge reproductible sur une topologie : STP, puis trafic généré pendant
+// la durée demandée, puis bilan de débit et des tables de commutation
+// (et de la mémoire par sous-système si compilé avec -DCOMPTER_MEMOIRE).
+// -x écrit la topologie et les rôles STP en DOT ou GraphML (selon l'extension).
+// -P affiche à la sortie le bilan par phase et écrit les piles repliées
+// (phases mesurées seulement si compilé avec -DPROFILER).
+// Usage : ./simuler_trafic [-m poisson|tous|chaud|incast|arp|trace] [-r trames/s]
+//         [-t taille|min-max|imix] [-s graine] [-c station] [-p proportion]
+//         [-f trace.csv] [-d durée_ms] [-a vieillissement_s] [-A cache_arp_s]
+//         [-x export.dot|export.graphml] [-P profil.folded] <configuration>
+
+static bool lire_motif(const char *nom, motif_trafic_t *motif) {
+    static const char *noms[] = {"poisson", "tous", "chaud", "incast", "arp", "trace"};
+    for (int k = 0; k < 6; k++) {
+        if (strcmp(nom, noms[k]) == 0) {
+            *motif = (motif_trafic_t)k;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool lire_taille(const char *texte, config_trafic_t *c) {
+    if (strcmp(texte, "imix") == 0) {
+        c->loi_taille = TAILLE_IMIX;
+        return true;
+    }
+    if (sscanf(texte, "%zu-%zu", &c->taille_min, &c->taille_max) == 2) {
+        c->loi_taille = TAILLE_UNIFORME;
+        return true;
+    }
+    if (sscanf(texte, "%zu", &c->taille_min) == 1) {
+        c->loi_taille = TAILLE_FIXE;
+        c->taille_max = c->taille_min;
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    config_trafic_t c;
+    config_trafic_defaut(&c);
+    double duree_ms = 100;
+    double vieillissement_s = 0;
+    double cache_arp_s = 0;
+    const char *configuration = NULL;
+    const char *export = NULL;
+    bool ok = true;
+
+    for (int i = 1; ok && i < argc; i++) {
+        const char *valeur = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (argv[i][0] != '-' || valeur == NULL) {
+            configuration = argv[i];
+            continue;
+        }
+        switch (argv[i][1]) {
+            case 'm': ok = lire_motif(valeur, &c.motif); break;
+            case 'r': c.debit = atof(valeur); break;
+            case 't': ok = lire_taille(valeur, &c); break;
+            case 's': c.graine = strtoull(valeur, NULL, 10); break;
+            case 'c': c.point_chaud = strtoul(valeur, NULL, 10); break;
+            case 'p': c.proportion = atof(valeur); break;
+            case 'f': c.trace = valeur; break;
+            case 'd': duree_ms = atof(valeur); break;
+            case 'a': vieillissement_s = atof(valeur); break;
+            case 'A': cache_arp_s = atof(valeur); break;
+            case 'x': export = valeur; break;
+            case 'P': ok = profiler_a_la_sortie(valeur); break;
+            default: ok = false; break;
+        }
+        i++;
+    }
+    if (!ok || configuration == NULL || duree_ms <= 0) {
+        fprintf(stderr, "Usage : %s [-m poisson|tous|chaud|incast|arp|trace] [-r trames/s] [-t taille|min-max|imix]\n"
+                        "       [-s graine] [-c station] [-p proportion] [-f trace.csv] [-d durée_ms]\n"
+                        "       [-a vieillissement_s] [-A cache_arp_s] [-x export.dot|export.graphml]\n"
+                        "       [-P profil.folded] <configuration>\n", argv[0]);
+        return 1;
+    }
+
+    reseau_t r;
+    init_reseau(&r);
+    if (!lire_reseau(configuration, &r)) {
+        deinit_reseau(&r);
+        return 1;
+    }
+    calculer_stp(&r, NULL);
+    if (export != NULL && !exporter_reseau(export, &r)) {
+        deinit_reseau(&r);
+        return 1;
+    }
+
+    simulation_t sim;
+    generateur_trafic_t g;
+    ok = init_simulation(&sim, &r);
+    if (ok && vieillissement_s > 0) ok = configurer_vieillissement(&sim, (temps_sim_t)(vieillissement_s * 1e9));
+    if (ok && cache_arp_s > 0) ok = activer_arp(&sim, (temps_sim_t)(cache_arp_s * 1e9));
+    if (ok && init_generateur(&g, &sim, &c)) {
+        generer_trafic(&g, (temps_sim_t)(duree_ms * 1e6));
+        executer_simulation(&sim, 0);
+        afficher_bilan_trafic(&g);
+        if (sim.caches_arp != NULL) afficher_bilan_arp(&sim);
+        afficher_latences(&sim);
+        compteur_memoire_t m;
+        if (compteur_memoire(MEMOIRE_GRAPHE, &m)) afficher_bilan_memoire(ordre(&r.g), nb_aretes(&r.g));
+        deinit_generateur(&g);
+    } else {
+        ok = false;
+    }
+
+    deinit_simulation(&sim);
+    deinit_reseau(&r);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,552 @@
+#include "stp.h"
+#include "journal.h"
+#include "profileur.h"
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+bridge_id_t calculer_bridge_id(const switch_t *sw) {
+    if (sw == NULL) return UINT64_MAX;
+
+    bridge_id_t id = (bridge_id_t)(sw->priorite & 0xFFFF) << 48;
+    for (int i = 0; i < 6; i++) {
+        id |= (bridge_id_t)sw->mac.octet[i] << (8 * (5 - i));
+    }
+    return id;
+}
+
+int comparer_bpdu(const bpdu_t *b1, const bpdu_t *b2) {
+    if (b1->racine != b2->racine) return (b1->racine < b2->racine) ? -1 : 1;
+    if (b1->cout != b2->cout) return (b1->cout < b2->cout) ? -1 : 1;
+    if (b1->emetteur != b2->emetteur) return (b1->emetteur < b2->emetteur) ? -1 : 1;
+    if (b1->port_emetteur != b2->port_emetteur) return (b1->port_emetteur < b2->port_emetteur) ? -1 : 1;
+    if (b1->port_recepteur != b2->port_recepteur) return (b1->port_recepteur < b2->port_recepteur) ? -1 : 1;
+    return 0;
+}
+
+// BPDU d'un switch qui se considère racine
+static bpdu_t bpdu_racine(bridge_id_t id) {
+    bpdu_t b = {id, 0, id, -1, -1};
+    return b;
+}
+
+void init_stp(switch_stp_t *stp, switch_t *sw) {
+    if (stp == NULL) return;
+
+    stp->sw = sw;
+    stp->id = calculer_bridge_id(sw);
+    stp->meilleur = bpdu_racine(stp->id);
+    stp->port_racine = -1;
+}
+
+void deinit_stp(switch_stp_t *stp) {
+    if (stp == NULL) return;
+
+    stp->sw = NULL;
+    stp->port_racine = -1;
+}
+
+// Index dans r->switchs du switch relié au port, ou UNKNOWN_INDEX ;
+// un port désactivé ne participe pas au protocole
+static size_t switch_voisin(const reseau_t *r, const port_info_t *port) {
+    if (!port->actif || port->voisin == UNKNOWN_INDEX || r->equipements[port->voisin].type != EQUIPEMENT_SWITCH) {
+        return UNKNOWN_INDEX;
+    }
+    return r->equipements[port->voisin].index;
+}
+
+// Meilleur BPDU du switch i au vu des BPDU courants de ses voisins :
+// chaque voisin j annonce {racine_j, cout_j, id_j, port_j}, reçu avec le coût du port.
+// Seuls les liens du cœur sont parcourus, les ports d'accès n'annonçant rien.
+static bpdu_t relaxer(const coeur_reseau_t *c, size_t i, const bridge_id_t *ids, const bpdu_t *etats) {
+    bpdu_t meilleur = bpdu_racine(ids[i]);
+
+    for (size_t k = c->debut_liens[i]; k < c->debut_liens[i + 1]; k++) {
+        const lien_coeur_t *l = &c->liens[k];
+        size_t j = l->voisin;
+        bpdu_t recu = {etats[j].racine, etats[j].cout + (uint32_t)l->cout, ids[j], l->port_voisin, l->port};
+        if (comparer_bpdu(&recu, &meilleur) < 0) {
+            meilleur = recu;
+        }
+    }
+    return meilleur;
+}
+
+// Rôle du port p du switch i une fois les BPDU stabilisés ; en mode rapide (RSTP),
+// un port non désigné est alternatif, ou de secours si le port désigné de son
+// segment appartient au même switch
+static etat_port_t role_port(const reseau_t *r, size_t i, int p, const bridge_id_t *ids, const bpdu_t *etats,
+                             bool rapide) {
+    const port_info_t *port = &r->switchs[i].ports[p];
+    if (port->voisin == UNKNOWN_INDEX || !port->actif) return PORT_INCONNU;
+
+    size_t j = switch_voisin(r, port);
+    if (j == UNKNOWN_INDEX) return PORT_DESIGNE; // station : port de bordure
+    if (etats[i].racine != ids[i] && etats[i].port_recepteur == p) return PORT_RACINE;
+
+    // le port désigné du segment est celui qui annonce le meilleur BPDU
+    bpdu_t local = {etats[i].racine, etats[i].cout, ids[i], p, 0};
+    bpdu_t distant = {etats[j].racine, etats[j].cout, ids[j], port->port_voisin, 0};
+    if (comparer_bpdu(&local, &distant) < 0) return PORT_DESIGNE;
+    if (!rapide) return PORT_BLOQUE;
+    return (ids[j] == ids[i]) ? PORT_SECOURS : PORT_ALTERNATIF;
+}
+
+// Nombre de BPDU émis par tour : un par port reliant deux switchs
+static uint64_t bpdu_par_tour(const coeur_reseau_t *c) {
+    return nb_liens_coeur(c);
+}
+
+static void bilan(const reseau_t *r, const bridge_id_t *ids, const bpdu_t *etats, resultat_stp_t *res) {
+    res->racine = (r->nb_switchs > 0) ? etats[0].racine : 0;
+    res->nb_racines = 0;
+    res->nb_ports_bloques = 0;
+    res->nb_ports_alternatifs = 0;
+    res->nb_ports_secours = 0;
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        if (etats[i].racine == ids[i]) res->nb_racines++;
+        for (int p = 0; p < r->switchs[i].nb_ports; p++) {
+            switch (get_etat_port(&r->switchs[i], p)) {
+                case PORT_ALTERNATIF: res->nb_ports_alternatifs++; res->nb_ports_bloques++; break;
+                case PORT_SECOURS: res->nb_ports_secours++; res->nb_ports_bloques++; break;
+                case PORT_BLOQUE: res->nb_ports_bloques++; break;
+                default: break;
+            }
+        }
+    }
+}
+
+// Relaxation en place : chaque switch tient compte immédiatement
+// des BPDU déjà améliorés pendant le tour courant. Renvoie le nombre de tours.
+static size_t converger(const coeur_reseau_t *c, const bridge_id_t *ids, bpdu_t *etats) {
+    size_t tours = 0;
+    bool change = true;
+    while (change) {
+        change = false;
+        tours++;
+        for (size_t i = 0; i < c->nb_switchs; i++) {
+            bpdu_t meilleur = relaxer(c, i, ids, etats);
+            if (comparer_bpdu(&meilleur, &etats[i]) != 0) {
+                etats[i] = meilleur;
+                change = true;
+            }
+        }
+    }
+    return tours;
+}
+
+bool calculer_stp(reseau_t *r, resultat_stp_t *res) {
+    if (r == NULL) return false;
+
+    PROFILER_ENTRER("stp");
+    size_t n = r->nb_switchs;
+    coeur_reseau_t c;
+    if (!construire_coeur(&c, r)) {
+        PROFILER_SORTIR();
+        return false;
+    }
+    switch_stp_t *stp = malloc((n > 0 ? n : 1) * sizeof(switch_stp_t));
+    bridge_id_t *ids = malloc((n > 0 ? n : 1) * sizeof(bridge_id_t));
+    bpdu_t *etats = malloc((n > 0 ? n : 1) * sizeof(bpdu_t));
+    if (stp == NULL || ids == NULL || etats == NULL) {
+        free(stp);
+        free(ids);
+        free(etats);
+        deinit_coeur(&c);
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        init_stp(&stp[i], &r->switchs[i]);
+        ids[i] = stp[i].id;
+        etats[i] = stp[i].meilleur;
+    }
+
+    PROFILER_ENTRER("relaxation");
+    size_t tours = converger(&c, ids, etats);
+    PROFILER_SORTIR();
+
+    PROFILER_ENTRER("roles");
+    for (size_t i = 0; i < n; i++) {
+        stp[i].meilleur = etats[i];
+        stp[i].port_racine = (etats[i].racine == ids[i]) ? -1 : etats[i].port_recepteur;
+        for (int p = 0; p < r->switchs[i].nb_ports; p++) {
+            set_etat_port(&r->switchs[i], p, role_port(r, i, p, ids, etats, false));
+        }
+        deinit_stp(&stp[i]);
+    }
+    PROFILER_SORTIR();
+
+    if (res != NULL) {
+        res->nb_tours = tours;
+        res->nb_bpdu = bpdu_par_tour(&c) * tours;
+        // 802.1D : une fois les rôles établis, écoute puis apprentissage avant de relayer
+        res->temps_convergence_ms = tours * DELAI_SAUT_BPDU_MS + 2 * FORWARD_DELAY_MS;
+        bilan(r, ids, etats, res);
+    }
+
+    free(stp);
+    free(ids);
+    free(etats);
+    deinit_coeur(&c);
+    PROFILER_SORTIR();
+    return true;
+}
+
+bool calculer_instance_stp(const reseau_t *r, const coeur_reseau_t *c, const bridge_id_t *ids, const size_t *debut,
+                           etat_port_t *roles, resultat_stp_t *res) {
+    if (r == NULL || c == NULL || ids == NULL || debut == NULL || roles == NULL) return false;
+
+    size_t n = r->nb_switchs;
+    bpdu_t *etats = malloc((n > 0 ? n : 1) * sizeof(bpdu_t));
+    if (etats == NULL) return false;
+
+    PROFILER_ENTRER("instance_stp");
+    for (size_t i = 0; i < n; i++) etats[i] = bpdu_racine(ids[i]);
+    size_t tours = converger(c, ids, etats);
+
+    resultat_stp_t bilan_instance = {0};
+    bilan_instance.racine = (n > 0) ? etats[0].racine : 0;
+    for (size_t i = 0; i < n; i++) {
+        if (etats[i].racine == ids[i]) bilan_instance.nb_racines++;
+        for (int p = 0; p < r->switchs[i].nb_ports; p++) {
+            etat_port_t role = role_port(r, i, p, ids, etats, true);
+            roles[debut[i] + p] = role;
+            if (role == PORT_ALTERNATIF) bilan_instance.nb_ports_alternatifs++;
+            if (role == PORT_SECOURS) bilan_instance.nb_ports_secours++;
+        }
+    }
+    bilan_instance.nb_ports_bloques = bilan_instance.nb_ports_alternatifs + bilan_instance.nb_ports_secours;
+    bilan_instance.nb_tours = tours;
+    bilan_instance.nb_bpdu = bpdu_par_tour(c) * tours;
+    // rôles rapides : les ports relaient dès l'accord, sans attente d'écoute ni d'apprentissage
+    bilan_instance.temps_convergence_ms = tours * DELAI_SAUT_BPDU_MS;
+    if (res != NULL) *res = bilan_instance;
+    PROFILER_SORTIR();
+
+    free(etats);
+    return true;
+}
+
+bool calculer_stp_parallele(reseau_t *r, int nb_threads, resultat_stp_t *res) {
+    if (r == NULL) return false;
+
+    PROFILER_ENTRER("stp_parallele");
+#ifdef _OPENMP
+    if (nb_threads <= 0) nb_threads = omp_get_max_threads();
+#else
+    nb_threads = 1;
+#endif
+
+    long n = (long)r->nb_switchs;
+    coeur_reseau_t c;
+    if (!construire_coeur(&c, r)) {
+        PROFILER_SORTIR();
+        return false;
+    }
+    bridge_id_t *ids = malloc((n > 0 ? n : 1) * sizeof(bridge_id_t));
+    bpdu_t *courant = malloc((n > 0 ? n : 1) * sizeof(bpdu_t));
+    bpdu_t *suivant = malloc((n > 0 ? n : 1) * sizeof(bpdu_t));
+    if (ids == NULL || courant == NULL || suivant == NULL) {
+        free(ids);
+        free(courant);
+        free(suivant);
+        deinit_coeur(&c);
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    #pragma omp parallel for num_threads(nb_threads) schedule(static)
+    for (long i = 0; i < n; i++) {
+        ids[i] = calculer_bridge_id(&r->switchs[i]);
+        courant[i] = bpdu_racine(ids[i]);
+    }
+
+    // Tours bulk-synchrones : chaque switch lit uniquement le tampon courant
+    // et écrit sa propre case du tampon suivant, aucun verrou n'est nécessaire
+    size_t tours = 0;
+    bool change = true;
+    while (change) {
+        change = false;
+        tours++;
+        #pragma omp parallel for num_threads(nb_threads) schedule(static) reduction(||:change)
+        for (long i = 0; i < n; i++) {
+            suivant[i] = relaxer(&c, i, ids, courant);
+            if (comparer_bpdu(&suivant[i], &courant[i]) != 0) change = true;
+        }
+        bpdu_t *tmp = courant;
+        courant = suivant;
+        suivant = tmp;
+    }
+
+    // Chaque switch n'écrit que ses propres ports
+    #pragma omp parallel for num_threads(nb_threads) schedule(static)
+    for (long i = 0; i < n; i++) {
+        for (int p = 0; p < r->switchs[i].nb_ports; p++) {
+            set_etat_port(&r->switchs[i], p, role_port(r, i, p, ids, courant, false));
+        }
+    }
+
+    if (res != NULL) {
+        res->nb_tours = tours;
+        res->nb_bpdu = bpdu_par_tour(&c) * tours;
+        // 802.1D : une fois les rôles établis, écoute puis apprentissage avant de relayer
+        res->temps_convergence_ms = tours * DELAI_SAUT_BPDU_MS + 2 * FORWARD_DELAY_MS;
+        bilan(r, ids, courant, res);
+    }
+
+    free(ids);
+    free(courant);
+    free(suivant);
+    deinit_coeur(&c);
+    PROFILER_SORTIR();
+    return true;
+}
+
+// État des ports pendant la convergence RSTP, indexés par debut[i] + p
+typedef struct {
+    size_t *debut;              // premier port global de chaque switch
+    size_t *pair;               // port global de l'autre extrémité (UNKNOWN_INDEX : station ou libre)
+    etat_port_t *roles;
+    statut_port_t *statuts;
+    size_t *proposition;        // saut d'envoi de la dernière proposition, 0 si aucune en cours
+    bool *accorde;              // accord obtenu pour l'information courante
+    bool *messages;             // bloc des drapeaux ci-dessous
+    bool *propositions[2];      // reçues au saut courant / à recevoir au saut suivant
+    bool *accords[2];
+} etat_rstp_t;
+
+static void liberer_etat_rstp(etat_rstp_t *e) {
+    free(e->debut);
+    free(e->pair);
+    free(e->roles);
+    free(e->statuts);
+    free(e->proposition);
+    free(e->accorde);
+    free(e->messages);
+}
+
+static bool allouer_etat_rstp(etat_rstp_t *e, const reseau_t *r) {
+    size_t n = r->nb_switchs;
+    e->debut = malloc((n + 1) * sizeof(size_t));
+    if (e->debut == NULL) return false;
+    e->debut[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        e->debut[i + 1] = e->debut[i] + r->switchs[i].nb_ports;
+    }
+
+    size_t m = e->debut[n] + 1;
+    e->pair = malloc(m * sizeof(size_t));
+    e->roles = malloc(m * sizeof(etat_port_t));
+    e->statuts = malloc(m * sizeof(statut_port_t));
+    e->proposition = calloc(m, sizeof(size_t));
+    e->accorde = calloc(m, sizeof(bool));
+    e->messages = calloc(4 * m, sizeof(bool));
+    if (e->pair == NULL || e->roles == NULL || e->statuts == NULL || e->proposition == NULL ||
+        e->accorde == NULL || e->messages == NULL) {
+        return false;
+    }
+    e->propositions[0] = e->messages;
+    e->propositions[1] = e->messages + m;
+    e->accords[0] = e->messages + 2 * m;
+    e->accords[1] = e->messages + 3 * m;
+
+    for (size_t i = 0; i < n; i++) {
+        const switch_t *sw = &r->switchs[i];
+        for (int p = 0; p < sw->nb_ports; p++) {
+            size_t k = e->debut[i] + p;
+            size_t j = switch_voisin(r, &sw->ports[p]);
+            e->pair[k] = (j == UNKNOWN_INDEX) ? UNKNOWN_INDEX : e->debut[j] + sw->ports[p].port_voisin;
+            e->roles[k] = PORT_INCONNU;
+            e->statuts[k] = STATUT_REJET;
+        }
+    }
+    return true;
+}
+
+// Synchronisation avant d'accepter une racine : les ports désignés vers d'autres
+// switchs qui n'ont pas obtenu d'accord pour l'information courante cessent de relayer
+static void synchroniser(etat_rstp_t *e, size_t i) {
+    for (size_t k = e->debut[i]; k < e->debut[i + 1]; k++) {
+        if (e->roles[k] == PORT_DESIGNE && e->pair[k] != UNKNOWN_INDEX && !e->accorde[k]) {
+            e->statuts[k] = STATUT_REJET;
+        }
+    }
+}
+
+bool calculer_rstp(reseau_t *r, resultat_stp_t *res) {
+    if (r == NULL) return false;
+
+    PROFILER_ENTRER("rstp");
+    size_t n = r->nb_switchs;
+    bridge_id_t *ids = malloc((n > 0 ? n : 1) * sizeof(bridge_id_t));
+    bpdu_t *courant = malloc((n > 0 ? n : 1) * sizeof(bpdu_t));
+    bpdu_t *suivant = malloc((n > 0 ? n : 1) * sizeof(bpdu_t));
+    etat_rstp_t e = {0};
+    coeur_reseau_t c = {0};
+    if (ids == NULL || courant == NULL || suivant == NULL || !allouer_etat_rstp(&e, r) || !construire_coeur(&c, r)) {
+        free(ids);
+        free(courant);
+        free(suivant);
+        liberer_etat_rstp(&e);
+        deinit_coeur(&c);
+        PROFILER_SORTIR();
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        ids[i] = calculer_bridge_id(&r->switchs[i]);
+        courant[i] = bpdu_racine(ids[i]);
+    }
+
+    // chaque saut : les BPDU émis au saut précédent sont reçus et traités
+    uint64_t nb_bpdu = bpdu_par_tour(&c);   // chaque switch s'annonce racine
+    size_t limite = 16 * (n + 4);
+    size_t sauts = 0;
+    bool actif = true;
+    while (actif && sauts < limite) {
+        sauts++;
+        bool emis = false;
+
+        // 1. Information : relaxation bulk-synchrone, un BPDU par port à chaque changement
+        bool info_change = false;
+        for (size_t i = 0; i < n; i++) {
+            suivant[i] = relaxer(&c, i, ids, courant);
+            if (comparer_bpdu(&suivant[i], &courant[i]) != 0) {
+                info_change = true;
+                for (size_t k = e.debut[i]; k < e.debut[i + 1]; k++) {
+                    // un accord ne vaut que pour l'information annoncée au moment de la proposition
+                    e.accorde[k] = false;
+                    if (e.pair[k] != UNKNOWN_INDEX) nb_bpdu++;
+                }
+            }
+        }
+        bpdu_t *tmp = courant;
+        courant = suivant;
+        suivant = tmp;
+
+        // 2. Rôles : un nouveau port racine relaie aussitôt, après synchronisation
+        for (size_t i = 0; i < n; i++) {
+            bool nouvelle_racine = false;
+            for (int p = 0; p < r->switchs[i].nb_ports; p++) {
+                size_t k = e.debut[i] + p;
+                etat_port_t role = role_port(r, i, p, ids, courant, true);
+                if (role == e.roles[k]) continue;
+
+                e.roles[k] = role;
+                e.proposition[k] = 0;
+                e.accorde[k] = false;
+                if (role == PORT_RACINE) {
+                    nouvelle_racine = true;
+                    e.statuts[k] = STATUT_ACHEMINEMENT;
+                } else if (role == PORT_DESIGNE && e.pair[k] == UNKNOWN_INDEX) {
+                    e.statuts[k] = STATUT_ACHEMINEMENT;   // port de bordure (station)
+                } else {
+                    e.statuts[k] = STATUT_REJET;
+                }
+            }
+            if (nouvelle_racine) synchroniser(&e, i);
+        }
+
+        // 3. Poignée de main : une proposition reçue sur un port non désigné est
+        // acceptée (après synchronisation s'il s'agit du port racine) ; un accord
+        // reçu fait passer le port désigné en acheminement sans attendre forward delay
+        for (size_t i = 0; i < n; i++) {
+            for (size_t k = e.debut[i]; k < e.debut[i + 1]; k++) {
+                if (e.propositions[0][k]) {
+                    e.propositions[0][k] = false;
+                    if (e.roles[k] == PORT_RACINE) {
+                        synchroniser(&e, i);
+                        e.statuts[k] = STATUT_ACHEMINEMENT;
+                    }
+                    if (e.roles[k] != PORT_DESIGNE) {
+                        e.accords[1][e.pair[k]] = true;
+                        nb_bpdu++;
+                        emis = true;
+                    }
+                }
+                if (e.accords[0][k]) {
+                    e.accords[0][k] = false;
+                    if (e.roles[k] == PORT_DESIGNE && e.proposition[k] != 0) {
+                        e.statuts[k] = STATUT_ACHEMINEMENT;
+                        e.accorde[k] = true;
+                        e.proposition[k] = 0;
+                    }
+                }
+            }
+        }
+
+        // 4. Propositions des ports désignés qui ne relaient pas encore,
+        // renouvelées si aucun accord n'est revenu après un aller-retour
+        for (size_t k = 0; k < e.debut[n]; k++) {
+            if (e.roles[k] == PORT_DESIGNE && e.pair[k] != UNKNOWN_INDEX && e.statuts[k] != STATUT_ACHEMINEMENT &&
+                (e.proposition[k] == 0 || sauts - e.proposition[k] >= 2)) {
+                e.propositions[1][e.pair[k]] = true;
+                e.proposition[k] = sauts;
+                nb_bpdu++;
+                emis = true;
+            }
+        }
+
+        bool *b = e.propositions[0];
+        e.propositions[0] = e.propositions[1];
+        e.propositions[1] = b;
+        b = e.accords[0];
+        e.accords[0] = e.accords[1];
+        e.accords[1] = b;
+
+        actif = info_change || emis;
+    }
+    if (actif) {
+        JOURNALISER(JOURNAL_AVERTISSEMENT, "RSTP : pas de convergence après %llu sauts", sauts, 0, 0, 0);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        switch_t *sw = &r->switchs[i];
+        for (int p = 0; p < sw->nb_ports; p++) {
+            size_t k = e.debut[i] + p;
+            set_etat_port(sw, p, e.roles[k]);
+            if (e.roles[k] != PORT_INCONNU) set_statut_port(sw, p, e.statuts[k]);
+        }
+    }
+
+    if (res != NULL) {
+        res->nb_tours = sauts;
+        res->nb_bpdu = nb_bpdu;
+        res->temps_convergence_ms = sauts * DELAI_SAUT_BPDU_MS;
+        bilan(r, ids, courant, res);
+    }
+
+    liberer_etat_rstp(&e);
+    deinit_coeur(&c);
+    free(ids);
+    free(courant);
+    free(suivant);
+    PROFILER_SORTIR();
+    return !actif;
+}
+
+void afficher_stp(const reseau_t *r) {
+    if (r == NULL) {
+        printf("Réseau: NULL\n");
+        return;
+    }
+
+    // numérotation du fichier de configuration, même après renumérotation
+    size_t i = 0;
+    for (sommet o = 0; o < ordre(&r->g); o++) {
+        const switch_t *sw = reseau_switch(r, sommet_depuis_origine(r, o));
+        if (sw == NULL) continue;
+        printf("Switch %zu (", i++);
+        afficher_mac(sw->mac);
+        printf(") :\n");
+        for (int p = 0; p < sw->nb_ports; p++) {
+            if (sw->ports[p].voisin == UNKNOWN_INDEX) continue;
+            printf("  Port %d -> équipement %zu : %s, %s\n", p, sommet_origine(r, sw->ports[p].voisin),
+                   etat_port_to_string(sw->ports[p].etat), statut_port_to_string(sw->ports[p].statut));
+        }
+    }
+}
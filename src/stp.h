@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "switch.h"
+#include "reseau.h"
+#include "coeur.h"
+
+// Modèle temporel de la convergence (802.1D) : délai d'un BPDU sur un saut
+// (émission, transit et traitement) et temporisations du protocole
+#define DELAI_SAUT_BPDU_MS 10
+#define FORWARD_DELAY_MS 15000
+#define HELLO_TIME_MS 2000
+#define MAX_AGE_MS 20000
+
+// Identifiant de pont : priorité sur les 16 bits de poids fort, MAC sur les 48 autres
+typedef uint64_t bridge_id_t;
+
+// Vecteur de priorité transporté par les BPDU (plus petit = meilleur)
+typedef struct {
+    bridge_id_t racine;
+    uint32_t cout;           // coût du chemin jusqu'à la racine
+    bridge_id_t emetteur;    // pont désigné ayant émis le BPDU
+    int port_emetteur;       // port de l'émetteur
+    int port_recepteur;      // port local de réception (départage final)
+} bpdu_t;
+
+// État STP d'un switch
+typedef struct {
+    switch_t *sw;
+    bridge_id_t id;
+    bpdu_t meilleur;         // meilleur BPDU reçu, coût du port inclus
+    int port_racine;         // -1 pour le switch racine
+} switch_stp_t;
+
+// Bilan d'un calcul STP sur un réseau
+typedef struct {
+    bridge_id_t racine;      // racine de la composante du premier switch
+    size_t nb_racines;       // une racine par composante connexe
+    size_t nb_tours;         // tours d'échange de BPDU jusqu'à convergence
+    uint64_t nb_bpdu;        // BPDU émis
+    size_t nb_ports_bloques; // bloqués, alternatifs ou de secours
+    size_t nb_ports_alternatifs;
+    size_t nb_ports_secours;
+    uint64_t temps_convergence_ms; // jusqu'à ce que tous les ports actifs relaient
+} resultat_stp_t;
+
+bridge_id_t calculer_bridge_id(const switch_t *sw);
+int comparer_bpdu(const bpdu_t *b1, const bpdu_t *b2);
+
+void init_stp(switch_stp_t *stp, switch_t *sw);
+void deinit_stp(switch_stp_t *stp);
+
+// Moteur séquentiel : relaxation des BPDU jusqu'à stabilité
+bool calculer_stp(reseau_t *r, resultat_stp_t *res);
+
+// Moteur parallèle (OpenMP) : tours bulk-synchrones sur tous les switchs,
+// avec double tampon de BPDU. Les rôles de ports obtenus sont identiques
+// à ceux de calculer_stp. nb_threads <= 0 : valeur par défaut d'OpenMP.
+bool calculer_stp_parallele(reseau_t *r, int nb_threads, resultat_stp_t *res);
+
+// Mode RSTP (802.1w) : rôles alternatif et de secours, statuts rejet /
+// apprentissage / acheminement et poignée de main proposition/accord sur les
+// liens point à point. Simulé par sauts de BPDU jusqu'à ce que l'arbre soit
+// stable et que tous les ports racine et désignés relaient.
+bool calculer_rstp(reseau_t *r, resultat_stp_t *res);
+
+// Une instance d'arbre couvrant calculée sur un cœur déjà construit, sans
+// toucher aux switchs : ids[i] identifie le switch i dans l'instance, le rôle
+// rapide (alternatif, secours) du port p du switch i est écrit dans
+// roles[debut[i] + p]. Réentrant : plusieurs instances peuvent être calculées
+// en même temps sur le même cœur.
+bool calculer_instance_stp(const reseau_t *r, const coeur_reseau_t *c, const bridge_id_t *ids, const size_t *debut,
+                           etat_port_t *roles, resultat_stp_t *res);
+
+void afficher_stp(const reseau_t *r);
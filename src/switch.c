@@ -1,4 +1,5 @@
 #include "switch.h"
+#include "memoire.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,59 +11,262 @@ void init_table_commutation(table_commutation_t *table) {
     table->entrees = NULL;
     table->taille = 0;
     table->capacite = 0;
+    table->index = NULL;
+    table->index_capacite = 0;
+    table->tetes_ports = NULL;
+    table->nb_ports_suivis = 0;
+    table->nb_purgees = 0;
+    table->rappel_purge = NULL;
+    table->contexte_purge = NULL;
 }
 
 void deinit_table_commutation(table_commutation_t *table) {
     if (table == NULL) return;
     
-    free(table->entrees);
-    table->entrees = NULL;
-    table->taille = 0;
-    table->capacite = 0;
+    liberer_memoire(MEMOIRE_TABLES, table->entrees, table->capacite * sizeof(table_entree_t));
+    liberer_memoire(MEMOIRE_TABLES, table->index, table->index_capacite * sizeof(int));
+    liberer_memoire(MEMOIRE_TABLES, table->tetes_ports, table->nb_ports_suivis * sizeof(int));
+    init_table_commutation(table);
 }
 
-bool ajouter_entree_table(table_commutation_t *table, mac_addr_t mac, int port) {
-    if (table == NULL || port < 0) return false;
+// La clé est le couple (FID, MAC) : une même adresse peut être apprise
+// indépendamment dans chaque VLAN
+static unsigned int hacher_mac(uint16_t fid, mac_addr_t mac) {
+    uint64_t h = fid;
+    for (int i = 0; i < 6; i++) {
+        h = (h << 8) | mac.octet[i];
+    }
+    h *= 0x9E3779B97F4A7C15ULL;
+    return (unsigned int)(h >> 32);
+}
+
+// Case de l'index contenant le couple (FID, MAC), ou première case libre rencontrée
+static int case_index(const table_commutation_t *table, uint16_t fid, mac_addr_t mac) {
+    int masque = table->index_capacite - 1;
+    int c = hacher_mac(fid, mac) & masque;
+    while (table->index[c] != -1) {
+        const table_entree_t *e = &table->entrees[table->index[c]];
+        if (e->fid == fid && mac_equals(e->mac, mac)) break;
+        c = (c + 1) & masque;
+    }
+    return c;
+}
+
+// Libère une case de l'index en recalant les entrées suivantes du même agrégat
+// (suppression par décalage arrière, sans marqueur de tombe)
+static void liberer_case_index(table_commutation_t *table, int c) {
+    int masque = table->index_capacite - 1;
+    int vide = c;
+    table->index[vide] = -1;
+    
+    for (int i = (vide + 1) & masque; table->index[i] != -1; i = (i + 1) & masque) {
+        const table_entree_t *e = &table->entrees[table->index[i]];
+        int ideale = hacher_mac(e->fid, e->mac) & masque;
+        // l'entrée en i peut combler le trou si sa case idéale ne se trouve pas dans ]vide, i]
+        if (((i - ideale) & masque) >= ((i - vide) & masque)) {
+            table->index[vide] = table->index[i];
+            table->index[i] = -1;
+            vide = i;
+        }
+    }
+}
+
+static bool redimensionner_index(table_commutation_t *table, int nouvelle_capacite) {
+    int *nouvel_index = allouer_memoire(MEMOIRE_TABLES, nouvelle_capacite * sizeof(int));
+    if (nouvel_index == NULL) return false;
     
+    liberer_memoire(MEMOIRE_TABLES, table->index, table->index_capacite * sizeof(int));
+    table->index = nouvel_index;
+    table->index_capacite = nouvelle_capacite;
+    for (int c = 0; c < nouvelle_capacite; c++) {
+        table->index[c] = -1;
+    }
     for (int i = 0; i < table->taille; i++) {
-        if (mac_equals(table->entrees[i].mac, mac)) {
-            table->entrees[i].port = port;
+        table->index[case_index(table, table->entrees[i].fid, table->entrees[i].mac)] = i;
+    }
+    return true;
+}
+
+static bool suivre_port(table_commutation_t *table, int port) {
+    if (port < table->nb_ports_suivis) return true;
+    
+    int nouveau_nb = (table->nb_ports_suivis == 0) ? 8 : table->nb_ports_suivis;
+    while (nouveau_nb <= port) {
+        nouveau_nb *= 2;
+    }
+    int *nouvelles_tetes = reallouer_memoire(MEMOIRE_TABLES, table->tetes_ports, table->nb_ports_suivis * sizeof(int),
+                                             nouveau_nb * sizeof(int));
+    if (nouvelles_tetes == NULL) return false;
+    
+    for (int p = table->nb_ports_suivis; p < nouveau_nb; p++) {
+        nouvelles_tetes[p] = -1;
+    }
+    table->tetes_ports = nouvelles_tetes;
+    table->nb_ports_suivis = nouveau_nb;
+    return true;
+}
+
+static void chainer_port(table_commutation_t *table, int i) {
+    int port = table->entrees[i].port;
+    table->entrees[i].precedent = -1;
+    table->entrees[i].suivant = table->tetes_ports[port];
+    if (table->tetes_ports[port] != -1) {
+        table->entrees[table->tetes_ports[port]].precedent = i;
+    }
+    table->tetes_ports[port] = i;
+}
+
+static void dechainer_port(table_commutation_t *table, int i) {
+    table_entree_t *e = &table->entrees[i];
+    if (e->precedent != -1) {
+        table->entrees[e->precedent].suivant = e->suivant;
+    } else {
+        table->tetes_ports[e->port] = e->suivant;
+    }
+    if (e->suivant != -1) {
+        table->entrees[e->suivant].precedent = e->precedent;
+    }
+}
+
+bool ajouter_entree_fid(table_commutation_t *table, uint16_t fid, mac_addr_t mac, int port) {
+    if (table == NULL || port < 0) return false;
+    if (!suivre_port(table, port)) return false;
+    
+    if (table->taille > 0) {
+        int i = table->index[case_index(table, fid, mac)];
+        if (i != -1) {
+            if (table->entrees[i].port != port) {
+                dechainer_port(table, i);
+                table->entrees[i].port = port;
+                chainer_port(table, i);
+            }
             return true;
         }
     }
     
     if (table->taille >= table->capacite) {
         int nouvelle_capacite = (table->capacite == 0) ? 8 : table->capacite * 2;
-        table_entree_t *nouvelles_entrees = realloc(table->entrees, 
-                                                     nouvelle_capacite * sizeof(table_entree_t));
+        table_entree_t *nouvelles_entrees = reallouer_memoire(MEMOIRE_TABLES, table->entrees,
+                                                              table->capacite * sizeof(table_entree_t),
+                                                              nouvelle_capacite * sizeof(table_entree_t));
         if (nouvelles_entrees == NULL) return false;
         
         table->entrees = nouvelles_entrees;
         table->capacite = nouvelle_capacite;
+        if (!redimensionner_index(table, 2 * nouvelle_capacite)) return false;
     }
     
-    table->entrees[table->taille].mac = mac;
-    table->entrees[table->taille].port = port;
+    int i = table->taille;
+    table->entrees[i].mac = mac;
+    table->entrees[i].fid = fid;
+    table->entrees[i].port = port;
+    table->entrees[i].vieillissement = -1;
+    table->index[case_index(table, fid, mac)] = i;
+    chainer_port(table, i);
     table->taille++;
     
     return true;
 }
 
+bool ajouter_entree_table(table_commutation_t *table, mac_addr_t mac, int port) {
+    return ajouter_entree_fid(table, 0, mac, port);
+}
+
+int chercher_port_fid(const table_commutation_t *table, uint16_t fid, mac_addr_t mac) {
+    if (table == NULL || table->taille == 0) return -1;
+    
+    int i = table->index[case_index(table, fid, mac)];
+    return (i != -1) ? table->entrees[i].port : -1;
+}
+
 int chercher_port_mac(const table_commutation_t *table, mac_addr_t mac) {
-    if (table == NULL) return -1;
+    return chercher_port_fid(table, 0, mac);
+}
+
+// L'entrée reste valide jusqu'à la prochaine modification de la table
+table_entree_t *chercher_entree_fid(table_commutation_t *table, uint16_t fid, mac_addr_t mac) {
+    if (table == NULL || table->taille == 0) return NULL;
     
-    for (int i = 0; i < table->taille; i++) {
-        if (mac_equals(table->entrees[i].mac, mac)) {
-            return table->entrees[i].port;
+    int i = table->index[case_index(table, fid, mac)];
+    return (i != -1) ? &table->entrees[i] : NULL;
+}
+
+table_entree_t *chercher_entree_table(table_commutation_t *table, mac_addr_t mac) {
+    return chercher_entree_fid(table, 0, mac);
+}
+
+// Retire l'entrée d'indice i en temps constant : la dernière entrée prend sa place
+static void retirer_entree(table_commutation_t *table, int i) {
+    if (table->rappel_purge != NULL && table->entrees[i].vieillissement != -1) {
+        table->rappel_purge(table->contexte_purge, table->entrees[i].vieillissement);
+    }
+    liberer_case_index(table, case_index(table, table->entrees[i].fid, table->entrees[i].mac));
+    dechainer_port(table, i);
+    
+    int derniere = table->taille - 1;
+    if (i != derniere) {
+        table_entree_t *e = &table->entrees[derniere];
+        table->index[case_index(table, e->fid, e->mac)] = i;
+        if (e->precedent != -1) {
+            table->entrees[e->precedent].suivant = i;
+        } else {
+            table->tetes_ports[e->port] = i;
         }
+        if (e->suivant != -1) {
+            table->entrees[e->suivant].precedent = i;
+        }
+        table->entrees[i] = *e;
     }
+    table->taille--;
+    table->nb_purgees++;
+}
+
+bool retirer_entree_fid(table_commutation_t *table, uint16_t fid, mac_addr_t mac) {
+    if (table == NULL || table->taille == 0) return false;
     
-    return -1; 
+    int i = table->index[case_index(table, fid, mac)];
+    if (i == -1) return false;
+    
+    retirer_entree(table, i);
+    return true;
+}
+
+bool retirer_entree_table(table_commutation_t *table, mac_addr_t mac) {
+    return retirer_entree_fid(table, 0, mac);
+}
+
+int vider_port_table(table_commutation_t *table, int port) {
+    // ne parcourt que les entrées apprises sur ce port
+    if (table == NULL || port < 0 || port >= table->nb_ports_suivis) return 0;
+    
+    int nb = 0;
+    while (table->tetes_ports[port] != -1) {
+        retirer_entree(table, table->tetes_ports[port]);
+        nb++;
+    }
+    return nb;
 }
 
 void vider_table_commutation(table_commutation_t *table) {
     if (table == NULL) return;
+    for (int i = 0; table->rappel_purge != NULL && i < table->taille; i++) {
+        if (table->entrees[i].vieillissement != -1) {
+            table->rappel_purge(table->contexte_purge, table->entrees[i].vieillissement);
+        }
+    }
     table->taille = 0;
+    for (int c = 0; c < table->index_capacite; c++) {
+        table->index[c] = -1;
+    }
+    for (int p = 0; p < table->nb_ports_suivis; p++) {
+        table->tetes_ports[p] = -1;
+    }
+}
+
+void surveiller_purges(table_commutation_t *table, rappel_purge_t rappel, void *contexte) {
+    if (table == NULL) return;
+    table->rappel_purge = rappel;
+    table->contexte_purge = contexte;
 }
 
 void afficher_table_commutation(const table_commutation_t *table) {
@@ -80,11 +284,242 @@ void afficher_table_commutation(const table_commutation_t *table) {
     for (int i = 0; i < table->taille; i++) {
         printf("  - MAC: ");
         afficher_mac(table->entrees[i].mac);
+        if (table->entrees[i].fid != 0) printf(" (VLAN %d)", table->entrees[i].fid);
         printf(" -> Port: %d\n", table->entrees[i].port);
     }
 }
 
 
+void init_table_multicast(table_multicast_t *table, int nb_ports) {
+    if (table == NULL) return;
+    
+    table->actif = false;
+    table->groupes = NULL;
+    table->nb = 0;
+    table->capacite = 0;
+    table->mots_ports = (nb_ports + 63) / 64;
+}
+
+static void liberer_groupe(const table_multicast_t *table, groupe_multicast_t *g) {
+    liberer_memoire(MEMOIRE_TABLES, g->ports, (table->mots_ports + 1) * sizeof(uint64_t));
+    liberer_memoire(MEMOIRE_TABLES, g->membres, g->membres_capacite * sizeof(membre_groupe_t));
+    g->ports = NULL;
+    g->membres = NULL;
+}
+
+void deinit_table_multicast(table_multicast_t *table) {
+    if (table == NULL) return;
+    
+    for (int k = 0; k < table->nb; k++) liberer_groupe(table, &table->groupes[k]);
+    liberer_memoire(MEMOIRE_TABLES, table->groupes, table->capacite * sizeof(groupe_multicast_t));
+    table->groupes = NULL;
+    table->nb = 0;
+    table->capacite = 0;
+}
+
+// Recherche linéaire : quelques dizaines de groupes par switch au plus
+groupe_multicast_t *chercher_groupe_multicast(const table_multicast_t *table, mac_addr_t groupe) {
+    if (table == NULL) return NULL;
+    
+    for (int k = 0; k < table->nb; k++) {
+        if (mac_equals(table->groupes[k].groupe, groupe)) return &table->groupes[k];
+    }
+    return NULL;
+}
+
+static groupe_multicast_t *creer_groupe(table_multicast_t *table, mac_addr_t groupe) {
+    if (table->nb >= table->capacite) {
+        int nouvelle_capacite = (table->capacite == 0) ? 8 : table->capacite * 2;
+        groupe_multicast_t *nouveaux = reallouer_memoire(MEMOIRE_TABLES, table->groupes,
+                                                         table->capacite * sizeof(groupe_multicast_t),
+                                                         nouvelle_capacite * sizeof(groupe_multicast_t));
+        if (nouveaux == NULL) return NULL;
+        
+        table->groupes = nouveaux;
+        table->capacite = nouvelle_capacite;
+    }
+    
+    groupe_multicast_t *g = &table->groupes[table->nb];
+    g->ports = allouer_memoire_zero(MEMOIRE_TABLES, table->mots_ports + 1, sizeof(uint64_t));
+    if (g->ports == NULL) return NULL;
+    g->groupe = groupe;
+    g->membres = NULL;
+    g->nb_membres = 0;
+    g->membres_capacite = 0;
+    table->nb++;
+    return g;
+}
+
+static void retirer_groupe(table_multicast_t *table, groupe_multicast_t *g) {
+    liberer_groupe(table, g);
+    *g = table->groupes[--table->nb];
+}
+
+static bool port_membre(const groupe_multicast_t *g, int port) {
+    return (g->ports[port / 64] >> (port % 64)) & 1;
+}
+
+// Le port reste membre tant qu'une station du groupe s'y trouve
+static void recalculer_port(groupe_multicast_t *g, int port) {
+    g->ports[port / 64] &= ~(1ULL << (port % 64));
+    for (int k = 0; k < g->nb_membres; k++) {
+        if (g->membres[k].port == port) {
+            g->ports[port / 64] |= 1ULL << (port % 64);
+            return;
+        }
+    }
+}
+
+bool rejoindre_groupe(table_multicast_t *table, mac_addr_t groupe, mac_addr_t station, int port) {
+    if (table == NULL || port < 0 || port >= table->mots_ports * 64 || !mac_est_multicast(groupe)) return false;
+    
+    groupe_multicast_t *g = chercher_groupe_multicast(table, groupe);
+    if (g == NULL) g = creer_groupe(table, groupe);
+    if (g == NULL) return false;
+    
+    // une station déjà membre a pu changer de port
+    for (int k = 0; k < g->nb_membres; k++) {
+        if (mac_equals(g->membres[k].station, station)) {
+            int ancien = g->membres[k].port;
+            g->membres[k].port = port;
+            g->membres[k].renouvele = true;
+            recalculer_port(g, ancien);
+            g->ports[port / 64] |= 1ULL << (port % 64);
+            return true;
+        }
+    }
+    
+    if (g->nb_membres >= g->membres_capacite) {
+        int nouvelle_capacite = (g->membres_capacite == 0) ? 8 : g->membres_capacite * 2;
+        membre_groupe_t *nouveaux = reallouer_memoire(MEMOIRE_TABLES, g->membres,
+                                                      g->membres_capacite * sizeof(membre_groupe_t),
+                                                      nouvelle_capacite * sizeof(membre_groupe_t));
+        if (nouveaux == NULL) return false;
+        
+        g->membres = nouveaux;
+        g->membres_capacite = nouvelle_capacite;
+    }
+    g->membres[g->nb_membres].station = station;
+    g->membres[g->nb_membres].port = port;
+    g->membres[g->nb_membres].renouvele = true;
+    g->nb_membres++;
+    g->ports[port / 64] |= 1ULL << (port % 64);
+    return true;
+}
+
+bool quitter_groupe(table_multicast_t *table, mac_addr_t groupe, mac_addr_t station) {
+    groupe_multicast_t *g = chercher_groupe_multicast(table, groupe);
+    if (g == NULL) return false;
+    
+    for (int k = 0; k < g->nb_membres; k++) {
+        if (mac_equals(g->membres[k].station, station)) {
+            int port = g->membres[k].port;
+            g->membres[k] = g->membres[--g->nb_membres];
+            if (g->nb_membres == 0) {
+                retirer_groupe(table, g);
+            } else {
+                recalculer_port(g, port);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool port_membre_groupe(const table_multicast_t *table, mac_addr_t groupe, int port) {
+    const groupe_multicast_t *g = chercher_groupe_multicast(table, groupe);
+    return g != NULL && port >= 0 && port < table->mots_ports * 64 && port_membre(g, port);
+}
+
+// Parcours à rebours : retirer_groupe remplace le groupe par le dernier, déjà traité
+void quitter_port_groupes(table_multicast_t *table, int port) {
+    if (table == NULL || port < 0 || port >= table->mots_ports * 64) return;
+    
+    for (int k = table->nb - 1; k >= 0; k--) {
+        groupe_multicast_t *g = &table->groupes[k];
+        for (int m = g->nb_membres - 1; m >= 0; m--) {
+            if (g->membres[m].port == port) g->membres[m] = g->membres[--g->nb_membres];
+        }
+        g->ports[port / 64] &= ~(1ULL << (port % 64));
+        if (g->nb_membres == 0) retirer_groupe(table, g);
+    }
+}
+
+int vieillir_groupes(table_multicast_t *table) {
+    if (table == NULL) return 0;
+    
+    int nb_oublies = 0;
+    for (int k = table->nb - 1; k >= 0; k--) {
+        groupe_multicast_t *g = &table->groupes[k];
+        int nb_avant = g->nb_membres;
+        for (int m = g->nb_membres - 1; m >= 0; m--) {
+            if (g->membres[m].renouvele) {
+                g->membres[m].renouvele = false;
+            } else {
+                g->membres[m] = g->membres[--g->nb_membres];
+            }
+        }
+        if (g->nb_membres == nb_avant) continue;
+        
+        nb_oublies += nb_avant - g->nb_membres;
+        if (g->nb_membres == 0) {
+            retirer_groupe(table, g);
+            continue;
+        }
+        memset(g->ports, 0, table->mots_ports * sizeof(uint64_t));
+        for (int m = 0; m < g->nb_membres; m++) {
+            g->ports[g->membres[m].port / 64] |= 1ULL << (g->membres[m].port % 64);
+        }
+    }
+    return nb_oublies;
+}
+
+void afficher_table_multicast(const table_multicast_t *table) {
+    if (table == NULL) {
+        printf("Table multicast: NULL\n");
+        return;
+    }
+    
+    printf("Table multicast (%d groupe(s)%s):\n", table->nb, table->actif ? "" : ", surveillance inactive");
+    for (int k = 0; k < table->nb; k++) {
+        const groupe_multicast_t *g = &table->groupes[k];
+        printf("  - Groupe: ");
+        afficher_mac(g->groupe);
+        printf(" -> %d membre(s), ports:", g->nb_membres);
+        for (int p = 0; p < table->mots_ports * 64; p++) {
+            if (port_membre(g, p)) printf(" %d", p);
+        }
+        printf("\n");
+    }
+}
+
+// 01:00:5E:00:00:16, l'adresse des rapports IGMPv3 (224.0.0.22)
+mac_addr_t adresse_adhesions(void) {
+    return creer_mac(0x01, 0x00, 0x5E, 0x00, 0x00, 0x16);
+}
+
+bool init_trame_adhesion(trame *t, mac_addr_t station, mac_addr_t groupe, int operation) {
+    uint8_t donnees[TAILLE_ADHESION];
+    donnees[0] = (uint8_t)operation;
+    memcpy(donnees + 1, groupe.octet, 6);
+    return init_trame(t, station, adresse_adhesions(), TYPE_ADHESION, donnees, sizeof(donnees));
+}
+
+bool surveiller_adhesion(switch_t *sw, int port, const trame *t) {
+    if (sw == NULL || t == NULL || !sw->multicast.actif || t->type != TYPE_ADHESION) return false;
+    if (t->taille_donnees < TAILLE_ADHESION || !port_est_actif(sw, port)) return false;
+    if (sw->ports[port].statut == STATUT_REJET) return false;
+    
+    mac_addr_t groupe;
+    memcpy(groupe.octet, t->donnees + 1, 6);
+    switch (t->donnees[0]) {
+        case ADHESION_REJOINDRE: return rejoindre_groupe(&sw->multicast, groupe, t->source, port);
+        case ADHESION_QUITTER: return quitter_groupe(&sw->multicast, groupe, t->source);
+        default: return false;
+    }
+}
+
+
 void init_switch(switch_t *sw) {
     if (sw == NULL) return;
     
@@ -92,15 +527,21 @@ void init_switch(switch_t *sw) {
     sw->nb_ports = 0;
     sw->priorite = 0;
     init_table_commutation(&sw->table);
+    init_table_multicast(&sw->multicast, 0);
     sw->ports = NULL;
+    sw->vlans = NULL;
+    reinitialiser_compteurs(sw);
 }
 
 void deinit_switch(switch_t *sw) {
     if (sw == NULL) return;
     
     deinit_table_commutation(&sw->table);
-    free(sw->ports);
+    deinit_table_multicast(&sw->multicast);
+    liberer_memoire(MEMOIRE_PORTS, sw->ports, sw->nb_ports * sizeof(port_info_t));
+    liberer_memoire(MEMOIRE_PORTS, sw->vlans, (sw->vlans != NULL ? sw->nb_ports * MOTS_VLAN : 0) * sizeof(uint64_t));
     sw->ports = NULL;
+    sw->vlans = NULL;
     sw->nb_ports = 0;
 }
 
@@ -110,12 +551,20 @@ switch_t creer_switch(mac_addr_t mac, int nb_ports, int priorite) {
     sw.nb_ports = nb_ports;
     sw.priorite = priorite;
     init_table_commutation(&sw.table);
+    init_table_multicast(&sw.multicast, nb_ports);
+    reinitialiser_compteurs(&sw);
+    sw.vlans = NULL;
     
-    sw.ports = malloc(nb_ports * sizeof(port_info_t));
+    sw.ports = allouer_memoire(MEMOIRE_PORTS, nb_ports * sizeof(port_info_t));
     if (sw.ports != NULL) {
         for (int i = 0; i < nb_ports; i++) {
             sw.ports[i].etat = PORT_INCONNU;
+            sw.ports[i].statut = STATUT_ACHEMINEMENT;
             sw.ports[i].actif = false;
+            sw.ports[i].voisin = UNKNOWN_INDEX;
+            sw.ports[i].port_voisin = -1;
+            sw.ports[i].cout = 0;
+            sw.ports[i].vlan_natif = 0;
         }
     }
     
@@ -135,24 +584,31 @@ void afficher_switch(const switch_t *sw) {
     if (sw->ports != NULL) {
         printf("État des ports:\n");
         for (int i = 0; i < sw->nb_ports; i++) {
-            printf("  Port %d: %s (%s)\n", i, 
+            printf("  Port %d: %s, %s (%s)\n", i, 
                    etat_port_to_string(sw->ports[i].etat),
+                   statut_port_to_string(sw->ports[i].statut),
                    sw->ports[i].actif ? "actif" : "inactif");
         }
     }
     
     afficher_table_commutation(&sw->table);
+    if (sw->multicast.actif || sw->multicast.nb > 0) afficher_table_multicast(&sw->multicast);
 }
 
 
 void init_ports(switch_t *sw) {
     if (sw == NULL || sw->nb_ports <= 0) return;
     
-    sw->ports = malloc(sw->nb_ports * sizeof(port_info_t));
+    sw->ports = allouer_memoire(MEMOIRE_PORTS, sw->nb_ports * sizeof(port_info_t));
     if (sw->ports != NULL) {
         for (int i = 0; i < sw->nb_ports; i++) {
             sw->ports[i].etat = PORT_INCONNU;
+            sw->ports[i].statut = STATUT_ACHEMINEMENT;
             sw->ports[i].actif = false;
+            sw->ports[i].voisin = UNKNOWN_INDEX;
+            sw->ports[i].port_voisin = -1;
+            sw->ports[i].cout = 0;
+            sw->ports[i].vlan_natif = 0;
         }
     }
 }
@@ -162,7 +618,32 @@ void set_etat_port(switch_t *sw, int port, etat_port_t etat) {
         return;
     }
     
+    // un changement de rôle invalide les adresses et les adhésions apprises sur ce port
+    if (sw->ports[port].etat != etat) {
+        vider_port_table(&sw->table, port);
+        quitter_port_groupes(&sw->multicast, port);
+    }
     sw->ports[port].etat = etat;
+    // rôle issu d'un arbre convergé : seuls les rôles bloquants rejettent les trames
+    // (le moteur RSTP ajuste ensuite le statut avec set_statut_port)
+    sw->ports[port].statut = (etat == PORT_BLOQUE || etat == PORT_ALTERNATIF || etat == PORT_SECOURS)
+                             ? STATUT_REJET : STATUT_ACHEMINEMENT;
+}
+
+void set_statut_port(switch_t *sw, int port, statut_port_t statut) {
+    if (sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports) {
+        return;
+    }
+    
+    sw->ports[port].statut = statut;
+}
+
+statut_port_t get_statut_port(const switch_t *sw, int port) {
+    if (sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports) {
+        return STATUT_REJET;
+    }
+    
+    return sw->ports[port].statut;
 }
 
 etat_port_t get_etat_port(const switch_t *sw, int port) {
@@ -187,6 +668,8 @@ void desactiver_port(switch_t *sw, int port) {
     }
     
     sw->ports[port].actif = false;
+    vider_port_table(&sw->table, port);
+    quitter_port_groupes(&sw->multicast, port);
 }
 
 bool port_est_actif(const switch_t *sw, int port) {
@@ -197,6 +680,165 @@ bool port_est_actif(const switch_t *sw, int port) {
     return sw->ports[port].actif;
 }
 
+bool port_transmet(const switch_t *sw, int port) {
+    // un port relaie les trames s'il est actif et en acheminement
+    return port_est_actif(sw, port) && sw->ports[port].statut == STATUT_ACHEMINEMENT;
+}
+
+bool configurer_vlan_port(switch_t *sw, int port, uint16_t vlan, bool membre) {
+    if (sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports || vlan == 0 || vlan > VLAN_MAX) {
+        return false;
+    }
+    
+    if (sw->vlans == NULL) {
+        if (!membre) return true;
+        sw->vlans = allouer_memoire_zero(MEMOIRE_PORTS, (size_t)sw->nb_ports * MOTS_VLAN, sizeof(uint64_t));
+        if (sw->vlans == NULL) return false;
+    }
+    uint64_t *mot = &sw->vlans[(size_t)port * MOTS_VLAN + vlan / 64];
+    if (membre) {
+        *mot |= 1ULL << (vlan % 64);
+    } else {
+        *mot &= ~(1ULL << (vlan % 64));
+    }
+    return true;
+}
+
+bool port_membre_vlan(const switch_t *sw, int port, uint16_t vlan) {
+    if (sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports || vlan > VLAN_MAX) return false;
+    if (sw->vlans == NULL) return true;
+    if (vlan == 0) return sw->ports[port].vlan_natif == 0;
+    
+    return (sw->vlans[(size_t)port * MOTS_VLAN + vlan / 64] >> (vlan % 64)) & 1;
+}
+
+bool set_vlan_natif(switch_t *sw, int port, uint16_t vlan) {
+    if (sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports || vlan > VLAN_MAX) return false;
+    if (vlan != 0 && !configurer_vlan_port(sw, port, vlan, true)) return false;
+    
+    sw->ports[port].vlan_natif = vlan;
+    return true;
+}
+
+uint16_t vlan_entree(const switch_t *sw, int port, uint16_t vlan_trame) {
+    if (vlan_trame != 0 || sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports) return vlan_trame;
+    return sw->ports[port].vlan_natif;
+}
+
+uint16_t vlan_sortie(const switch_t *sw, int port, uint16_t vlan) {
+    if (sw == NULL || sw->ports == NULL || port < 0 || port >= sw->nb_ports) return vlan;
+    return (sw->ports[port].vlan_natif == vlan) ? 0 : vlan;
+}
+
+int premier_port_libre(const switch_t *sw) {
+    if (sw == NULL || sw->ports == NULL) return -1;
+    
+    for (int i = 0; i < sw->nb_ports; i++) {
+        if (sw->ports[i].voisin == UNKNOWN_INDEX) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+
+// Port de sortie possible pour une trame du VLAN : relais dans l'instance
+// (rôles fournis) ou selon le statut du port, puis appartenance au VLAN
+static bool port_relaie(const switch_t *sw, const etat_port_t *roles, uint16_t vlan, int p) {
+    if (roles != NULL) {
+        if (!port_est_actif(sw, p) || (roles[p] != PORT_RACINE && roles[p] != PORT_DESIGNE)) return false;
+    } else if (!port_transmet(sw, p)) {
+        return false;
+    }
+    return sw->vlans == NULL || port_membre_vlan(sw, p, vlan);
+}
+
+/**
+ * Commutation d'une trame reçue sur port_entree : apprentissage de la source,
+ * puis envoi vers le port associé à la destination, ou inondation
+ * @param ports_sortie Tableau d'au moins nb_ports cases, rempli avec les ports de sortie
+ * @return Le nombre de ports de sortie (0 si la trame est filtrée)
+ */
+int commuter_trame(switch_t *sw, int port_entree, mac_addr_t source, mac_addr_t destination, int ports_sortie[]) {
+    return commuter_trame_vlan(sw, port_entree, 0, NULL, source, destination, ports_sortie);
+}
+
+int commuter_trame_vlan(switch_t *sw, int port_entree, uint16_t vlan, const etat_port_t *roles, mac_addr_t source,
+                        mac_addr_t destination, int ports_sortie[]) {
+    if (sw == NULL || ports_sortie == NULL || !port_est_actif(sw, port_entree)) return 0;
+    
+    // en apprentissage, le port retient la source mais ne relaie pas ;
+    // un port qui ne relaie pas dans l'instance du VLAN n'apprend rien
+    statut_port_t statut = sw->ports[port_entree].statut;
+    if (roles != NULL) {
+        bool relaie = roles[port_entree] == PORT_RACINE || roles[port_entree] == PORT_DESIGNE;
+        statut = relaie ? STATUT_ACHEMINEMENT : STATUT_REJET;
+    }
+    if (statut == STATUT_REJET) return 0;
+    // filtrage en entrée : une trame d'un VLAN dont le port n'est pas membre est rejetée
+    if (sw->vlans != NULL && !port_membre_vlan(sw, port_entree, vlan)) return 0;
+    ajouter_entree_fid(&sw->table, vlan, source, port_entree);
+    if (statut == STATUT_APPRENTISSAGE) return 0;
+    
+    // groupe connu : seuls ses ports membres reçoivent la trame
+    if (sw->multicast.actif && mac_est_multicast(destination) && !mac_est_diffusion(destination)) {
+        const groupe_multicast_t *g = chercher_groupe_multicast(&sw->multicast, destination);
+        if (g != NULL) {
+            int nb = 0;
+            for (int m = 0; m < sw->multicast.mots_ports; m++) {
+                for (uint64_t bits = g->ports[m]; bits != 0; bits &= bits - 1) {
+                    int p = m * 64 + __builtin_ctzll(bits);
+                    if (p != port_entree && port_relaie(sw, roles, vlan, p)) ports_sortie[nb++] = p;
+                }
+            }
+            sw->compteurs.nb_multicast++;
+            sw->compteurs.nb_copies_multicast += nb;
+            return nb;
+        }
+    }
+    
+    int port = chercher_port_fid(&sw->table, vlan, destination);
+    if (port >= 0) {
+        if (port == port_entree || !port_relaie(sw, roles, vlan, port)) return 0;
+        ports_sortie[0] = port;
+        sw->compteurs.nb_commutees++;
+        return 1;
+    }
+    
+    int nb = 0;
+    for (int p = 0; p < sw->nb_ports; p++) {
+        if (p != port_entree && port_relaie(sw, roles, vlan, p)) {
+            ports_sortie[nb++] = p;
+        }
+    }
+    sw->compteurs.nb_inondees++;
+    sw->compteurs.nb_copies += nb;
+    return nb;
+}
+
+/**
+ * Remise d'une trame à un switch par la station reliée à son port 0
+ * @return Le nombre de ports sur lesquels la trame est réémise
+ */
+int envoyer_trame(const trame *t, switch_t *sw) {
+    if (t == NULL || sw == NULL || sw->nb_ports <= 0) return 0;
+    
+    int ports_sortie[sw->nb_ports];
+    surveiller_adhesion(sw, 0, t);
+    return commuter_trame(sw, 0, t->source, t->destination, ports_sortie);
+}
+
+void reinitialiser_compteurs(switch_t *sw) {
+    if (sw == NULL) return;
+    
+    sw->compteurs.nb_commutees = 0;
+    sw->compteurs.nb_inondees = 0;
+    sw->compteurs.nb_copies = 0;
+    sw->compteurs.nb_multicast = 0;
+    sw->compteurs.nb_copies_multicast = 0;
+    sw->table.nb_purgees = 0;
+}
 
 bool switch_equals(const switch_t *s1, const switch_t *s2) {
     if (s1 == NULL || s2 == NULL) return false;
@@ -212,6 +854,17 @@ const char* etat_port_to_string(etat_port_t etat) {
         case PORT_RACINE: return "RACINE";
         case PORT_DESIGNE: return "DESIGNE";
         case PORT_BLOQUE: return "BLOQUE";
+        case PORT_ALTERNATIF: return "ALTERNATIF";
+        case PORT_SECOURS: return "SECOURS";
+        default: return "INVALIDE";
+    }
+}
+
+const char* statut_port_to_string(statut_port_t statut) {
+    switch (statut) {
+        case STATUT_REJET: return "REJET";
+        case STATUT_APPRENTISSAGE: return "APPRENTISSAGE";
+        case STATUT_ACHEMINEMENT: return "ACHEMINEMENT";
         default: return "INVALIDE";
     }
-}
\ No newline at end of file
+}
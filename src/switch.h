@@ -1,49 +1,155 @@
 #pragma once
 
 #include "adresse.h"
+#include "graphe.h"
+#include "trame.h"
 #include <stdbool.h>
 
 // Structure pour une entrée de la table de commutation
 typedef struct {
     mac_addr_t mac;
+    uint16_t fid;      // base de filtrage : VLAN de l'apprentissage, 0 sans VLAN
     int port;
+    int precedent;     // entrée précédente apprise sur le même port (-1 si aucune)
+    int suivant;       // entrée suivante apprise sur le même port (-1 si aucune)
+    int vieillissement; // temporisation d'expiration dans la roue de la simulation (-1 si aucune)
 } table_entree_t;
 
+// Appelé pour chaque entrée retirée de la table qui portait une temporisation
+// d'expiration, afin que la roue qui l'a armée l'annule
+typedef void (*rappel_purge_t)(void *contexte, int vieillissement);
+
 // Structure pour la table de commutation
 typedef struct {
-    table_entree_t *entrees;
+    table_entree_t *entrees;   // entrées contiguës [0, taille)
     int taille;
     int capacite;
+    int *index;                // hachage (FID, MAC) -> indice d'entrée (adressage ouvert, -1 si libre)
+    int index_capacite;        // puissance de 2, au moins le double de capacite
+    int *tetes_ports;          // première entrée apprise sur chaque port (-1 si aucune)
+    int nb_ports_suivis;
+    uint64_t nb_purgees;       // entrées retirées par vider_port_table / retirer_entree_table
+    rappel_purge_t rappel_purge;   // NULL si aucune temporisation n'est suivie
+    void *contexte_purge;
 } table_commutation_t;
 
-// Énumération pour l'état des ports STP
+// Adhésions multicast simulées : trame TYPE_ADHESION envoyée à ADRESSE_ADHESIONS,
+// données = opération puis adresse du groupe
+#define ADHESION_REJOINDRE 1
+#define ADHESION_QUITTER 2
+#define TAILLE_ADHESION 7
+
+typedef struct {
+    mac_addr_t station;
+    int port;
+    bool renouvele;            // adhésion reçue depuis le dernier vieillir_groupes
+} membre_groupe_t;
+
+// Groupe multicast : ports membres en bitmap pour l'acheminement, et suivi explicite
+// des membres pour qu'un départ ne retire le port que s'il n'y reste personne
+typedef struct {
+    mac_addr_t groupe;
+    uint64_t *ports;               // mots_ports mots, bit p : port p membre
+    membre_groupe_t *membres;
+    int nb_membres;
+    int membres_capacite;
+} groupe_multicast_t;
+
+// Table des groupes d'un switch (surveillance des adhésions, comme l'IGMP snooping).
+// Sans surveillance, les trames multicast sont inondées comme une destination inconnue.
+typedef struct {
+    bool actif;
+    groupe_multicast_t *groupes;
+    int nb;
+    int capacite;
+    int mots_ports;
+} table_multicast_t;
+
+// Énumération pour l'état des ports STP (rôle du port dans l'arbre couvrant)
 typedef enum {
     PORT_INCONNU = 0,
     PORT_RACINE,
     PORT_DESIGNE,
-    PORT_BLOQUE
+    PORT_BLOQUE,
+    PORT_ALTERNATIF,   // RSTP : chemin de secours vers la racine
+    PORT_SECOURS       // RSTP : doublon d'un port désigné du même switch
 } etat_port_t;
 
+// Statut de transmission du port (802.1w), indépendant du rôle
+typedef enum {
+    STATUT_REJET = 0,        // ni apprentissage ni relais
+    STATUT_APPRENTISSAGE,    // apprend les adresses sources sans relayer
+    STATUT_ACHEMINEMENT      // apprend et relaie
+} statut_port_t;
+
 typedef struct {
     etat_port_t etat;
+    statut_port_t statut;
     bool actif;
+    sommet voisin;     // équipement relié à ce port (UNKNOWN_INDEX si libre)
+    int port_voisin;   // port de l'équipement voisin (-1 pour une station)
+    int cout;          // coût STP du port, repris du poids du lien
+    uint16_t vlan_natif; // VLAN des trames reçues sans étiquette, émises sans étiquette (0 : aucun)
 } port_info_t;
 
+// Compteurs de commutation, remis à zéro par reinitialiser_compteurs
+typedef struct {
+    uint64_t nb_commutees;     // trames envoyées sur un seul port grâce à la table
+    uint64_t nb_inondees;      // trames à destination inconnue ou de diffusion
+    uint64_t nb_copies;        // copies émises lors des inondations
+    uint64_t nb_multicast;     // trames multicast limitées aux ports membres de leur groupe
+    uint64_t nb_copies_multicast;
+} compteurs_switch_t;
+
 typedef struct {
     mac_addr_t mac;
     int nb_ports;
     int priorite;
     table_commutation_t table;
+    table_multicast_t multicast;
     port_info_t *ports;
+    uint64_t *vlans;   // appartenance : MOTS_VLAN mots par port, NULL tant qu'aucun VLAN n'est configuré
+    compteurs_switch_t compteurs;
 } switch_t;
 
+// Bitmap d'appartenance d'un port : bit v pour le VLAN v
+#define MOTS_VLAN ((VLAN_MAX + 64) / 64)
+
 void init_table_commutation(table_commutation_t *table);
 void deinit_table_commutation(table_commutation_t *table);
 bool ajouter_entree_table(table_commutation_t *table, mac_addr_t mac, int port);
 int chercher_port_mac(const table_commutation_t *table, mac_addr_t mac);
+table_entree_t *chercher_entree_table(table_commutation_t *table, mac_addr_t mac);
+bool retirer_entree_table(table_commutation_t *table, mac_addr_t mac);
+// Apprentissage indépendant par VLAN (802.1Q IVL) : les fonctions sans FID
+// ci-dessus travaillent dans la base 0, celle des trames sans VLAN
+bool ajouter_entree_fid(table_commutation_t *table, uint16_t fid, mac_addr_t mac, int port);
+int chercher_port_fid(const table_commutation_t *table, uint16_t fid, mac_addr_t mac);
+table_entree_t *chercher_entree_fid(table_commutation_t *table, uint16_t fid, mac_addr_t mac);
+bool retirer_entree_fid(table_commutation_t *table, uint16_t fid, mac_addr_t mac);
+int vider_port_table(table_commutation_t *table, int port);
 void vider_table_commutation(table_commutation_t *table);
+void surveiller_purges(table_commutation_t *table, rappel_purge_t rappel, void *contexte);
 void afficher_table_commutation(const table_commutation_t *table);
 
+void init_table_multicast(table_multicast_t *table, int nb_ports);
+void deinit_table_multicast(table_multicast_t *table);
+groupe_multicast_t *chercher_groupe_multicast(const table_multicast_t *table, mac_addr_t groupe);
+bool rejoindre_groupe(table_multicast_t *table, mac_addr_t groupe, mac_addr_t station, int port);
+bool quitter_groupe(table_multicast_t *table, mac_addr_t groupe, mac_addr_t station);
+bool port_membre_groupe(const table_multicast_t *table, mac_addr_t groupe, int port);
+// Oublie les membres appris sur le port (changement de rôle, port coupé)
+void quitter_port_groupes(table_multicast_t *table, int port);
+// Oublie les membres sans adhésion reçue depuis l'appel précédent ; renvoie leur nombre
+int vieillir_groupes(table_multicast_t *table);
+void afficher_table_multicast(const table_multicast_t *table);
+
+mac_addr_t adresse_adhesions(void);
+bool init_trame_adhesion(trame *t, mac_addr_t station, mac_addr_t groupe, int operation);
+// Applique l'adhésion portée par t, reçue sur port, si la surveillance est active.
+// La trame elle-même est ensuite commutée normalement (inondée).
+bool surveiller_adhesion(switch_t *sw, int port, const trame *t);
+
 void init_switch(switch_t *sw);
 void deinit_switch(switch_t *sw);
 switch_t creer_switch(mac_addr_t mac, int nb_ports, int priorite);
@@ -52,9 +158,36 @@ void afficher_switch(const switch_t *sw);
 void init_ports(switch_t *sw);
 void set_etat_port(switch_t *sw, int port, etat_port_t etat);
 etat_port_t get_etat_port(const switch_t *sw, int port);
+void set_statut_port(switch_t *sw, int port, statut_port_t statut);
+statut_port_t get_statut_port(const switch_t *sw, int port);
 void activer_port(switch_t *sw, int port);
 void desactiver_port(switch_t *sw, int port);
 bool port_est_actif(const switch_t *sw, int port);
+int premier_port_libre(const switch_t *sw);
+bool port_transmet(const switch_t *sw, int port);
+
+// VLAN 802.1Q. Tant qu'aucun VLAN n'est configuré, le switch ne filtre rien.
+// Ensuite, un port ne reçoit et n'émet que les VLAN dont il est membre ; les
+// trames sans VLAN (0) ne passent que par les ports sans VLAN natif.
+bool configurer_vlan_port(switch_t *sw, int port, uint16_t vlan, bool membre);
+bool port_membre_vlan(const switch_t *sw, int port, uint16_t vlan);
+// Le port devient membre de son VLAN natif (0 : retour aux trames sans VLAN)
+bool set_vlan_natif(switch_t *sw, int port, uint16_t vlan);
+// VLAN d'une trame reçue sur le port : son étiquette, ou le VLAN natif du port
+uint16_t vlan_entree(const switch_t *sw, int port, uint16_t vlan_trame);
+// Étiquette à l'émission : aucune sur le VLAN natif du port
+uint16_t vlan_sortie(const switch_t *sw, int port, uint16_t vlan);
+
+int commuter_trame(switch_t *sw, int port_entree, mac_addr_t source, mac_addr_t destination, int ports_sortie[]);
+// Commutation dans un VLAN : apprentissage et recherche dans sa base de
+// filtrage, ports de sortie limités à ses membres. roles donne l'état de
+// chaque port dans l'instance d'arbre couvrant du VLAN (MSTP) ; NULL : les
+// statuts des ports, c'est-à-dire l'arbre commun.
+int commuter_trame_vlan(switch_t *sw, int port_entree, uint16_t vlan, const etat_port_t *roles, mac_addr_t source,
+                        mac_addr_t destination, int ports_sortie[]);
+void reinitialiser_compteurs(switch_t *sw);
+int envoyer_trame(const trame *t, switch_t *sw);
 
 bool switch_equals(const switch_t *s1, const switch_t *s2);
-const char* etat_port_to_string(etat_port_t etat);
\ No newline at end of file
+const char* etat_port_to_string(etat_port_t etat);
+const char* statut_port_to_string(statut_port_t statut);
\ No newline at end of file
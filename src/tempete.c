@@ -0,0 +1,332 @@
+#include "tempete.h"
+#include <stdio.h>
+#include <string.h>
+
+void config_tempete_defaut(config_tempete_t *c) {
+    if (c == NULL) return;
+
+    c->taille_trame = 64;
+    c->nb_sauts_max = 256;
+    c->copies_max = 1000000000ULL;
+    c->nb_pas_max = 100000;
+    c->respecter_stp = false;
+}
+
+// Durée d'émission d'une trame de la taille configurée, intervalle inter-trames compris
+static temps_sim_t duree_emission(size_t taille, int poids) {
+    uint64_t bits = (taille + INTERVALLE_INTER_TRAMES) * 8ULL;
+    return (bits * 1000000000ULL) / debit_lien(poids);
+}
+
+static int poids_lien(const reseau_t *r, sommet a, sommet b) {
+    arete e = {a, b, 0, false};
+    size_t i = index_arete(&r->g, e);
+    return (i == UNKNOWN_INDEX) ? 4 : r->g.aretes[i].poids;
+}
+
+bool init_tempete(tempete_t *t, const reseau_t *r, const config_tempete_t *c) {
+    if (t == NULL || r == NULL) return false;
+
+    memset(t, 0, sizeof(*t));
+    t->reseau = r;
+    if (c != NULL) {
+        t->config = *c;
+    } else {
+        config_tempete_defaut(&t->config);
+    }
+    if (t->config.nb_sauts_max == 0) t->config.nb_sauts_max = 1;
+    t->pas_saturation = SIZE_MAX;
+
+    size_t n = ordre(&r->g);
+    t->premiere = malloc((n + 1) * sizeof(size_t));
+    if (t->premiere == NULL) return false;
+    t->premiere[0] = 0;
+    for (sommet s = 0; s < n; s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        size_t nb = (sw != NULL) ? (size_t)sw->nb_ports : (reseau_station(r, s) != NULL) ? 1 : 0;
+        t->premiere[s + 1] = t->premiere[s] + nb;
+    }
+    t->nb_sens = t->premiere[n];
+    t->sens = malloc((t->nb_sens + 1) * sizeof(sens_lien_t));
+    t->demande = malloc((t->nb_sens + 1) * sizeof(uint64_t));
+    t->charge_sens = calloc(t->nb_sens + 1, sizeof(uint64_t));
+    if (t->sens == NULL || t->demande == NULL || t->charge_sens == NULL) {
+        deinit_tempete(t);
+        return false;
+    }
+
+    // extrémités de chaque sens, puis pas calé sur le lien relayant le plus lent
+    temps_sim_t plus_lent = 0;
+    for (sommet s = 0; s < n; s++) {
+        const switch_t *sw = reseau_switch(r, s);
+        for (size_t a = t->premiere[s]; a < t->premiere[s + 1]; a++) {
+            sens_lien_t *e = &t->sens[a];
+            sommet voisin;
+            int port_voisin;
+            if (sw != NULL) {
+                int p = (int)(a - t->premiere[s]);
+                voisin = sw->ports[p].voisin;
+                port_voisin = sw->ports[p].port_voisin;
+                e->relaie = t->config.respecter_stp ? port_transmet(sw, p) : port_est_actif(sw, p);
+            } else {
+                const raccordement_t *rc = &r->raccordements[r->equipements[s].index];
+                voisin = rc->voisin;
+                port_voisin = rc->port_voisin;
+                e->relaie = true;
+            }
+            e->destination = voisin;
+            e->inverse = UNKNOWN_INDEX;
+            e->capacite = 0;
+            if (voisin == UNKNOWN_INDEX || t->premiere[voisin] == t->premiere[voisin + 1]) {
+                e->destination = UNKNOWN_INDEX;
+                e->relaie = false;
+                continue;
+            }
+            e->inverse = t->premiere[voisin] + (reseau_switch(r, voisin) != NULL ? (size_t)port_voisin : 0);
+            // durée d'émission, convertie en capacité une fois le pas connu
+            e->capacite = duree_emission(t->config.taille_trame, poids_lien(r, s, voisin));
+            if (e->relaie && e->capacite > plus_lent) plus_lent = e->capacite;
+        }
+    }
+    t->duree_pas = (plus_lent > 0) ? plus_lent : duree_emission(t->config.taille_trame, 4);
+    for (size_t a = 0; a < t->nb_sens; a++) {
+        uint64_t d = t->sens[a].capacite;
+        t->sens[a].capacite = (d > 0 && t->duree_pas / d > 1) ? t->duree_pas / d : 1;
+    }
+    return true;
+}
+
+void deinit_tempete(tempete_t *t) {
+    if (t == NULL) return;
+
+    free(t->premiere);
+    free(t->sens);
+    free(t->injections);
+    free(t->demande);
+    free(t->charge_sens);
+    free(t->courbe);
+    memset(t, 0, sizeof(*t));
+    t->pas_saturation = SIZE_MAX;
+}
+
+bool injecter_diffusion(tempete_t *t, sommet station, size_t pas) {
+    if (t == NULL || t->reseau == NULL) return false;
+
+    const reseau_t *r = t->reseau;
+    if (reseau_station(r, station) == NULL || t->sens[t->premiere[station]].destination == UNKNOWN_INDEX) return false;
+
+    if (t->nb_injections == t->injections_capacite) {
+        size_t capacite = (t->injections_capacite == 0) ? 8 : 2 * t->injections_capacite;
+        injection_t *nouveau = realloc(t->injections, capacite * sizeof(injection_t));
+        if (nouveau == NULL) return false;
+        t->injections = nouveau;
+        t->injections_capacite = capacite;
+    }
+
+    // une inondation sans boucle atteint une fois chaque autre station de la composante
+    size_t visees = 0;
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        if (s != station && reseau_station(r, s) != NULL && meme_composante(&r->g, s, station)) visees++;
+    }
+    injection_t *inj = &t->injections[t->nb_injections++];
+    inj->station = station;
+    inj->pas = pas;
+    inj->nb_stations_visees = visees;
+    return true;
+}
+
+static bool ajouter_point(tempete_t *t, const pas_tempete_t *point) {
+    if (t->nb_pas == t->courbe_capacite) {
+        size_t capacite = (t->courbe_capacite == 0) ? 8 : 2 * t->courbe_capacite;
+        pas_tempete_t *nouveau = realloc(t->courbe, capacite * sizeof(pas_tempete_t));
+        if (nouveau == NULL) return false;
+        t->courbe = nouveau;
+        t->courbe_capacite = capacite;
+    }
+    t->courbe[t->nb_pas++] = *point;
+    return true;
+}
+
+// Copies de la trame reçues par chaque switch, puis renvoyées sur chaque port
+// relayant sauf vers le sens d'où elles viennent
+static void propager(const tempete_t *t, const uint64_t *copies, uint64_t *suivantes) {
+    const reseau_t *r = t->reseau;
+    for (sommet s = 0; s < ordre(&r->g); s++) {
+        size_t debut = t->premiere[s], fin = t->premiere[s + 1];
+        if (reseau_switch(r, s) == NULL) {
+            for (size_t a = debut; a < fin; a++) suivantes[a] = 0;
+            continue;
+        }
+
+        uint64_t recues = 0;
+        for (size_t a = debut; a < fin; a++) {
+            if (t->sens[a].relaie) recues += copies[t->sens[a].inverse];
+        }
+        for (size_t a = debut; a < fin; a++) {
+            suivantes[a] = t->sens[a].relaie ? recues - copies[t->sens[a].inverse] : 0;
+        }
+    }
+}
+
+size_t executer_tempete(tempete_t *t) {
+    if (t == NULL || t->reseau == NULL || t->nb_injections == 0) return 0;
+
+    const reseau_t *r = t->reseau;
+    size_t nb_sens = t->nb_sens, nb_trames = t->nb_injections;
+    uint64_t *copies = calloc(nb_trames * nb_sens + 1, sizeof(uint64_t));
+    uint64_t *suivantes = malloc((nb_sens + 1) * sizeof(uint64_t));
+    bool *vivante = calloc(nb_trames, sizeof(bool));  // trame injectée dont des copies sont en vol
+    if (copies == NULL || suivantes == NULL || vivante == NULL) {
+        free(copies);
+        free(suivantes);
+        free(vivante);
+        return 0;
+    }
+
+    size_t derniere_injection = 0;
+    for (size_t f = 0; f < nb_trames; f++) {
+        if (t->injections[f].pas > derniere_injection) derniere_injection = t->injections[f].pas;
+    }
+
+    size_t pas = 0;
+    uint64_t en_vol = 0;
+    while (pas < t->config.nb_pas_max && t->nb_copies < t->config.copies_max) {
+        if (pas > derniere_injection && en_vol == 0) break;
+
+        for (size_t f = 0; f < nb_trames; f++) {
+            const injection_t *inj = &t->injections[f];
+            if (inj->pas != pas) continue;
+            copies[f * nb_sens + t->premiere[inj->station]]++;
+            vivante[f] = true;
+        }
+
+        // demande de chaque sens, toutes trames confondues, écrêtée à son débit
+        pas_tempete_t point = {0, 0, 0, 0.0};
+        memset(t->demande, 0, nb_sens * sizeof(uint64_t));
+        for (size_t f = 0; f < nb_trames; f++) {
+            const uint64_t *c = &copies[f * nb_sens];
+            if (!vivante[f]) continue;
+            for (size_t a = 0; a < nb_sens; a++) t->demande[a] += c[a];
+        }
+        for (size_t a = 0; a < nb_sens; a++) {
+            uint64_t demande = t->demande[a], capacite = t->sens[a].capacite;
+            if (demande == 0) continue;
+
+            double charge = (double)demande / capacite;
+            if (charge > point.charge_max) point.charge_max = charge;
+            if (demande <= capacite) continue;
+
+            // part de chaque trame arrondie sur les cumuls : le sens écoule exactement sa capacité
+            point.liens_satures++;
+            uint64_t cumul = 0, ecoulees = 0;
+            for (size_t f = 0; f < nb_trames; f++) {
+                uint64_t *c = &copies[f * nb_sens + a];
+                cumul += *c;
+                uint64_t jusque_la = cumul * capacite / demande;
+                *c = jusque_la - ecoulees;
+                ecoulees = jusque_la;
+            }
+            point.rejetees += demande - capacite;
+            t->demande[a] = capacite;
+        }
+        if (point.liens_satures > 0 && t->pas_saturation == SIZE_MAX) t->pas_saturation = pas;
+
+        // émission : charge des sens et livraison aux stations
+        for (size_t a = 0; a < nb_sens; a++) {
+            uint64_t emises = t->demande[a];
+            if (emises == 0) continue;
+
+            point.copies += emises;
+            t->charge_sens[a] += emises;
+            if (reseau_station(r, t->sens[a].destination) != NULL) t->nb_livrees += emises;
+        }
+        t->nb_copies += point.copies;
+        t->nb_rejetees += point.rejetees;
+        ajouter_point(t, &point);
+
+        // réception et renvoi ; les copies qui dépasseraient nb_sauts_max sont abandonnées
+        en_vol = 0;
+        for (size_t f = 0; f < nb_trames; f++) {
+            const injection_t *inj = &t->injections[f];
+            uint64_t *c = &copies[f * nb_sens];
+            if (!vivante[f]) continue;
+
+            propager(t, c, suivantes);
+            uint64_t total = 0;
+            for (size_t a = 0; a < nb_sens; a++) total += suivantes[a];
+            if (pas + 1 - inj->pas >= t->config.nb_sauts_max) {
+                t->nb_abandonnees += total;
+                memset(c, 0, nb_sens * sizeof(uint64_t));
+                vivante[f] = false;
+            } else {
+                vivante[f] = total > 0;
+                memcpy(c, suivantes, nb_sens * sizeof(uint64_t));
+                en_vol += total;
+            }
+        }
+        pas++;
+    }
+    t->nb_abandonnees += en_vol;
+
+    free(copies);
+    free(suivantes);
+    free(vivante);
+    return pas;
+}
+
+double facteur_amplification(const tempete_t *t) {
+    if (t == NULL) return 0.0;
+
+    uint64_t attendues = 0;
+    for (size_t f = 0; f < t->nb_injections; f++) attendues += t->injections[f].nb_stations_visees;
+    return (attendues == 0) ? 0.0 : (double)t->nb_livrees / attendues;
+}
+
+temps_sim_t temps_saturation(const tempete_t *t) {
+    if (t == NULL || t->pas_saturation == SIZE_MAX) return 0;
+    return (temps_sim_t)(t->pas_saturation + 1) * t->duree_pas;
+}
+
+void afficher_bilan_tempete(const tempete_t *t, size_t nb_liens) {
+    if (t == NULL || t->reseau == NULL) return;
+
+    const reseau_t *r = t->reseau;
+    printf("Tempête : %zu trame(s) injectée(s), %zu pas de %llu ns, %s\n", t->nb_injections, t->nb_pas,
+           (unsigned long long)t->duree_pas, t->config.respecter_stp ? "ports bloqués respectés" : "sans STP");
+    printf("  copies émises %llu, livrées aux stations %llu, rejetées %llu, abandonnées %llu\n",
+           (unsigned long long)t->nb_copies, (unsigned long long)t->nb_livrees, (unsigned long long)t->nb_rejetees,
+           (unsigned long long)t->nb_abandonnees);
+    printf("  facteur d'amplification %.2f", facteur_amplification(t));
+    if (t->pas_saturation != SIZE_MAX) {
+        printf(", saturation au pas %zu (%.3f ms)\n", t->pas_saturation, temps_saturation(t) / 1e6);
+    } else {
+        printf(", aucun lien saturé\n");
+    }
+
+    printf("  %10s %14s %14s %10s %10s\n", "pas", "copies", "rejetées", "saturés", "charge max");
+    for (size_t p = 0; p < t->nb_pas; p = (p == 0) ? 1 : 2 * p) {
+        const pas_tempete_t *pt = &t->courbe[p];
+        printf("  %10zu %14llu %14llu %10zu %10.2f\n", p, (unsigned long long)pt->copies,
+               (unsigned long long)pt->rejetees, pt->liens_satures, pt->charge_max);
+    }
+
+    // sélection des sens les plus chargés, nb_liens passages sur les sens
+    uint64_t precedente = UINT64_MAX;
+    size_t dernier = UNKNOWN_INDEX;
+    for (size_t k = 0; k < nb_liens; k++) {
+        size_t meilleur = UNKNOWN_INDEX;
+        for (size_t a = 0; a < t->nb_sens; a++) {
+            uint64_t charge = t->charge_sens[a];
+            if (charge == 0 || charge > precedente || (charge == precedente && a <= dernier)) continue;
+            if (meilleur == UNKNOWN_INDEX || charge > t->charge_sens[meilleur]) meilleur = a;
+        }
+        if (meilleur == UNKNOWN_INDEX) break;
+
+        sommet s = 0;
+        while (t->premiere[s + 1] <= meilleur) s++;
+        printf("  lien %zu -> %zu : %llu copies\n", sommet_origine(r, s),
+               sommet_origine(r, t->sens[meilleur].destination), (unsigned long long)t->charge_sens[meilleur]);
+        precedente = t->charge_sens[meilleur];
+        dernier = meilleur;
+    }
+}
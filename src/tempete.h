@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "reseau.h"
+#include "simulation.h"
+
+// Tempête de diffusion : des trames de diffusion sont injectées et inondées
+// par pas synchrones, sans que le STP ne coupe forcément les boucles. Une
+// boucle multiplie les copies à chaque tour, jusqu'à des centaines de millions :
+// au lieu de matérialiser chaque copie, on tient pour chaque trame injectée le
+// nombre de ses copies sur chaque sens de lien. Un switch qui reçoit k copies
+// d'une trame par ses ports en renvoie, sur chaque port relayant, toutes celles
+// qui ne sont pas arrivées par ce port.
+//
+// Un pas dure le temps d'émettre une trame sur le lien le plus lent ; chaque
+// sens de lien écoule au plus les copies que son débit permet pendant un pas,
+// l'excédent est rejeté au prorata des trames. Les copies d'une trame sont
+// abandonnées au-delà de nb_sauts_max sauts et la tempête s'arrête au plus
+// tard une fois copies_max copies émises ou nb_pas_max pas joués.
+typedef struct {
+    size_t taille_trame;     // octets sur le support, en-tête compris
+    size_t nb_sauts_max;
+    uint64_t copies_max;
+    size_t nb_pas_max;
+    bool respecter_stp;      // false : tous les ports actifs relaient
+} config_tempete_t;
+
+// Un point de la courbe de charge
+typedef struct {
+    uint64_t copies;         // copies émises pendant le pas
+    uint64_t rejetees;       // copies au-delà du débit des liens
+    size_t liens_satures;    // sens de lien dont la demande a dépassé le débit
+    double charge_max;       // demande du sens le plus chargé, rapportée à son débit
+} pas_tempete_t;
+
+// Sens de lien : case premiere[s] + port pour un switch, premiere[s] pour une station
+typedef struct {
+    sommet destination;      // UNKNOWN_INDEX si le port n'est relié à rien
+    size_t inverse;          // sens opposé
+    bool relaie;             // l'extrémité source émet et accepte les diffusions par ce port
+    uint64_t capacite;       // copies par pas
+} sens_lien_t;
+
+typedef struct {
+    sommet station;
+    size_t pas;              // pas d'émission
+    size_t nb_stations_visees; // autres stations de la même composante
+} injection_t;
+
+typedef struct {
+    const reseau_t *reseau;
+    config_tempete_t config;
+    temps_sim_t duree_pas;
+    size_t *premiere;
+    sens_lien_t *sens;
+    size_t nb_sens;
+    injection_t *injections;
+    size_t nb_injections;
+    size_t injections_capacite;
+    uint64_t *demande;       // par sens, toutes trames confondues
+    uint64_t *charge_sens;   // copies émises sur chaque sens depuis le début
+    pas_tempete_t *courbe;
+    size_t nb_pas;
+    size_t courbe_capacite;
+    // bilan
+    uint64_t nb_copies;
+    uint64_t nb_rejetees;
+    uint64_t nb_livrees;     // copies reçues par les stations
+    uint64_t nb_abandonnees; // copies en vol au-delà de nb_sauts_max ou à l'arrêt
+    size_t pas_saturation;   // premier pas dont un lien a saturé, SIZE_MAX sinon
+} tempete_t;
+
+void config_tempete_defaut(config_tempete_t *c);
+
+bool init_tempete(tempete_t *t, const reseau_t *r, const config_tempete_t *c);
+void deinit_tempete(tempete_t *t);
+
+// La station émet une trame de diffusion au début du pas donné
+bool injecter_diffusion(tempete_t *t, sommet station, size_t pas);
+
+// Joue les pas jusqu'à extinction des trames ou atteinte d'un plafond ;
+// renvoie le nombre de pas joués. À n'appeler qu'une fois par tempête.
+size_t executer_tempete(tempete_t *t);
+
+// Copies reçues par station, rapportées à une inondation sans boucle (1 par
+// station de la composante) ; 0 sans injection
+double facteur_amplification(const tempete_t *t);
+// Date de fin du premier pas saturé, 0 si aucun lien n'a saturé
+temps_sim_t temps_saturation(const tempete_t *t);
+
+// Bilan, courbe de charge sur une échelle logarithmique des pas et liens les plus chargés
+void afficher_bilan_tempete(const tempete_t *t, size_t nb_liens);
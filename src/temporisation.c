@@ -0,0 +1,187 @@
+#include "temporisation.h"
+#include "memoire.h"
+#include <stdlib.h>
+
+bool init_roue(roue_temporisations_t *roue, uint64_t resolution) {
+    if (roue == NULL || resolution == 0) return false;
+
+    roue->temporisations = NULL;
+    roue->capacite = 0;
+    roue->libre = -1;
+    roue->nb_armees = 0;
+    for (int n = 0; n < ROUE_NIVEAUX; n++) {
+        roue->nb_par_niveau[n] = 0;
+        for (int c = 0; c < ROUE_CASES; c++) {
+            roue->cases[n][c] = -1;
+        }
+    }
+    roue->resolution = resolution;
+    roue->tic = 0;
+    roue->nb_expirees = 0;
+    return true;
+}
+
+void deinit_roue(roue_temporisations_t *roue) {
+    if (roue == NULL) return;
+
+    liberer_memoire(MEMOIRE_EVENEMENTS, roue->temporisations, roue->capacite * sizeof(temporisation_t));
+    roue->temporisations = NULL;
+    roue->capacite = 0;
+    roue->libre = -1;
+    roue->nb_armees = 0;
+}
+
+// Tic d'une date, arrondi au tic supérieur : une temporisation n'expire jamais en avance
+static uint64_t tic_date(const roue_temporisations_t *roue, uint64_t date) {
+    return date / roue->resolution + (date % roue->resolution != 0);
+}
+
+static void inserer(roue_temporisations_t *roue, int id) {
+    temporisation_t *t = &roue->temporisations[id];
+    uint64_t echeance = (t->echeance < roue->tic) ? roue->tic : t->echeance;
+    uint64_t ecart = echeance - roue->tic;
+
+    int niveau = 0;
+    while (niveau < ROUE_NIVEAUX - 1 && ecart >= (1ULL << (ROUE_BITS * (niveau + 1)))) {
+        niveau++;
+    }
+    // au-delà de l'horizon : rangée au plus loin, replacée lors de la descente
+    uint64_t horizon = (1ULL << (ROUE_BITS * ROUE_NIVEAUX)) - 1;
+    if (ecart > horizon) echeance = roue->tic + horizon;
+
+    int c = (int)((echeance >> (ROUE_BITS * niveau)) & (ROUE_CASES - 1));
+    t->case_roue = niveau * ROUE_CASES + c;
+    t->precedent = -1;
+    t->suivant = roue->cases[niveau][c];
+    if (t->suivant != -1) roue->temporisations[t->suivant].precedent = id;
+    roue->cases[niveau][c] = id;
+    roue->nb_par_niveau[niveau]++;
+}
+
+static void extraire(roue_temporisations_t *roue, int id) {
+    temporisation_t *t = &roue->temporisations[id];
+    if (t->precedent != -1) {
+        roue->temporisations[t->precedent].suivant = t->suivant;
+    } else {
+        roue->cases[t->case_roue / ROUE_CASES][t->case_roue % ROUE_CASES] = t->suivant;
+    }
+    if (t->suivant != -1) roue->temporisations[t->suivant].precedent = t->precedent;
+    roue->nb_par_niveau[t->case_roue / ROUE_CASES]--;
+}
+
+static void liberer(roue_temporisations_t *roue, int id) {
+    roue->temporisations[id].case_roue = -1;
+    roue->temporisations[id].suivant = roue->libre;
+    roue->libre = id;
+    roue->nb_armees--;
+}
+
+int armer_temporisation(roue_temporisations_t *roue, uint64_t date, int type, size_t objet, uint64_t argument) {
+    if (roue == NULL) return TEMPORISATION_AUCUNE;
+
+    if (roue->libre == -1) {
+        int nouvelle_capacite = (roue->capacite == 0) ? 8 : roue->capacite * 2;
+        temporisation_t *nouvelles = reallouer_memoire(MEMOIRE_EVENEMENTS, roue->temporisations,
+                                                       roue->capacite * sizeof(temporisation_t),
+                                                       nouvelle_capacite * sizeof(temporisation_t));
+        if (nouvelles == NULL) return TEMPORISATION_AUCUNE;
+
+        // les nouveaux emplacements sont chaînés par indice croissant
+        for (int i = nouvelle_capacite - 1; i >= roue->capacite; i--) {
+            nouvelles[i].case_roue = -1;
+            nouvelles[i].suivant = roue->libre;
+            roue->libre = i;
+        }
+        roue->temporisations = nouvelles;
+        roue->capacite = nouvelle_capacite;
+    }
+
+    int id = roue->libre;
+    temporisation_t *t = &roue->temporisations[id];
+    roue->libre = t->suivant;
+    t->echeance = tic_date(roue, date);
+    t->type = type;
+    t->objet = objet;
+    t->argument = argument;
+    roue->nb_armees++;
+    inserer(roue, id);
+    return id;
+}
+
+bool temporisation_armee(const roue_temporisations_t *roue, int id) {
+    return roue != NULL && id >= 0 && id < roue->capacite && roue->temporisations[id].case_roue != -1;
+}
+
+bool rearmer_temporisation(roue_temporisations_t *roue, int id, uint64_t date) {
+    if (!temporisation_armee(roue, id)) return false;
+
+    extraire(roue, id);
+    roue->temporisations[id].echeance = tic_date(roue, date);
+    inserer(roue, id);
+    return true;
+}
+
+bool annuler_temporisation(roue_temporisations_t *roue, int id) {
+    if (!temporisation_armee(roue, id)) return false;
+
+    extraire(roue, id);
+    liberer(roue, id);
+    return true;
+}
+
+// Redescend le contenu d'une case de niveau supérieur vers les niveaux inférieurs
+static void cascader(roue_temporisations_t *roue, int niveau, int c) {
+    int id = roue->cases[niveau][c];
+    roue->cases[niveau][c] = -1;
+    while (id != -1) {
+        roue->nb_par_niveau[niveau]--;
+        int suivant = roue->temporisations[id].suivant;
+        inserer(roue, id);
+        id = suivant;
+    }
+}
+
+void avancer_roue(roue_temporisations_t *roue, uint64_t date, rappel_temporisation_t rappel, void *contexte) {
+    if (roue == NULL) return;
+
+    uint64_t dernier = date / roue->resolution;
+    while (roue->tic <= dernier) {
+        // roue vide : rien ne peut expirer d'ici là
+        if (roue->nb_armees == 0) {
+            roue->tic = dernier + 1;
+            return;
+        }
+        // niveaux inférieurs vides : rien ne se passe avant la prochaine descente
+        int vide = 0;
+        while (vide < ROUE_NIVEAUX - 1 && roue->nb_par_niveau[vide] == 0) {
+            vide++;
+        }
+        if (vide > 0) {
+            uint64_t pas = 1ULL << (ROUE_BITS * vide);
+            uint64_t prochain = (roue->tic + pas - 1) & ~(pas - 1);
+            if (prochain > dernier) {
+                roue->tic = dernier + 1;
+                return;
+            }
+            roue->tic = prochain;
+        }
+
+        for (int niveau = 1; niveau < ROUE_NIVEAUX; niveau++) {
+            if ((roue->tic & ((1ULL << (ROUE_BITS * niveau)) - 1)) != 0) break;
+            cascader(roue, niveau, (int)((roue->tic >> (ROUE_BITS * niveau)) & (ROUE_CASES - 1)));
+        }
+
+        int c = (int)(roue->tic & (ROUE_CASES - 1));
+        uint64_t maintenant = roue->tic * roue->resolution;
+        // le rappel peut armer de nouvelles temporisations dans cette même case
+        while (roue->cases[0][c] != -1) {
+            int id = roue->cases[0][c];
+            extraire(roue, id);
+            temporisation_t t = roue->temporisations[id];
+            liberer(roue, id);
+            roue->nb_expirees++;
+            if (rappel != NULL) rappel(contexte, maintenant, id, &t);
+        }
+        roue->tic++;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Roue de temporisations hiérarchique : armement, annulation et réarmement en
+// O(1), adaptée aux temporisations presque toujours réarmées avant d'expirer.
+// Le temps est découpé en tics de `resolution` ns ; le niveau k couvre
+// 2^(8(k+1)) tics, au-delà l'échéance est recalculée en redescendant.
+#define ROUE_NIVEAUX 4
+#define ROUE_BITS 8
+#define ROUE_CASES (1 << ROUE_BITS)
+
+#define TEMPORISATION_AUCUNE -1
+
+typedef struct {
+    uint64_t echeance;   // tic d'expiration
+    int type;            // défini par l'utilisateur de la roue
+    size_t objet;
+    uint64_t argument;
+    int precedent;       // chaînage dans la case (-1 en bout de liste)
+    int suivant;         // ou dans la liste des emplacements libres
+    int case_roue;       // niveau * ROUE_CASES + case, -1 si l'emplacement est libre
+} temporisation_t;
+
+typedef struct {
+    temporisation_t *temporisations;  // emplacements, désignés par leur indice
+    int capacite;
+    int libre;                        // premier emplacement libre, -1 si aucun
+    int nb_armees;
+    int cases[ROUE_NIVEAUX][ROUE_CASES];
+    int nb_par_niveau[ROUE_NIVEAUX];  // permet de sauter les tics sans échéance
+    uint64_t resolution;              // durée d'un tic, en ns
+    uint64_t tic;                     // prochain tic à traiter
+    uint64_t nb_expirees;
+} roue_temporisations_t;
+
+// Appelée pour chaque temporisation expirée, à la date de son tic ; l'identifiant
+// est déjà libéré et peut être réattribué par un armement depuis le rappel
+typedef void (*rappel_temporisation_t)(void *contexte, uint64_t date, int id, const temporisation_t *t);
+
+bool init_roue(roue_temporisations_t *roue, uint64_t resolution);
+void deinit_roue(roue_temporisations_t *roue);
+
+// Renvoie l'identifiant de la temporisation, TEMPORISATION_AUCUNE en cas d'échec
+int armer_temporisation(roue_temporisations_t *roue, uint64_t date, int type, size_t objet, uint64_t argument);
+bool rearmer_temporisation(roue_temporisations_t *roue, int id, uint64_t date);
+bool annuler_temporisation(roue_temporisations_t *roue, int id);
+bool temporisation_armee(const roue_temporisations_t *roue, int id);
+
+// Déclenche, par tic croissant, les temporisations échues jusqu'à date incluse
+void avancer_roue(roue_temporisations_t *roue, uint64_t date, rappel_temporisation_t rappel, void *contexte);
@@ -0,0 +1,276 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "configuration.h"
+#include "stp.h"
+#include "trafic.h"
+
+// Non-régression à l'échelle : pour 10, 1 000, 100 000 et 1 000 000
+// d'équipements, génère une topologie maillée, l'écrit au format de
+// configuration, la relit, calcule le STP puis joue une charge proportionnelle
+// au nombre de stations (TRAMES_PAR_STATION trames chacune). Le bilan
+// (racine, ports bloqués, trames livrées) est comparé au fichier de référence,
+// et le temps écoulé et le pic de mémoire résidente à leurs budgets : une
+// complexité quadratique introduite par mégarde fait échouer le test.
+// Les tailles sont jouées par ordre croissant, le pic de mémoire du processus
+// est donc celui de la plus grande taille jouée jusque-là.
+// Usage : ./test_echelle [-e] [-n max_equipements] [reference]
+//   -e : réécrit la référence à partir de cette exécution (budgets = 3 x mesuré)
+
+#define REFERENCE_DEFAUT "echelle_attendu.txt"
+#define FICHIER_TOPOLOGIE "test_echelle_topologie.txt"
+#define FICHIER_TRACE "test_echelle_trace.txt"
+#define TRAMES_PAR_STATION 4
+#define PERIODE_TRAMES 1000000   // ns entre deux trames d'une même station
+#define STATIONS_PAR_SWITCH 2
+#define MARGE_BUDGET 3
+#define NB_TAILLES_MAX 16
+
+typedef struct {
+    size_t nb_equipements;
+    unsigned long long racine;
+    size_t ports_bloques;
+    unsigned long long livrees;
+    double budget_ms;
+    double budget_rss_mo;
+} bilan_echelle_t;
+
+static const size_t tailles[] = {10, 1000, 100000, 1000000};
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double pic_rss_mo(void) {
+    struct rusage u;
+    getrusage(RUSAGE_SELF, &u);
+    return u.ru_maxrss / 1024.0;   // ko sous Linux
+}
+
+// Grille de switchs avec quelques diagonales, stations réparties sur les
+// switchs ; écrite au format des fichiers de configuration
+static bool ecrire_topologie(const char *nom_fichier, size_t nb_equipements) {
+    static const int poids[] = {4, 19, 100};
+    size_t nb_switchs = nb_equipements / (STATIONS_PAR_SWITCH + 1);
+    if (nb_switchs == 0) nb_switchs = 1;
+    size_t nb_stations = nb_equipements - nb_switchs;
+    size_t cote = 1;
+    while (cote * cote < nb_switchs) cote++;
+
+    FILE *f = fopen(nom_fichier, "w");
+    if (f == NULL) return false;
+
+    // liens comptés d'abord pour l'en-tête : mêmes tirages dans les deux passages
+    size_t nb_liens = nb_stations;
+    for (int passage = 0; passage < 2; passage++) {
+        srand(42);
+        if (passage == 1) {
+            fprintf(f, "%zu %zu\n", nb_equipements, nb_liens);
+            for (size_t i = 0; i < nb_switchs; i++) {
+                fprintf(f, "2;02:00:%02zx:%02zx:%02zx:%02zx;%d;%d\n", (i >> 24) & 0xFF, (i >> 16) & 0xFF,
+                        (i >> 8) & 0xFF, i & 0xFF, 12, 4096 * (1 + rand() % 8));
+            }
+            for (size_t k = 0; k < nb_stations; k++) {
+                fprintf(f, "1;02:01:%02zx:%02zx:%02zx:%02zx;10.%zu.%zu.%zu\n", (k >> 24) & 0xFF, (k >> 16) & 0xFF,
+                        (k >> 8) & 0xFF, k & 0xFF, (k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF);
+            }
+        } else {
+            for (size_t i = 0; i < nb_switchs; i++) rand();
+        }
+        for (size_t i = 0; i < nb_switchs; i++) {
+            size_t x = i % cote;
+            size_t voisins[3] = {UNKNOWN_INDEX, UNKNOWN_INDEX, UNKNOWN_INDEX};
+            if (x + 1 < cote && i + 1 < nb_switchs) voisins[0] = i + 1;
+            if (i + cote < nb_switchs) voisins[1] = i + cote;
+            if (rand() % 4 == 0 && x + 1 < cote && i + cote + 1 < nb_switchs) voisins[2] = i + cote + 1;
+            for (int v = 0; v < 3; v++) {
+                if (voisins[v] == UNKNOWN_INDEX) continue;
+                int p = poids[rand() % 3];
+                if (passage == 0) {
+                    nb_liens++;
+                } else {
+                    fprintf(f, "%zu;%zu;%d\n", i, voisins[v], p);
+                }
+            }
+        }
+        if (passage == 1) {
+            for (size_t k = 0; k < nb_stations; k++) fprintf(f, "%zu;%zu;19\n", k % nb_switchs, nb_switchs + k);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// Charge de la trace : chaque station s'annonce d'abord par une trame adressée
+// à elle-même (apprise puis filtrée par son switch), puis envoie
+// TRAMES_PAR_STATION trames à une station du même switch. Une destination
+// inconnue inonderait tout l'arbre : la charge resterait quadratique.
+static bool ecrire_trace(const char *nom_fichier, size_t nb_equipements) {
+    size_t nb_switchs = nb_equipements / (STATIONS_PAR_SWITCH + 1);
+    if (nb_switchs == 0) nb_switchs = 1;
+    size_t nb_stations = nb_equipements - nb_switchs;
+
+    FILE *f = fopen(nom_fichier, "w");
+    if (f == NULL) return false;
+
+    for (size_t k = 0; k < nb_stations; k++) fprintf(f, "0;%zu;%zu;64\n", nb_switchs + k, nb_switchs + k);
+    for (int t = 1; t <= TRAMES_PAR_STATION; t++) {
+        for (size_t k = 0; k < nb_stations; k++) {
+            // station k reliée au switch k % nb_switchs, comme dans ecrire_topologie
+            size_t voisine = (k + nb_switchs < nb_stations) ? k + nb_switchs : k % nb_switchs;
+            fprintf(f, "%d;%zu;%zu;512\n", t * PERIODE_TRAMES, nb_switchs + k, nb_switchs + voisine);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// Chargement, STP et charge proportionnelle aux stations (trace reproductible)
+static bool jouer(size_t nb_equipements, bilan_echelle_t *b, double *duree_ms) {
+    double t0 = maintenant();
+    if (!ecrire_topologie(FICHIER_TOPOLOGIE, nb_equipements) || !ecrire_trace(FICHIER_TRACE, nb_equipements)) {
+        remove(FICHIER_TOPOLOGIE);
+        return false;
+    }
+    double t1 = maintenant();
+
+    reseau_t r;
+    init_reseau(&r);
+    bool ok = lire_reseau(FICHIER_TOPOLOGIE, &r);
+    remove(FICHIER_TOPOLOGIE);
+    double t2 = maintenant();
+
+    resultat_stp_t res;
+    ok = ok && calculer_stp(&r, &res);
+    double t3 = maintenant();
+
+    simulation_t sim;
+    generateur_trafic_t g;
+    config_trafic_t c;
+    config_trafic_defaut(&c);
+    c.motif = MOTIF_TRACE;
+    c.trace = FICHIER_TRACE;
+    uint64_t livrees = 0;
+    if (ok && init_simulation(&sim, &r)) {
+        if (init_generateur(&g, &sim, &c)) {
+            generer_trafic(&g, (TRAMES_PAR_STATION + 1) * PERIODE_TRAMES);
+            executer_simulation(&sim, 0);
+            livrees = sim.compteurs.nb_livrees;
+            deinit_generateur(&g);
+        } else {
+            ok = false;
+        }
+        deinit_simulation(&sim);
+    } else {
+        ok = false;
+    }
+    remove(FICHIER_TRACE);
+    double t4 = maintenant();
+
+    b->nb_equipements = nb_equipements;
+    b->racine = ok ? (unsigned long long)res.racine : 0;
+    b->ports_bloques = ok ? res.nb_ports_bloques : 0;
+    b->livrees = livrees;
+    *duree_ms = (t4 - t1) * 1e3;
+    printf("%9zu équipements : génération %.0f ms, chargement %.0f ms, STP %.0f ms, charge %.0f ms\n",
+           nb_equipements, (t1 - t0) * 1e3, (t2 - t1) * 1e3, (t3 - t2) * 1e3, (t4 - t3) * 1e3);
+    deinit_reseau(&r);
+    return ok;
+}
+
+static size_t lire_reference(const char *nom_fichier, bilan_echelle_t *attendus) {
+    FILE *f = fopen(nom_fichier, "r");
+    if (f == NULL) return 0;
+
+    char ligne[MAX_LIGNE];
+    size_t nb = 0;
+    while (nb < NB_TAILLES_MAX && fgets(ligne, sizeof(ligne), f) != NULL) {
+        bilan_echelle_t *b = &attendus[nb];
+        if (ligne[0] == '#') continue;
+        if (sscanf(ligne, "%zu;%llx;%zu;%llu;%lf;%lf", &b->nb_equipements, &b->racine, &b->ports_bloques, &b->livrees,
+                   &b->budget_ms, &b->budget_rss_mo) == 6) nb++;
+    }
+    fclose(f);
+    return nb;
+}
+
+static bool ecrire_reference(const char *nom_fichier, const bilan_echelle_t *bilans, size_t nb) {
+    FILE *f = fopen(nom_fichier, "w");
+    if (f == NULL) return false;
+
+    fprintf(f, "# equipements;racine;ports_bloques;trames_livrees;budget_ms;budget_rss_mo\n");
+    for (size_t k = 0; k < nb; k++) {
+        const bilan_echelle_t *b = &bilans[k];
+        fprintf(f, "%zu;%llx;%zu;%llu;%.0f;%.0f\n", b->nb_equipements, b->racine, b->ports_bloques, b->livrees,
+                b->budget_ms, b->budget_rss_mo);
+    }
+    return fclose(f) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    bool enregistrer = false;
+    size_t max_equipements = SIZE_MAX;
+    const char *reference = REFERENCE_DEFAUT;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0) {
+            enregistrer = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            max_equipements = strtoul(argv[++i], NULL, 10);
+        } else {
+            reference = argv[i];
+        }
+    }
+
+    bilan_echelle_t attendus[NB_TAILLES_MAX], bilans[NB_TAILLES_MAX];
+    size_t nb_attendus = enregistrer ? 0 : lire_reference(reference, attendus);
+    if (!enregistrer && nb_attendus == 0) {
+        fprintf(stderr, "Référence %s absente ou vide (./test_echelle -e pour la créer)\n", reference);
+        return 1;
+    }
+
+    size_t nb = 0, nb_echecs = 0;
+    for (size_t k = 0; k < sizeof(tailles) / sizeof(tailles[0]) && tailles[k] <= max_equipements; k++) {
+        bilan_echelle_t *b = &bilans[nb++];
+        double duree_ms;
+        if (!jouer(tailles[k], b, &duree_ms)) {
+            printf("%9zu équipements : ÉCHEC de l'exécution\n", tailles[k]);
+            nb_echecs++;
+            continue;
+        }
+        double rss_mo = pic_rss_mo();
+        b->budget_ms = MARGE_BUDGET * duree_ms < 100 ? 100 : MARGE_BUDGET * duree_ms;
+        b->budget_rss_mo = MARGE_BUDGET * rss_mo < 64 ? 64 : MARGE_BUDGET * rss_mo;
+        if (enregistrer) continue;
+
+        const bilan_echelle_t *a = NULL;
+        for (size_t j = 0; j < nb_attendus; j++) {
+            if (attendus[j].nb_equipements == tailles[k]) a = &attendus[j];
+        }
+        if (a == NULL) {
+            printf("%9zu équipements : absent de la référence\n", tailles[k]);
+            nb_echecs++;
+            continue;
+        }
+        bool resultat = a->racine == b->racine && a->ports_bloques == b->ports_bloques && a->livrees == b->livrees;
+        bool temps = duree_ms <= a->budget_ms, memoire = rss_mo <= a->budget_rss_mo;
+        printf("%9zu équipements : racine %llx, %zu ports bloqués, %llu trames livrées (%s), "
+               "%.0f / %.0f ms (%s), pic %.0f / %.0f Mo (%s)\n",
+               tailles[k], b->racine, b->ports_bloques, b->livrees, resultat ? "conforme" : "DIFFÉRENT", duree_ms,
+               a->budget_ms, temps ? "ok" : "DÉPASSÉ", rss_mo, a->budget_rss_mo, memoire ? "ok" : "DÉPASSÉ");
+        if (!resultat || !temps || !memoire) nb_echecs++;
+    }
+
+    if (enregistrer) {
+        if (nb_echecs > 0 || !ecrire_reference(reference, bilans, nb)) {
+            fprintf(stderr, "Référence non écrite\n");
+            return 1;
+        }
+        printf("Référence écrite dans %s\n", reference);
+        return 0;
+    }
+    printf("%s : %zu taille(s) en échec\n", nb_echecs == 0 ? "Succès" : "ÉCHEC", nb_echecs);
+    return nb_echecs == 0 ? 0 : 1;
+}
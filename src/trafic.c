@@ -0,0 +1,331 @@
+#include "trafic.h"
+#include "journal.h"
+#include "profileur.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LONGUEUR_LIGNE_TRACE 256
+
+void config_trafic_defaut(config_trafic_t *c) {
+    if (c == NULL) return;
+
+    c->motif = MOTIF_POISSON;
+    c->debit = 10000;
+    c->loi_taille = TAILLE_FIXE;
+    c->taille_min = 64;
+    c->taille_max = TAILLE_DONNEES_MAX;
+    c->graine = 1;
+    c->point_chaud = 0;
+    c->proportion = 0.5;
+    c->trace = NULL;
+}
+
+// splitmix64 : suite reproductible, indépendante de rand()
+static uint64_t tirer(generateur_trafic_t *g) {
+    uint64_t z = (g->alea += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniforme sur [0, 1)
+static double uniforme(generateur_trafic_t *g) {
+    return (tirer(g) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static size_t tirer_indice(generateur_trafic_t *g, size_t n) {
+    return (size_t)(tirer(g) % n);
+}
+
+// Intervalle entre deux arrivées d'un processus de Poisson, en ns
+static temps_sim_t intervalle_poisson(generateur_trafic_t *g) {
+    return (temps_sim_t)(-log(1.0 - uniforme(g)) / g->config.debit * 1e9);
+}
+
+// Au moins 1 ns, sinon les motifs périodiques n'avanceraient plus
+static temps_sim_t periode(const generateur_trafic_t *g) {
+    temps_sim_t p = (temps_sim_t)(1e9 / g->config.debit);
+    return (p > 0) ? p : 1;
+}
+
+static size_t tirer_taille(generateur_trafic_t *g) {
+    const config_trafic_t *c = &g->config;
+    switch (c->loi_taille) {
+        case TAILLE_UNIFORME:
+            return c->taille_min + tirer_indice(g, c->taille_max - c->taille_min + 1);
+        case TAILLE_IMIX: {
+            size_t k = tirer_indice(g, 12);
+            return (k < 7) ? 46 : (k < 11) ? 576 : 1500;
+        }
+        default:
+            return c->taille_min;
+    }
+}
+
+static mac_addr_t mac_station(const generateur_trafic_t *g, size_t k) {
+    return reseau_station(g->sim->reseau, g->stations[k])->mac;
+}
+
+static void remplir_paire(generateur_trafic_t *g, size_t source, size_t dest) {
+    g->source = g->stations[source];
+    g->destination = mac_station(g, dest);
+    g->cible = g->stations[dest];
+    g->type = TYPE_IPV4;
+    g->taille = tirer_taille(g);
+}
+
+// Paire source / destination distinctes, destination imposée si dest < nb_stations
+static void tirer_paire(generateur_trafic_t *g, size_t dest) {
+    size_t n = g->nb_stations;
+    if (dest >= n) dest = tirer_indice(g, n);
+    size_t source = tirer_indice(g, n - 1);
+    if (source >= dest) source++;
+
+    remplir_paire(g, source, dest);
+}
+
+// Ligne suivante de la trace : date_ns;source;destination;taille (destination -1 : diffusion)
+static bool lire_ligne_trace(generateur_trafic_t *g) {
+    reseau_t *r = g->sim->reseau;
+    char ligne[LONGUEUR_LIGNE_TRACE];
+
+    while (fgets(ligne, sizeof(ligne), g->trace) != NULL) {
+        g->numero_ligne++;
+        if (ligne[0] == '\n' || ligne[0] == '\r' || ligne[0] == '#') continue;
+
+        unsigned long long date;
+        long long source, destination;
+        size_t taille;
+        if (sscanf(ligne, "%llu;%lld;%lld;%zu", &date, &source, &destination, &taille) == 4 && source >= 0 &&
+            taille <= TAILLE_DONNEES_MAX) {
+            sommet s = sommet_depuis_origine(r, (sommet)source);
+            sommet cible = (destination >= 0) ? sommet_depuis_origine(r, (sommet)destination) : UNKNOWN_INDEX;
+            station_t *st_dest = (destination >= 0) ? reseau_station(r, cible) : NULL;
+            if (reseau_station(r, s) != NULL && (destination < 0 || st_dest != NULL)) {
+                g->date = g->debut + date;
+                g->source = s;
+                g->cible = cible;
+                g->destination = (st_dest != NULL) ? st_dest->mac : creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF);
+                g->type = (st_dest != NULL) ? TYPE_IPV4 : TYPE_ARP;
+                g->taille = taille;
+                return true;
+            }
+        }
+        g->nb_refusees++;
+        JOURNALISER_TEXTE(JOURNAL_AVERTISSEMENT, "Trace : ligne %s ignorée (ligne %llu)", ligne,
+                          g->numero_ligne, 0, 0);
+    }
+    return false;
+}
+
+// Prépare la prochaine trame ; false quand le motif n'en produit plus
+static bool preparer(generateur_trafic_t *g) {
+    const config_trafic_t *c = &g->config;
+    size_t n = g->nb_stations;
+
+    switch (c->motif) {
+        case MOTIF_POISSON:
+            g->date += intervalle_poisson(g);
+            tirer_paire(g, n);
+            return true;
+        case MOTIF_POINT_CHAUD:
+            g->date += intervalle_poisson(g);
+            tirer_paire(g, (uniforme(g) < c->proportion) ? g->j : n);
+            return true;
+        case MOTIF_TEMPETE_ARP:
+            g->date += intervalle_poisson(g);
+            tirer_paire(g, n);
+            if (uniforme(g) < c->proportion) {
+                g->destination = creer_mac(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF);
+                g->type = TYPE_ARP;
+                g->cible = UNKNOWN_INDEX;
+                g->taille = TAILLE_PAQUET_ARP;
+            }
+            return true;
+        case MOTIF_TOUS_VERS_TOUS:
+            // cycle sur toutes les paires ordonnées (i, j) de stations distinctes
+            g->date += periode(g);
+            if (++g->j == g->i) g->j++;
+            if (g->j >= n) {
+                g->i = (g->i + 1) % n;
+                g->j = (g->i == 0) ? 1 : 0;
+            }
+            remplir_paire(g, g->i, g->j);
+            return true;
+        case MOTIF_INCAST:
+            // toutes les sources i d'une rafale vers j partent à la même date
+            if (++g->i == g->j) g->i++;
+            if (g->i >= n) {
+                g->i = (g->j == 0) ? 1 : 0;
+                g->date += periode(g);
+            }
+            remplir_paire(g, g->i, g->j);
+            return true;
+        case MOTIF_TRACE:
+            return lire_ligne_trace(g);
+    }
+    return false;
+}
+
+static void compter_commutations(const reseau_t *r, uint64_t *commutees, uint64_t *inondees) {
+    *commutees = 0;
+    *inondees = 0;
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        *commutees += r->switchs[i].compteurs.nb_commutees;
+        *inondees += r->switchs[i].compteurs.nb_inondees;
+    }
+}
+
+bool init_generateur(generateur_trafic_t *g, simulation_t *sim, const config_trafic_t *c) {
+    if (g == NULL || sim == NULL || c == NULL) return false;
+
+    reseau_t *r = sim->reseau;
+    g->sim = sim;
+    g->config = *c;
+    g->alea = c->graine;
+    g->trace = NULL;
+    g->numero_ligne = 0;
+    g->debut = sim->horloge;
+    g->date = sim->horloge;
+    g->nb_generees = 0;
+    g->nb_refusees = 0;
+    g->octets_generes = 0;
+    compter_commutations(r, &g->commutees_debut, &g->inondees_debut);
+    g->livrees_debut = sim->compteurs.nb_livrees;
+    g->octets_livres_debut = sim->compteurs.octets_livres;
+    g->nb_stations = 0;
+    g->stations = malloc((ordre(&r->g) + 1) * sizeof(sommet));
+    if (g->stations == NULL) return false;
+
+    // ordre du fichier : la suite des trames ne dépend pas d'une renumérotation
+    size_t chaud = ordre(&r->g);
+    for (sommet o = 0; o < ordre(&r->g); o++) {
+        sommet s = sommet_depuis_origine(r, o);
+        if (reseau_station(r, s) == NULL) continue;
+        if (r->raccordements[r->equipements[s].index].voisin == UNKNOWN_INDEX) continue;
+        if (o == c->point_chaud) chaud = g->nb_stations;
+        g->stations[g->nb_stations++] = s;
+    }
+
+    bool ok = true;
+    if (c->motif == MOTIF_TRACE) {
+        g->trace = (c->trace != NULL) ? fopen(c->trace, "r") : NULL;
+        if (g->trace == NULL) {
+            perror("Erreur d'ouverture de la trace");
+            ok = false;
+        }
+    } else if (g->nb_stations < 2 || !(c->debit > 0 && c->debit <= DEBIT_MAX) || c->taille_min > c->taille_max ||
+               c->taille_max > TAILLE_DONNEES_MAX) {
+        JOURNALISER(JOURNAL_ERREUR, "Trafic : au moins 2 stations raccordées, un débit positif d'au plus %llu "
+                    "trames/s et des tailles entre 0 et %llu octets sont nécessaires", (unsigned long long)DEBIT_MAX,
+                    TAILLE_DONNEES_MAX, 0, 0);
+        ok = false;
+    } else if ((c->motif == MOTIF_POINT_CHAUD || c->motif == MOTIF_INCAST) && chaud >= g->nb_stations) {
+        JOURNALISER(JOURNAL_ERREUR, "Trafic : l'équipement %llu n'est pas une station raccordée",
+                    c->point_chaud, 0, 0, 0);
+        ok = false;
+    }
+    if (!ok) {
+        deinit_generateur(g);
+        return false;
+    }
+
+    // tous vers tous et incast démarrent immédiatement sur leur première paire ;
+    // j désigne la station visée (point chaud, incast)
+    switch (c->motif) {
+        case MOTIF_TOUS_VERS_TOUS:
+            g->i = 0;
+            g->j = 1;
+            remplir_paire(g, g->i, g->j);
+            g->actif = true;
+            break;
+        case MOTIF_INCAST:
+            g->j = chaud;
+            g->i = (chaud == 0) ? 1 : 0;
+            remplir_paire(g, g->i, g->j);
+            g->actif = true;
+            break;
+        default:
+            g->i = 0;
+            g->j = chaud;
+            g->actif = preparer(g);
+            break;
+    }
+    return true;
+}
+
+void deinit_generateur(generateur_trafic_t *g) {
+    if (g == NULL) return;
+
+    if (g->trace != NULL) fclose(g->trace);
+    g->trace = NULL;
+    free(g->stations);
+    g->stations = NULL;
+    g->nb_stations = 0;
+    g->actif = false;
+}
+
+static bool emettre(generateur_trafic_t *g) {
+    static const uint8_t zeros[TAILLE_DONNEES_MAX];
+    reseau_t *r = g->sim->reseau;
+
+    trame t;
+    if (!init_trame(&t, reseau_station(r, g->source)->mac, g->destination, g->type, zeros, g->taille)) return false;
+    bool ok = (g->sim->caches_arp != NULL && g->cible != UNKNOWN_INDEX)
+              ? envoyer_ip(g->sim, g->source, reseau_station(r, g->cible)->ip, &t)
+              : emettre_trame(g->sim, g->source, &t);
+    if (ok) {
+        g->nb_generees++;
+        g->octets_generes += taille_trame_octets(&t);
+    } else {
+        g->nb_refusees++;
+    }
+    deinit_trame(&t);
+    return ok;
+}
+
+size_t generer_trafic(generateur_trafic_t *g, temps_sim_t fin) {
+    if (g == NULL) return 0;
+
+    // une seule phase pour toute la boucle : une par trame coûterait plus de 1 %
+    PROFILER_ENTRER("acheminement");
+    size_t nb = 0;
+    while (g->actif && g->date <= fin) {
+        avancer_simulation(g->sim, g->date);
+        if (emettre(g)) nb++;
+        g->actif = preparer(g);
+    }
+    avancer_simulation(g->sim, fin);
+    PROFILER_SORTIR();
+    return nb;
+}
+
+void afficher_bilan_trafic(const generateur_trafic_t *g) {
+    if (g == NULL) return;
+
+    const simulation_t *sim = g->sim;
+    const reseau_t *r = sim->reseau;
+    double duree = (sim->horloge > g->debut) ? (sim->horloge - g->debut) / 1e9 : 0;
+    double offert = (duree > 0) ? g->octets_generes * 8 / duree / 1e6 : 0;
+    uint64_t livrees = sim->compteurs.nb_livrees - g->livrees_debut;
+    double livre = (duree > 0) ? (sim->compteurs.octets_livres - g->octets_livres_debut) * 8 / duree / 1e6 : 0;
+    printf("Trafic sur %.3f ms : %llu trame(s) générée(s), %llu refusée(s) | offert %.1f Mb/s, livré %.1f Mb/s "
+           "(%llu trame(s), %llu rejetée(s) en file)\n",
+           duree * 1e3, (unsigned long long)g->nb_generees, (unsigned long long)g->nb_refusees, offert, livre,
+           (unsigned long long)livrees, (unsigned long long)sim->compteurs.nb_rejetees);
+
+    uint64_t commutees, inondees;
+    compter_commutations(r, &commutees, &inondees);
+    size_t entrees = 0;
+    int entrees_max = 0;
+    for (size_t i = 0; i < r->nb_switchs; i++) {
+        entrees += r->switchs[i].table.taille;
+        if (r->switchs[i].table.taille > entrees_max) entrees_max = r->switchs[i].table.taille;
+    }
+    printf("Switchs : %llu trame(s) commutée(s), %llu inondée(s) | tables : %zu entrée(s), au plus %d par switch, "
+           "%llu expirée(s)\n",
+           (unsigned long long)(commutees - g->commutees_debut), (unsigned long long)(inondees - g->inondees_debut),
+           entrees, entrees_max,
+           (unsigned long long)sim->compteurs.nb_expirees);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "simulation.h"
+
+// Générateur de charge : les stations émettent des trames selon un motif,
+// la simulation avançant jusqu'à la date de chaque émission. À graine égale,
+// la suite des trames est identique d'une exécution à l'autre. Si l'ARP est
+// activé, les trames unicast passent par envoyer_ip et leur résolution.
+typedef enum {
+    MOTIF_POISSON,         // arrivées poissoniennes, source et destination uniformes
+    MOTIF_TOUS_VERS_TOUS,  // chaque station envoie à chacune des autres, à tour de rôle
+    MOTIF_POINT_CHAUD,     // arrivées poissoniennes, une part du trafic vers une même station
+    MOTIF_INCAST,          // rafales synchrones de toutes les stations vers une seule
+    MOTIF_TEMPETE_ARP,     // arrivées poissoniennes, une part en requêtes ARP diffusées
+    MOTIF_TRACE            // relecture d'un fichier CSV, ligne par ligne
+} motif_trafic_t;
+
+// Taille des données de chaque trame
+typedef enum {
+    TAILLE_FIXE,           // taille_min
+    TAILLE_UNIFORME,       // uniforme sur [taille_min, taille_max]
+    TAILLE_IMIX            // 46 / 576 / 1500 octets dans les proportions 7 / 4 / 1
+} loi_taille_t;
+
+typedef struct {
+    motif_trafic_t motif;
+    double debit;            // trames par seconde, toutes stations confondues (rafales par seconde en incast)
+    loi_taille_t loi_taille;
+    size_t taille_min;
+    size_t taille_max;
+    uint64_t graine;
+    sommet point_chaud;      // indice d'origine de la station visée (point chaud, incast)
+    double proportion;       // part vers le point chaud, ou part de diffusion ARP
+    // MOTIF_TRACE : lignes date_ns;source;destination;taille, dates relatives au
+    // démarrage du générateur, indices d'origine, destination -1 pour une diffusion ARP
+    const char *trace;
+} config_trafic_t;
+
+#define TAILLE_DONNEES_MAX 1500
+#define DEBIT_MAX 1e9            // une trame par ns : les dates avancent d'au moins 1 ns
+
+typedef struct {
+    simulation_t *sim;
+    config_trafic_t config;
+    sommet *stations;        // stations raccordées, dans l'ordre du fichier
+    size_t nb_stations;
+    uint64_t alea;           // état du générateur pseudo-aléatoire
+    bool actif;              // false une fois la trace épuisée
+    // prochaine trame à émettre
+    temps_sim_t date;
+    sommet source;
+    mac_addr_t destination;
+    sommet cible;            // station destinataire, UNKNOWN_INDEX pour une diffusion
+    uint16_t type;
+    size_t taille;
+    size_t i, j;             // position dans le cycle tous vers tous ou dans la rafale
+    FILE *trace;
+    int numero_ligne;
+    // bilan
+    temps_sim_t debut;
+    uint64_t commutees_debut;  // compteurs des switchs au démarrage du générateur
+    uint64_t inondees_debut;
+    uint64_t livrees_debut;    // compteurs de la simulation au démarrage du générateur
+    uint64_t octets_livres_debut;
+    uint64_t nb_generees;
+    uint64_t nb_refusees;    // station non raccordée, ligne de trace invalide ou paquet abandonné par l'ARP
+    uint64_t octets_generes; // taille sur le support
+} generateur_trafic_t;
+
+void config_trafic_defaut(config_trafic_t *c);
+
+bool init_generateur(generateur_trafic_t *g, simulation_t *sim, const config_trafic_t *c);
+void deinit_generateur(generateur_trafic_t *g);
+
+// Émet les trames datées jusqu'à fin incluse en faisant avancer la simulation,
+// puis place l'horloge à fin. Renvoie le nombre de trames émises.
+size_t generer_trafic(generateur_trafic_t *g, temps_sim_t fin);
+
+// Débit offert et livré, commutation et occupation des tables des switchs
+void afficher_bilan_trafic(const generateur_trafic_t *g);
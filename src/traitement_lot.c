@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lot.h"
+#include "journal.h"
+
+// Validation d'un lot de topologies : chargement + STP pour chaque fichier,
+// un seul fichier de résultats agrégés.
+// Usage : ./traitement_lot [-j nb_threads] [-o resultats.txt] <répertoire|liste>
+
+int main(int argc, char *argv[]) {
+    int nb_threads = 4;
+    const char *sortie = "resultats_lot.txt";
+    const char *source = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            nb_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            sortie = argv[++i];
+        } else {
+            source = argv[i];
+        }
+    }
+    if (source == NULL || nb_threads <= 0) {
+        fprintf(stderr, "Usage : %s [-j nb_threads] [-o resultats.txt] <répertoire|liste>\n", argv[0]);
+        return 1;
+    }
+    
+    char **fichiers;
+    size_t nb;
+    if (!lister_fichiers_lot(source, &fichiers, &nb)) return 1;
+    
+    resultat_lot_t *resultats = malloc((nb > 0 ? nb : 1) * sizeof(resultat_lot_t));
+    if (resultats == NULL) {
+        liberer_fichiers_lot(fichiers, nb);
+        return 1;
+    }
+    
+    // les erreurs de chargement des threads passent par le journal asynchrone
+    demarrer_journal(stderr, CAPACITE_JOURNAL_DEFAUT);
+    histogramme_t durees;
+    init_histogramme(&durees);
+    bool ok = executer_lot(fichiers, nb, nb_threads, resultats, &durees)
+              && ecrire_resultats_lot(sortie, fichiers, resultats, nb);
+    arreter_journal();
+    if (ok) {
+        printf("%zu fichier(s) traité(s) sur %d thread(s), résultats dans %s\n", nb, nb_threads, sortie);
+        afficher_histogramme(&durees, "Temps par fichier", "ms", 1e6);
+    }
+    
+    free(resultats);
+    liberer_fichiers_lot(fichiers, nb);
+    return ok ? 0 : 1;
+}
@@ -1,16 +1,58 @@
 #include "trame.h"
+#include "memoire.h"
 #include <stdio.h>
 #include <string.h>
 
+charge_utile_t *creer_charge_utile(const uint8_t *donnees, size_t taille){
+    // un octet nul est ajouté après les données (non compté) pour pouvoir afficher du texte
+    charge_utile_t *charge = allouer_memoire(MEMOIRE_TRAMES, sizeof(charge_utile_t) + taille + 1);
+    if(charge == NULL){
+        return NULL;
+    }
+    charge->references = 1;
+    charge->taille = taille;
+    memcpy(charge->octets, donnees, taille);
+    charge->octets[taille] = '\0';
+    return charge;
+}
+
+charge_utile_t *retenir_charge_utile(charge_utile_t *charge){
+    if(charge != NULL){
+        charge->references++;
+    }
+    return charge;
+}
+
+void liberer_charge_utile(charge_utile_t *charge){
+    if(charge != NULL && --charge->references == 0){
+        liberer_memoire(MEMOIRE_TRAMES, charge, sizeof(charge_utile_t) + charge->taille + 1);
+    }
+}
+
 bool init_trame(trame *t, MAC src, MAC dest, uint16_t type, const uint8_t *donnees, size_t taille_donnees){
-    if(t == NULL || donnees == NULL){
+    if(t == NULL || (donnees == NULL && taille_donnees > 0)){
         return false;
     }
+    memset(t->preambule, 0xAA, sizeof(t->preambule));
+    t->sfd = 0xAB;
     t->source = src;
     t->destination = dest;
     t->type = type;
-    t->donnees = donnees;
-    t->taille_donnees = taille_donnees;
+    t->vlan = 0;
+    t->fcs = 0;
+    t->date_emission = 0;
+    // les données sont recopiées une seule fois dans une charge utile partagée
+    t->charge = NULL;
+    t->donnees = NULL;
+    t->taille_donnees = 0;
+    if(taille_donnees > 0){
+        t->charge = creer_charge_utile(donnees, taille_donnees);
+        if(t->charge == NULL){
+            return false;
+        }
+        t->donnees = t->charge->octets;
+        t->taille_donnees = taille_donnees;
+    }
     return true;
 }
 
@@ -18,7 +60,38 @@ void deinit_trame(trame *t){
     if(t == NULL){
         return;
     }
-    free(t->donnees);
+    liberer_charge_utile(t->charge);
+    t->charge = NULL;
     t->donnees = NULL;
     t->taille_donnees = 0;
 }
+
+void copier_trame(trame *dest, const trame *src){
+    // copie de l'en-tête, la charge utile est partagée
+    if(dest == NULL || src == NULL){
+        return;
+    }
+    *dest = *src;
+    retenir_charge_utile(dest->charge);
+}
+
+size_t dupliquer_trame(const trame *t, trame copies[], size_t nb){
+    // nb descripteurs légers pour une inondation, une seule charge utile
+    if(t == NULL || copies == NULL){
+        return 0;
+    }
+    for(size_t i = 0; i < nb; i++){
+        copier_trame(&copies[i], t);
+    }
+    return nb;
+}
+
+size_t taille_trame_octets(const trame *t){
+    // taille sur le support : préambule, SFD, en-tête, données (complétées), FCS
+    if(t == NULL){
+        return 0;
+    }
+    size_t donnees = t->taille_donnees < TAILLE_DONNEES_MIN ? TAILLE_DONNEES_MIN : t->taille_donnees;
+    size_t etiquette = t->vlan != 0 ? TAILLE_ETIQUETTE_VLAN : 0;
+    return sizeof(t->preambule) + sizeof(t->sfd) + TAILLE_EN_TETE_ETHERNET + etiquette + donnees + TAILLE_FCS;
+}
@@ -5,17 +5,49 @@
 #include <stdbool.h>
 #include "adresse.h"
 
+#define TYPE_IPV4 0x0800
+#define TYPE_ARP 0x0806
+#define TYPE_ADHESION 0x88B5   // EtherType expérimental IEEE 802 : adhésions multicast simulées (rôle d'IGMP)
+#define TYPE_VLAN 0x8100       // TPID de l'étiquette 802.1Q
+
+#define TAILLE_EN_TETE_ETHERNET 14   // destination + source + type
+#define TAILLE_DONNEES_MIN 46        // les données plus courtes sont complétées
+#define TAILLE_FCS 4
+#define TAILLE_ETIQUETTE_VLAN 4      // TPID + TCI, insérés entre la source et le type
+
+#define VLAN_MAX 4094                // 0 : trame sans VLAN, 4095 réservé
+
+// Charge utile immuable, partagée par toutes les copies d'une trame
+// et libérée avec la dernière (compteur non atomique : un seul thread de simulation)
+typedef struct {
+    size_t references;
+    size_t taille;
+    uint8_t octets[];
+} charge_utile_t;
+
+// Descripteur de trame : l'en-tête est propre à chaque copie,
+// les données pointent dans la charge utile partagée
 typedef struct {
     uint8_t preambule[7];
     uint8_t sfd;
     MAC destination;
     MAC source;
     uint16_t type;
-    uint8_t *donnees;
+    uint16_t vlan;            // VID de l'étiquette 802.1Q, 0 si la trame n'est pas étiquetée
+    const uint8_t *donnees;
     size_t taille_donnees;
     uint32_t fcs;
+    charge_utile_t *charge;
+    uint64_t date_emission;   // horodatage de la simulation (ns), 0 hors simulation
 } trame;
 
 
+charge_utile_t *creer_charge_utile(const uint8_t *donnees, size_t taille);
+charge_utile_t *retenir_charge_utile(charge_utile_t *charge);
+void liberer_charge_utile(charge_utile_t *charge);
+
 bool init_trame(trame *t, MAC src, MAC dest, uint16_t type, const uint8_t *donnees, size_t taille_donnees);
 void deinit_trame(trame *t);
+void copier_trame(trame *dest, const trame *src);
+size_t dupliquer_trame(const trame *t, trame copies[], size_t nb);
+size_t taille_trame_octets(const trame *t);